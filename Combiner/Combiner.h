@@ -20,7 +20,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #ifndef _COMBINER_H_
 #define _COMBINER_H_
 
-#include "..\Utility\CSortedList.h"
+#include "../Utility/CSortedList.h"
 
 class CRender;
 
@@ -351,6 +351,7 @@ void CDirectXPixelShaderCombiner::InitCombinerCycleFill(void)
 
 void CDirectXPixelShaderCombiner::InitCombinerBlenderForSimpleTextureDraw(uint32 tile)
 {
+	gRDP.dirtyStates |= RDP_DIRTY_RENDER;
 	gD3DDevWrapper.SetPixelShader( NULL );
 	m_pD3DRender->ZBufferEnable( FALSE );
 
@@ -0,0 +1,66 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "../../stdafx.h"
+
+CNullColorCombiner::CNullColorCombiner(CRender *pRender)
+	:CColorCombiner(pRender)
+{
+	m_pDecodedMux = new DecodedMux;
+}
+
+CNullColorCombiner::~CNullColorCombiner()
+{
+	SAFE_DELETE(m_pDecodedMux);
+}
+
+bool CNullColorCombiner::Initialize(void)
+{
+	return true;
+}
+
+void CNullColorCombiner::InitCombinerCycleCopy(void)
+{
+	m_pRender->SetTexelRepeatFlags(gRSP.curTile);
+	NULL_RENDER_COUNT(numCombinerChanges, 1);
+}
+
+void CNullColorCombiner::InitCombinerCycle12(void)
+{
+	if( m_bTex0Enabled )
+		m_pRender->SetTexelRepeatFlags(gRSP.curTile);
+
+	if( m_bTex1Enabled )
+		m_pRender->SetTexelRepeatFlags((gRSP.curTile+1)&7);
+
+	NULL_RENDER_COUNT(numCombinerChanges, 1);
+}
+
+void CNullColorCombiner::InitCombinerCycleFill(void)
+{
+	NULL_RENDER_COUNT(numCombinerChanges, 1);
+}
+
+void CNullColorCombiner::InitCombinerBlenderForSimpleTextureDraw(uint32 tile)
+{
+	gRDP.dirtyStates |= RDP_DIRTY_RENDER;
+	m_pRender->ZBufferEnable( FALSE );
+	m_pRender->SetAddressUAllStages( 0, D3DTADDRESS_CLAMP );
+	m_pRender->SetAddressVAllStages( 0, D3DTADDRESS_CLAMP );
+	NULL_RENDER_COUNT(numCombinerChanges, 1);
+}
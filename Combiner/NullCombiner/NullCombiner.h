@@ -0,0 +1,37 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef _NULL_COMBINER_H_
+#define _NULL_COMBINER_H_
+
+// Decodes the muxes like the pixel shader combiner but sets up no device states
+class CNullColorCombiner : public CColorCombiner
+{
+public:
+	CNullColorCombiner(CRender *pRender);
+	~CNullColorCombiner();
+	bool Initialize(void);
+	void InitCombinerBlenderForSimpleTextureDraw(uint32 tile=0);
+
+protected:
+	void InitCombinerCycleCopy(void);
+	void InitCombinerCycleFill(void);
+	void InitCombinerCycle12(void);
+};
+
+#endif
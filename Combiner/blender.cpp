@@ -16,7 +16,7 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
-#include "..\stdafx.h"
+#include "../stdafx.h"
 
 #ifdef _DEBUG
 static const char * const kBlendCl[] = { "In", "Mem", "Bl", "Fog" };
@@ -53,7 +53,7 @@ static inline void DebugBlender(u32 cycle_type, u32 blender, u32 alpha_cvg_sel,
 #endif
 
 //========================================================================
-void CBlender::InitBlenderMode(void)					// Set Alpha Blender mode
+BlendType CBlender::GetBlendType(void)
 {
 /*Possible Blending Inputs:
 
@@ -79,17 +79,6 @@ Possible Blending Factors:
 	
 	uint32 active_mode = (cycle_type == CYCLE_TYPE_2) ? blendmode : (blendmode & 0xcccc);
 
-	enum BlendType
-	{
-		kBlendModeOpaque,
-		kBlendModeAlphaTrans,
-		kBlendModeFade,
-		kBlendModeOne,
-		kBlendModeZeroOne,
-		kBlendModeAlphaTransInvSrc,
-		kBlendModeOneSrc
-	};
-
 	BlendType type = kBlendModeOpaque;
 
 	// FIXME(strmnnrmn): lots of these need fog! (death-droid CHECKME)
@@ -197,7 +186,13 @@ Possible Blending Factors:
 	if (type == kBlendModeAlphaTrans && !have_alpha)
 		type = kBlendModeOpaque;
 
-	switch (type)
+	return type;
+}
+
+void CBlender::InitBlenderMode(void)					// Set Alpha Blender mode
+{
+#ifdef _WIN32
+	switch (GetBlendType())
 	{
 	case kBlendModeOpaque:
 		gD3DDevWrapper.SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
@@ -233,4 +228,5 @@ Possible Blending Factors:
 		gD3DDevWrapper.SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
 		break;
 	}
+#endif
 }
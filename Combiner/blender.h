@@ -19,12 +19,25 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #ifndef _BLENDER_H_
 #define _BLENDER_H_
 
+enum BlendType
+{
+	kBlendModeOpaque,
+	kBlendModeAlphaTrans,
+	kBlendModeFade,
+	kBlendModeOne,
+	kBlendModeZeroOne,
+	kBlendModeAlphaTransInvSrc,
+	kBlendModeOneSrc
+};
+
 class CBlender
 {
 public:
 	
 	static void InitBlenderMode(void);
 
+	// The blending of the current other modes, without setting it up
+	static BlendType GetBlendType(void);
 };
 
 #endif
@@ -180,6 +180,18 @@ void GenerateFrameBufferOptions(void)
 		break;
 	}
 
+	if( options.bHeadlessRender )
+	{
+		// back buffer copies and render textures are device surfaces, the null render has none
+		frameBufferOptions.bCheckBackBufs				= false;
+		frameBufferOptions.bWriteBackBufToRDRAM			= false;
+		frameBufferOptions.bLoadBackBufFromRDRAM		= false;
+		frameBufferOptions.bSupportRenderTextures		= false;
+		frameBufferOptions.bCheckRenderTextures			= false;
+		frameBufferOptions.bRenderTextureWriteBack		= false;
+		frameBufferOptions.bLoadRDRAMIntoRenderTexture	= false;
+		frameBufferOptions.bIgnore						= true;
+	}
 }
 //////////////////////////////////////////////////////////////////////////
 
@@ -216,9 +228,22 @@ void WriteConfiguration(void)
 	ini.SetLongValue("RenderSetting", "EnableFog", options.bEnableFog);
 	ini.SetLongValue("RenderSetting", "WinFrameMode", options.bWinFrameMode);
 	ini.SetLongValue("RenderSetting", "MipMaps", options.bMipMaps);
+	ini.SetLongValue("RenderSetting", "CaptureDisplayLists", options.captureDisplayLists);
+	ini.SetLongValue("RenderSetting", "HeadlessRender", options.bHeadlessRender);
+	ini.SetLongValue("RenderSetting", "CountRenderCalls", options.bCountRenderCalls);
+	ini.SetLongValue("RenderSetting", "SoftwareRender", options.bSoftwareRender);
+	ini.SetLongValue("RenderSetting", "CacheDisplayLists", options.bCacheDisplayLists);
+	ini.SetLongValue("RenderSetting", "ProfileDisplayLists", options.bProfileDisplayLists);
+	ini.SetLongValue("RenderSetting", "RenderThread", options.bRenderThread);
+	ini.SetLongValue("RenderSetting", "BatchTriangles", options.bBatchTriangles);
+	ini.SetLongValue("RenderSetting", "CullDisplayLists", options.bCullDisplayLists);
 
 	//Now texture settings
 	ini.SetLongValue("Texture Settings", "CacheHiResTextures" , (uint32)options.bCacheHiResTextures);
+	ini.SetLongValue("Texture Settings", "StreamHiResTextures" , (uint32)options.bStreamHiResTextures);
+	ini.SetLongValue("Texture Settings", "HiResStreamBudget" , options.hiresStreamBudget);
+	ini.SetLongValue("Texture Settings", "CompressHiResCache" , (uint32)options.bCompressHiResCache);
+	ini.SetLongValue("Texture Settings", "CompressEnhancedTextures" , (uint32)options.bCompressEnhancedTextures);
 	ini.SetLongValue("Texture Settings", "ForceTextureFilter", (uint32)options.forceTextureFilter);
 	ini.SetLongValue("Texture Settings", "LoadHiResTextures", (uint32)options.bLoadHiResTextures);
 	ini.SetLongValue("Texture Settings", "DumpTexturesToFiles", (uint32)options.bDumpTexturesToFiles);
@@ -258,11 +283,24 @@ void ReadConfiguration(void)
 		options.bLoadHiResTextures = FALSE;
 		// set caching by default to "off"
 		options.bCacheHiResTextures = FALSE;
+		options.bStreamHiResTextures = FALSE;
+		options.hiresStreamBudget = 512;
+		options.bCompressHiResCache = TRUE;
+		options.bCompressEnhancedTextures = FALSE;
 		options.bDumpTexturesToFiles = FALSE;
 		options.textureEnhancement = 0;
 		options.textureEnhancementControl = 0;
 		options.DirectXAntiAliasingValue = 0;
 		options.DirectXAnisotropyValue = 0;
+		options.captureDisplayLists = 0;
+		options.bHeadlessRender = FALSE;
+		options.bCountRenderCalls = FALSE;
+		options.bSoftwareRender = FALSE;
+		options.bCacheDisplayLists = FALSE;
+		options.bProfileDisplayLists = FALSE;
+		options.bRenderThread = FALSE;
+		options.bBatchTriangles = FALSE;
+		options.bCullDisplayLists = TRUE;
 
 		defaultRomOptions.N64FrameBufferEmuType = FRM_BUF_NONE;
 		defaultRomOptions.N64FrameBufferWriteBackControl = FRM_BUF_WRITEBACK_NORMAL;
@@ -295,6 +333,10 @@ void ReadConfiguration(void)
 		options.forceTextureFilter = ini.GetLongValue("Texture Settings","ForceTextureFilter");
 		options.bLoadHiResTextures = ini.GetBoolValue("Texture Settings","LoadHiResTextures");
 		options.bCacheHiResTextures = ini.GetBoolValue("Texture Settings","CacheHiResTextures");
+		options.bStreamHiResTextures = ini.GetBoolValue("Texture Settings","StreamHiResTextures");
+		options.hiresStreamBudget = ini.GetLongValue("Texture Settings","HiResStreamBudget", 512);
+		options.bCompressHiResCache = ini.GetBoolValue("Texture Settings","CompressHiResCache", true);
+		options.bCompressEnhancedTextures = ini.GetBoolValue("Texture Settings","CompressEnhancedTextures");
 		options.bDumpTexturesToFiles = ini.GetBoolValue("Texture Settings","DumpTexturesToFiles");
 
 		options.DirectXAntiAliasingValue = ini.GetLongValue("RenderSetting", "DirectXAntiAliasingValue");
@@ -302,6 +344,15 @@ void ReadConfiguration(void)
 		options.bEnableFog = ini.GetBoolValue("RenderSetting", "EnableFog");
 		options.bWinFrameMode = ini.GetBoolValue("RenderSetting", "WinFrameMode");
 		options.bMipMaps = ini.GetBoolValue("RenderSetting", "MipMaps");
+		options.captureDisplayLists = ini.GetLongValue("RenderSetting", "CaptureDisplayLists", 0);
+		options.bHeadlessRender = ini.GetBoolValue("RenderSetting", "HeadlessRender");
+		options.bCountRenderCalls = ini.GetBoolValue("RenderSetting", "CountRenderCalls");
+		options.bSoftwareRender = ini.GetBoolValue("RenderSetting", "SoftwareRender");
+		options.bCacheDisplayLists = ini.GetBoolValue("RenderSetting", "CacheDisplayLists", false);
+		options.bProfileDisplayLists = ini.GetBoolValue("RenderSetting", "ProfileDisplayLists");
+		options.bRenderThread = ini.GetBoolValue("RenderSetting", "RenderThread");
+		options.bBatchTriangles = ini.GetBoolValue("RenderSetting", "BatchTriangles", false);
+		options.bCullDisplayLists = ini.GetBoolValue("RenderSetting", "CullDisplayLists", true);
 
 		ini.Reset();
 	}
@@ -130,10 +130,24 @@ struct GlobalOptions{
 	bool	bDumpTexturesToFiles;
 	bool	bLoadHiResTextures;
 	bool	bCacheHiResTextures;
+	bool	bStreamHiResTextures;	// Decode hires textures on demand in background threads, if not cached
+	uint32	hiresStreamBudget;		// Memory for streamed hires textures, in MB
+	bool	bCompressHiResCache;	// Keep cached hires textures zlib compressed in memory
+	bool	bCompressEnhancedTextures;	// Store hires and enhanced textures as DXT1/DXT5, hires ones are cached on disk
 
 	uint32	DirectXAntiAliasingValue;
 	uint32	DirectXAnisotropyValue;
 
+	uint32	captureDisplayLists;	// Number of display lists recorded to the capture folder from the start of each rom, 0 for none
+	bool	bHeadlessRender;		// Draw with the null render, no Direct3D device is created
+	bool	bCountRenderCalls;		// Count the draws and state changes reaching the null render
+	bool	bSoftwareRender;		// The headless render rasterizes the frames in system memory, for image comparisons
+	bool	bCacheDisplayLists;		// Replay the display lists which have not changed from a cache of decoded commands
+	bool	bRenderThread;			// Run the display lists on a thread of their own while the emulation goes on
+	bool	bBatchTriangles;		// Draw the triangles of consecutive Tri commands together until a device state changes
+	bool	bCullDisplayLists;		// Skip the vertices and triangles of the display lists called off screen, by their learned bounds
+	bool	bProfileDisplayLists;	// Time each microcode handler, the tables are written to the profile folder when the rom is closed
+
 	HACK_FOR_GAMES	enableHackForGames;
 } ;
 
@@ -17,8 +17,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 */
 
-#include "..\stdafx.h"
-#include "..\_BldNum.h"
+#include "../stdafx.h"
+#include "../_BldNum.h"
 
 #ifdef _DEBUG
 
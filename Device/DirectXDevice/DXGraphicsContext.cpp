@@ -54,7 +54,10 @@ void CDXGraphicsContext::Clear(ClearFlag dwFlags, uint32 color, float depth)
 	if( dwFlags&CLEAR_DEPTH_BUFFER )	flag |= D3DCLEAR_ZBUFFER;
 	Lock();
 	if (m_pd3dDevice != NULL)
+	{
+		FlushBatchedTriangles();
 		m_pd3dDevice->Clear(0, NULL, flag, color, depth, 0);
+	}
 	Unlock();
 }
 
@@ -295,19 +298,22 @@ HRESULT CDXGraphicsContext::InitializeD3D()
 	m_d3dpp.BackBufferWidth = m_bWindowed ? 0 : windowSetting.uDisplayWidth;
 	m_d3dpp.BackBufferHeight = m_bWindowed ? 0 : windowSetting.uDisplayHeight;
 
+	// The render thread draws and UpdateScreen presents on the emulator thread
+	DWORD threadFlags = options.bRenderThread ? D3DCREATE_MULTITHREADED : 0;
+
     // Create the device
 	if(!SUCCEEDED(m_pD3D->CreateDevice(
 		D3DADAPTER_DEFAULT,
 		D3DDEVTYPE_HAL, 
 		m_hWnd, 
-		D3DCREATE_HARDWARE_VERTEXPROCESSING | D3DCREATE_PUREDEVICE, 
+		D3DCREATE_HARDWARE_VERTEXPROCESSING | D3DCREATE_PUREDEVICE | threadFlags, 
 		&m_d3dpp,	&m_pd3dDevice )))
 	{
 		if(!SUCCEEDED(m_pD3D->CreateDevice(
 				D3DADAPTER_DEFAULT,
 				D3DDEVTYPE_HAL, 
 				m_hWnd, 
-				D3DCREATE_SOFTWARE_VERTEXPROCESSING, 
+				D3DCREATE_SOFTWARE_VERTEXPROCESSING | threadFlags, 
 				&m_d3dpp,	&m_pd3dDevice )))
 		{
 			MsgInfo("Failed to initialize Direct3D");
@@ -601,6 +607,10 @@ VOID CDXGraphicsContext::CleanUp()
 
 		SAFE_RELEASE(m_pd3dDevice);
 		SAFE_RELEASE(m_pD3D);
+
+		// the textures are created in system memory while there is no device
+		g_pD3DDev = NULL;
+		gD3DDevWrapper.SetD3DDev(NULL);
     }
 }
 
@@ -682,6 +692,7 @@ HRESULT CD3DDevWrapper::SetRenderState(D3DRENDERSTATETYPE State,DWORD Value)
 	{
 		if (m_savedRenderStates[State] != Value || !m_savedRenderStates[State])
 		{
+			FlushBatchedTriangles();
 			m_savedRenderStates[State] = Value;
 			return m_pD3DDev->SetRenderState(State, Value);
 		}
@@ -706,6 +717,7 @@ HRESULT CD3DDevWrapper::SetTextureStageState(DWORD Stage,D3DTEXTURESTAGESTATETYP
 			case D3DTSS_ALPHAARG0: 
 				if( Value != D3DTA_IGNORE )
 				{
+					FlushBatchedTriangles();
 					m_savedTextureStageStates[Stage][Type] = Value;
 					return m_pD3DDev->SetTextureStageState(Stage, Type, Value);
 				}
@@ -713,6 +725,7 @@ HRESULT CD3DDevWrapper::SetTextureStageState(DWORD Stage,D3DTEXTURESTAGESTATETYP
 					return S_OK;
 				break;
 			default:
+				FlushBatchedTriangles();
 				m_savedTextureStageStates[Stage][Type] = Value;
 				return m_pD3DDev->SetTextureStageState(Stage, Type, Value);
 				break;
@@ -729,6 +742,7 @@ HRESULT CD3DDevWrapper::SetPixelShader(IDirect3DPixelShader9* pShader)
 	{
 		if( m_savedPixelShader != pShader )
 		{
+			FlushBatchedTriangles();
 			m_savedPixelShader = pShader;
 			return m_pD3DDev->SetPixelShader(pShader);
 		}
@@ -745,6 +759,7 @@ HRESULT CD3DDevWrapper::SetPixelShaderConstant(DWORD Register, float* pfdata)
 		if(m_savedPixelShaderConstants[Register][0] != pfdata[0] || m_savedPixelShaderConstants[Register][1] != pfdata[1] ||
 		   m_savedPixelShaderConstants[Register][2] != pfdata[2] || m_savedPixelShaderConstants[Register][3] != pfdata[3] )
 		{
+			FlushBatchedTriangles();
 			m_savedPixelShaderConstants[Register][0] = pfdata[0];
 			m_savedPixelShaderConstants[Register][1] = pfdata[1];
 			m_savedPixelShaderConstants[Register][2] = pfdata[2];
@@ -784,6 +799,12 @@ HRESULT CD3DDevWrapper::SetViewport(D3DVIEWPORT9* pViewport)
 			}
 		}
 
+		if( memcmp(&m_savedViewport, pViewport, sizeof(D3DVIEWPORT9)) != 0 )
+		{
+			FlushBatchedTriangles();
+			m_savedViewport = *pViewport;
+		}
+
 		try
 		{
 			return m_pD3DDev->SetViewport(pViewport);
@@ -802,6 +823,8 @@ HRESULT CD3DDevWrapper::SetTexture(DWORD Stage,IDirect3DBaseTexture9* pTexture)
 	{
 		//if (m_savedTexturePointers[Stage] != pTexture )
 		{
+			if( m_savedTexturePointers[Stage] != pTexture )
+				FlushBatchedTriangles();
 			m_savedTexturePointers[Stage] = pTexture;
 			return m_pD3DDev->SetTexture( Stage, pTexture );
 		}
@@ -816,6 +839,8 @@ HRESULT CD3DDevWrapper::SetFVF(DWORD FVF)
 	{
 		//if( m_savedFVF != FVF )
 		{
+			if( m_savedFVF != FVF )
+				FlushBatchedTriangles();
 			m_savedFVF = FVF;
 			return m_pD3DDev->SetFVF(FVF);
 		}
@@ -824,6 +849,21 @@ HRESULT CD3DDevWrapper::SetFVF(DWORD FVF)
 	return S_OK;
 }
 
+HRESULT CD3DDevWrapper::SetSamplerState(DWORD Sampler,D3DSAMPLERSTATETYPE Type,DWORD Value)
+{
+	if( m_pD3DDev != NULL )
+	{
+		if( m_savedSamplerStates[Sampler][Type] != Value )
+		{
+			FlushBatchedTriangles();
+			m_savedSamplerStates[Sampler][Type] = Value;
+			return m_pD3DDev->SetSamplerState(Sampler, Type, Value);
+		}
+	}
+
+	return S_OK;
+}
+
 void CD3DDevWrapper::SetD3DDev(LPDIRECT3DDEVICE9 pD3DDev)
 {
 	m_pD3DDev = pD3DDev;
@@ -838,6 +878,8 @@ void CD3DDevWrapper::Initalize(void)
 	memset(&m_savedPixelShaderConstants, 0xEE, sizeof(m_savedPixelShaderConstants));
 	memset(&m_savedTextureStageStates, 0xEE, sizeof(m_savedTextureStageStates));
 	memset(&m_savedTexturePointers, 0xEE, sizeof(m_savedTexturePointers));
+	memset(&m_savedSamplerStates, 0xEE, sizeof(m_savedSamplerStates));
+	memset(&m_savedViewport, 0xEE, sizeof(m_savedViewport));
 
 	for( int i=0; i<8; i++ )
 	{
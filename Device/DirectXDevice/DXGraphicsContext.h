@@ -91,6 +91,7 @@ protected:
 #define MAX_RENDER_STATE					152
 #define MAX_NUM_OF_PIXEL_SHADER_CONSTANT	30
 #define MAX_TEXTURE_STAGE_STATE				25
+#define MAX_SAMPLER_STATE					14
 class CD3DDevWrapper
 {
 public:
@@ -113,6 +114,7 @@ public:
 	HRESULT SetViewport (D3DVIEWPORT9* pViewport);
 	HRESULT SetTexture (DWORD Stage,IDirect3DBaseTexture9* pTexture);
 	HRESULT SetFVF (DWORD Handle);
+	HRESULT SetSamplerState (DWORD Sampler,D3DSAMPLERSTATETYPE Type,DWORD Value);
 	void    Initalize(void);
 
 private:
@@ -123,6 +125,8 @@ private:
 	DWORD m_savedFVF;
 	float m_savedPixelShaderConstants[MAX_NUM_OF_PIXEL_SHADER_CONSTANT][4];
 	IDirect3DBaseTexture9* m_savedTexturePointers[8];
+	DWORD m_savedSamplerStates[8][MAX_SAMPLER_STATE];
+	D3DVIEWPORT9 m_savedViewport;
 };
 
 #endif
@@ -19,9 +19,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 // ===========================================================================
 
-#include "..\stdafx.h"
-#include "..\Parser\UcodeDefs.h"
-#include "..\Parser\RSP_Parser.h"
+#include "../stdafx.h"
+#include "../Parser/UcodeDefs.h"
+#include "../Parser/RSP_Parser.h"
+#include "../Parser/RenderThread.h"
 
 extern TMEMLoadMapInfo g_tmemLoadAddrMap[0x200];	// Totally 4KB TMEM;
 
@@ -507,6 +508,9 @@ void TexRectToFrameBuffer_8b(uint32 dwXL, uint32 dwYL, uint32 dwXH, uint32 dwYH,
 	dwHeight = min(dwHeight, maxH-dwTop);
 	if( maxH <= dwTop )	return;
 
+	uint32 dwDstAddr = g_pRenderTextureInfo->CI_Info.dwAddr;
+	gRenderThread.AddWrite(dwDstAddr + dwTop*dwDstPitch, dwDstAddr + (dwTop+dwHeight)*dwDstPitch);
+
 	for (uint32 y = 0; y < dwHeight; y++)
 	{
 		uint32 dwByteOffset = (uint32)(((y*yScale+dwSrcOffY) * dwSrcPitch) + dwSrcOffX);
@@ -541,6 +545,7 @@ void TexRectToN64FrameBuffer_16b(uint32 x0, uint32 y0, uint32 width, uint32 heig
 
 	uint32 n64CIaddr = g_CI.dwAddr;
 	uint32 n64CIwidth = g_CI.dwWidth;
+	gRenderThread.AddWrite((n64CIaddr&(g_dwRamSize-1)) + y0*n64CIwidth*2, (n64CIaddr&(g_dwRamSize-1)) + (y0+height)*n64CIwidth*2);
 
 	for (uint32 y = 0; y < height; y++)
 	{
@@ -567,7 +572,7 @@ uint32 CalculateRDRAMCRC(void *pPhysicalAddress, uint32 left, uint32 top, uint32
 		if (!options.bLoadHiResTextures && !options.bDumpTexturesToFiles)
 		{
 			//Code by CornN64
-			retCrc = (uint32)pPhysicalAddress;
+			retCrc = (uint32)(uintptr_t)pPhysicalAddress;
 			register uint32 *pStart = (uint32*)(pPhysicalAddress);
 			register uint32 *pEnd = pStart;
 			
@@ -974,7 +979,7 @@ OK, heres the drill!
 	if( gRenderTextureInfos[idxToUse].pRenderTexture == NULL || matchidx < 0 )
 	{
 		gRenderTextureInfos[idxToUse].pRenderTexture = 
-				new CDXRenderTexture(tempRenderTextureInfo.bufferWidth, tempRenderTextureInfo.bufferHeight, &gRenderTextureInfos[idxToUse], AS_BACK_BUFFER_SAVE);
+				CreateRenderTexture(tempRenderTextureInfo.bufferWidth, tempRenderTextureInfo.bufferHeight, &gRenderTextureInfos[idxToUse], AS_BACK_BUFFER_SAVE);
 	}
 
 	// Need to set all variables for gRenderTextureInfos[idxToUse]
@@ -1199,7 +1204,7 @@ void FrameBufferManager::ActiveTextureBuffer(void)
 			}
 
 			gRenderTextureInfos[idxToUse].pRenderTexture = 
-				new CDXRenderTexture(w, newRenderTextureInfo.bufferHeight, &gRenderTextureInfos[idxToUse], AS_RENDER_TARGET);
+				CreateRenderTexture(w, newRenderTextureInfo.bufferHeight, &gRenderTextureInfos[idxToUse], AS_RENDER_TARGET);
 		}
 
 		// Need to set all variables for gRenderTextureInfos[idxToUse]
@@ -1240,8 +1245,10 @@ void FrameBufferManager::ActiveTextureBuffer(void)
 			//SetScreenMult(1, 1);
 			SetScreenMult(gRenderTextureInfos[m_curRenderTextureIndex].scaleX, gRenderTextureInfos[m_curRenderTextureIndex].scaleY);
 			CRender::g_pRender->UpdateClipRectangle();
+#ifdef _WIN32
 			D3DVIEWPORT9 vp = {0,0,gRenderTextureInfos[idxToUse].bufferWidth,gRenderTextureInfos[idxToUse].bufferHeight,0,1};
 			gD3DDevWrapper.SetViewport(&vp);
+#endif
 
 			// If needed, draw RDRAM into the render_texture
 			if( frameBufferOptions.bLoadRDRAMIntoRenderTexture )
@@ -1460,6 +1467,7 @@ void FrameBufferManager::CopyBufferToRDRAM(uint32 addr, uint32 fmt, uint32 siz,
 	if( siz == TXT_SIZE_16b )
 	{
 		uint16 *frameBufferBase = (uint16*)(g_pu8RamBase+addr);
+		gRenderThread.AddWrite(addr + startline*pitch*2, addr + endline*pitch*2);
 
 		int  sy0;
 		float ratio = bufHeight/(float)height;
@@ -1488,6 +1496,7 @@ void FrameBufferManager::CopyBufferToRDRAM(uint32 addr, uint32 fmt, uint32 siz,
 	else if( siz == TXT_SIZE_8b && fmt == TXT_FMT_CI )
 	{
 		uint8 *frameBufferBase = (uint8*)(g_pu8RamBase+addr);
+		gRenderThread.AddWrite(addr + startline*width, addr + endline*width);
 
 		uint16 tempword;
 		InitTlutReverseLookup();
@@ -1512,6 +1521,7 @@ void FrameBufferManager::CopyBufferToRDRAM(uint32 addr, uint32 fmt, uint32 siz,
 	else if( siz == TXT_SIZE_8b && fmt == TXT_FMT_I )
 	{
 		uint8 *frameBufferBase = (uint8*)(g_pu8RamBase+addr);
+		gRenderThread.AddWrite(addr + startline*width, addr + endline*width);
 
 		int sy0;
 		float ratio = bufHeight/(float)height;
@@ -1626,3 +1636,15 @@ void FrameBufferManager::SaveBackBuffer(int ciInfoIdx, RECT* pSrcRect, bool forc
 
 	g_uRecentCIInfoPtrs[ciInfoIdx]->bCopied = true;
 }
+
+CRenderTexture* NullFrameBufferManager::CreateRenderTexture(int width, int height, RenderTextureInfo* pInfo, TextureUsage usage)
+{
+	// never asked for, GenerateFrameBufferOptions turns the render textures off for the null render
+	return NULL;
+}
+
+void NullFrameBufferManager::SaveBackBuffer(int ciInfoIdx, RECT* pSrcRect, bool forceToSaveToRDRAM)
+{
+	// there is no back buffer surface, the buffer is only marked as saved
+	g_uRecentCIInfoPtrs[ciInfoIdx]->bCopied = true;
+}
@@ -29,7 +29,7 @@ class FrameBufferManager
 	friend class CDXGraphicsContext;
 public:
 	FrameBufferManager();
-	~FrameBufferManager();
+	virtual ~FrameBufferManager();
 
 	void Initialize();
 	void CloseUp();
@@ -66,6 +66,7 @@ public:
 	virtual bool IsRenderingToTexture() {return m_isRenderingToTexture;}
 
 	// Device dependent functions
+	virtual CRenderTexture* CreateRenderTexture(int width, int height, RenderTextureInfo* pInfo, TextureUsage usage) = 0;
 	virtual void SaveBackBuffer(int ciInfoIdx, RECT* pRect=NULL, bool forceToSaveToRDRAM = false);			// Copy the current back buffer to temp buffer
 	virtual void CopyBackBufferToRenderTexture(int idx, RecentCIInfo &ciInfo, RECT* pRect=NULL) {}			// Copy the current back buffer to temp buffer
 	virtual void CopyBufferToRDRAM(uint32 addr, uint32 fmt, uint32 siz, uint32 width, 
@@ -88,6 +89,7 @@ class DXFrameBufferManager : public FrameBufferManager
 {
 public:
 	// Device dependent functions
+	virtual CRenderTexture* CreateRenderTexture(int width, int height, RenderTextureInfo* pInfo, TextureUsage usage);
 	virtual void CopyBackBufferToRenderTexture(int idx, RecentCIInfo &ciInfo, RECT* pRect=NULL);			// Copy the current back buffer to temp buffer
 	virtual void CopyD3DSurfaceToRDRAM(uint32 addr, uint32 fmt, uint32 siz, uint32 width, 
 		uint32 height, uint32 bufWidth, uint32 bufHeight, uint32 startaddr=0xFFFFFFFF, 
@@ -97,6 +99,14 @@ public:
 		uint32 memsize=0xFFFFFFFF, uint32 pitch=0);
 };
 
+// Frame buffer manager of the null render, the back buffers are never copied
+class NullFrameBufferManager : public FrameBufferManager
+{
+public:
+	virtual CRenderTexture* CreateRenderTexture(int width, int height, RenderTextureInfo* pInfo, TextureUsage usage);
+	virtual void SaveBackBuffer(int ciInfoIdx, RECT* pRect=NULL, bool forceToSaveToRDRAM = false);
+};
+
 extern RenderTextureInfo gRenderTextureInfos[];
 extern RenderTextureInfo newRenderTextureInfo;
 
@@ -23,11 +23,19 @@ Overview of DX framebuffer code:
 */
 
 #include "..\stdafx.h"
+
+CRenderTexture* DXFrameBufferManager::CreateRenderTexture(int width, int height, RenderTextureInfo* pInfo, TextureUsage usage)
+{
+	return new CDXRenderTexture(width, height, pInfo, usage);
+}
+
 //copies DirectX backbuffer to the render_texture structure
 //This can be slow....
 //But, its needed to render framebuffer effects, due to the current implementation.
 void DXFrameBufferManager::CopyBackBufferToRenderTexture(int idx, RecentCIInfo &ciInfo, RECT* pDstRect)
 {
+	FlushBatchedTriangles();
+
 	LPDIRECT3DSURFACE9 pSavedBuffer;
 	gRenderTextureInfos[idx].pRenderTexture->m_pTexture->GetTexture()->GetSurfaceLevel(0,&pSavedBuffer);
 
@@ -75,6 +83,8 @@ void DXFrameBufferManager::CopyD3DSurfaceToRDRAM(uint32 addr, uint32 fmt, uint32
 	if( addr == 0 || addr>=g_dwRamSize )	return;
 	if( pitch == 0 ) pitch = width;
 
+	FlushBatchedTriangles();
+
 	IDirect3DSurface9 *surf2 = NULL;
 
 	TXTRBUF_DUMP(DebuggerAppendMsg("Copy Back to N64 RDRAM"););
@@ -110,6 +120,7 @@ void DXFrameBufferManager::CopyD3DSurfaceToRDRAM(uint32 addr, uint32 fmt, uint32
 void DXFrameBufferManager::StoreBackBufferToRDRAM(uint32 addr, uint32 fmt, uint32 siz, uint32 width, uint32 height, uint32 bufWidth, uint32 bufHeight, uint32 startaddr, uint32 memsize, uint32 pitch)
 {
 	IDirect3DSurface9 *backBuffer = NULL;
+	FlushBatchedTriangles();
 	g_pD3DDev->GetBackBuffer(0, 0,D3DBACKBUFFER_TYPE_MONO, &backBuffer);
 
 	TXTRBUF_DUMP(DebuggerAppendMsg("Copy Back Buffer to N64 RDRAM"););
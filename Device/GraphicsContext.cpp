@@ -18,7 +18,7 @@
 
 */
 
-#include "..\stdafx.h"
+#include "../stdafx.h"
 
 CGraphicsContext* CGraphicsContext::g_pGraphicsContext = NULL;
 bool CGraphicsContext::needCleanScene = false;
@@ -57,6 +57,10 @@ void CGraphicsContext::InitWindowInfo()
 
 	m_hWndStatus = g_GraphicsInfo.hStatusBar;
 
+	// Add extra margin for the status bar
+	windowSetting.statusBarHeight = 0;
+
+#ifdef _WIN32
 	m_hMenu = GetMenu(m_hWnd);
 
 	// Save window properties
@@ -66,14 +70,13 @@ void CGraphicsContext::InitWindowInfo()
 
 	RECT rcStatus;
 
-	// Add extra margin for the status bar
-	windowSetting.statusBarHeight = 0;
 	if ( IsWindow( m_hWndStatus ) )
 	{
 		// Add on enough space for the status bar
 		GetClientRect(m_hWndStatus, &rcStatus);
 		windowSetting.statusBarHeight = (rcStatus.bottom - rcStatus.top);
 	}
+#endif
 }
 
 
@@ -90,6 +93,7 @@ bool CGraphicsContext::Initialize(HWND hWnd, HWND hWndStatus, uint32 dwWidth, ui
 		windowSetting.uDisplayHeight = windowSetting.uWindowDisplayHeight;
 	}
 	
+#ifdef _WIN32
 	RECT rcScreen;
 	SetRect(&rcScreen, 0,0, windowSetting.uDisplayWidth, windowSetting.uDisplayHeight);
 	rcScreen.bottom += windowSetting.statusBarHeight;
@@ -107,6 +111,7 @@ bool CGraphicsContext::Initialize(HWND hWnd, HWND hWndStatus, uint32 dwWidth, ui
 		ShowCursor( FALSE );
 	else
 		ShowCursor( TRUE );
+#endif
 
 	g_pFrameBufferManager->Initialize();
 
@@ -118,6 +123,7 @@ void CGraphicsContext::CleanUp()
     m_bActive = false;
     m_bReady  = false;
 
+#ifdef _WIN32
 	if ( IsWindow( m_hWnd ) )
 	{
 		SetWindowLong( m_hWnd, GWL_STYLE, m_dwWindowStyle );
@@ -127,6 +133,7 @@ void CGraphicsContext::CleanUp()
 	{
 		SetWindowLong( m_hWndStatus, GWL_STYLE, m_dwStatusWindowStyle);
 	}
+#endif
 }
 
 int _cdecl SortResolutionsCallback( const VOID* arg1, const VOID* arg2 )
@@ -154,11 +161,13 @@ void CGraphicsContext::InitDeviceParameters(void)
 {
 	// Initialize common device parameters
 
-	int i=0,j;
-	DEVMODE deviceMode;
 	CGraphicsContext::m_numOfResolutions=0;
 	memset(&CGraphicsContext::m_FullScreenResolutions, 0, 40*2*sizeof(int));
 
+#ifdef _WIN32
+	int i=0,j;
+	DEVMODE deviceMode;
+
 	while (EnumDisplaySettings( NULL, i, &deviceMode ) != 0)
 	{
 		//Lets ensure that the current display resolution is not already in our list
@@ -185,11 +194,12 @@ void CGraphicsContext::InitDeviceParameters(void)
 
 	// To initialze device parameters for DirectX
 	CDXGraphicsContext::InitDeviceParameters();
+#endif
 }
 
 void OutputText(char *msg, RECT *prect, uint32 flag)
 {
-
+#ifdef _WIN32
 	HDC hdc = GetDC(g_GraphicsInfo.hWnd);
 	if( hdc )
 	{
@@ -203,4 +213,5 @@ void OutputText(char *msg, RECT *prect, uint32 flag)
 		//TextOut(hdc,prect->left,prect->bottom,msg, strlen(msg));
 		ReleaseDC(g_GraphicsInfo.hWnd,hdc);
 	}
+#endif
 }
\ No newline at end of file
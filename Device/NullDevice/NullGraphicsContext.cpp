@@ -0,0 +1,76 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "../../stdafx.h"
+
+CNullGraphicsContext::CNullGraphicsContext()
+{
+}
+
+CNullGraphicsContext::~CNullGraphicsContext()
+{
+}
+
+bool CNullGraphicsContext::Initialize(HWND hWnd, HWND hWndStatus, uint32 dwWidth, uint32 dwHeight, BOOL bWindowed )
+{
+	m_bWindowed = true;
+	CGraphicsContext::Initialize(hWnd, hWndStatus, dwWidth, dwHeight, TRUE);
+
+#ifdef _WIN32
+	if( g_GraphicsInfo.hStatusBar )
+	{
+		SetWindowText(g_GraphicsInfo.hStatusBar,"Headless render is ready");
+	}
+#endif
+
+	m_bReady = true;
+	m_bActive = true;
+	return true;
+}
+
+void CNullGraphicsContext::Clear(ClearFlag dwFlags, uint32 color, float depth)
+{
+	if( CSoftwareRender::g_pSoftwareRender )
+	{
+		CSoftwareRender::g_pSoftwareRender->ClearSurface(dwFlags, color, depth);
+	}
+
+	NULL_RENDER_COUNT(numClears, 1);
+}
+
+void CNullGraphicsContext::UpdateFrame(bool swaponly)
+{
+	if( CRender::g_pRender )
+	{
+		CRender::g_pRender->BeginRendering();
+	}
+
+	g_pFrameBufferManager->UpdateFrameBufferBeforeUpdateFrame();
+
+	if( CRender::g_pRender )
+	{
+		CRender::g_pRender->EndRendering();
+	}
+
+	NULL_RENDER_COUNT(numFrames, 1);
+}
+
+bool CNullGraphicsContext::ToggleFullscreen()
+{
+	return false;
+}
@@ -0,0 +1,36 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef _NULL_GRAPHICS_CONTEXT_H_
+#define _NULL_GRAPHICS_CONTEXT_H_
+
+// Graphics context of the null render, no device is created and the textures are kept in system memory
+class CNullGraphicsContext : public CGraphicsContext
+{
+public:
+	CNullGraphicsContext();
+	virtual ~CNullGraphicsContext();
+
+	bool Initialize(HWND hWnd, HWND hWndStatus, uint32 dwWidth, uint32 dwHeight, BOOL bWindowed );
+
+	void Clear(ClearFlag dwFlags, uint32 color=0xFF000000, float depth=1.0f);
+	void UpdateFrame(bool swaponly=false);
+	bool ToggleFullscreen();		// return false as the result is windowed
+};
+
+#endif
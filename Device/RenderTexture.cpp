@@ -67,6 +67,8 @@ bool CDXRenderTexture::SetAsRenderTarget(bool enable)
 			{
 				LPDIRECT3DSURFACE9 pColorBuffer;
 
+				FlushBatchedTriangles();
+
 				// save the current back buffer
 				g_pD3DDev->GetBackBuffer(0, 0, D3DBACKBUFFER_TYPE_MONO, &m_pColorBufferSave);
 				g_pD3DDev->GetDepthStencilSurface(&m_pDepthBufferSave);
@@ -99,6 +101,7 @@ bool CDXRenderTexture::SetAsRenderTarget(bool enable)
 		{
 			if( m_pColorBufferSave && m_pDepthBufferSave )
 			{
+				FlushBatchedTriangles();
 				g_pD3DDev->SetRenderTarget(0, m_pColorBufferSave);
 				m_beingRendered = false;
 				SAFE_RELEASE(m_pColorBufferSave);
@@ -168,6 +171,8 @@ void CDXRenderTexture::StoreToRDRAM(int infoIdx)
 {
 	if( !frameBufferOptions.bRenderTextureWriteBack )	return;
 
+	FlushBatchedTriangles();
+
 	RenderTextureInfo &info = gRenderTextureInfos[infoIdx];
 	DXFrameBufferManager &FBmgr = *(DXFrameBufferManager*)g_pFrameBufferManager;
 
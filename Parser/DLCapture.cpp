@@ -0,0 +1,529 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "..\stdafx.h"
+#include <string>
+#include "DLCapture.h"
+#include "DLCulling.h"
+#include "..\lib\BMGLib\zlib114\zlib.h"
+
+#define DLCAPTURE_SP_MEM_SIZE	0x1000
+
+CDListCapture gDListCapture;
+bool CDListCapture::s_bReplaying = false;
+
+extern void GetPluginDir( char * Directory );
+
+// The register pointers of a GFX_INFO, in the order of the DLCAPTURE_*_REG values
+static void GetRegisters(GFX_INFO &info, uint32 **regs[DLCAPTURE_NUM_REGS])
+{
+	regs[DLCAPTURE_MI_INTR_REG] = &info.MI_INTR_REG;
+	regs[DLCAPTURE_DPC_START_REG] = &info.DPC_START_REG;
+	regs[DLCAPTURE_DPC_END_REG] = &info.DPC_END_REG;
+	regs[DLCAPTURE_DPC_CURRENT_REG] = &info.DPC_CURRENT_REG;
+	regs[DLCAPTURE_DPC_STATUS_REG] = &info.DPC_STATUS_REG;
+	regs[DLCAPTURE_DPC_CLOCK_REG] = &info.DPC_CLOCK_REG;
+	regs[DLCAPTURE_DPC_BUFBUSY_REG] = &info.DPC_BUFBUSY_REG;
+	regs[DLCAPTURE_DPC_PIPEBUSY_REG] = &info.DPC_PIPEBUSY_REG;
+	regs[DLCAPTURE_DPC_TMEM_REG] = &info.DPC_TMEM_REG;
+	regs[DLCAPTURE_VI_STATUS_REG] = &info.VI_STATUS_REG;
+	regs[DLCAPTURE_VI_ORIGIN_REG] = &info.VI_ORIGIN_REG;
+	regs[DLCAPTURE_VI_WIDTH_REG] = &info.VI_WIDTH_REG;
+	regs[DLCAPTURE_VI_INTR_REG] = &info.VI_INTR_REG;
+	regs[DLCAPTURE_VI_V_CURRENT_LINE_REG] = &info.VI_V_CURRENT_LINE_REG;
+	regs[DLCAPTURE_VI_TIMING_REG] = &info.VI_TIMING_REG;
+	regs[DLCAPTURE_VI_V_SYNC_REG] = &info.VI_V_SYNC_REG;
+	regs[DLCAPTURE_VI_H_SYNC_REG] = &info.VI_H_SYNC_REG;
+	regs[DLCAPTURE_VI_LEAP_REG] = &info.VI_LEAP_REG;
+	regs[DLCAPTURE_VI_H_START_REG] = &info.VI_H_START_REG;
+	regs[DLCAPTURE_VI_V_START_REG] = &info.VI_V_START_REG;
+	regs[DLCAPTURE_VI_V_BURST_REG] = &info.VI_V_BURST_REG;
+	regs[DLCAPTURE_VI_X_SCALE_REG] = &info.VI_X_SCALE_REG;
+	regs[DLCAPTURE_VI_Y_SCALE_REG] = &info.VI_Y_SCALE_REG;
+}
+
+CDListCapture::CDListCapture() :
+	m_pFile(NULL),
+	m_numDLists(0)
+{
+}
+
+CDListCapture::~CDListCapture()
+{
+	Stop();
+}
+
+void CDListCapture::StartForRom(void)
+{
+	if( options.captureDisplayLists == 0 || s_bReplaying )
+		return;
+
+	char foldername[_MAX_PATH];
+	char filename[_MAX_PATH];
+	GetPluginDir(foldername);
+	strcat(foldername, "capture\\");
+	CreateDirectory(foldername, NULL);
+
+	for( int i=0; ; i++ )
+	{
+		sprintf(filename, "%s%s-%d.rdlc", foldername, g_curRomInfo.szGameName, i);
+		if( !PathFileExists(filename) )
+			break;
+	}
+
+	if( !Start(filename) )
+		TRACE1("Cannot create the capture file %s", filename);
+}
+
+bool CDListCapture::Start(const char *filename)
+{
+	Stop();
+
+	m_pFile = fopen(filename, "wb");
+	if( m_pFile == NULL )
+		return false;
+
+	DListCaptureHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = DLCAPTURE_MAGIC;
+	header.version = DLCAPTURE_VERSION;
+	header.rdramSize = g_dwRamSize;
+	header.memoryBswaped = g_GraphicsInfo.MemoryBswaped;
+	memcpy(header.romHeader, g_GraphicsInfo.HEADER, sizeof(header.romHeader));
+	if( fwrite(&header, sizeof(header), 1, m_pFile) != 1 )
+	{
+		Stop();
+		return false;
+	}
+
+	// the first record holds all the memory
+	m_shadowRDRAM.assign(g_dwRamSize, 0);
+	m_shadowDMEM.assign(DLCAPTURE_SP_MEM_SIZE, 0);
+	m_shadowIMEM.assign(DLCAPTURE_SP_MEM_SIZE, 0);
+	m_numDLists = 0;
+	return true;
+}
+
+void CDListCapture::Stop(void)
+{
+	if( m_pFile == NULL )
+		return;
+
+	fclose(m_pFile);
+	m_pFile = NULL;
+
+	std::vector<uint8>().swap(m_shadowRDRAM);
+	std::vector<uint8>().swap(m_shadowDMEM);
+	std::vector<uint8>().swap(m_shadowIMEM);
+	std::vector<uint8>().swap(m_pages);
+	std::vector<uint8>().swap(m_compressed);
+}
+
+bool CDListCapture::WriteRecord(uint32 type, const void *pData, uint32 size)
+{
+	DListCaptureRecord record;
+	record.type = type;
+	record.size = size;
+	if( fwrite(&record, sizeof(record), 1, m_pFile) != 1 || fwrite(pData, size, 1, m_pFile) != 1 )
+	{
+		TRACE0("Cannot write the capture file");
+		Stop();
+		return false;
+	}
+	return true;
+}
+
+void CDListCapture::AddChangedPages(DListCaptureRegion region, const uint8 *pMem, uint32 size, std::vector<uint8> &shadow)
+{
+	if( pMem == NULL )
+		return;
+
+	for( uint32 offset=0; offset+DLCAPTURE_PAGE_SIZE<=size; offset+=DLCAPTURE_PAGE_SIZE )
+	{
+		if( memcmp(pMem+offset, &shadow[offset], DLCAPTURE_PAGE_SIZE) == 0 )
+			continue;
+
+		DListCapturePage page;
+		page.region = region;
+		page.page = offset/DLCAPTURE_PAGE_SIZE;
+		m_pages.insert(m_pages.end(), (const uint8 *)&page, (const uint8 *)(&page+1));
+		m_pages.insert(m_pages.end(), pMem+offset, pMem+offset+DLCAPTURE_PAGE_SIZE);
+		memcpy(&shadow[offset], pMem+offset, DLCAPTURE_PAGE_SIZE);
+	}
+}
+
+void CDListCapture::RecordMemory(void)
+{
+	m_pages.clear();
+	AddChangedPages(DLCAPTURE_RDRAM, g_GraphicsInfo.RDRAM, g_dwRamSize, m_shadowRDRAM);
+	AddChangedPages(DLCAPTURE_DMEM, g_GraphicsInfo.DMEM, DLCAPTURE_SP_MEM_SIZE, m_shadowDMEM);
+	AddChangedPages(DLCAPTURE_IMEM, g_GraphicsInfo.IMEM, DLCAPTURE_SP_MEM_SIZE, m_shadowIMEM);
+	if( m_pages.empty() )
+		return;
+
+	uint32 rawSize = (uint32)m_pages.size();
+	uLongf size = compressBound(rawSize);
+	m_compressed.resize(sizeof(uint32) + size);
+	memcpy(&m_compressed[0], &rawSize, sizeof(uint32));
+	if( compress2(&m_compressed[sizeof(uint32)], &size, &m_pages[0], rawSize, Z_BEST_SPEED) != Z_OK )
+	{
+		TRACE0("Cannot compress the captured memory");
+		Stop();
+		return;
+	}
+
+	WriteRecord(DLCAPTURE_REC_MEMORY, &m_compressed[0], (uint32)(sizeof(uint32) + size));
+}
+
+void CDListCapture::RecordCall(DListCaptureCallType call)
+{
+	if( m_pFile == NULL )
+		return;
+
+	if( call == DLCAPTURE_PROCESS_DLIST && ++m_numDLists > options.captureDisplayLists )
+	{
+		Stop();
+		return;
+	}
+
+	RecordMemory();
+	if( m_pFile == NULL )
+		return;
+
+	DListCaptureCall record;
+	uint32 **regs[DLCAPTURE_NUM_REGS];
+	GetRegisters(g_GraphicsInfo, regs);
+	record.call = call;
+	for( int i=0; i<DLCAPTURE_NUM_REGS; i++ )
+		record.regs[i] = *regs[i] ? **regs[i] : 0;
+
+	WriteRecord(DLCAPTURE_REC_CALL, &record, sizeof(record));
+}
+
+//---------------------------------------------------------------------------------------
+// Replay
+
+static void ReplayCheckInterrupts(void)
+{
+}
+
+static LRESULT CALLBACK ReplayWndProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
+{
+	return DefWindowProc(hWnd, uMsg, wParam, lParam);
+}
+
+static HWND CreateReplayWindow(void)
+{
+	WNDCLASS wc;
+	memset(&wc, 0, sizeof(wc));
+	wc.lpfnWndProc = ReplayWndProc;
+	wc.hInstance = windowSetting.myhInst;
+	wc.hCursor = LoadCursor(NULL, IDC_ARROW);
+	wc.hbrBackground = (HBRUSH)GetStockObject(BLACK_BRUSH);
+	wc.lpszClassName = "RiceVideoReplay";
+	RegisterClass(&wc);
+
+	return CreateWindow("RiceVideoReplay", "Display list replay", WS_OVERLAPPEDWINDOW|WS_VISIBLE, CW_USEDEFAULT, CW_USEDEFAULT,
+		640, 480, NULL, NULL, windowSetting.myhInst, NULL);
+}
+
+static void PumpReplayMessages(void)
+{
+	MSG msg;
+	while( PeekMessage(&msg, NULL, 0, 0, PM_REMOVE) )
+	{
+		TranslateMessage(&msg);
+		DispatchMessage(&msg);
+	}
+}
+
+// Copies the pages of a memory record to the memory given to the plugin
+static bool ApplyMemoryRecord(const uint8 *pData, uint32 size, std::vector<uint8> &pages, std::vector<uint8> *memory[3])
+{
+	uint32 rawSize;
+	if( size < sizeof(uint32) )
+		return false;
+	memcpy(&rawSize, pData, sizeof(uint32));
+
+	pages.resize(rawSize);
+	uLongf destSize = rawSize;
+	if( uncompress(&pages[0], &destSize, pData+sizeof(uint32), size-sizeof(uint32)) != Z_OK || destSize != rawSize )
+		return false;
+
+	for( uint32 offset=0; offset+sizeof(DListCapturePage)+DLCAPTURE_PAGE_SIZE<=rawSize; offset+=sizeof(DListCapturePage)+DLCAPTURE_PAGE_SIZE )
+	{
+		DListCapturePage page;
+		memcpy(&page, &pages[offset], sizeof(page));
+		if( page.region > DLCAPTURE_IMEM || (uint64)(page.page+1)*DLCAPTURE_PAGE_SIZE > memory[page.region]->size() )
+			return false;
+		memcpy(&(*memory[page.region])[page.page*DLCAPTURE_PAGE_SIZE], &pages[offset+sizeof(DListCapturePage)], DLCAPTURE_PAGE_SIZE);
+	}
+	return true;
+}
+
+/********************************************************************************************************************
+ * Replays a capture file through the entry points of the plugin, as the emulator called them
+ * parameter:
+ * filename: the capture file
+ * return:
+ * stats: the number of display lists and frames and the time spent rendering them
+ * return value: false if the file cannot be read or is damaged
+ ********************************************************************************************************************/
+bool ReplayDListCapture(const char *filename, DListReplayStats &stats, DListDispatchMode dispatch)
+{
+	memset(&stats, 0, sizeof(stats));
+
+	FILE *f = fopen(filename, "rb");
+	if( f == NULL )
+		return false;
+	std::vector<uint8> file;
+	fseek(f, 0, SEEK_END);
+	long fileSize = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if( fileSize > 0 )
+	{
+		file.resize(fileSize);
+		if( fread(&file[0], fileSize, 1, f) != 1 )
+			file.clear();
+	}
+	fclose(f);
+
+	DListCaptureHeader header;
+	if( file.size() < sizeof(header) )
+		return false;
+	memcpy(&header, &file[0], sizeof(header));
+	if( header.magic != DLCAPTURE_MAGIC || header.version != DLCAPTURE_VERSION || header.rdramSize == 0 )
+		return false;
+
+	std::vector<uint8> rdram(header.rdramSize, 0);
+	std::vector<uint8> dmem(DLCAPTURE_SP_MEM_SIZE, 0);
+	std::vector<uint8> imem(DLCAPTURE_SP_MEM_SIZE, 0);
+	std::vector<uint8> *memory[3] = { &rdram, &dmem, &imem };
+	std::vector<uint8> pages;
+	uint32 regValues[DLCAPTURE_NUM_REGS];
+	memset(regValues, 0, sizeof(regValues));
+
+	HWND hWnd = CreateReplayWindow();
+	if( hWnd == NULL )
+		return false;
+
+	GFX_INFO info;
+	memset(&info, 0, sizeof(info));
+	info.hWnd = hWnd;
+	info.hStatusBar = NULL;
+	info.MemoryBswaped = header.memoryBswaped;
+	info.HEADER = header.romHeader;
+	info.RDRAM = &rdram[0];
+	info.DMEM = &dmem[0];
+	info.IMEM = &imem[0];
+	info.CheckInterrupts = ReplayCheckInterrupts;
+
+	uint32 **regs[DLCAPTURE_NUM_REGS];
+	GetRegisters(info, regs);
+	for( int i=0; i<DLCAPTURE_NUM_REGS; i++ )
+		*regs[i] = &regValues[i];
+
+	CDListCapture::s_bReplaying = true;
+	g_dwRamSize = header.rdramSize;
+	InitiateGFX(info);
+
+	// after InitiateGFX, which reads the options again
+	if( dispatch != DLDISPATCH_OPTIONS )
+	{
+		options.bCacheDisplayLists = dispatch != DLDISPATCH_FETCH;
+	}
+
+	bool ok = RomOpen();
+
+	std::string baseName = filename;
+	size_t dot = baseName.find_last_of('.');
+	if( dot != std::string::npos && baseName.find_first_of("\\/", dot) == std::string::npos )
+		baseName.erase(dot);
+
+	LARGE_INTEGER freq, start, end, callStart, callEnd;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&start);
+
+	size_t offset = sizeof(header);
+	while( ok && offset+sizeof(DListCaptureRecord) <= file.size() )
+	{
+		DListCaptureRecord record;
+		memcpy(&record, &file[offset], sizeof(record));
+		offset += sizeof(record);
+		if( record.size > file.size()-offset )
+		{
+			ok = false;
+			break;
+		}
+		const uint8 *pData = &file[offset];
+		offset += record.size;
+
+		if( record.type == DLCAPTURE_REC_MEMORY )
+		{
+			ok = ApplyMemoryRecord(pData, record.size, pages, memory);
+		}
+		else if( record.type == DLCAPTURE_REC_CALL && record.size == sizeof(DListCaptureCall) )
+		{
+			DListCaptureCall call;
+			memcpy(&call, pData, sizeof(call));
+			memcpy(regValues, call.regs, sizeof(regValues));
+
+			PumpReplayMessages();
+
+			switch( call.call )
+			{
+			case DLCAPTURE_PROCESS_DLIST:
+				{
+					uint32 ucodeCount = status.gUcodeCount;
+					QueryPerformanceCounter(&callStart);
+					ProcessDList();
+					QueryPerformanceCounter(&callEnd);
+					stats.dlistTime += (callEnd.QuadPart-callStart.QuadPart)*1000.0/freq.QuadPart;
+					stats.numCommands += status.gUcodeCount-ucodeCount;
+					stats.numDLists++;
+				}
+				break;
+			case DLCAPTURE_PROCESS_RDP_LIST:
+				ProcessRDPList();
+				break;
+			case DLCAPTURE_UPDATE_SCREEN:
+				UpdateScreen();
+				stats.numFrames++;
+				if( CSoftwareRender::g_pSoftwareRender )
+				{
+					// <capture>-<frame>.png, to be compared with the frames of another build
+					char frameName[_MAX_PATH+32];
+					sprintf(frameName, "%s-%04u.png", baseName.c_str(), stats.numFrames);
+					CSoftwareRender::g_pSoftwareRender->CaptureScreen(frameName);
+				}
+				break;
+			case DLCAPTURE_VI_STATUS_CHANGED:
+				ViStatusChanged();
+				break;
+			case DLCAPTURE_VI_WIDTH_CHANGED:
+				ViWidthChanged();
+				break;
+			case DLCAPTURE_SHOW_CFB:
+				ShowCFB();
+				break;
+			}
+		}
+	}
+
+	QueryPerformanceCounter(&end);
+	stats.totalTime = (end.QuadPart-start.QuadPart)*1000.0/freq.QuadPart;
+
+	RomClosed();
+	CloseDLL();
+	CDListCapture::s_bReplaying = false;
+
+	DestroyWindow(hWnd);
+	PumpReplayMessages();
+	return ok;
+}
+
+/********************************************************************************************************************
+ * Replays a capture file and shows how long the rendering took, run with rundll32:
+ *   rundll32 RiceVideo.dll,ReplayCapture "<plugin dir>\capture\<GameName>-<n>.rdlc"
+ ********************************************************************************************************************/
+#if defined(_M_IX86)
+#pragma comment(linker, "/EXPORT:ReplayCapture=_ReplayCapture@16")
+#else
+#pragma comment(linker, "/EXPORT:ReplayCapture")
+#endif
+static std::string GetCaptureFilename(LPSTR lpszCmdLine)
+{
+	std::string filename = lpszCmdLine;
+	while( filename.size() > 0 && (filename[0] == ' ' || filename[0] == '"') )
+		filename.erase(0, 1);
+	while( filename.size() > 0 && (filename[filename.size()-1] == ' ' || filename[filename.size()-1] == '"') )
+		filename.erase(filename.size()-1);
+	return filename;
+}
+
+extern "C" void CALLBACK ReplayCapture(HWND hWnd, HINSTANCE hInstance, LPSTR lpszCmdLine, int nCmdShow)
+{
+	std::string filename = GetCaptureFilename(lpszCmdLine);
+
+	char message[_MAX_PATH+400];
+	DListReplayStats stats;
+	bool ok = ReplayDListCapture(filename.c_str(), stats);
+	if( ok )
+	{
+		sprintf(message, "%u display lists, %u frames\n%.1f ms rendering the display lists (%.3f ms per display list)\n%.1f ms in total",
+			stats.numDLists, stats.numFrames, stats.dlistTime, stats.numDLists ? stats.dlistTime/stats.numDLists : 0.0, stats.totalTime);
+
+		RedundantStateCounters &r = gRedundantStateCounters;
+		sprintf(message+strlen(message), "\n\nRedundant state commands dropped: %u SetCombine, %u SetOtherMode, %u SetPrimColor, %u SetEnvColor, %u SetTile, %u SetTileSize",
+			r.numSetCombine, r.numSetOtherMode, r.numSetPrimColor, r.numSetEnvColor, r.numSetTile, r.numSetTileSize);
+		sprintf(message+strlen(message), "\nDisplay lists culled by their bounds: %u", gDListCuller.GetNumCulled());
+
+		if( options.bHeadlessRender && options.bCountRenderCalls )
+		{
+			NullRenderCounters &c = gNullRenderCounters;
+			sprintf(message+strlen(message), "\n\n%u triangles in %u flushes, %u tex rects, %u fill rects, %u lines\n%u texture changes, %u combiner changes, %u state changes",
+				c.numTriangles, c.numFlushes, c.numTexRects, c.numFillRects, c.numLines, c.numTextureChanges, c.numCombinerChanges, c.numStateChanges);
+		}
+	}
+	else
+	{
+		sprintf(message, "Cannot replay %s", filename.c_str());
+	}
+
+	MessageBox(hWnd, message, "Display list replay", ok ? MB_OK|MB_ICONINFORMATION : MB_OK|MB_ICONERROR);
+}
+
+/********************************************************************************************************************
+ * Replays a capture file once with each parser loop and shows the time per display list and per command, run with
+ * rundll32 on a release build, best with the HeadlessRender option so that the rendering does not hide the parser:
+ *   rundll32 RiceVideo.dll,BenchmarkCapture "<plugin dir>\capture\<GameName>-<n>.rdlc"
+ ********************************************************************************************************************/
+#if defined(_M_IX86)
+#pragma comment(linker, "/EXPORT:BenchmarkCapture=_BenchmarkCapture@16")
+#else
+#pragma comment(linker, "/EXPORT:BenchmarkCapture")
+#endif
+extern "C" void CALLBACK BenchmarkCapture(HWND hWnd, HINSTANCE hInstance, LPSTR lpszCmdLine, int nCmdShow)
+{
+	static const char *modeNames[DLDISPATCH_COUNT] = { "Fetch from RDRAM", "Display list cache" };
+
+	std::string filename = GetCaptureFilename(lpszCmdLine);
+
+	char message[_MAX_PATH+600];
+	bool ok = true;
+	message[0] = 0;
+	for( int mode=0; mode<DLDISPATCH_COUNT && ok; mode++ )
+	{
+		DListReplayStats stats;
+		ok = ReplayDListCapture(filename.c_str(), stats, (DListDispatchMode)mode);
+		if( ok )
+		{
+			sprintf(message+strlen(message), "%s: %.1f ms, %.3f ms per display list, %.1f ns per command\n",
+				modeNames[mode], stats.dlistTime, stats.numDLists ? stats.dlistTime/stats.numDLists : 0.0,
+				stats.numCommands ? stats.dlistTime*1000000.0/stats.numCommands : 0.0);
+		}
+	}
+
+	if( !ok )
+	{
+		sprintf(message, "Cannot replay %s", filename.c_str());
+	}
+
+	MessageBox(hWnd, message, "Display list benchmark", ok ? MB_OK|MB_ICONINFORMATION : MB_OK|MB_ICONERROR);
+}
@@ -0,0 +1,183 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef _DL_CAPTURE_H_
+#define _DL_CAPTURE_H_
+
+#include <vector>
+
+/*
+	Display list capture file (.rdlc), records what the emulator hands to the plugin so that a game can be rendered
+	again without the emulator:
+
+	DListCaptureHeader
+	records, each one a DListCaptureRecord followed by its payload:
+		DLCAPTURE_REC_MEMORY: uint32 size of the uncompressed data, then zlib compressed pages of RDRAM, DMEM and IMEM
+		                      which have changed since the previous record, each one a DListCapturePage followed by
+		                      DLCAPTURE_PAGE_SIZE bytes. The first record holds all pages which are not zero.
+		DLCAPTURE_REC_CALL:   DListCaptureCall, a call of the plugin with the registers it sees
+
+	The memory is captured before each call, so replaying the records in order feeds the same data to the same entry
+	points of the plugin.
+*/
+
+#define DLCAPTURE_MAGIC		0x434C4452		// "RDLC"
+#define DLCAPTURE_VERSION	1
+#define DLCAPTURE_PAGE_SIZE	4096
+
+enum DListCaptureRecordType
+{
+	DLCAPTURE_REC_MEMORY = 1,
+	DLCAPTURE_REC_CALL,
+};
+
+enum DListCaptureRegion
+{
+	DLCAPTURE_RDRAM,
+	DLCAPTURE_DMEM,
+	DLCAPTURE_IMEM,
+};
+
+// The plugin functions recorded
+enum DListCaptureCallType
+{
+	DLCAPTURE_PROCESS_DLIST,
+	DLCAPTURE_PROCESS_RDP_LIST,
+	DLCAPTURE_UPDATE_SCREEN,
+	DLCAPTURE_VI_STATUS_CHANGED,
+	DLCAPTURE_VI_WIDTH_CHANGED,
+	DLCAPTURE_SHOW_CFB,
+};
+
+// The registers of GFX_INFO, in the order of the structure
+enum
+{
+	DLCAPTURE_MI_INTR_REG,
+	DLCAPTURE_DPC_START_REG,
+	DLCAPTURE_DPC_END_REG,
+	DLCAPTURE_DPC_CURRENT_REG,
+	DLCAPTURE_DPC_STATUS_REG,
+	DLCAPTURE_DPC_CLOCK_REG,
+	DLCAPTURE_DPC_BUFBUSY_REG,
+	DLCAPTURE_DPC_PIPEBUSY_REG,
+	DLCAPTURE_DPC_TMEM_REG,
+	DLCAPTURE_VI_STATUS_REG,
+	DLCAPTURE_VI_ORIGIN_REG,
+	DLCAPTURE_VI_WIDTH_REG,
+	DLCAPTURE_VI_INTR_REG,
+	DLCAPTURE_VI_V_CURRENT_LINE_REG,
+	DLCAPTURE_VI_TIMING_REG,
+	DLCAPTURE_VI_V_SYNC_REG,
+	DLCAPTURE_VI_H_SYNC_REG,
+	DLCAPTURE_VI_LEAP_REG,
+	DLCAPTURE_VI_H_START_REG,
+	DLCAPTURE_VI_V_START_REG,
+	DLCAPTURE_VI_V_BURST_REG,
+	DLCAPTURE_VI_X_SCALE_REG,
+	DLCAPTURE_VI_Y_SCALE_REG,
+	DLCAPTURE_NUM_REGS
+};
+
+struct DListCaptureHeader
+{
+	uint32	magic;
+	uint32	version;
+	uint32	rdramSize;
+	uint32	memoryBswaped;
+	uint8	romHeader[0x40];		// as given to the plugin, in the byte order of the memory
+};
+
+struct DListCaptureRecord
+{
+	uint32	type;
+	uint32	size;					// bytes of the payload following the record
+};
+
+struct DListCapturePage
+{
+	uint32	region;
+	uint32	page;
+};
+
+struct DListCaptureCall
+{
+	uint32	call;
+	uint32	regs[DLCAPTURE_NUM_REGS];
+};
+
+/********************************************************************************************************************
+ * Records the plugin calls of a rom to a capture file. It is started by StartVideo when the CaptureDisplayLists
+ * option is set and stops after that number of display lists.
+ ********************************************************************************************************************/
+class CDListCapture
+{
+public:
+	CDListCapture();
+	~CDListCapture();
+
+	// Starts a new file capture\<GameName>-<n>.rdlc in the plugin folder
+	void StartForRom(void);
+	void Stop(void);
+	bool IsRecording(void) { return m_pFile != NULL; }
+
+	// Records the memory which has changed and the call about to be made
+	void RecordCall(DListCaptureCallType call);
+
+	// No capture is started while a capture is replayed
+	static bool s_bReplaying;
+
+private:
+	bool Start(const char *filename);
+	void RecordMemory(void);
+	void AddChangedPages(DListCaptureRegion region, const uint8 *pMem, uint32 size, std::vector<uint8> &shadow);
+	bool WriteRecord(uint32 type, const void *pData, uint32 size);
+
+	FILE *m_pFile;
+	std::vector<uint8> m_shadowRDRAM;		// the memory as it was at the previous record
+	std::vector<uint8> m_shadowDMEM;
+	std::vector<uint8> m_shadowIMEM;
+	std::vector<uint8> m_pages;				// the changed pages of the current record
+	std::vector<uint8> m_compressed;
+	uint32 m_numDLists;
+};
+
+extern CDListCapture gDListCapture;
+
+struct DListReplayStats
+{
+	uint32	numDLists;
+	uint32	numFrames;				// UpdateScreen calls
+	uint32	numCommands;			// microcode commands run by ProcessDList
+	double	dlistTime;				// milliseconds spent in ProcessDList
+	double	totalTime;				// milliseconds for replaying all the records
+};
+
+// How the replay runs the display lists, to compare the parser loops on the same capture
+enum DListDispatchMode
+{
+	DLDISPATCH_OPTIONS = -1,		// as set in the options
+	DLDISPATCH_FETCH,				// fetch and decode each command from RDRAM
+	DLDISPATCH_CACHE,				// fetch the commands from the display list cache
+	DLDISPATCH_COUNT
+};
+
+// Feeds a capture file to the plugin in a window of its own
+bool ReplayDListCapture(const char *filename, DListReplayStats &stats, DListDispatchMode dispatch = DLDISPATCH_OPTIONS);
+
+#endif
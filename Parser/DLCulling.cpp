@@ -0,0 +1,447 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "../stdafx.h"
+
+#include <float.h>
+
+#include "ucode.h"
+#include "Microcode.h"
+#include "DLCulling.h"
+
+extern const MicroCodeInstruction *gUcodeFunc;
+
+CDListCuller gDListCuller;
+
+#define DLCULL_HASH_SEED	2166136261u
+
+static inline uint32 HashWords(const uint32 *pWords, uint32 numWords, uint32 hash)
+{
+	for( uint32 i=0; i<numWords; i++ )
+	{
+		hash = (hash ^ pWords[i]) * 16777619u;
+	}
+	return hash;
+}
+
+static uint32 HashRanges(const std::vector<DListCullRange> &ranges, uint32 hash)
+{
+	for( size_t i=0; i<ranges.size(); i++ )
+	{
+		hash = HashWords(&g_pu32RamBase[ranges[i].address>>2], ranges[i].size>>2, hash);
+	}
+	return hash;
+}
+
+CDListCuller::CDListCuller()
+{
+	m_bSupportedUcode = false;
+	m_bEnabled = false;
+	m_numCulled = 0;
+	DropLists();
+}
+
+void CDListCuller::SetMicrocode(uint32 ucode)
+{
+	m_bSupportedUcode = (ucode == GBI_1 || ucode == GBI_2);
+	m_bEnabled = m_bEnabled && m_bSupportedUcode;
+	DropLists();
+}
+
+void CDListCuller::Reset()
+{
+	DropLists();
+	m_numCulled = 0;
+}
+
+void CDListCuller::DropLists()
+{
+	m_lists.clear();
+	m_numFrames = 0;
+	m_time = 0;
+	memset(m_loadTimes, 0, sizeof(m_loadTimes));
+}
+
+void CDListCuller::BeginDList()
+{
+	if( m_lists.size() > DLCULL_MAX_LISTS )
+	{
+		m_lists.clear();
+	}
+
+	m_numFrames = 0;
+	m_time = 0;
+	memset(m_loadTimes, 0, sizeof(m_loadTimes));
+
+	m_bEnabled = options.bCullDisplayLists && m_bSupportedUcode;
+}
+
+void CDListCuller::EndDList()
+{
+	LeaveLists(0);
+}
+
+// Hashes the commands of the list, at most once per DLParser_Process, and checks that the lists it calls are still
+// those the bounds were learned from. Returns false if the bounds are not to be used.
+bool CDListCuller::CheckCommands(DListBounds &entry, uint32 address)
+{
+	if( entry.checkedDList == status.gDlistCount )
+		return entry.bLearned;
+
+	entry.checkedDList = status.gDlistCount;
+
+	const MicroCodeCommand *pCommands = (const MicroCodeCommand*)&g_pu32RamBase[address>>2];
+	uint32 hash = DLCULL_HASH_SEED;
+	bool bEnd = false;
+	for( uint32 i=0; i<DLCULL_MAX_OPS && address+i*8+8 <= g_dwRamSize; i++ )
+	{
+		hash = HashWords((const uint32*)&pCommands[i], 2, hash);
+		if( gUcodeFunc[pCommands[i].inst.cmd] == RSP_GBI1_EndDL )
+		{
+			bEnd = true;
+			break;
+		}
+	}
+
+	if( hash != entry.hash )
+	{
+		// Another list at the same address, nothing known about this one
+		uint32 checkedDList = entry.checkedDList;
+		entry = DListBounds();
+		entry.checkedDList = checkedDList;
+		entry.hash = hash;
+	}
+
+	if( !bEnd )
+	{
+		entry.bUnbounded = true;
+	}
+	else if( entry.bLearned )
+	{
+		for( size_t i=0; i<entry.children.size() && entry.bLearned; i++ )
+		{
+			DListBounds &child = m_lists[entry.children[i].address];
+			CheckCommands(child, entry.children[i].address);
+			if( child.hash != entry.children[i].hash )
+				entry.bLearned = false;
+		}
+
+		if( !entry.bLearned )
+			entry.numRuns = 0;
+	}
+
+	return entry.bLearned;
+}
+
+// Hashes the vertex data of a learned list, at most once per DLParser_Process, and drops its bounds if it has changed
+bool CDListCuller::CheckVertices(DListBounds &entry)
+{
+	if( entry.bLearned && entry.vertexCheckedDList != status.gDlistCount )
+	{
+		entry.vertexCheckedDList = status.gDlistCount;
+		if( HashRanges(entry.ranges, DLCULL_HASH_SEED) != entry.vertexHash )
+		{
+			entry.bLearned = false;
+			entry.numRuns = 0;
+		}
+	}
+
+	return entry.bLearned;
+}
+
+bool CDListCuller::IsCullable(DListBounds &entry, uint32 address)
+{
+	// A list loading no vertex has nothing to skip
+	if( !entry.bLearned || entry.bUnbounded || entry.bShared || entry.numRuns < DLCULL_MIN_RUNS || entry.vMin[0] > entry.vMax[0] )
+		return false;
+
+	for( uint32 i=0; i<16; i++ )
+	{
+		if( (entry.segmentMask & (1<<i)) && gRSP.segments[i] != entry.segments[i] )
+			return false;
+	}
+
+	return IsBoxOffScreen(entry.vMin, entry.vMax) && CheckCommands(entry, address) && CheckVertices(entry);
+}
+
+void CDListCuller::AddSegment(DListBounds &entry, uint32 segAddress)
+{
+	entry.segmentMask |= 1 << ((segAddress>>24)&0x0F);
+}
+
+// The lists on the stack learn nothing more in this run, they learn again when next called
+void CDListCuller::StopLearning()
+{
+	for( int i=0; i<m_numFrames; i++ )
+	{
+		m_frames[i].bLearning = false;
+		m_frames[i].bInLearning = false;
+	}
+}
+
+void CDListCuller::PopLists(int level)
+{
+	while( m_numFrames > 0 && m_frames[m_numFrames-1].level >= level )
+	{
+		Frame &frame = m_frames[--m_numFrames];
+		DListBounds &entry = *frame.pEntry;
+
+		if( frame.bLearning && !entry.bUnbounded )
+		{
+			for( uint32 i=0; i<16; i++ )
+			{
+				entry.segments[i] = (entry.segmentMask & (1<<i)) ? gRSP.segments[i] : 0;
+			}
+
+			// A load is live if the later ones do not overwrite all its slots, before the list returns or a CullDL
+			// ends it
+			bool bOverwritten[MAX_VERTS];
+			memset(bOverwritten, 0, sizeof(bOverwritten));
+			for( size_t i=entry.ranges.size(); i-- > 0; )
+			{
+				DListCullRange &range = entry.ranges[i];
+				range.bLive = entry.bCullTest;
+				for( uint32 v=range.v0; v<range.v0+range.size/sizeof(FiddledVtx) && v<MAX_VERTS; v++ )
+				{
+					range.bLive = range.bLive || !bOverwritten[v];
+					bOverwritten[v] = true;
+				}
+			}
+
+			// The vertex hash was taken as the vertices were loaded
+			entry.vertexCheckedDList = status.gDlistCount;
+			entry.bLearned = true;
+		}
+
+		if( entry.bLearned && !frame.bCulled )
+			entry.numRuns++;
+
+		if( m_numFrames == 0 || !m_frames[m_numFrames-1].bLearning )
+			continue;
+
+		// The caller is learning its bounds, they hold those of this list
+		DListBounds &parent = *m_frames[m_numFrames-1].pEntry;
+		if( !entry.bLearned || entry.bUnbounded || parent.ranges.size() + entry.ranges.size() > DLCULL_MAX_RANGES ||
+			parent.children.size() + entry.children.size() >= DLCULL_MAX_RANGES )
+		{
+			parent.bUnbounded = true;
+			continue;
+		}
+
+		// Bounds learned in an earlier run may be of other commands or vertices
+		if( !CheckCommands(entry, frame.address) || !CheckVertices(entry) )
+		{
+			StopLearning();
+			continue;
+		}
+
+		for( int i=0; i<3; i++ )
+		{
+			parent.vMin[i] = min(parent.vMin[i], entry.vMin[i]);
+			parent.vMax[i] = max(parent.vMax[i], entry.vMax[i]);
+		}
+		parent.segmentMask |= entry.segmentMask;
+		parent.bCullTest = parent.bCullTest || entry.bCullTest;
+		parent.ranges.insert(parent.ranges.end(), entry.ranges.begin(), entry.ranges.end());
+		parent.vertexHash = HashRanges(entry.ranges, parent.vertexHash);
+
+		DListCullChild child = { frame.address, entry.hash };
+		parent.children.push_back(child);
+		parent.children.insert(parent.children.end(), entry.children.begin(), entry.children.end());
+	}
+}
+
+void CDListCuller::EnterList(uint32 segAddress, uint32 address)
+{
+	// A list entered at this level before has returned
+	LeaveLists(gDlistStackPointer);
+
+	Frame *pParent = m_numFrames > 0 ? &m_frames[m_numFrames-1] : NULL;
+	if( pParent != NULL && pParent->bCulled )
+		return;
+
+	if( pParent != NULL && pParent->bLearning )
+		AddSegment(*pParent->pEntry, segAddress);
+
+	if( (address&7) != 0 || address+8 > g_dwRamSize || m_numFrames >= MAX_DL_STACK_SIZE )
+	{
+		SetUnbounded();
+		return;
+	}
+
+	// Reading the commands and the vertices of all the lists each frame costs more than the culling saves
+	DListBounds &entry = m_lists[address];
+	if( ++entry.numCalls % DLCULL_CHECK_CALLS == 0 )
+	{
+		CheckCommands(entry, address);
+		CheckVertices(entry);
+	}
+
+	Frame &frame = m_frames[m_numFrames++];
+	frame.pEntry = &entry;
+	frame.address = address;
+	frame.level = gDlistStackPointer;
+	frame.enterTime = ++m_time;
+	frame.numLoads = 0;
+	frame.bInLearning = false;
+	frame.bCulled = IsCullable(entry, address);
+	frame.bLearning = !frame.bCulled && !entry.bUnbounded && !entry.bLearned;
+
+	if( frame.bCulled )
+	{
+		LOG_UCODE("    Display list 0x%08x is off screen, skipping its triangles", address);
+		status.dwNumDListsCulled++;
+		m_numCulled++;
+		return;
+	}
+
+	if( !frame.bLearning && !entry.bUnbounded && entry.bLearned )
+	{
+		// Called with other segments, its vertices may come from other places
+		for( uint32 i=0; i<16; i++ )
+		{
+			if( (entry.segmentMask & (1<<i)) && gRSP.segments[i] != entry.segments[i] )
+			{
+				frame.bLearning = true;
+				break;
+			}
+		}
+	}
+
+	if( frame.bLearning )
+	{
+		CheckCommands(entry, address);
+		frame.bLearning = !entry.bUnbounded;
+	}
+	frame.bInLearning = frame.bLearning || (pParent != NULL && pParent->bInLearning);
+
+	if( frame.bLearning )
+	{
+		entry.bLearned = false;
+		entry.bCullTest = false;
+		entry.numRuns = 0;
+		entry.segmentMask = 0;
+		entry.vertexHash = DLCULL_HASH_SEED;
+		entry.ranges.clear();
+		entry.children.clear();
+		for( int i=0; i<3; i++ )
+		{
+			entry.vMin[i] = FLT_MAX;
+			entry.vMax[i] = -FLT_MAX;
+		}
+	}
+}
+
+bool CDListCuller::LoadVertices(uint32 segAddress, uint32 address, uint32 v0, uint32 n)
+{
+	LeaveLists(gDlistStackPointer+1);
+
+	Frame *pFrame = m_numFrames > 0 ? &m_frames[m_numFrames-1] : NULL;
+
+	// Also when the load is skipped, a list entered later drawing with these slots is sharing them
+	uint32 time = ++m_time;
+	for( uint32 i=v0; i<v0+n && i<MAX_VERTS; i++ )
+	{
+		m_loadTimes[i] = time;
+	}
+
+	if( pFrame != NULL && pFrame->bCulled )
+	{
+		// The loads are those of the run the bounds were learned from, the live ones are run for the caller
+		const DListBounds &entry = *pFrame->pEntry;
+		uint32 load = pFrame->numLoads++;
+		return !entry.bCullTest && load < entry.ranges.size() && !entry.ranges[load].bLive;
+	}
+
+	if( pFrame == NULL || !pFrame->bLearning )
+		return false;
+
+	DListBounds &entry = *pFrame->pEntry;
+	if( (address&3) != 0 || address+n*sizeof(FiddledVtx) > g_dwRamSize || entry.ranges.size() >= DLCULL_MAX_RANGES )
+	{
+		entry.bUnbounded = true;
+		return false;
+	}
+
+	AddSegment(entry, segAddress);
+
+	DListCullRange range = { address, n*sizeof(FiddledVtx), v0, true };
+	entry.ranges.push_back(range);
+	entry.vertexHash = HashWords(&g_pu32RamBase[address>>2], range.size>>2, entry.vertexHash);
+
+	const FiddledVtx *pVtx = (const FiddledVtx*)(g_pu8RamBase + address);
+	for( uint32 i=0; i<n; i++ )
+	{
+		float x = (float)pVtx[i].x;
+		float y = (float)pVtx[i].y;
+		float z = (float)pVtx[i].z;
+		entry.vMin[0] = min(entry.vMin[0], x);	entry.vMax[0] = max(entry.vMax[0], x);
+		entry.vMin[1] = min(entry.vMin[1], y);	entry.vMax[1] = max(entry.vMax[1], y);
+		entry.vMin[2] = min(entry.vMin[2], z);	entry.vMax[2] = max(entry.vMax[2], z);
+	}
+
+	return false;
+}
+
+// The lists entered after the vertex was loaded draw with the vertices of their caller
+void CDListCuller::UseVertex(uint32 v)
+{
+	if( v >= MAX_VERTS )
+		return;
+
+	for( int i=m_numFrames-1; i>=0 && m_frames[i].enterTime > m_loadTimes[v]; i-- )
+	{
+		m_frames[i].pEntry->bShared = true;
+	}
+}
+
+void CDListCuller::UseTriangle(uint32 v0, uint32 v1, uint32 v2)
+{
+	UseVertex(v0);
+	UseVertex(v1);
+	UseVertex(v2);
+}
+
+bool CDListCuller::UseVertexRange(uint32 first, uint32 last)
+{
+	LeaveLists(gDlistStackPointer+1);
+
+	// The vertices of a culled list are all within its bounds, beyond one plane
+	if( m_numFrames > 0 && m_frames[m_numFrames-1].bCulled )
+		return true;
+
+	// The lists on the stack may end here, all their vertex loads are run when they are culled
+	for( int i=0; i<m_numFrames; i++ )
+	{
+		m_frames[i].pEntry->bCullTest = true;
+	}
+
+	for( uint32 v=first; v<=last && v<MAX_VERTS; v++ )
+	{
+		UseVertex(v);
+	}
+	return false;
+}
+
+void CDListCuller::SetUnbounded()
+{
+	for( int i=0; i<m_numFrames; i++ )
+	{
+		m_frames[i].pEntry->bUnbounded = true;
+	}
+}
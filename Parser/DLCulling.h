@@ -0,0 +1,198 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef _DLIST_CULLING_H_
+#define _DLIST_CULLING_H_
+
+#include <unordered_map>
+#include <vector>
+
+#define DLCULL_MAX_LISTS		4096	// the bounds are all dropped when more lists are known
+#define DLCULL_MAX_OPS			4096	// longer lists are never culled
+#define DLCULL_MAX_RANGES		256		// lists loading their vertices from more places, or calling more lists, are never culled
+#define DLCULL_MIN_RUNS			3		// a list is culled once it has been run this many times with the same bounds
+#define DLCULL_CHECK_CALLS		16		// the commands and the vertices of a list not being culled are hashed once in this many calls
+
+// Vertex data loaded by a list or by the lists it calls, in the order of the loads
+struct DListCullRange
+{
+	uint32	address;
+	uint32	size;
+	uint32	v0;
+	bool	bLive;				// some of its vertices are still in their slots when the list returns
+};
+
+// A list called by a list, directly or not, and the hash of its commands when the bounds were learned
+struct DListCullChild
+{
+	uint32	address;
+	uint32	hash;
+};
+
+struct DListBounds
+{
+	uint32	checkedDList;		// status.gDlistCount when the commands were last hashed
+	uint32	vertexCheckedDList;	// status.gDlistCount when the vertices were last hashed
+	uint32	hash;				// of the commands up to the EndDL
+	uint32	vertexHash;			// of the ranges
+	bool	bLearned;			// the bounds hold all the vertices of the last run
+	bool	bUnbounded;			// something in the list, or in a list it calls, moves the vertices it loads
+	bool	bShared;			// the list draws with vertices loaded before it was entered
+	bool	bCullTest;			// a CullDL may end the list, or a list it calls, before its last vertex loads
+	uint32	numRuns;			// since the bounds were learned
+	uint32	numCalls;			// counts to DLCULL_CHECK_CALLS
+	float	vMin[3];			// model space bounds of the vertices, under the matrices of the caller
+	float	vMax[3];
+	uint32	segmentMask;		// segments which the vertex and list addresses go through
+	uint32	segments[16];
+	std::vector<DListCullRange> ranges;
+	std::vector<DListCullChild> children;
+
+	DListBounds() : checkedDList(0), vertexCheckedDList(0), hash(0), vertexHash(0), bLearned(false), bUnbounded(false), bShared(false),
+		bCullTest(false), numRuns(0), numCalls(0), segmentMask(0) {}
+};
+
+/********************************************************************************************************************
+ * Skips the vertices and the triangles of the display lists called off screen.
+ *
+ * The first times a list is called through a pushing DL command, the positions of the vertices it loads, and those
+ * of the lists it calls, are collected into a box in model space. Once the box is known, the list is called again
+ * with its commands, the segments it uses and its vertex data unchanged, and the 8 corners of the box, under the
+ * world and projection matrices of the call, are all beyond one of the planes which clip the vertices, then the
+ * list is run without adding its triangles. Its vertex loads are skipped, but for those leaving vertices in their
+ * slots when it returns, which its caller may draw with: these are run as they would be without the culling. All
+ * the other commands of the list still run, so the states it leaves to its caller are the same, and a CullDL in it
+ * ends it like the RSP would.
+ *
+ * The commands and the vertex data of a list are hashed when it starts learning its bounds, when they are about to
+ * cull it, and once in DLCULL_CHECK_CALLS calls otherwise, so the lists which change are learned again.
+ *
+ * The lists changing the matrices or the segments, branching, or drawing with the vertices loaded by their caller
+ * are never culled. Only the GBI_1 and GBI_2 microcodes are handled, as the others have Vtx and Tri commands of
+ * their own.
+ ********************************************************************************************************************/
+class CDListCuller
+{
+public:
+	CDListCuller();
+
+	// Drops all the bounds, the vertex commands change with the microcode
+	void SetMicrocode(uint32 ucode);
+	// Drops all the bounds and clears the count of culled lists, when a rom is opened
+	void Reset();
+
+	// Called at the start and at the end of each DLParser_Process
+	void BeginDList();
+	void EndDList();
+
+	// After a pushing DL command has entered the list at address, given by segAddress
+	inline void CallDList(uint32 segAddress, uint32 address)
+	{
+		if( m_bEnabled )
+			EnterList(segAddress, address);
+	}
+
+	// Returns true if the vertices are not to be loaded, as the list loading them is culled
+	inline bool SkipVertices(uint32 segAddress, uint32 address, uint32 v0, uint32 n)
+	{
+		return m_bEnabled && LoadVertices(segAddress, address, v0, n);
+	}
+
+	// Returns true if the triangle is not to be added, as the list drawing it is culled
+	inline bool SkipTriangle(uint32 v0, uint32 v1, uint32 v2)
+	{
+		if( !m_bEnabled )
+			return false;
+
+		LeaveLists(gDlistStackPointer+1);
+		if( m_numFrames == 0 )
+			return false;
+		if( m_frames[m_numFrames-1].bCulled )
+			return true;
+
+		// The vertices a list draws with only change with its commands, they are known once it has learned its bounds
+		if( m_frames[m_numFrames-1].bInLearning )
+			UseTriangle(v0, v1, v2);
+		return false;
+	}
+
+	// Returns true if a CullDL is to end the current list without looking at the vertices
+	inline bool SkipCullTest(uint32 first, uint32 last)
+	{
+		return m_bEnabled && UseVertexRange(first, last);
+	}
+
+	// The current lists change the matrices or the segments, or go somewhere else than their EndDL
+	inline void Uncullable()
+	{
+		if( m_bEnabled )
+			SetUnbounded();
+	}
+
+	// Since the last Reset
+	uint32 GetNumCulled() { return m_numCulled; }
+
+protected:
+	struct Frame
+	{
+		DListBounds	*pEntry;
+		uint32		address;
+		int			level;			// in gDlistStack
+		uint32		enterTime;
+		uint32		numLoads;		// vertex loads run or skipped since it was entered culled
+		bool		bLearning;
+		bool		bInLearning;	// it or one of its callers is learning
+		bool		bCulled;
+	};
+
+	void EnterList(uint32 segAddress, uint32 address);
+	bool LoadVertices(uint32 segAddress, uint32 address, uint32 v0, uint32 n);
+	void UseTriangle(uint32 v0, uint32 v1, uint32 v2);
+	bool UseVertexRange(uint32 first, uint32 last);
+	void SetUnbounded();
+
+	void DropLists();
+	void PopLists(int level);
+
+	// The lists entered at level and above have returned
+	inline void LeaveLists(int level)
+	{
+		if( m_numFrames > 0 && m_frames[m_numFrames-1].level >= level )
+			PopLists(level);
+	}
+
+	void UseVertex(uint32 v);
+	void StopLearning();
+	bool CheckCommands(DListBounds &entry, uint32 address);
+	bool CheckVertices(DListBounds &entry);
+	bool IsCullable(DListBounds &entry, uint32 address);
+	void AddSegment(DListBounds &entry, uint32 segAddress);
+
+	std::unordered_map<uint32, DListBounds> m_lists;
+	Frame	m_frames[MAX_DL_STACK_SIZE];
+	int		m_numFrames;
+	uint32	m_loadTimes[MAX_VERTS];
+	uint32	m_time;
+	bool	m_bSupportedUcode;
+	bool	m_bEnabled;
+	uint32	m_numCulled;
+};
+
+extern CDListCuller gDListCuller;
+
+#endif
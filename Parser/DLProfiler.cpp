@@ -0,0 +1,348 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "../stdafx.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "ucode.h"
+#include "Microcode.h"
+#include "DLProfiler.h"
+#include "DLCulling.h"
+
+extern void GetPluginDir( char * Directory );
+
+CDListProfiler gDListProfiler;
+
+static_assert(DLPROFILE_UCODE_OTHER == GBI_PD+1, "the profiler has a table for each GBIVersion");
+
+// By GBIVersion
+static const char *ucodeNames[DLPROFILE_NUM_UCODES] =
+{
+	"GBI0", "GBI1", "GBI2", "S2DEX1", "S2DEX2", "WaveRace", "DKR", "LastLegion", "SOTE", "GoldenEye", "Conker", "PerfectDark",
+	"Other"
+};
+
+struct DListProfileHandlerName
+{
+	MicroCodeInstruction	func;
+	const char				*name;
+};
+
+#define DLPROFILE_HANDLER(func)		{ func, #func }
+
+// The handlers of the microcode tables
+static const DListProfileHandlerName handlerNames[] =
+{
+	DLPROFILE_HANDLER(RSP_RDP_Nothing),
+	DLPROFILE_HANDLER(RSP_GBI1_Mtx),
+	DLPROFILE_HANDLER(RSP_Mtx_DKR),
+	DLPROFILE_HANDLER(RSP_GBI1_DL),
+	DLPROFILE_HANDLER(RSP_GBI0_Vtx),
+	DLPROFILE_HANDLER(RSP_Vtx_DKR),
+	DLPROFILE_HANDLER(RSP_Vtx_WRUS),
+	DLPROFILE_HANDLER(RSP_Vtx_ShadowOfEmpire),
+	DLPROFILE_HANDLER(DLParser_RSP_Last_Legion_0x80),
+	DLPROFILE_HANDLER(DLParser_TexRect_Last_Legion),
+	DLPROFILE_HANDLER(RDP_GFX_DLInMem),
+	DLPROFILE_HANDLER(RSP_GBI0_Tri4),
+	DLPROFILE_HANDLER(RSP_DMA_Tri_DKR),
+	DLPROFILE_HANDLER(DLParser_Set_Addr_DKR),
+	DLPROFILE_HANDLER(RSP_MoveWord_DKR),
+	DLPROFILE_HANDLER(RSP_Vtx_PD),
+	DLPROFILE_HANDLER(RSP_Set_Vtx_CI_PD),
+	DLPROFILE_HANDLER(RSP_Vtx_Conker),
+	DLPROFILE_HANDLER(RSP_MoveWord_Conker),
+	DLPROFILE_HANDLER(RSP_Tri1_Conker),
+	DLPROFILE_HANDLER(RSP_Tri2_Conker),
+	DLPROFILE_HANDLER(RSP_Tri4_Conker),
+	DLPROFILE_HANDLER(RSP_MoveMem_Conker),
+	DLPROFILE_HANDLER(RSP_GBI_Sprite2DBase),
+	DLPROFILE_HANDLER(RSP_GBI1_SpNoop),
+	DLPROFILE_HANDLER(RSP_GBI1_Reserved),
+	DLPROFILE_HANDLER(RSP_GBI1_Vtx),
+	DLPROFILE_HANDLER(RSP_GBI1_MoveMem),
+	DLPROFILE_HANDLER(RSP_GBI1_RDPHalf_Cont),
+	DLPROFILE_HANDLER(RSP_GBI1_RDPHalf_2),
+	DLPROFILE_HANDLER(RSP_GBI1_RDPHalf_1),
+	DLPROFILE_HANDLER(RSP_GBI1_Line3D),
+	DLPROFILE_HANDLER(RSP_GBI1_GeometryMode),
+	DLPROFILE_HANDLER(RSP_GBI1_EndDL),
+	DLPROFILE_HANDLER(RSP_GBI1_SetOtherModeL),
+	DLPROFILE_HANDLER(RSP_GBI1_SetOtherModeH),
+	DLPROFILE_HANDLER(RSP_GBI1_Texture),
+	DLPROFILE_HANDLER(RSP_GBI1_MoveWord),
+	DLPROFILE_HANDLER(RSP_GBI1_PopMtx),
+	DLPROFILE_HANDLER(RSP_GBI1_CullDL),
+	DLPROFILE_HANDLER(RSP_GBI1_Tri1),
+	DLPROFILE_HANDLER(RSP_GBI1_Tri2),
+	DLPROFILE_HANDLER(RSP_GBI1_Noop),
+	DLPROFILE_HANDLER(RSP_GBI1_ModifyVtx),
+	DLPROFILE_HANDLER(RSP_GBI1_BranchZ),
+	DLPROFILE_HANDLER(RSP_GBI1_LoadUCode),
+	DLPROFILE_HANDLER(DLParser_TexRect),
+	DLPROFILE_HANDLER(DLParser_TexRectFlip),
+	DLPROFILE_HANDLER(DLParser_RDPLoadSync),
+	DLPROFILE_HANDLER(DLParser_RDPPipeSync),
+	DLPROFILE_HANDLER(DLParser_RDPTileSync),
+	DLPROFILE_HANDLER(DLParser_RDPFullSync),
+	DLPROFILE_HANDLER(DLParser_SetKeyGB),
+	DLPROFILE_HANDLER(DLParser_SetKeyR),
+	DLPROFILE_HANDLER(DLParser_SetConvert),
+	DLPROFILE_HANDLER(DLParser_SetScissor),
+	DLPROFILE_HANDLER(DLParser_SetPrimDepth),
+	DLPROFILE_HANDLER(DLParser_RDPSetOtherMode),
+	DLPROFILE_HANDLER(DLParser_LoadTLut),
+	DLPROFILE_HANDLER(DLParser_SetTileSize),
+	DLPROFILE_HANDLER(DLParser_LoadBlock),
+	DLPROFILE_HANDLER(DLParser_LoadTile),
+	DLPROFILE_HANDLER(DLParser_SetTile),
+	DLPROFILE_HANDLER(DLParser_FillRect),
+	DLPROFILE_HANDLER(DLParser_SetFillColor),
+	DLPROFILE_HANDLER(DLParser_SetFogColor),
+	DLPROFILE_HANDLER(DLParser_SetBlendColor),
+	DLPROFILE_HANDLER(DLParser_SetPrimColor),
+	DLPROFILE_HANDLER(DLParser_SetEnvColor),
+	DLPROFILE_HANDLER(DLParser_SetCombine),
+	DLPROFILE_HANDLER(DLParser_SetTImg),
+	DLPROFILE_HANDLER(DLParser_SetZImg),
+	DLPROFILE_HANDLER(DLParser_SetCImg),
+	DLPROFILE_HANDLER(DLParser_RDPHalf1_GoldenEye),
+	DLPROFILE_HANDLER(RSP_GBI2_MoveWord),
+	DLPROFILE_HANDLER(RSP_GBI2_Texture),
+	DLPROFILE_HANDLER(RSP_GBI2_GeometryMode),
+	DLPROFILE_HANDLER(RSP_GBI2_SetOtherModeL),
+	DLPROFILE_HANDLER(RSP_GBI2_SetOtherModeH),
+	DLPROFILE_HANDLER(RSP_GBI2_MoveMem),
+	DLPROFILE_HANDLER(RSP_GBI2_Mtx),
+	DLPROFILE_HANDLER(RSP_GBI2_PopMtx),
+	DLPROFILE_HANDLER(RSP_GBI2_Vtx),
+	DLPROFILE_HANDLER(RSP_GBI2_Tri1),
+	DLPROFILE_HANDLER(RSP_GBI2_Tri2),
+	DLPROFILE_HANDLER(RSP_GBI2_Line3D),
+	DLPROFILE_HANDLER(RSP_GBI2_DL_Count),
+	DLPROFILE_HANDLER(RSP_GBI2_SubModule),
+	DLPROFILE_HANDLER(RSP_GBI2_0x8),
+	DLPROFILE_HANDLER(RSP_S2DEX_BG_1CYC_2),
+	DLPROFILE_HANDLER(RSP_S2DEX_OBJ_RENDERMODE_2),
+	DLPROFILE_HANDLER(RSP_S2DEX_BG_1CYC),
+	DLPROFILE_HANDLER(RSP_S2DEX_BG_COPY),
+	DLPROFILE_HANDLER(RSP_S2DEX_OBJ_RECTANGLE),
+	DLPROFILE_HANDLER(RSP_S2DEX_OBJ_SPRITE),
+	DLPROFILE_HANDLER(RSP_S2DEX_OBJ_MOVEMEM),
+	DLPROFILE_HANDLER(RSP_S2DEX_SELECT_DL),
+	DLPROFILE_HANDLER(RSP_S2DEX_OBJ_RENDERMODE),
+	DLPROFILE_HANDLER(RSP_S2DEX_OBJ_RECTANGLE_R),
+	DLPROFILE_HANDLER(RSP_S2DEX_SPObjLoadTxtr),
+	DLPROFILE_HANDLER(RSP_S2DEX_SPObjLoadTxSprite),
+	DLPROFILE_HANDLER(RSP_S2DEX_SPObjLoadTxRect),
+	DLPROFILE_HANDLER(RSP_S2DEX_SPObjLoadTxRectR),
+	DLPROFILE_HANDLER(RSP_S2DEX_RDPHALF_0),
+	DLPROFILE_HANDLER(DLParser_TriRSP),
+};
+
+static const char *GetHandlerName(MicroCodeInstruction func)
+{
+	for( int i=0; i<ARRAYSIZE(handlerNames); i++ )
+	{
+		if( handlerNames[i].func == func )
+			return handlerNames[i].name;
+	}
+
+	static char unknown[32];
+	sprintf(unknown, "0x%p", func);
+	return unknown;
+}
+
+CDListProfiler::CDListProfiler()
+{
+	m_ucode = 0;
+	Reset();
+}
+
+void CDListProfiler::Reset()
+{
+	memset(m_opcodes, 0, sizeof(m_opcodes));
+	memset(m_frameOpcodeTicks, 0, sizeof(m_frameOpcodeTicks));
+	memset(&m_frame, 0, sizeof(m_frame));
+	memset(&m_total, 0, sizeof(m_total));
+	m_numFrames = 0;
+	m_frames.clear();
+	m_dlistStart = 0;
+	m_dlistUcodeCount = 0;
+
+	QueryPerformanceCounter(&m_startTime);
+	m_startTicks = __rdtsc();
+}
+
+void CDListProfiler::BeginDList()
+{
+	m_dlistUcodeCount = status.gUcodeCount;
+	m_dlistStart = __rdtsc();
+}
+
+void CDListProfiler::EndDList()
+{
+	unsigned __int64 ticks = __rdtsc() - m_dlistStart;
+	uint32 numCommands = status.gUcodeCount - m_dlistUcodeCount;
+
+	m_frame.numDLists++;
+	m_frame.numCommands += numCommands;
+	m_frame.dlistTicks += ticks;
+
+	m_total.numDLists++;
+	m_total.numCommands += numCommands;
+	m_total.dlistTicks += ticks;
+}
+
+void CDListProfiler::EndFrame()
+{
+	if( m_frame.numDLists == 0 )
+		return;
+
+	for( uint32 ucode=0; ucode<DLPROFILE_NUM_UCODES; ucode++ )
+	{
+		for( uint32 cmd=0; cmd<256; cmd++ )
+		{
+			if( m_frameOpcodeTicks[ucode][cmd] > m_frame.topTicks )
+			{
+				m_frame.topUcode = ucode;
+				m_frame.topOpcode = cmd;
+				m_frame.topTicks = m_frameOpcodeTicks[ucode][cmd];
+			}
+		}
+	}
+
+	if( m_frames.size() < DLPROFILE_MAX_FRAMES )
+		m_frames.push_back(m_frame);
+	m_numFrames++;
+
+	memset(m_frameOpcodeTicks, 0, sizeof(m_frameOpcodeTicks));
+	memset(&m_frame, 0, sizeof(m_frame));
+}
+
+double CDListProfiler::GetTicksPerMs()
+{
+	LARGE_INTEGER freq, now;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&now);
+	unsigned __int64 ticks = __rdtsc() - m_startTicks;
+
+	double ms = (now.QuadPart-m_startTime.QuadPart)*1000.0/freq.QuadPart;
+	return ms > 0 && ticks > 0 ? ticks/ms : 1.0;
+}
+
+bool CDListProfiler::Export()
+{
+	if( m_total.numDLists == 0 )
+		return false;
+
+	char foldername[_MAX_PATH];
+	char filename[_MAX_PATH];
+	GetPluginDir(foldername);
+	strcat(foldername, "profile\\");
+	CreateDirectory(foldername, NULL);
+
+	for( int i=0; ; i++ )
+	{
+		sprintf(filename, "%s%s-%d.txt", foldername, g_curRomInfo.szGameName, i);
+		if( !PathFileExists(filename) )
+			break;
+	}
+
+	FILE *f = fopen(filename, "wt");
+	if( f == NULL )
+	{
+		TRACE1("Cannot create the profile %s", filename);
+		return false;
+	}
+
+	double ticksPerMs = GetTicksPerMs();
+	uint32 numFrames = max(m_numFrames, 1);
+
+	// Opcodes by time, the most expensive first
+	std::vector< std::pair<unsigned __int64, uint32> > opcodes;
+	unsigned __int64 handlerTicks = 0;
+	unsigned __int64 ucodeTicks[DLPROFILE_NUM_UCODES] = {0};
+	uint32 ucodeCalls[DLPROFILE_NUM_UCODES] = {0};
+	for( uint32 ucode=0; ucode<DLPROFILE_NUM_UCODES; ucode++ )
+	{
+		for( uint32 cmd=0; cmd<256; cmd++ )
+		{
+			DListProfileOpcode &opcode = m_opcodes[ucode][cmd];
+			if( opcode.numCalls == 0 )
+				continue;
+
+			opcodes.push_back(std::make_pair(opcode.ticks, (ucode<<8)|cmd));
+			handlerTicks += opcode.ticks;
+			ucodeTicks[ucode] += opcode.ticks;
+			ucodeCalls[ucode] += opcode.numCalls;
+		}
+	}
+	std::sort(opcodes.begin(), opcodes.end(), std::greater< std::pair<unsigned __int64, uint32> >());
+	double handlerMs = max(handlerTicks/ticksPerMs, 1e-6);
+
+	fprintf(f, "Display list profile of %s\n", g_curRomInfo.szGameName);
+	fprintf(f, "%u frames, %u display lists, %u commands, %.3f ms in DLParser_Process, %.3f ms in the handlers\n",
+		m_numFrames, m_total.numDLists, m_total.numCommands, m_total.dlistTicks/ticksPerMs, handlerTicks/ticksPerMs);
+
+	RedundantStateCounters &r = gRedundantStateCounters;
+	fprintf(f, "Redundant state commands dropped: %u SetCombine, %u SetOtherMode, %u SetPrimColor, %u SetEnvColor, %u SetTile, %u SetTileSize\n",
+		r.numSetCombine, r.numSetOtherMode, r.numSetPrimColor, r.numSetEnvColor, r.numSetTile, r.numSetTileSize);
+	fprintf(f, "Display lists culled by their bounds: %u\n\n", gDListCuller.GetNumCulled());
+
+	fprintf(f, "%-12s %-6s %-32s %10s %12s %12s %8s %10s\n",
+		"Microcode", "Opcode", "Handler", "Calls", "Calls/frame", "Total ms", "% time", "ns/call");
+	for( size_t i=0; i<opcodes.size(); i++ )
+	{
+		uint32 ucode = opcodes[i].second>>8;
+		uint32 cmd = opcodes[i].second&0xFF;
+		DListProfileOpcode &opcode = m_opcodes[ucode][cmd];
+		double ms = opcode.ticks/ticksPerMs;
+		fprintf(f, "%-12s 0x%02X   %-32s %10u %12.1f %12.3f %7.2f%% %10.1f\n",
+			ucodeNames[ucode], cmd, GetHandlerName(opcode.func), opcode.numCalls, (double)opcode.numCalls/numFrames,
+			ms, ms*100/handlerMs, ms*1000000.0/opcode.numCalls);
+	}
+
+	fprintf(f, "\n%-12s %10s %12s %12s %8s\n", "Microcode", "Calls", "Total ms", "ms/frame", "% time");
+	for( uint32 ucode=0; ucode<DLPROFILE_NUM_UCODES; ucode++ )
+	{
+		if( ucodeCalls[ucode] == 0 )
+			continue;
+
+		double ms = ucodeTicks[ucode]/ticksPerMs;
+		fprintf(f, "%-12s %10u %12.3f %12.3f %7.2f%%\n", ucodeNames[ucode], ucodeCalls[ucode], ms, ms/numFrames, ms*100/handlerMs);
+	}
+
+	fprintf(f, "\n%8s %8s %10s %12s %12s  %-32s %10s\n", "Frame", "DLists", "Commands", "DList ms", "Handlers ms", "Top handler", "Top ms");
+	for( size_t i=0; i<m_frames.size(); i++ )
+	{
+		DListProfileFrame &frame = m_frames[i];
+		fprintf(f, "%8u %8u %10u %12.3f %12.3f  %-32s %10.3f\n", (uint32)i, frame.numDLists, frame.numCommands,
+			frame.dlistTicks/ticksPerMs, frame.handlerTicks/ticksPerMs,
+			GetHandlerName(m_opcodes[frame.topUcode][frame.topOpcode].func), frame.topTicks/ticksPerMs);
+	}
+	if( m_numFrames > m_frames.size() )
+	{
+		fprintf(f, "... %u more frames\n", m_numFrames-(uint32)m_frames.size());
+	}
+
+	fclose(f);
+	return true;
+}
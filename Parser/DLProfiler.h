@@ -0,0 +1,117 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef _DLIST_PROFILER_H_
+#define _DLIST_PROFILER_H_
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#include <vector>
+
+#define DLPROFILE_UCODE_OTHER	12		// after GBI_PD, the microcodes which are no GBIVersion are counted there
+#define DLPROFILE_NUM_UCODES	13		// GBI_0 to GBI_PD and the other ones
+#define DLPROFILE_MAX_FRAMES	36000	// frames listed one by one in the profile, the totals go on after
+
+struct DListProfileOpcode
+{
+	MicroCodeInstruction	func;		// the handler which ran the opcode
+	uint32					numCalls;
+	unsigned __int64		ticks;		// time stamp counter ticks spent in the handler
+};
+
+struct DListProfileFrame
+{
+	uint32				numDLists;
+	uint32				numCommands;
+	unsigned __int64	dlistTicks;		// in DLParser_Process, with the parser loop and the rendering it starts
+	unsigned __int64	handlerTicks;	// in the handlers
+	uint32				topUcode;		// the opcode which took the most time in the frame
+	uint32				topOpcode;
+	unsigned __int64	topTicks;
+};
+
+/********************************************************************************************************************
+ * Profiler of the display list parser, used by the ProfileDisplayLists option in release builds.
+ *
+ * Each command is run through Run, which counts the calls and the time stamp counter ticks of the handler by
+ * microcode family and opcode. The totals are kept for the whole rom and for each frame, and written as tables to
+ * the profile folder of the plugin when the rom is closed, so the handlers which dominate a game can be told apart.
+ ********************************************************************************************************************/
+class CDListProfiler
+{
+public:
+	CDListProfiler();
+
+	// Clears the counters, called when a rom starts
+	void Reset();
+
+	// The microcode family of the handlers run from now on, a GBIVersion
+	void SetMicrocode(uint32 ucode) { m_ucode = ucode < DLPROFILE_UCODE_OTHER ? ucode : DLPROFILE_UCODE_OTHER; }
+
+	// Around DLParser_Process
+	void BeginDList();
+	void EndDList();
+
+	// Called by UpdateScreen
+	void EndFrame();
+
+	// Writes the tables to <plugin dir>\profile\<GameName>-<n>.txt, if anything was profiled
+	bool Export();
+
+	inline void Run(MicroCodeInstruction func, MicroCodeCommand command)
+	{
+		// the handler may load another microcode, the time goes to the one which decoded the command
+		DListProfileOpcode &opcode = m_opcodes[m_ucode][command.inst.cmd];
+		unsigned __int64 &frameTicks = m_frameOpcodeTicks[m_ucode][command.inst.cmd];
+
+		unsigned __int64 start = __rdtsc();
+		func(command);
+		unsigned __int64 ticks = __rdtsc() - start;
+
+		opcode.func = func;
+		opcode.numCalls++;
+		opcode.ticks += ticks;
+		frameTicks += ticks;
+		m_frame.handlerTicks += ticks;
+	}
+
+protected:
+	double GetTicksPerMs();
+
+	DListProfileOpcode				m_opcodes[DLPROFILE_NUM_UCODES][256];
+	unsigned __int64				m_frameOpcodeTicks[DLPROFILE_NUM_UCODES][256];
+	uint32							m_ucode;
+
+	DListProfileFrame				m_frame;		// the frame being profiled
+	DListProfileFrame				m_total;
+	uint32							m_numFrames;
+	std::vector<DListProfileFrame>	m_frames;
+
+	unsigned __int64				m_dlistStart;
+	uint32							m_dlistUcodeCount;
+
+	LARGE_INTEGER					m_startTime;	// to convert the ticks to milliseconds
+	unsigned __int64				m_startTicks;
+};
+
+extern CDListProfiler gDListProfiler;
+
+#endif
@@ -0,0 +1,154 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "../stdafx.h"
+
+#include "ucode.h"
+#include "DListCache.h"
+
+extern const MicroCodeInstruction *gUcodeFunc;
+
+CDListCache gDListCache;
+
+CDListCache::CDListCache()
+{
+	Reset();
+}
+
+void CDListCache::Reset()
+{
+	m_lists.clear();
+	BeginDList();
+}
+
+void CDListCache::BeginDList()
+{
+	if( m_lists.size() > DLCACHE_MAX_LISTS )
+	{
+		m_lists.clear();
+	}
+
+	memset(m_cursors, 0, sizeof(m_cursors));
+	for( int i=0; i<MAX_DL_STACK_SIZE; i++ )
+		m_cursors[i].nextPC = ~0u;
+	m_lastStackPointer = -1;
+}
+
+bool CDListCache::Matches(const DListCacheEntry &entry, uint32 address)
+{
+	return memcmp(&entry.words[0], &g_pu32RamBase[address>>2], entry.words.size()*sizeof(uint32)) == 0;
+}
+
+void CDListCache::Build(DListCacheEntry &entry, uint32 address)
+{
+	entry.ops.clear();
+
+	for( uint32 pc=address; pc+8 <= g_dwRamSize && entry.ops.size() < DLCACHE_MAX_OPS; pc+=8 )
+	{
+		DListCacheOp op;
+		op.command = *(MicroCodeCommand*)&g_pu32RamBase[pc>>2];
+		op.func = gUcodeFunc[op.command.inst.cmd];
+		entry.ops.push_back(op);
+
+		if( op.func == RSP_GBI1_EndDL )
+		{
+			entry.words.assign(&g_pu32RamBase[address>>2], &g_pu32RamBase[(pc+8)>>2]);
+			return;
+		}
+	}
+
+	// No end within the limits, the list is fetched from RDRAM
+	entry.ops.clear();
+}
+
+DListCacheEntry *CDListCache::Lookup(uint32 address)
+{
+	if( (address&7) != 0 || address+8 > g_dwRamSize )
+		return NULL;
+
+	DListCacheEntry &entry = m_lists[address];
+	if( entry.checkedDList != status.gDlistCount )
+	{
+		entry.checkedDList = status.gDlistCount;
+
+		if( entry.numRebuilds <= DLCACHE_MAX_REBUILDS && (entry.ops.empty() || !Matches(entry, address)) )
+		{
+			entry.numRebuilds++;
+			if( entry.numRebuilds > DLCACHE_MAX_REBUILDS )
+				entry.ops.clear();
+			else
+				Build(entry, address);
+		}
+	}
+
+	return entry.ops.empty() ? NULL : &entry;
+}
+
+CDListCache::Cursor &CDListCache::SyncCursor()
+{
+	int sp = gDlistStackPointer;
+
+	// A new level is a new list, whatever was replayed there before
+	for( int i=m_lastStackPointer+1; i<=sp; i++ )
+	{
+		m_cursors[i].pEntry = NULL;
+		m_cursors[i].nextPC = ~0u;
+	}
+	m_lastStackPointer = sp;
+
+	uint32 pc = gDlistStack.address[sp];
+	Cursor &cursor = m_cursors[sp];
+
+	if( pc != cursor.nextPC )
+	{
+		// A handler has moved the PC, to a command of the same list or to another list
+		uint32 offset = pc - cursor.address;
+		if( cursor.pEntry != NULL && (offset&7) == 0 && offset/8 < cursor.pEntry->ops.size() )
+		{
+			cursor.index = offset/8;
+		}
+		else
+		{
+			cursor.pEntry = Lookup(pc);
+			cursor.address = pc;
+			cursor.index = 0;
+		}
+		cursor.nextPC = pc;
+	}
+
+	return cursor;
+}
+
+MicroCodeInstruction CDListCache::FetchNextCommand(MicroCodeCommand *pCommand)
+{
+	Cursor &cursor = SyncCursor();
+	uint32 pc = cursor.nextPC;
+	gDlistStack.address[gDlistStackPointer] = cursor.nextPC = pc+8;
+
+	if( cursor.pEntry != NULL && cursor.index < cursor.pEntry->ops.size() )
+	{
+		const DListCacheOp &op = cursor.pEntry->ops[cursor.index++];
+		*pCommand = op.command;
+		return op.func;
+	}
+
+	cursor.pEntry = NULL;
+	*pCommand = *(MicroCodeCommand*)&g_pu32RamBase[pc>>2];
+	return gUcodeFunc[pCommand->inst.cmd];
+}
+
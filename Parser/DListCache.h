@@ -0,0 +1,92 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef _DLIST_CACHE_H_
+#define _DLIST_CACHE_H_
+
+#include <unordered_map>
+#include <vector>
+
+#define DLCACHE_MAX_LISTS		4096	// the cache is emptied when it holds more lists
+#define DLCACHE_MAX_OPS			4096	// longer lists are not cached
+#define DLCACHE_MAX_REBUILDS	8		// lists changing more often are left to the normal fetch
+
+// A command of a cached display list with the handler of the current microcode
+struct DListCacheOp
+{
+	MicroCodeInstruction	func;
+	MicroCodeCommand		command;
+};
+
+struct DListCacheEntry
+{
+	uint32	checkedDList;		// status.gDlistCount when the commands were last compared with RDRAM
+	uint32	numRebuilds;
+	std::vector<DListCacheOp> ops;		// up to and including the EndDL, empty if the list is not cached
+	std::vector<uint32> words;			// the commands as they were in RDRAM, compared in one memcmp
+
+	DListCacheEntry() : checkedDList(0), numRebuilds(0) {}
+};
+
+/********************************************************************************************************************
+ * Cache of the display lists of the previous frames, by RDRAM address.
+ *
+ * A list is decoded once, from its address to its EndDL, into the commands and the handlers which run them. When
+ * the list is entered again, its commands are compared with RDRAM the first time in each DLParser_Process and the
+ * cached ops are dispatched without fetching and decoding the commands. The commands are kept as they are in RDRAM,
+ * so the segmented vertex, matrix and texture addresses are still resolved by the handlers when they run.
+ *
+ * The handlers still see the PC in gDlistStack. If one of them moves it, for a branch or after reading the next
+ * commands itself, the cache follows it within the list or goes back to fetching from RDRAM.
+ ********************************************************************************************************************/
+class CDListCache
+{
+public:
+	CDListCache();
+
+	// Drops all the lists, the handlers change with the microcode
+	void Reset();
+
+	// Called at the start of each DLParser_Process
+	void BeginDList();
+
+	// Reads the command at the PC of the current display list, updates the PC and returns the handler
+	MicroCodeInstruction FetchNextCommand(MicroCodeCommand *pCommand);
+
+protected:
+	struct Cursor
+	{
+		DListCacheEntry	*pEntry;	// the list being replayed at this level, or NULL
+		uint32			address;	// of the list
+		uint32			index;		// of the next op
+		uint32			nextPC;		// PC of the next command if no handler has moved it
+	};
+
+	Cursor &SyncCursor();
+	DListCacheEntry *Lookup(uint32 address);
+	bool Matches(const DListCacheEntry &entry, uint32 address);
+	void Build(DListCacheEntry &entry, uint32 address);
+
+	std::unordered_map<uint32, DListCacheEntry> m_lists;
+	Cursor	m_cursors[MAX_DL_STACK_SIZE];
+	int		m_lastStackPointer;
+};
+
+extern CDListCache gDListCache;
+
+#endif
@@ -16,7 +16,7 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 */
-#include "..\stdafx.h"
+#include "../stdafx.h"
 #include "Microcode.h"
 
 
@@ -28,7 +28,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 MicroCodeInstruction gCustomInstruction[256];
 
-void GBIMicrocode_SetCustom(u32 ucode, u32 offset);
+static void GBIMicrocode_SetCustom(u32 ucode, u32 offset);
 
 //////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////
@@ -47,89 +47,11 @@ void GBIMicrocode_SetCustom(u32 ucode, u32 offset);
 
 static UcodeInfo gUcodeInfo[ MAX_UCODE_CACHE_ENTRIES ];
 
-static bool	GBIMicrocode_DetectVersionString( u32 data_base, u32 data_size, char * str, u32 str_len )
-{
-	//DAEDALUS_ASSERT( data_base < MAX_RAM_ADDRESS + 0x1000 ,"GBIMicrocode out of bound %08X", data_base );
-
-	const s8 * ram( g_ps8RamBase );
-
-	for ( u32 i = 0; i+2 < data_size; i++ )
-	{
-		if ( ram[ (data_base + i+0) ^ 3 ] == 'R' &&
-			 ram[ (data_base + i+1) ^ 3 ] == 'S' &&
-			 ram[ (data_base + i+2) ^ 3 ] == 'P' )
-		{
-			char * p = str;
-			char * e = str+str_len;
-
-			// Loop while we haven't filled our buffer, and there's space for our terminator
-			while (p+1 < e)
-			{
-				char c( ram[ (data_base + i)  ^ 0x3 ] );
-				if( c < ' ')
-					break;
-
-				*p++ = c;
-				++i;
-			}
-			*p++ = 0;
-			return true;
-		}
-	}
-	return false;
-}
-
-static u32 GBIMicrocode_MicrocodeHash(u32 code_base, u32 code_size)
-{
-	// Needed for Conker's Bad Fur Day
-	if( code_size == 0 ) code_size = 0x1000;
-
-	const u8 * ram( g_pu8RamBase );
-
-	u32 hash = 0;
-	for (u32 i = 0; i < code_size; ++i)
-	{
-		hash = (hash << 4) + hash + ram[ (code_base+i) ^ 0x3 ];   // Best hash ever!
-	}
-	return hash;
-}
-
 void GBIMicrocode_Reset()
 {
 	memset(&gUcodeInfo, 0, sizeof(gUcodeInfo));
 }
 
-//*****************************************************************************
-//
-//*****************************************************************************
-struct MicrocodeData
-{
-	u32	ucode;
-	u32 offset;
-	u32 stride;
-	u32	hash;
-};
-
-static const MicrocodeData gMicrocodeData[] = 
-{
-	//
-	//	The only games that need defining are custom ucodes and incorrectly detected ones
-	//	If you believe a title should be here post the line for it from ucodes.txt @ http://www.daedalusx64.com
-	//	Note - Games are in alphabetical order by game title
-	//
-	{ GBI_CONKER,	GBI_2,  2,	0x60256efc	},	//"RSP Gfx ucode F3DEXBG.NoN fifo 2.08  Yoshitaka Yasumoto 1999 Nintendo.", "Conker's Bad Fur Day"}, 
-	{ GBI_LL,		GBI_1,  2,	0x6d8bec3e	},	//"", "Dark Rift"},
-	{ GBI_DKR,		GBI_0, 10,	0x0c10181a	},	//"", "Diddy Kong Racing (v1.0)"}, 
-	{ GBI_DKR,		GBI_0, 10,	0x713311dc	},	//"", "Diddy Kong Racing (v1.1)"}, 
-	{ GBI_GE,		GBI_0, 10,	0x23f92542	},	//"RSP SW Version: 2.0G, 09-30-96", "GoldenEye 007"}, 
-	{ GBI_DKR,		GBI_0, 10,	0x169dcc9d	},	//"", "Jet Force Gemini"},														
-	{ GBI_LL,		GBI_1,  2,	0x26da8a4c	},	//"", "Last Legion UX"},							
-	{ GBI_PD,		GBI_0, 10,	0xcac47dc4	},	//"", "Perfect Dark (v1.1)"}, 
-	{ GBI_SE,		GBI_0,  5,	0x6cbb521d	},	//"RSP SW Version: 2.0D, 04-01-96", "Star Wars - Shadows of the Empire (v1.0)"}, 
-	{ GBI_LL,		GBI_1,	2,  0xdd560323	},	//"", "Toukon Road - Brave Spirits"},											
-	{ GBI_WR,		GBI_0,	5,  0x64cc729d	},	//"RSP SW Version: 2.0D, 04-01-96", "Wave Race 64"},
-};
-
 UcodeInfo	GBIMicrocode_DetectVersion( u32 code_base, u32 code_size, u32 data_base, u32 data_size )
 {
 	// I think only checking code_base should be enough..
@@ -149,76 +71,22 @@ UcodeInfo	GBIMicrocode_DetectVersion( u32 code_base, u32 code_size, u32 data_bas
 			return gUcodeInfo[i];
 	}
 
-	//
-	//	Try to find the version string in the microcode data. This is faster than calculating a crc of the code
-	//
-	char str[256] = "";
-	GBIMicrocode_DetectVersionString( data_base, data_size, str, 256 );
-
-	// It wasn't the same as the last time around, we'll hash it and check if is a custom ucode.
-	//
-	u32 code_hash = GBIMicrocode_MicrocodeHash( code_base, code_size );
-
-	for ( u32 x = 0; x < ARRAYSIZE(gMicrocodeData); x++ )
-	{
-		if ( code_hash == gMicrocodeData[x].hash )
-		{
-			//DBGConsole_Msg(0, "Ucode has been Detected in Array :[M\"%s\", Ucode %d]", str, gMicrocodeData[ i ].ucode);
-			GBIMicrocode_SetCustom(gMicrocodeData[x].ucode, gMicrocodeData[x].offset);
-			
-			gUcodeInfo[i].set = true;
-			gUcodeInfo[i].func = gCustomInstruction;
-			gUcodeInfo[i].stride = gMicrocodeData[x].stride;
-			gUcodeInfo[i].address = address;
-
-			return gUcodeInfo[i];
-		}
-	}
-
-	//
-	// If it wasn't a custom ucode
-	// See if we can identify it by string, if no match was found set default for Fast3D ucode
-	//
-	const char  *ucodes[] = { "F3", "L3", "S2DEX" };
-	char 		*match = 0;
-
-	for(u32 j = 0; j<3;j++)
-	{
-		if( (match = strstr(str, ucodes[j])) )
-			break;
-	}
-
-	u32 ucode_stride;
-	u32 ucode_version;
+	char str[256];
+	MicrocodeData data = GBIMicrocode_Identify( g_pu8RamBase, g_dwRamSize-1, code_base, code_size, data_base, data_size, str, 256 );
 
-	if (!match)
+	if ( IS_CUSTOM_UCODE( data.ucode ) )
 	{
-		ucode_stride = 10;
-		ucode_version = GBI_0;
+		GBIMicrocode_SetCustom(data.ucode, data.offset);
+		gUcodeInfo[i].func = gCustomInstruction;
 	}
 	else
 	{
-		ucode_stride = 2;
-
-		if( strstr(match, "fifo") || strstr(match, "xbus") )
-		{
-			if( !strncmp(match, "S2DEX", 5) )
-				ucode_version = GBI_2_S2DEX;
-			else
-				ucode_version = GBI_2;
-		}
-		else
-		{
-			if( !strncmp(match, "S2DEX", 5) )
-				ucode_version = GBI_1_S2DEX;
-			else
-				ucode_version = GBI_1;
-		}
+		gUcodeInfo[i].func = gNormalInstruction[data.ucode];
 	}
 
 	gUcodeInfo[i].set = true;
-	gUcodeInfo[i].func = gNormalInstruction[ucode_version];
-	gUcodeInfo[i].stride = ucode_stride;
+	gUcodeInfo[i].stride = data.stride;
+	gUcodeInfo[i].ucode = data.ucode;
 	gUcodeInfo[i].address = address;
 
 //	DBGConsole_Msg(0,"Detected %s Ucode is: [M Ucode %d, 0x%08x, \"%s\", \"%s\"]",ucode_offset == u32(~0) ? "" :"Custom", ucode_version, code_hash, str, g_ROM.settings.GameName.c_str() );
@@ -235,7 +103,7 @@ UcodeInfo	GBIMicrocode_DetectVersion( u32 code_base, u32 code_size, u32 data_bas
 //*************************************************************************************
 static void GBIMicrocode_SetCustom(u32 ucode, u32 offset)
 {
-	memcpy(&gCustomInstruction, &gNormalInstruction[offset], 1024); // sizeof(gNormalInstruction)/MAX_UCODE
+	memcpy(&gCustomInstruction, &gNormalInstruction[offset], sizeof(gCustomInstruction));
 
 #if defined(DAEDALUS_DEBUG_DISPLAYLIST) || defined(DAEDALUS_ENABLE_PROFILING)
 	memcpy(gCustomInstructionName, gNormalInstructionName[offset], 1024);
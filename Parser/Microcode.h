@@ -32,28 +32,10 @@ struct UcodeInfo
 
 	u32  address; // ucode_base + data_base
 	u32  stride;  // Multiplier applied to vertex index's
+	u32  ucode;	  // GBIVersion, of the custom ucode if it is one
 	bool set;	  // This returns false when current entry is free to use
 };
 
-//*****************************************************************************
-// Enum
-//*****************************************************************************
-enum GBIVersion
-{
-	GBI_0 = 0,
-	GBI_1,
-	GBI_2,
-	GBI_1_S2DEX,
-	GBI_2_S2DEX,
-	GBI_WR,
-	GBI_DKR,
-	GBI_LL,
-	GBI_SE,
-	GBI_GE,
-	GBI_CONKER,
-	GBI_PD
-};
-
 //*****************************************************************************
 // Function
 //*****************************************************************************
@@ -0,0 +1,196 @@
+/*
+Copyright (C) 2009 StrmnNrmn
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+// The microcode detection of Microcode.cpp, without the handler tables. It only reads the memory it is given, so
+// the offline display list analyzer in Tools/DListAnalyzer detects the microcodes with the same code as the plugin.
+// The includer provides the u8, s8 and u32 types.
+
+#ifndef HLEGRAPHICS_MICROCODE_DETECT_H_
+#define HLEGRAPHICS_MICROCODE_DETECT_H_
+
+#include <string.h>
+
+//*****************************************************************************
+// Enum
+//*****************************************************************************
+enum GBIVersion
+{
+	GBI_0 = 0,
+	GBI_1,
+	GBI_2,
+	GBI_1_S2DEX,
+	GBI_2_S2DEX,
+	GBI_WR,
+	GBI_DKR,
+	GBI_LL,
+	GBI_SE,
+	GBI_GE,
+	GBI_CONKER,
+	GBI_PD
+};
+
+// The versions up to GBI_2_S2DEX have a table in gNormalInstruction, the others are custom
+#define MAX_UCODE_TABLE		5
+#define IS_CUSTOM_UCODE(x)	(x>=MAX_UCODE_TABLE)
+
+//*****************************************************************************
+//
+//*****************************************************************************
+struct MicrocodeData
+{
+	u32	ucode;
+	u32 offset;
+	u32 stride;
+	u32	hash;
+};
+
+// ram is the RDRAM, addressed like g_pu8RamBase, and ram_mask its size - 1
+inline bool GBIMicrocode_DetectVersionString( const u8 * ram, u32 ram_mask, u32 data_base, u32 data_size, char * str, u32 str_len )
+{
+	for ( u32 i = 0; i+2 < data_size; i++ )
+	{
+		if ( ram[ ((data_base + i+0) ^ 3) & ram_mask ] == 'R' &&
+			 ram[ ((data_base + i+1) ^ 3) & ram_mask ] == 'S' &&
+			 ram[ ((data_base + i+2) ^ 3) & ram_mask ] == 'P' )
+		{
+			char * p = str;
+			char * e = str+str_len;
+
+			// Loop while we haven't filled our buffer, and there's space for our terminator
+			while (p+1 < e)
+			{
+				char c( (s8)ram[ ((data_base + i) ^ 0x3) & ram_mask ] );
+				if( c < ' ')
+					break;
+
+				*p++ = c;
+				++i;
+			}
+			*p++ = 0;
+			return true;
+		}
+	}
+	return false;
+}
+
+inline u32 GBIMicrocode_MicrocodeHash( const u8 * ram, u32 ram_mask, u32 code_base, u32 code_size )
+{
+	// Needed for Conker's Bad Fur Day
+	if( code_size == 0 ) code_size = 0x1000;
+
+	u32 hash = 0;
+	for (u32 i = 0; i < code_size; ++i)
+	{
+		hash = (hash << 4) + hash + ram[ ((code_base+i) ^ 0x3) & ram_mask ];   // Best hash ever!
+	}
+	return hash;
+}
+
+//*****************************************************************************
+// Finds the version of the microcode, and the table a custom microcode is
+// based on. str gets the version string, "" if there is none
+//*****************************************************************************
+inline MicrocodeData GBIMicrocode_Identify( const u8 * ram, u32 ram_mask, u32 code_base, u32 code_size,
+											u32 data_base, u32 data_size, char * str, u32 str_len )
+{
+	static const MicrocodeData gMicrocodeData[] = 
+	{
+		//
+		//	The only games that need defining are custom ucodes and incorrectly detected ones
+		//	If you believe a title should be here post the line for it from ucodes.txt @ http://www.daedalusx64.com
+		//	Note - Games are in alphabetical order by game title
+		//
+		{ GBI_CONKER,	GBI_2,  2,	0x60256efc	},	//"RSP Gfx ucode F3DEXBG.NoN fifo 2.08  Yoshitaka Yasumoto 1999 Nintendo.", "Conker's Bad Fur Day"}, 
+		{ GBI_LL,		GBI_1,  2,	0x6d8bec3e	},	//"", "Dark Rift"},
+		{ GBI_DKR,		GBI_0, 10,	0x0c10181a	},	//"", "Diddy Kong Racing (v1.0)"}, 
+		{ GBI_DKR,		GBI_0, 10,	0x713311dc	},	//"", "Diddy Kong Racing (v1.1)"}, 
+		{ GBI_GE,		GBI_0, 10,	0x23f92542	},	//"RSP SW Version: 2.0G, 09-30-96", "GoldenEye 007"}, 
+		{ GBI_DKR,		GBI_0, 10,	0x169dcc9d	},	//"", "Jet Force Gemini"},														
+		{ GBI_LL,		GBI_1,  2,	0x26da8a4c	},	//"", "Last Legion UX"},							
+		{ GBI_PD,		GBI_0, 10,	0xcac47dc4	},	//"", "Perfect Dark (v1.1)"}, 
+		{ GBI_SE,		GBI_0,  5,	0x6cbb521d	},	//"RSP SW Version: 2.0D, 04-01-96", "Star Wars - Shadows of the Empire (v1.0)"}, 
+		{ GBI_LL,		GBI_1,	2,  0xdd560323	},	//"", "Toukon Road - Brave Spirits"},											
+		{ GBI_WR,		GBI_0,	5,  0x64cc729d	},	//"RSP SW Version: 2.0D, 04-01-96", "Wave Race 64"},
+	};
+
+	//
+	//	Try to find the version string in the microcode data. This is faster than calculating a crc of the code
+	//
+	str[0] = 0;
+	GBIMicrocode_DetectVersionString( ram, ram_mask, data_base, data_size, str, str_len );
+
+	// It wasn't the same as the last time around, we'll hash it and check if is a custom ucode.
+	//
+	u32 code_hash = GBIMicrocode_MicrocodeHash( ram, ram_mask, code_base, code_size );
+
+	for ( u32 x = 0; x < sizeof(gMicrocodeData)/sizeof(gMicrocodeData[0]); x++ )
+	{
+		if ( code_hash == gMicrocodeData[x].hash )
+		{
+			//DBGConsole_Msg(0, "Ucode has been Detected in Array :[M\"%s\", Ucode %d]", str, gMicrocodeData[ i ].ucode);
+			return gMicrocodeData[x];
+		}
+	}
+
+	//
+	// If it wasn't a custom ucode
+	// See if we can identify it by string, if no match was found set default for Fast3D ucode
+	//
+	const char  *ucodes[] = { "F3", "L3", "S2DEX" };
+	const char	*match = 0;
+
+	for(u32 j = 0; j<3;j++)
+	{
+		if( (match = strstr(str, ucodes[j])) )
+			break;
+	}
+
+	MicrocodeData data;
+	data.hash = code_hash;
+
+	if (!match)
+	{
+		data.stride = 10;
+		data.ucode = GBI_0;
+	}
+	else
+	{
+		data.stride = 2;
+
+		if( strstr(match, "fifo") || strstr(match, "xbus") )
+		{
+			if( !strncmp(match, "S2DEX", 5) )
+				data.ucode = GBI_2_S2DEX;
+			else
+				data.ucode = GBI_2;
+		}
+		else
+		{
+			if( !strncmp(match, "S2DEX", 5) )
+				data.ucode = GBI_1_S2DEX;
+			else
+				data.ucode = GBI_1;
+		}
+	}
+
+	data.offset = data.ucode;
+	return data;
+}
+
+#endif // HLEGRAPHICS_MICROCODE_DETECT_H_
@@ -797,7 +797,10 @@ void PrepareTextures()
 			}
 		}
 
+		// The TexRects and the background draws bind the textures here too, the next triangles set up their
+		// texture constants, combiner and filter again for what is bound now
 		gRDP.textureIsChanged = false;
+		gRDP.dirtyStates |= RDP_DIRTY_TEXTURE;
 	}
 }
 
@@ -833,6 +836,7 @@ void DLParser_LoadTLut(MicroCodeCommand command)
 	tile.sh = lrs;
 	tile.th = lrt;
 	tile.bSizeIsValid = true;
+	memset(&gRDP.mTileSize[tileno], 0, sizeof(RDP_TileSize));		// the size is no longer the one of the last SetTileSize
 
 	tile.lastTileCmd = CMD_LOADTLUT;
 
@@ -918,6 +922,7 @@ void DLParser_LoadBlock(MicroCodeCommand command)
 	info.tl = tile.tl = ult;
 	info.th = tile.th = dxt;
 	tile.bSizeIsValid = false;
+	memset(&gRDP.mTileSize[tileno], 0, sizeof(RDP_TileSize));
 
 	for( int i=0; i<8; i++ )
 	{
@@ -1017,6 +1022,7 @@ void DLParser_LoadTile(MicroCodeCommand command)
 	tile.hilite_sh = tile.sh = lrs;
 	tile.hilite_th = tile.th = lrt;
 	tile.bSizeIsValid = true;
+	memset(&gRDP.mTileSize[tileno], 0, sizeof(RDP_TileSize));
 
 	void (*Interleave)( void *mem, uint32 numDWords );
 	uint32 address, height, bpl, line, y;
@@ -1134,14 +1140,25 @@ static char *pszOnOff[2]     = {"Off", "On"};
 uint32 lastSetTile;
 void DLParser_SetTile(MicroCodeCommand command)
 {
+	uint32 tileno		= command.settile.tile;
+	lastSetTile = tileno;
+
+	// Only SetTile sets these fields of the tile, they are as the last one left them
+	RDP_Tile rdpTile;
+	rdpTile.cmd0 = command.inst.cmd0;
+	rdpTile.cmd1 = command.inst.cmd1;
+	if( gRDP.mTiles[tileno] == rdpTile )
+	{
+		gRedundantStateCounters.numSetTile++;
+		return;
+	}
+	gRDP.mTiles[tileno] = rdpTile;
+
 	gRDP.textureIsChanged = true;
 
-	uint32 tileno		= command.settile.tile;
 	Tile &tile = gRDP.tiles[tileno];
 	tile.bForceWrapS = tile.bForceWrapT = tile.bForceClampS = tile.bForceClampT = false;
 
-	lastSetTile = tileno;
-
 	tile.dwFormat	= command.settile.fmt;
 	tile.dwSize		= command.settile.siz;
 	tile.dwLine		= command.settile.line;
@@ -1225,9 +1242,21 @@ void DLParser_SetTile(MicroCodeCommand command)
 
 void DLParser_SetTileSize(MicroCodeCommand command)
 {
+	uint32 tileno	= command.loadtile.tile;
+
+	// The loads clear mTileSize when they change the size of the tile
+	RDP_TileSize rdpTileSize;
+	rdpTileSize.cmd0 = command.inst.cmd0;
+	rdpTileSize.cmd1 = command.inst.cmd1;
+	if( gRDP.mTileSize[tileno] == rdpTileSize )
+	{
+		gRedundantStateCounters.numSetTileSize++;
+		return;
+	}
+	gRDP.mTileSize[tileno] = rdpTileSize;
+
 	gRDP.textureIsChanged = true;
 
-	uint32 tileno	= command.loadtile.tile;
 	int sl		= command.loadtile.sl;
 	int tl		= command.loadtile.tl;
 	int sh		= command.loadtile.sh;
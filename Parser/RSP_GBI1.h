@@ -45,6 +45,9 @@ void RSP_GBI1_Vtx(MicroCodeCommand command)
 		return;
 	}
 
+	if (gDListCuller.SkipVertices(command.vtx1.addr, addr, v0, n))
+		return;
+
 	ProcessVertexData(addr, v0, n);
 #ifdef _DEBUG
 	status.dwNumVertices += n;
@@ -68,6 +71,7 @@ void RSP_GBI1_ModifyVtx(MicroCodeCommand command)
 		return;
 	}
 
+	gDListCuller.Uncullable();
 	ModifyVertexInfo(offset, dwVert, dwValue);
 }
 
@@ -123,6 +127,8 @@ void RSP_GBI1_Tri2(MicroCodeCommand command)
 void RSP_GBI1_BranchZ(MicroCodeCommand command)
 {
 	uint32 vtx = command.branchz.vtx;
+	gDListCuller.Uncullable();
+
 	float vtxdepth = g_vecProjected[vtx].ProjectedPos.z / g_vecProjected[vtx].ProjectedPos.w;
 
 #ifdef _DEBUG
@@ -157,6 +163,7 @@ void RSP_GBI1_LoadUCode(MicroCodeCommand command)
 //NOT GBI1 SPECFIFIC MOVEME FIXME CLEANME
 void RSP_GFX_Force_Matrix(uint32 dwAddr)
 {
+	gDListCuller.Uncullable();
 	gRSP.mWorldProjectValid = true;
 	gRSP.mWPmodified = true;//Signal that Worldproject matrix is changed
 
@@ -370,6 +377,10 @@ void RSP_GBI1_Line3D(MicroCodeCommand command)
 		uint32 dwV1		= command.gbi1line3d.v1/gRSP.vertexMult;
 		uint32 dwWidth  = command.gbi1line3d.v2;
 		uint32 dwFlag	= command.gbi1line3d.v3/gRSP.vertexMult;	
+
+		// Drawn without AddTri, the culler still has to know the vertices are used
+		if( gDListCuller.SkipTriangle(dwV0, dwV1, dwV1) )
+			return;
 		
 		CRender::g_pRender->SetCombinerAndBlender();
 
@@ -426,6 +437,7 @@ void RSP_GBI1_GeometryMode(MicroCodeCommand command)
 	}
 	
 	gRDP.tnl._u32 = 0;
+	gRDP.dirtyStates |= RDP_DIRTY_OTHERMODE;
 
 	gRDP.tnl.Light		= gGeometryMode.GBI1_Lighting;
 	gRDP.tnl.TexGen		= gGeometryMode.GBI1_TexGen;
@@ -457,8 +469,15 @@ void RSP_GBI1_EndDL(MicroCodeCommand command)
 void RSP_GBI1_SetOtherModeL(MicroCodeCommand command)
 {
 	const u32 mask = ((1 << command.othermode.len) - 1) << command.othermode.sft;
+	const u32 L = (gRDP.otherMode.L & ~mask) | command.othermode.data;
+	if( L == gRDP.otherMode.L )
+	{
+		gRedundantStateCounters.numSetOtherMode++;
+		return;
+	}
 
-	gRDP.otherMode.L = (gRDP.otherMode.L & ~mask) | command.othermode.data;
+	gRDP.otherMode.L = L;
+	gRDP.dirtyStates |= RDP_DIRTY_OTHERMODE;
 }
 
 //*****************************************************************************
@@ -467,8 +486,15 @@ void RSP_GBI1_SetOtherModeL(MicroCodeCommand command)
 void RSP_GBI1_SetOtherModeH(MicroCodeCommand command)
 {
 	const u32 mask = ((1 << command.othermode.len) - 1) << command.othermode.sft;
+	const u32 H = (gRDP.otherMode.H & ~mask) | command.othermode.data;
+	if( H == gRDP.otherMode.H )
+	{
+		gRedundantStateCounters.numSetOtherMode++;
+		return;
+	}
 
-	gRDP.otherMode.H = (gRDP.otherMode.H & ~mask) | command.othermode.data;
+	gRDP.otherMode.H = H;
+	gRDP.dirtyStates |= RDP_DIRTY_OTHERMODE;
 }
 
 //*****************************************************************************
@@ -525,6 +551,7 @@ void RSP_GBI1_MoveWord(MicroCodeCommand command)
 		{
 			uint32 segment = (offset >> 2) & 0xF;
 			LOG_UCODE("    RSP_MOVE_WORD_SEGMENT Seg[%d] = 0x%08x", segment, value);
+			gDListCuller.Uncullable();
 			gRSP.segments[segment] = value & 0x00FFFFFF;
 		}
 		break;
@@ -644,9 +671,14 @@ void RSP_GBI1_DL(MicroCodeCommand command)
 
 	if(command.dlist.param == RSP_DLIST_PUSH)
 		gDlistStackPointer++;
+	else
+		gDListCuller.Uncullable();
 
 	gDlistStack.address[gDlistStackPointer] = addr;
 
+	if(command.dlist.param == RSP_DLIST_PUSH)
+		gDListCuller.CallDList(command.dlist.addr, addr);
+
 	LOG_UCODE("Level=%d", gDlistStackPointer + 1);
 	LOG_UCODE("^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^");
 }
@@ -663,6 +695,13 @@ void RSP_GBI1_CullDL(MicroCodeCommand command)
 
 	if( last < first )	return;
 
+	if (gDListCuller.SkipCullTest(first, last))
+	{
+		status.dwNumDListsCulled++;
+		RDP_GFX_PopDL();
+		return;
+	}
+
 	uint32 flags = g_vecProjected[first].ClipFlags;
 	for (uint32 i = first+1; i <= last; i++)
 	{
@@ -41,7 +41,7 @@ void RSP_GBI2_Vtx(MicroCodeCommand command)
 	{
 		DebuggerAppendMsg("ProcessVertexData: Address out of range (0x%08x)", addr);
 	}
-	else
+	else if (!gDListCuller.SkipVertices(command.vtx2.addr, addr, v0, n))
 	{
 		ProcessVertexData(addr, v0, n);
 
@@ -85,6 +85,7 @@ void RSP_GBI2_MoveWord(MicroCodeCommand command)
 			uint32 dwAddr    = command.mw2.value & 0x00FFFFFF;			// Hack - convert to physical
 
 			LOG_UCODE("      RSP_MOVE_WORD_SEGMENT Segment[%d] = 0x%08x",	dwSeg, dwAddr);
+			gDListCuller.Uncullable();
 
 			gRSP.segments[dwSeg] = dwAddr;
 
@@ -326,6 +327,7 @@ void RSP_GBI2_GeometryMode(MicroCodeCommand command)
 	gGeometryMode._u32  |= command.inst.cmd1;
 
 	gRDP.tnl._u32 = 0;
+	gRDP.dirtyStates |= RDP_DIRTY_OTHERMODE;
 
 	gRDP.tnl.Light		= gGeometryMode.GBI2_Lighting;
 	gRDP.tnl.TexGen		= gGeometryMode.GBI2_TexGen;
@@ -475,8 +477,15 @@ void RSP_GBI2_SetOtherModeL(MicroCodeCommand command)
 {
 	// Mask is constructed slightly differently
 	const uint32 mask = (uint32)((s32)(0x80000000) >> command.othermode.len) >> command.othermode.sft;
+	const uint32 L = (gRDP.otherMode.L & ~mask) | command.othermode.data;
+	if( L == gRDP.otherMode.L )
+	{
+		gRedundantStateCounters.numSetOtherMode++;
+		return;
+	}
 
-	gRDP.otherMode.L = (gRDP.otherMode.L & ~mask) | command.othermode.data;
+	gRDP.otherMode.L = L;
+	gRDP.dirtyStates |= RDP_DIRTY_OTHERMODE;
 }
 
 //*****************************************************************************
@@ -486,8 +495,15 @@ void RSP_GBI2_SetOtherModeH(MicroCodeCommand command)
 {
 	// Mask is constructed slightly differently
 	const uint32 mask = (uint32)((s32)(0x80000000) >> command.othermode.len) >> command.othermode.sft;
+	const uint32 H = (gRDP.otherMode.H & ~mask) | command.othermode.data;
+	if( H == gRDP.otherMode.H )
+	{
+		gRedundantStateCounters.numSetOtherMode++;
+		return;
+	}
 
-	gRDP.otherMode.H = (gRDP.otherMode.H & ~mask) | command.othermode.data;
+	gRDP.otherMode.H = H;
+	gRDP.dirtyStates |= RDP_DIRTY_OTHERMODE;
 }
 
 //*****************************************************************************
@@ -504,6 +520,7 @@ void RSP_GBI2_DL_Count(MicroCodeCommand command)
 		return;
 	}
 
+	gDListCuller.Uncullable();
 	gDlistStackPointer++;
 	gDlistStack.address[gDlistStackPointer] = address;
 	gDlistStack.limit = (command.inst.cmd0) & 0xFFFF;
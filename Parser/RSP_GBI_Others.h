@@ -45,6 +45,7 @@ void TexRectToN64FrameBuffer_YUV_16b(uint32 x0, uint32 y0, uint32 width, uint32
 
 	uint32 n64CIaddr = g_CI.dwAddr;
 	uint32 n64CIwidth = g_CI.dwWidth;
+	gRenderThread.AddWrite((n64CIaddr&(g_dwRamSize-1)) + y0*n64CIwidth*2, (n64CIaddr&(g_dwRamSize-1)) + (y0+height)*n64CIwidth*2);
 
 	for (uint32 y = 0; y < height; y++)
 	{
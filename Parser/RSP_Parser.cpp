@@ -17,10 +17,14 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 */
 
-#include "..\stdafx.h"
+#include "../stdafx.h"
 
 #include "ucode.h"
 #include "Microcode.h"
+#include "DListCache.h"
+#include "DLCulling.h"
+#include "DLProfiler.h"
+#include "RenderThread.h"
 
 //////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////
@@ -33,6 +37,7 @@ static bool gFirstCall = true;
 
 static u32 gRDPHalf1 = 0;
 static u32 gLastUcodeBase = 0;
+static u32 gLastUcode = GBI_0;
 const MicroCodeInstruction *gUcodeFunc = NULL;
 
 void DLParser_InitMicrocode(u32 code_base, u32 code_size, u32 data_base, u32 data_size);
@@ -53,7 +58,9 @@ char *pszImgSize[4] = {"4", "8", "16", "32"};
 const char *textluttype[4] = {"RGB16", "I16?", "RGBA16", "IA16"};
 uint16	g_wRDPTlut[0x200];
 
-#include "..\Device\FrameBuffer.h"
+RedundantStateCounters gRedundantStateCounters;
+
+#include "../Device/FrameBuffer.h"
 
 //Normal ucodes
 #include "RSP_GBI0.h"
@@ -99,6 +106,9 @@ void DLParser_Init()
 	{
 		memset(&gRDP.tiles[i], 0, sizeof(Tile));
 	}
+	memset(gRDP.mTiles, 0, sizeof(gRDP.mTiles));
+	memset(gRDP.mTileSize, 0, sizeof(gRDP.mTileSize));
+	memset(&gRedundantStateCounters, 0, sizeof(gRedundantStateCounters));
 	memset(g_tmemLoadAddrMap, 0, sizeof(g_tmemLoadAddrMap));
 
 	status.bAllowLoadFromTMEM = true;
@@ -115,6 +125,8 @@ void DLParser_Init()
 	memset(&g_CI, 0, sizeof(SetImgInfo));
 	memset(&g_TI, 0, sizeof(SetImgInfo));
 
+	gDListCache.Reset();
+	gDListCuller.Reset();
 }
 
 void RDP_GFX_Reset()
@@ -141,7 +153,11 @@ void DLParser_InitMicrocode(u32 code_base, u32 code_size, u32 data_base, u32 dat
 	UcodeInfo info = GBIMicrocode_DetectVersion(code_base, code_size, data_base, data_size);
 	gRSP.vertexMult = info.stride;
 	gLastUcodeBase = code_base;
+	gLastUcode = info.ucode;
 	gUcodeFunc = info.func;
+	gDListCache.Reset();
+	gDListProfiler.SetMicrocode(info.ucode);
+	gDListCuller.SetMicrocode(info.ucode);
 	// Used for fetching ucode names (Debug Only)
 //#if defined(DAEDALUS_DEBUG_DISPLAYLIST) || defined(DAEDALUS_ENABLE_PROFILING)
 	//gUcodeName = IS_CUSTOM_UCODE(ucode) ? gCustomInstructionName : gNormalInstructionName[ucode];
@@ -160,6 +176,9 @@ void DLParser_Process()
 	status.gRDPTime = timeGetTime();
 	status.gDlistCount++;
 
+	if( options.bProfileDisplayLists )
+		gDListProfiler.BeginDList();
+
 	OSTask * pTask = (OSTask *)(g_GraphicsInfo.DMEM + 0x0FC0);
 	u32 code_base = (u32)pTask->t.ucode & 0x1fffffff;
 	u32 code_size = pTask->t.ucode_size;
@@ -197,9 +216,13 @@ void DLParser_Process()
 	CRender::g_pRender->SetViewport(0, 0, windowSetting.uViWidth, windowSetting.uViHeight, 0x3FF);
 	CRender::g_pRender->SetFillMode(options.bWinFrameMode? RICE_FILLMODE_WINFRAME : RICE_FILLMODE_SOLID);
 
+	gDListCache.BeginDList();
+	gDListCuller.BeginDList();
+
 	try
 	{
 		MicroCodeCommand command;
+		MicroCodeInstruction func;
 
 		// The main loop
 		while( gDlistStackPointer >= 0 )
@@ -215,9 +238,20 @@ void DLParser_Process()
 
 			status.gUcodeCount++;
 
-			DLParser_FetchNextCommand(&command);
+			if( options.bCacheDisplayLists )
+			{
+				func = gDListCache.FetchNextCommand(&command);
+			}
+			else
+			{
+				DLParser_FetchNextCommand(&command);
+				func = gUcodeFunc[command.inst.cmd];
+			}
 
-			gUcodeFunc[command.inst.cmd](command);
+			if( options.bProfileDisplayLists )
+				gDListProfiler.Run(func, command);
+			else
+				func(command);
 
 			if (gDlistStack.limit >= 0)
 			{
@@ -235,8 +269,95 @@ void DLParser_Process()
 		TRACE0("Unknown exception happens in ProcessDList");
 	}
 
+	gDListCuller.EndDList();
 	CRender::g_pRender->EndRendering();
-		
+
+	if( options.bProfileDisplayLists )
+		gDListProfiler.EndDList();
+}
+
+//*****************************************************************************
+// Walks the list of the current task without running it, to tell if it ends
+// with a full sync. Returns 1 when the full sync is reached, 0 when the list
+// ends without one and -1 when the walk cannot tell: the ucode is not known
+// yet or not a plain GBI one, or the list branches on what the parser computes
+// (BranchZ, CullDL), loads a ucode or counts commands.
+//*****************************************************************************
+int DLParser_FindFullSync()
+{
+	const OSTask * pTask = (const OSTask *)(g_GraphicsInfo.DMEM + 0x0FC0);
+	u32 code_base = (u32)pTask->t.ucode & 0x1fffffff;
+
+	if( gLastUcodeBase != code_base || gUcodeFunc == NULL || (gLastUcode != GBI_0 && gLastUcode != GBI_1 && gLastUcode != GBI_2) )
+		return -1;
+
+	// the TexRect of these games does not always take two more commands
+	if( options.enableHackForGames == HACK_FOR_ALL_STAR_BASEBALL || options.enableHackForGames == HACK_FOR_MLB )
+		return -1;
+
+	u32 segments[16];
+	memcpy(segments, gRSP.segments, sizeof(segments));
+
+	u32 address[MAX_DL_STACK_SIZE];
+	bool conditional[MAX_DL_STACK_SIZE];	// the rest of the list may be culled
+	int sp = 0;
+	address[0] = (u32)pTask->t.data_ptr;
+	conditional[0] = false;
+
+	for( u32 count=0; sp >= 0; count++ )
+	{
+		u32 pc = address[sp];
+		if( count >= MAX_DL_COUNT || (pc&7) != 0 || pc+8 > g_dwRamSize )
+			return -1;
+
+		MicroCodeCommand command = *(MicroCodeCommand*)&g_pu32RamBase[pc>>2];
+		MicroCodeInstruction func = gUcodeFunc[command.inst.cmd];
+		address[sp] = pc+8;
+
+		if( func == DLParser_RDPFullSync )
+		{
+			return conditional[sp] ? -1 : 1;
+		}
+		else if( func == RSP_GBI1_DL )
+		{
+			u32 seg = command.dlist.addr;
+			u32 addr = (segments[(seg>>24)&0x0F] + (seg&0x00FFFFFF)) & (g_dwRamSize - 1);
+			if( command.dlist.param == RSP_DLIST_PUSH )
+			{
+				if( sp+1 >= MAX_DL_STACK_SIZE )
+					return -1;
+				sp++;
+				conditional[sp] = conditional[sp-1];
+			}
+			address[sp] = addr;
+		}
+		else if( func == RSP_GBI1_EndDL || func == RSP_RDP_Nothing )
+		{
+			sp--;
+		}
+		else if( func == RSP_GBI1_CullDL )
+		{
+			conditional[sp] = true;
+		}
+		else if( func == RSP_GBI1_BranchZ || func == RSP_GBI2_DL_Count || func == RSP_GBI1_LoadUCode )
+		{
+			return -1;
+		}
+		else if( func == DLParser_TexRect || func == DLParser_TexRectFlip )
+		{
+			address[sp] += 16;
+		}
+		else if( func == RSP_GBI1_MoveWord && command.mw1.type == RSP_MOVE_WORD_SEGMENT )
+		{
+			segments[(command.mw1.offset >> 2) & 0xF] = command.mw1.value & 0x00FFFFFF;
+		}
+		else if( func == RSP_GBI2_MoveWord && command.mw2.type == RSP_MOVE_WORD_SEGMENT )
+		{
+			segments[(command.mw2.offset >> 2) & 0xF] = command.mw2.value & 0x00FFFFFF;
+		}
+	}
+
+	return 0;
 }
 
 //*****************************************************************************
@@ -334,8 +455,15 @@ void DLParser_SetPrimDepth(MicroCodeCommand command)
 //BACKTOMERIGHTNOW
 void DLParser_RDPSetOtherMode(MicroCodeCommand command)
 {
+	if( gRDP.otherMode.H == command.inst.cmd0 && gRDP.otherMode.L == command.inst.cmd1 )
+	{
+		gRedundantStateCounters.numSetOtherMode++;
+		return;
+	}
+
 	gRDP.otherMode.H = (command.inst.cmd0);
 	gRDP.otherMode.L = (command.inst.cmd1);
+	gRDP.dirtyStates |= RDP_DIRTY_OTHERMODE;
 }
 
 void DLParser_RDPLoadSync(MicroCodeCommand command)	{	LOG_UCODE("LoadSync: (Ignored)"); }
@@ -427,6 +555,8 @@ void DLParser_FillRect(MicroCodeCommand command)
 
 		u32 zi_width_in_dwords = g_CI.dwWidth >> 1;
 		u32 * dst = (u32*)(g_pu8RamBase + g_CI.dwAddr) + y0 * zi_width_in_dwords;
+		if( y1 > y0 )
+			gRenderThread.AddWrite(g_CI.dwAddr + y0*zi_width_in_dwords*4, g_CI.dwAddr + y1*zi_width_in_dwords*4);
 
 		for (int y = y0; y < y1; y++)
 		{
@@ -486,6 +616,7 @@ void DLParser_FillRect(MicroCodeCommand command)
 				uint16 color = (uint16)fill_colour;
 				uint32 pitch = g_pRenderTextureInfo->N64Width<<1;
                 uintptr_t base = (uintptr_t)(g_pu8RamBase + g_pRenderTextureInfo->CI_Info.dwAddr);
+				gRenderThread.AddWrite(g_pRenderTextureInfo->CI_Info.dwAddr + pitch*command.fillrect.y0, g_pRenderTextureInfo->CI_Info.dwAddr + pitch*command.fillrect.y1);
 				for( uint32 i =command.fillrect.y0; i<command.fillrect.y1; i++ )
 				{
 					for( uint32 j=command.fillrect.x0; j<command.fillrect.x1; j++ )
@@ -499,6 +630,7 @@ void DLParser_FillRect(MicroCodeCommand command)
 				uint8 color = (uint8)fill_colour;
 				uint32 pitch = g_pRenderTextureInfo->N64Width;
                 uintptr_t base = (uintptr_t)(g_pu8RamBase + g_pRenderTextureInfo->CI_Info.dwAddr);
+				gRenderThread.AddWrite(g_pRenderTextureInfo->CI_Info.dwAddr + pitch*command.fillrect.y0, g_pRenderTextureInfo->CI_Info.dwAddr + pitch*command.fillrect.y1);
 				for( uint32 i=command.fillrect.y0; i<command.fillrect.y1; i++ )
 				{
 					for( uint32 j=command.fillrect.x0; j<command.fillrect.x1; j++ )
@@ -565,6 +697,7 @@ void RSP_RDP_Nothing(MicroCodeCommand command)
 
 void RSP_RDP_InsertMatrix(MicroCodeCommand command)
 {
+	gDListCuller.Uncullable();
 	gRSP.mWPmodified = true; //Signal that worldproject matrix is changed 
 
 	//Make sure WP matrix is up to date before changing WP matrix
@@ -635,6 +768,12 @@ void DLParser_SetCombine(MicroCodeCommand command)
 {
 	uint32 dwMux0 = (command.inst.cmd0)&0x00FFFFFF;
 	uint32 dwMux1 = (command.inst.cmd1);
+	if( CRender::g_pRender->m_Mux == ((((uint64)dwMux0) << 32) | (uint64)dwMux1) )
+	{
+		gRedundantStateCounters.numSetCombine++;
+		return;
+	}
+
 	CRender::g_pRender->SetMux(dwMux0, dwMux1);
 }
 
@@ -655,16 +794,31 @@ void DLParser_SetFogColor(MicroCodeCommand command)
 void DLParser_SetBlendColor(MicroCodeCommand command)
 {
 	CRender::g_pRender->SetAlphaRef(command.setcolor.a);
+	gRDP.dirtyStates |= RDP_DIRTY_OTHERMODE;
 }
 
 
 void DLParser_SetPrimColor(MicroCodeCommand command)
 {
+	uint32 dwLODMin = command.setcolor.prim_min_level;
+	uint32 dwLODFrac = max((uint32)command.setcolor.prim_level, dwLODMin);
+	if( gRDP.primitiveColor == COLOR_RGBA(command.setcolor.r, command.setcolor.g, command.setcolor.b, command.setcolor.a) && gRDP.primLODMin == dwLODMin && gRDP.primLODFrac == dwLODFrac )
+	{
+		gRedundantStateCounters.numSetPrimColor++;
+		return;
+	}
+
 	SetPrimitiveColor( COLOR_RGBA(command.setcolor.r, command.setcolor.g, command.setcolor.b, command.setcolor.a), command.setcolor.prim_min_level, command.setcolor.prim_level);
 }
 
 void DLParser_SetEnvColor(MicroCodeCommand command)
 {
+	if( gRDP.envColor == COLOR_RGBA(command.setcolor.r, command.setcolor.g, command.setcolor.b, command.setcolor.a) )
+	{
+		gRedundantStateCounters.numSetEnvColor++;
+		return;
+	}
+
 	SetEnvColor( COLOR_RGBA(command.setcolor.r, command.setcolor.g, command.setcolor.b, command.setcolor.a) );
 }
 
@@ -20,7 +20,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #ifndef __RICE_RDP_GFX_H__
 #define __RICE_RDP_GFX_H__
-#include "ucodedefs.h"
+#include "UcodeDefs.h"
 
 #define	RSP_SPNOOP				0	// handle 0 gracefully 
 #define	RSP_MTX					1
@@ -779,12 +779,26 @@ extern TmemType g_Tmem;
 
 extern DListStack	gDlistStack;
 
+// State commands which would not change anything, dropped by their handlers since the rom started
+struct RedundantStateCounters
+{
+	uint32	numSetCombine;
+	uint32	numSetOtherMode;		// SetOtherMode_H, SetOtherMode_L and the RDP SetOtherMode
+	uint32	numSetPrimColor;
+	uint32	numSetEnvColor;
+	uint32	numSetTile;
+	uint32	numSetTileSize;
+};
+
+extern RedundantStateCounters gRedundantStateCounters;
+
 extern int gDlistStackPointer;
 
 void DLParser_Init();
 void RDP_GFX_Reset();
 void RDP_Cleanup();
 void DLParser_Process();
+int DLParser_FindFullSync();
 void RDP_DLParser_Process(void);
 
 void PrepareTextures();
@@ -0,0 +1,248 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "../stdafx.h"
+#include "RenderThread.h"
+
+CRenderThread gRenderThread;
+
+// The VI registers of GFX_INFO, the list reads them for the size of the frame
+static uint32 * GFX_INFO::* const viRegs[RENDER_THREAD_NUM_VI_REGS] =
+{
+	&GFX_INFO::VI_STATUS_REG,
+	&GFX_INFO::VI_ORIGIN_REG,
+	&GFX_INFO::VI_WIDTH_REG,
+	&GFX_INFO::VI_INTR_REG,
+	&GFX_INFO::VI_V_CURRENT_LINE_REG,
+	&GFX_INFO::VI_TIMING_REG,
+	&GFX_INFO::VI_V_SYNC_REG,
+	&GFX_INFO::VI_H_SYNC_REG,
+	&GFX_INFO::VI_LEAP_REG,
+	&GFX_INFO::VI_H_START_REG,
+	&GFX_INFO::VI_V_START_REG,
+	&GFX_INFO::VI_V_BURST_REG,
+	&GFX_INFO::VI_X_SCALE_REG,
+	&GFX_INFO::VI_Y_SCALE_REG,
+};
+
+CRenderThread::CRenderThread() :
+	m_bFullSync(false),
+	m_bQueued(false),
+	m_bStop(false)
+{
+}
+
+CRenderThread::~CRenderThread()
+{
+	Stop();
+}
+
+void CRenderThread::Start()
+{
+	Stop();
+
+#ifndef _DEBUG
+	// the debugger pauses the parser on the emulator thread
+	m_rdram.resize(g_dwRamSize);
+	m_saved.resize(g_dwRamSize);
+	m_bBlockSaved.assign(g_dwRamSize/RENDER_THREAD_SAVE_BLOCK, 0);
+	m_savedBlocks.clear();
+	m_writes.clear();
+	m_bQueued = false;
+	m_bStop = false;
+	m_thread = std::thread(&CRenderThread::RenderThread, this);
+#endif
+}
+
+void CRenderThread::Stop()
+{
+	if( !IsRunning() )
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStop = true;
+	}
+	m_cond.notify_all();
+
+	// the thread runs the queued list before it exits
+	m_thread.join();
+	CopyWrites();
+	std::vector<uint8>().swap(m_rdram);
+	std::vector<uint8>().swap(m_saved);
+	std::vector<uint8>().swap(m_bBlockSaved);
+}
+
+bool CRenderThread::CanProcessDList()
+{
+	if( !IsRunning() || g_GraphicsInfo.DMEM == NULL || g_GraphicsInfo.RDRAM == NULL )
+		return false;
+
+	// the game reads these frames from RDRAM, the list has to write them there before the emulation goes on
+	if( frameBufferOptions.bWriteBackBufToRDRAM || frameBufferOptions.bRenderTextureWriteBack )
+		return false;
+
+	// the snapshot is a copy of this memory, the walk tells ProcessDList whether to raise the DP interrupt
+	int fullSync = DLParser_FindFullSync();
+	if( fullSync < 0 )
+		return false;
+
+	m_bFullSync = (fullSync > 0);
+	return true;
+}
+
+void CRenderThread::ProcessDList()
+{
+	// The snapshot is only read by the thread, which is idle since the last Sync
+	memcpy(&m_rdram[0], g_GraphicsInfo.RDRAM, g_dwRamSize);
+	memcpy(m_dmem, g_GraphicsInfo.DMEM, RENDER_THREAD_DMEM_SIZE);
+
+	m_info = g_GraphicsInfo;
+	m_info.RDRAM = &m_rdram[0];
+	m_info.DMEM = m_dmem;
+	for( int i=0; i<RENDER_THREAD_NUM_VI_REGS; i++ )
+	{
+		uint32 *pReg = g_GraphicsInfo.*viRegs[i];
+		m_viRegs[i] = pReg ? *pReg : 0;
+		m_info.*viRegs[i] = &m_viRegs[i];
+	}
+
+	// The game waits for the DP interrupt of the full sync ending its list before it goes on, the thread cannot
+	// raise it, the emulator is not thread safe
+	if( m_bFullSync )
+		TriggerDPInterrupt();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bQueued = true;
+	}
+	m_cond.notify_one();
+}
+
+void CRenderThread::Sync()
+{
+	if( !IsRunning() || IsRenderThread() )
+		return;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while( m_bQueued )
+		m_doneCond.wait(lock);
+
+	CopyWrites();
+}
+
+void CRenderThread::AddWrite(uint32 start, uint32 end)
+{
+	if( !IsRenderThread() )
+		return;
+
+	// whole words, the halves and the bytes of a word are written with the ^2 and ^3 swizzle
+	start &= ~3;
+	end = (min(end, g_dwRamSize) + 3) & ~3;
+	if( start >= end )
+		return;
+
+	for( uint32 block=start/RENDER_THREAD_SAVE_BLOCK; block<=(end-1)/RENDER_THREAD_SAVE_BLOCK; block++ )
+	{
+		if( m_bBlockSaved[block] )
+			continue;
+
+		uint32 offset = block*RENDER_THREAD_SAVE_BLOCK;
+		memcpy(&m_saved[offset], &m_rdram[offset], RENDER_THREAD_SAVE_BLOCK);
+		m_bBlockSaved[block] = 1;
+		m_savedBlocks.push_back(block);
+	}
+
+	if( !m_writes.empty() && start <= m_writes.back().end && end >= m_writes.back().start )
+	{
+		m_writes.back().start = min(start, m_writes.back().start);
+		m_writes.back().end = max(end, m_writes.back().end);
+	}
+	else
+	{
+		WriteRange range = { start, end };
+		m_writes.push_back(range);
+	}
+}
+
+void CRenderThread::CopyWrites()
+{
+	uint32 *pRDRAM = (uint32 *)g_GraphicsInfo.RDRAM;
+	const uint32 *pList = (const uint32 *)&m_rdram[0];
+	const uint32 *pSaved = (const uint32 *)&m_saved[0];
+
+	for( size_t i=0; i<m_writes.size(); i++ )
+	{
+		const WriteRange &range = m_writes[i];
+		for( uint32 word=range.start>>2; word<range.end>>2; word++ )
+		{
+			// the words the emulation wrote since the snapshot are newer than the list
+			if( pRDRAM[word] == pSaved[word] )
+				pRDRAM[word] = pList[word];
+		}
+	}
+	m_writes.clear();
+
+	for( size_t i=0; i<m_savedBlocks.size(); i++ )
+		m_bBlockSaved[m_savedBlocks[i]] = 0;
+	m_savedBlocks.clear();
+}
+
+void CRenderThread::RunDList()
+{
+	// The plugin reads the memory and the registers through these, nothing else of the plugin runs until Sync
+	GFX_INFO savedInfo = g_GraphicsInfo;
+	g_GraphicsInfo = m_info;
+	g_pu8RamBase = m_info.RDRAM;
+	g_pu32RamBase = (uint32*)m_info.RDRAM;
+	g_ps8RamBase = (signed char *)m_info.RDRAM;
+
+	try
+	{
+		DLParser_Process();
+	}
+	catch (...)
+	{
+		TRACE0("Unknown Error in the render thread");
+	}
+
+	g_GraphicsInfo = savedInfo;
+	g_pu8RamBase = savedInfo.RDRAM;
+	g_pu32RamBase = (uint32*)savedInfo.RDRAM;
+	g_ps8RamBase = (signed char *)savedInfo.RDRAM;
+}
+
+void CRenderThread::RenderThread()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	for(;;)
+	{
+		while( !m_bStop && !m_bQueued )
+			m_cond.wait(lock);
+		if( !m_bQueued )
+			break;
+
+		lock.unlock();
+		RunDList();
+		lock.lock();
+
+		m_bQueued = false;
+		m_doneCond.notify_all();
+	}
+}
@@ -0,0 +1,110 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef _RENDER_THREAD_H_
+#define _RENDER_THREAD_H_
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#define RENDER_THREAD_NUM_VI_REGS	14
+#define RENDER_THREAD_DMEM_SIZE		0x1000
+#define RENDER_THREAD_SAVE_BLOCK	0x1000		// RDRAM saved at once before the list writes to it
+
+/********************************************************************************************************************
+ * Runs the display lists on a thread of its own when the RenderThread option is set. ProcessDList copies what a list
+ * reads from the emulator, the RDRAM, the DMEM with the task and the VI registers, into a snapshot, hands it to the
+ * thread and returns, so the emulation goes on while the list is parsed, transformed and drawn.
+ *
+ * One list is in flight at most. The other entry points of the plugin call Sync first, which waits until the list is
+ * done, so the rest of the plugin never runs at the same time as the thread. Those calls are the sync points: the
+ * frame is presented by UpdateScreen after its list is complete. When the frame buffer emulation writes the frames
+ * back to RDRAM the lists are run on the emulator thread, the game reads what is drawn there.
+ *
+ * The game waits for the DP interrupt of the full sync ending a list, the emulator is not thread safe so ProcessDList
+ * raises it. The list is walked first to know whether it has one, a list the walk cannot tell about is run on the
+ * emulator thread.
+ *
+ * The list writes to the RDRAM of the snapshot: the z buffer clears, the render texture fills, the texture rectangles
+ * copied to the frame buffer and the frames the frame buffer emulation stores. Those writes call AddWrite first, which
+ * saves the snapshot of the blocks written, and Sync copies the written ranges back to the RDRAM of the emulator. A
+ * word the emulation has written since the snapshot, found by comparing it with the saved block, keeps the value of
+ * the emulation: the game wrote it after the list ran. Only when the game writes back the very value the word had at
+ * the snapshot does the list's value win.
+ *
+ * The cost is one copy of RDRAM for each list, 4 or 8 MB, and the copies of the blocks the list writes to. The ranges
+ * a list reads, its commands, vertices, matrices and textures, are only known once it has been parsed.
+ ********************************************************************************************************************/
+class CRenderThread
+{
+public:
+	CRenderThread();
+	~CRenderThread();
+
+	void Start();
+	// Runs the queued list and stops the thread
+	void Stop();
+	bool IsRunning() { return m_thread.joinable(); }
+	bool IsRenderThread() { return IsRunning() && std::this_thread::get_id() == m_thread.get_id(); }
+
+	// Whether the display list of the current task can be run on the thread, walks it for the full sync
+	bool CanProcessDList();
+
+	// Takes the snapshot of the current task and queues it, call Sync before
+	void ProcessDList();
+
+	// Waits until the queued list is done and copies what it wrote to RDRAM
+	void Sync();
+
+	// Called on the thread before the list writes [start, end) of RDRAM, a no-op on the emulator thread
+	void AddWrite(uint32 start, uint32 end);
+
+private:
+	void RenderThread();
+	void RunDList();
+	void CopyWrites();
+
+	struct WriteRange
+	{
+		uint32 start;
+		uint32 end;
+	};
+
+	std::vector<uint8>	m_rdram;
+	std::vector<uint8>	m_saved;		// the blocks of m_rdram the list writes to, before it does
+	std::vector<uint8>	m_bBlockSaved;	// by RENDER_THREAD_SAVE_BLOCK
+	std::vector<uint32>	m_savedBlocks;	// the blocks saved for the last list
+	std::vector<WriteRange>	m_writes;	// the ranges of RDRAM the last list wrote, copied back by Sync
+	bool				m_bFullSync;	// the queued list ends with a full sync
+	uint8				m_dmem[RENDER_THREAD_DMEM_SIZE];
+	uint32				m_viRegs[RENDER_THREAD_NUM_VI_REGS];
+	GFX_INFO			m_info;			// g_GraphicsInfo with the memory and VI registers of the snapshot
+
+	std::mutex				m_mutex;
+	std::condition_variable	m_cond;			// signals a queued list to the thread
+	std::condition_variable	m_doneCond;		// signals the end of the list to Sync()
+	std::thread				m_thread;
+	bool					m_bQueued;
+	bool					m_bStop;
+};
+
+extern CRenderThread gRenderThread;
+
+#endif
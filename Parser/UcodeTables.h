@@ -0,0 +1,452 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+// The handlers of gNormalInstruction in ucode.h, one table per GBIVersion up to MAX_UCODE_TABLE.
+// This file is the body of an initializer, included with UCODE(name) defined: ucode.h takes the
+// handlers themselves, Tools/DListAnalyzer their names. So it has no include guard.
+
+	// uCode 0 - RSP SW 2.0X
+	// Games: Super Mario 64, Tetrisphere, Demos
+	{
+		UCODE(RSP_GBI1_SpNoop), UCODE(RSP_GBI1_Mtx), UCODE(RSP_GBI1_Reserved), UCODE(RSP_GBI1_MoveMem),
+		UCODE(RSP_GBI0_Vtx), UCODE(RSP_GBI1_Reserved), UCODE(RSP_GBI1_DL), UCODE(RSP_GBI1_Reserved),
+		UCODE(RSP_GBI1_Reserved), UCODE(RSP_GBI_Sprite2DBase), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//10
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//20
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//30
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//40
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//50
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//60
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//70
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+
+		//80
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//90
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//a0
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//b0
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_GBI0_Tri4), UCODE(RSP_GBI1_RDPHalf_Cont), UCODE(RSP_GBI1_RDPHalf_2),
+		UCODE(RSP_GBI1_RDPHalf_1), UCODE(RSP_GBI1_Line3D), UCODE(RSP_GBI1_GeometryMode), UCODE(RSP_GBI1_GeometryMode),
+		UCODE(RSP_GBI1_EndDL), UCODE(RSP_GBI1_SetOtherModeL), UCODE(RSP_GBI1_SetOtherModeH), UCODE(RSP_GBI1_Texture),
+		UCODE(RSP_GBI1_MoveWord), UCODE(RSP_GBI1_PopMtx), UCODE(RSP_GBI1_CullDL), UCODE(RSP_GBI1_Tri1),
+
+		//c0
+		UCODE(RSP_GBI1_Noop), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP),
+		UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP),
+		//d0
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//e0
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(DLParser_TexRect), UCODE(DLParser_TexRectFlip), UCODE(DLParser_RDPLoadSync), UCODE(DLParser_RDPPipeSync),
+		UCODE(DLParser_RDPTileSync), UCODE(DLParser_RDPFullSync), UCODE(DLParser_SetKeyGB), UCODE(DLParser_SetKeyR),
+		UCODE(DLParser_SetConvert), UCODE(DLParser_SetScissor), UCODE(DLParser_SetPrimDepth), UCODE(DLParser_RDPSetOtherMode),
+		//f0
+		UCODE(DLParser_LoadTLut), UCODE(RSP_RDP_Nothing), UCODE(DLParser_SetTileSize), UCODE(DLParser_LoadBlock),
+		UCODE(DLParser_LoadTile), UCODE(DLParser_SetTile), UCODE(DLParser_FillRect), UCODE(DLParser_SetFillColor),
+		UCODE(DLParser_SetFogColor), UCODE(DLParser_SetBlendColor), UCODE(DLParser_SetPrimColor), UCODE(DLParser_SetEnvColor),
+		UCODE(DLParser_SetCombine), UCODE(DLParser_SetTImg), UCODE(DLParser_SetZImg), UCODE(DLParser_SetCImg)
+	},
+	// uCode 1 - F3DEX 1.XX
+	// 00-3f
+	// games: Mario Kart, Star Fox
+	{
+		UCODE(RSP_GBI1_SpNoop), UCODE(RSP_GBI1_Mtx), UCODE(RSP_GBI1_Reserved), UCODE(RSP_GBI1_MoveMem),
+		UCODE(RSP_GBI1_Vtx), UCODE(RSP_GBI1_Reserved), UCODE(RSP_GBI1_DL), UCODE(RSP_GBI1_Reserved),
+		UCODE(RSP_GBI1_Reserved), UCODE(RSP_GBI_Sprite2DBase), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//10
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//20
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//30
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		// 40
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//50
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//60
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//70
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+
+		//80
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//90
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//a0
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_GBI1_LoadUCode),
+		//b0
+		UCODE(RSP_GBI1_BranchZ), UCODE(RSP_GBI1_Tri2), UCODE(RSP_GBI1_ModifyVtx), UCODE(RSP_GBI1_RDPHalf_2),
+		UCODE(RSP_GBI1_RDPHalf_1), UCODE(RSP_GBI1_Line3D), UCODE(RSP_GBI1_GeometryMode), UCODE(RSP_GBI1_GeometryMode),
+		UCODE(RSP_GBI1_EndDL), UCODE(RSP_GBI1_SetOtherModeL), UCODE(RSP_GBI1_SetOtherModeH), UCODE(RSP_GBI1_Texture),
+		UCODE(RSP_GBI1_MoveWord), UCODE(RSP_GBI1_PopMtx), UCODE(RSP_GBI1_CullDL), UCODE(RSP_GBI1_Tri1),
+
+		//c0
+		UCODE(RSP_GBI1_Noop), UCODE(RSP_S2DEX_SPObjLoadTxtr), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP),
+		UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP),
+		//d0
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//e0
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(DLParser_TexRect), UCODE(DLParser_TexRectFlip), UCODE(DLParser_RDPLoadSync), UCODE(DLParser_RDPPipeSync),
+		UCODE(DLParser_RDPTileSync), UCODE(DLParser_RDPFullSync), UCODE(DLParser_SetKeyGB), UCODE(DLParser_SetKeyR),
+		UCODE(DLParser_SetConvert), UCODE(DLParser_SetScissor), UCODE(DLParser_SetPrimDepth), UCODE(DLParser_RDPSetOtherMode),
+		//f0
+		UCODE(DLParser_LoadTLut), UCODE(RSP_RDP_Nothing), UCODE(DLParser_SetTileSize), UCODE(DLParser_LoadBlock),
+		UCODE(DLParser_LoadTile), UCODE(DLParser_SetTile), UCODE(DLParser_FillRect), UCODE(DLParser_SetFillColor),
+		UCODE(DLParser_SetFogColor), UCODE(DLParser_SetBlendColor), UCODE(DLParser_SetPrimColor), UCODE(DLParser_SetEnvColor),
+		UCODE(DLParser_SetCombine), UCODE(DLParser_SetTImg), UCODE(DLParser_SetZImg), UCODE(DLParser_SetCImg)
+	},
+
+	// Ucode:F3DEX_GBI_2
+	// Zelda and new games
+	{
+		UCODE(RSP_GBI1_Noop), UCODE(RSP_GBI2_Vtx), UCODE(RSP_GBI1_ModifyVtx), UCODE(RSP_GBI1_CullDL),
+		UCODE(RSP_GBI1_BranchZ), UCODE(RSP_GBI2_Tri1), UCODE(RSP_GBI2_Tri2), UCODE(RSP_GBI2_Line3D),
+		UCODE(RSP_GBI2_0x8), UCODE(RSP_S2DEX_BG_1CYC), UCODE(RSP_S2DEX_BG_COPY), UCODE(RSP_S2DEX_OBJ_RENDERMODE),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//10
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//20
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//30
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//40
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//50
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//60
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//70
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+
+		//80
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//90
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//a0
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_GBI1_LoadUCode),
+		//b0
+		UCODE(RSP_GBI1_BranchZ), UCODE(RSP_GBI0_Tri4), UCODE(RSP_GBI1_ModifyVtx), UCODE(RSP_GBI1_RDPHalf_2),
+		UCODE(RSP_GBI1_RDPHalf_1), UCODE(RSP_GBI1_Line3D), UCODE(RSP_GBI1_GeometryMode), UCODE(RSP_GBI1_GeometryMode),
+		UCODE(RSP_GBI1_EndDL), UCODE(RSP_GBI1_SetOtherModeL), UCODE(RSP_GBI1_SetOtherModeH), UCODE(RSP_GBI1_Texture),
+		UCODE(RSP_GBI1_MoveWord), UCODE(RSP_GBI1_PopMtx), UCODE(RSP_GBI1_CullDL), UCODE(RSP_GBI1_Tri1),
+
+		//c0
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP),
+		UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP),
+		//d0
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_GBI2_DL_Count), UCODE(RSP_GBI2_SubModule), UCODE(RSP_GBI2_Texture),
+		UCODE(RSP_GBI2_PopMtx), UCODE(RSP_GBI2_GeometryMode), UCODE(RSP_GBI2_Mtx), UCODE(RSP_GBI2_MoveWord),
+		UCODE(RSP_GBI2_MoveMem), UCODE(RSP_GBI1_LoadUCode), UCODE(RSP_GBI1_DL), UCODE(RSP_GBI1_EndDL),
+		//e0
+		UCODE(RSP_GBI1_SpNoop), UCODE(RSP_GBI1_RDPHalf_1), UCODE(RSP_GBI2_SetOtherModeL), UCODE(RSP_GBI2_SetOtherModeH),
+		UCODE(DLParser_TexRect), UCODE(DLParser_TexRectFlip), UCODE(DLParser_RDPLoadSync), UCODE(DLParser_RDPPipeSync),
+		UCODE(DLParser_RDPTileSync), UCODE(DLParser_RDPFullSync), UCODE(DLParser_SetKeyGB), UCODE(DLParser_SetKeyR),
+		UCODE(DLParser_SetConvert), UCODE(DLParser_SetScissor), UCODE(DLParser_SetPrimDepth), UCODE(DLParser_RDPSetOtherMode),
+		//f0
+		UCODE(DLParser_LoadTLut), UCODE(RSP_RDP_Nothing), UCODE(DLParser_SetTileSize), UCODE(DLParser_LoadBlock),
+		UCODE(DLParser_LoadTile), UCODE(DLParser_SetTile), UCODE(DLParser_FillRect), UCODE(DLParser_SetFillColor),
+		UCODE(DLParser_SetFogColor), UCODE(DLParser_SetBlendColor), UCODE(DLParser_SetPrimColor), UCODE(DLParser_SetEnvColor),
+		UCODE(DLParser_SetCombine), UCODE(DLParser_SetTImg), UCODE(DLParser_SetZImg), UCODE(DLParser_SetCImg)
+	},
+
+	// Ucode: S2DEX 1.--
+	// Games: Yoshi's Story
+	{
+		UCODE(RSP_GBI1_SpNoop), UCODE(RSP_S2DEX_BG_1CYC_2), UCODE(RSP_S2DEX_BG_COPY), UCODE(RSP_S2DEX_OBJ_RECTANGLE),
+		UCODE(RSP_S2DEX_OBJ_SPRITE), UCODE(RSP_S2DEX_OBJ_MOVEMEM), UCODE(RSP_GBI1_DL), UCODE(RSP_GBI1_Reserved),
+		UCODE(RSP_GBI1_Reserved), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+
+		//10
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//20
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//30
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//40
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//50
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//60
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//70
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+
+		//80
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//90
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//a0
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_GBI1_LoadUCode),
+		//b0
+		UCODE(RSP_S2DEX_SELECT_DL), UCODE(RSP_S2DEX_OBJ_RENDERMODE_2), UCODE(RSP_S2DEX_OBJ_RECTANGLE_R), UCODE(RSP_GBI1_RDPHalf_2),
+		UCODE(RSP_GBI1_RDPHalf_1), UCODE(RSP_GBI1_Line3D), UCODE(RSP_GBI1_GeometryMode), UCODE(RSP_GBI1_GeometryMode),
+		UCODE(RSP_GBI1_EndDL), UCODE(RSP_GBI1_SetOtherModeL), UCODE(RSP_GBI1_SetOtherModeH), UCODE(RSP_GBI1_Texture),
+		UCODE(RSP_GBI1_MoveWord), UCODE(RSP_GBI1_PopMtx), UCODE(RSP_GBI1_CullDL), UCODE(RSP_GBI1_Tri1),
+
+		//c0
+		UCODE(RSP_GBI1_Noop), UCODE(RSP_S2DEX_SPObjLoadTxtr), UCODE(RSP_S2DEX_SPObjLoadTxSprite), UCODE(RSP_S2DEX_SPObjLoadTxRect),
+		UCODE(RSP_S2DEX_SPObjLoadTxRectR), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP),
+		UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP),
+		//d0
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//e0
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_S2DEX_RDPHALF_0), UCODE(DLParser_TexRectFlip), UCODE(DLParser_RDPLoadSync), UCODE(DLParser_RDPPipeSync),
+		UCODE(DLParser_RDPTileSync), UCODE(DLParser_RDPFullSync), UCODE(DLParser_SetKeyGB), UCODE(DLParser_SetKeyR),
+		UCODE(DLParser_SetConvert), UCODE(DLParser_SetScissor), UCODE(DLParser_SetPrimDepth), UCODE(DLParser_RDPSetOtherMode),
+		//f0
+		UCODE(DLParser_LoadTLut), UCODE(RSP_RDP_Nothing), UCODE(DLParser_SetTileSize), UCODE(DLParser_LoadBlock),
+		UCODE(DLParser_LoadTile), UCODE(DLParser_SetTile), UCODE(DLParser_FillRect), UCODE(DLParser_SetFillColor),
+		UCODE(DLParser_SetFogColor), UCODE(DLParser_SetBlendColor), UCODE(DLParser_SetPrimColor), UCODE(DLParser_SetEnvColor),
+		UCODE(DLParser_SetCombine), UCODE(DLParser_SetTImg), UCODE(DLParser_SetZImg), UCODE(DLParser_SetCImg)
+	},
+
+	// Ucode: S2DEX 2.--
+	// Games: Neon Evangelion, Kirby
+	{
+		UCODE(RSP_GBI1_Noop), UCODE(RSP_S2DEX_OBJ_RECTANGLE), UCODE(RSP_S2DEX_OBJ_SPRITE), UCODE(RSP_GBI1_CullDL),
+		UCODE(RSP_S2DEX_SELECT_DL), UCODE(RSP_S2DEX_SPObjLoadTxtr), UCODE(RSP_S2DEX_SPObjLoadTxSprite), UCODE(RSP_S2DEX_SPObjLoadTxRect),
+		UCODE(RSP_S2DEX_SPObjLoadTxRectR), UCODE(RSP_S2DEX_BG_1CYC), UCODE(RSP_S2DEX_BG_COPY), UCODE(RSP_S2DEX_OBJ_RENDERMODE),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+
+		//10
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//20
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//30
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//40
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//50
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//60
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//70
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//80
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//90
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//a0
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//b0
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		//c0
+		UCODE(RSP_GBI1_Noop), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP),
+		UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP), UCODE(DLParser_TriRSP),
+		//d0
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing), UCODE(RSP_RDP_Nothing),
+		UCODE(RSP_RDP_Nothing), UCODE(RSP_GBI2_DL_Count), UCODE(RSP_GBI2_SubModule), UCODE(RSP_GBI2_Texture),
+		UCODE(RSP_GBI2_PopMtx), UCODE(RSP_GBI2_GeometryMode), UCODE(RSP_S2DEX_OBJ_RECTANGLE_R), UCODE(RSP_GBI2_MoveWord),
+		UCODE(RSP_GBI2_MoveMem), UCODE(RSP_GBI1_LoadUCode), UCODE(RSP_GBI1_DL), UCODE(RSP_GBI1_EndDL),
+		//e0
+		UCODE(RSP_GBI1_SpNoop), UCODE(RSP_GBI1_RDPHalf_1), UCODE(RSP_GBI2_SetOtherModeL), UCODE(RSP_GBI2_SetOtherModeH),
+		UCODE(DLParser_TexRect), UCODE(DLParser_TexRectFlip), UCODE(DLParser_RDPLoadSync), UCODE(DLParser_RDPPipeSync),
+		UCODE(DLParser_RDPTileSync), UCODE(DLParser_RDPFullSync), UCODE(DLParser_SetKeyGB), UCODE(DLParser_SetKeyR),
+		UCODE(DLParser_SetConvert), UCODE(DLParser_SetScissor), UCODE(DLParser_SetPrimDepth), UCODE(DLParser_RDPSetOtherMode),
+		//f0
+		UCODE(DLParser_LoadTLut), UCODE(RSP_RDP_Nothing), UCODE(DLParser_SetTileSize), UCODE(DLParser_LoadBlock),
+		UCODE(DLParser_LoadTile), UCODE(DLParser_SetTile), UCODE(DLParser_FillRect), UCODE(DLParser_SetFillColor),
+		UCODE(DLParser_SetFogColor), UCODE(DLParser_SetBlendColor), UCODE(DLParser_SetPrimColor), UCODE(DLParser_SetEnvColor),
+		UCODE(DLParser_SetCombine), UCODE(DLParser_SetTImg), UCODE(DLParser_SetZImg), UCODE(DLParser_SetCImg)
+	},
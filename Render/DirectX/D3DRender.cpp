@@ -25,12 +25,32 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 const int d3d_bias_factor = 4;
 
+#define MAX_BATCHED_VERTICES	(3*10000)
+
+// Clipped triangles of the RenderFlushTris calls since the last device state change
+static std::vector<TLITVERTEX> s_batchedTris;
+
+void FlushBatchedTriangles(void)
+{
+	if( s_batchedTris.empty() || g_pD3DDev == NULL )
+		return;
+
+	g_pD3DDev->SetFVF(RICE_FVF_TLITVERTEX);
+	g_pD3DDev->DrawPrimitiveUP(D3DPT_TRIANGLELIST, (UINT)s_batchedTris.size()/3, &s_batchedTris[0], sizeof(TLITVERTEX));
+	s_batchedTris.clear();
+}
+
 //*****************************************************************************
 // Creator function for singleton
 //*****************************************************************************
 D3DRender::D3DRender()
 {
 	m_Mux = 0;
+
+	//Create the pixel shader, where going to assume the user has support for this
+	m_pColorCombiner = new CDirectXPixelShaderCombiner(this);
+	//Inititalize the pixel shader combiner
+	m_pColorCombiner->Initialize();
 }
 
 D3DRender::~D3DRender()
@@ -41,6 +61,8 @@ D3DRender::~D3DRender()
 
 bool D3DRender::ClearDeviceObjects()
 {
+	s_batchedTris.clear();
+
 	for( int i=0; i<MAX_TEXTURES; i++)
 	{
 		if (g_textures[i].m_lpsTexturePtr)		// We keep a reference to the most recently selected texture
@@ -96,6 +118,7 @@ bool D3DRender::InitDeviceObjects()
 	m_Mux = 0;
 
 	gD3DDevWrapper.Initalize();
+	gRDP.dirtyStates = RDP_DIRTY_ALL;
 
 	for(int i = 0; i < 8; i++) 
 	{ 
@@ -105,10 +128,10 @@ bool D3DRender::InitDeviceObjects()
 		if(options.bMipMaps)
 		{
 			D3DSetMipFilter( i, D3DTEXF_LINEAR );
-			g_pD3DDev->SetSamplerState(i, D3DSAMP_MIPMAPLODBIAS, 10);
+			gD3DDevWrapper.SetSamplerState(i, D3DSAMP_MIPMAPLODBIAS, 10);
 		}
-		g_pD3DDev->SetSamplerState(i, D3DSAMP_ADDRESSU, D3DTADDRESS_WRAP ); 
-		g_pD3DDev->SetSamplerState(i, D3DSAMP_ADDRESSV, D3DTADDRESS_WRAP ); 
+		gD3DDevWrapper.SetSamplerState(i, D3DSAMP_ADDRESSU, D3DTADDRESS_WRAP ); 
+		gD3DDevWrapper.SetSamplerState(i, D3DSAMP_ADDRESSV, D3DTADDRESS_WRAP ); 
 		
 
 		gD3DDevWrapper.SetTextureStageState( i, D3DTSS_COLORARG1, D3DTA_TEXTURE ); 
@@ -133,6 +156,7 @@ bool D3DRender::InitDeviceObjects()
 	clippingstatus.ClipIntersection = 0xFFFFFFFF;
 	g_pD3DDev->SetClipStatus(&clippingstatus);
 	g_pD3DDev->GetClipStatus(&clippingstatus);
+	FlushBatchedTriangles();
 	g_pD3DDev->SetRenderState(D3DRS_CLIPPING, TRUE);
 
 	return true;	
@@ -140,6 +164,7 @@ bool D3DRender::InitDeviceObjects()
 
 bool D3DRender::RenderTexRect()
 {
+	FlushBatchedTriangles();
 	gD3DDevWrapper.SetRenderState(D3DRS_DEPTHBIAS,0);
 	uint16 wIndices[2*3] = {1,0,2, 2,0,3};
 	g_pD3DDev->SetFVF(RICE_FVF_TLITVERTEX);
@@ -154,6 +179,7 @@ bool D3DRender::RenderFillRect(uint32 dwColor, float depth)
 								{m_fillRectVtx[0].x, m_fillRectVtx[1].y, depth, 1, dwColor}  };
 	static uint16 wIndices[2*3] = {1,0,2, 2,0,3};
 
+	FlushBatchedTriangles();
 	gD3DDevWrapper.SetRenderState(D3DRS_DEPTHBIAS,0);
 	g_pD3DDev->SetFVF(RICE_FVF_FILLRECTVERTEX);
 	return S_OK == g_pD3DDev->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST, 0, 4, 2, wIndices, D3DFMT_INDEX16, frv, sizeof(FILLRECTVERTEX));
@@ -184,10 +210,22 @@ bool D3DRender::RenderFlushTris()
 {
 	ApplyZBias(m_dwZBias);
 
-	g_pD3DDev->SetFVF(RICE_FVF_TLITVERTEX);
 	ClipVertexes();
-	if( g_clippedVtxCount > 0 )
+	if( g_clippedVtxCount <= 0 )
+		return true;
+
+	if( options.bBatchTriangles )
+	{
+		// The device states have not changed since the batched triangles, or they would have been drawn by now
+		if( s_batchedTris.size() + g_clippedVtxCount > MAX_BATCHED_VERTICES )
+			FlushBatchedTriangles();
+		s_batchedTris.insert(s_batchedTris.end(), g_clippedVtxBuffer, g_clippedVtxBuffer+g_clippedVtxCount);
+	}
+	else
+	{
+		g_pD3DDev->SetFVF(RICE_FVF_TLITVERTEX);
 		g_pD3DDev->DrawPrimitiveUP(D3DPT_TRIANGLELIST, g_clippedVtxCount/3, g_clippedVtxBuffer, sizeof(TLITVERTEX));
+	}
 
 	return true;
 }
@@ -201,6 +239,7 @@ bool D3DRender::RenderLine3D()
 
 	static uint16 wIndices[2*3] = {1,0,2, 2,1,3};
 
+	FlushBatchedTriangles();
 	gD3DDevWrapper.SetRenderState(D3DRS_DEPTHBIAS,0);
 	g_pD3DDev->SetFVF(RICE_FVF_FILLRECTVERTEX);
 	HRESULT hr = g_pD3DDev->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST, 0, 4, 2, wIndices, D3DFMT_INDEX16, frv, sizeof(FILLRECTVERTEX));
@@ -217,6 +256,7 @@ void D3DRender::DrawSimple2DTexture(float x0, float y0, float x1, float y1, floa
 	StartDrawSimple2DTexture(x0, y0, x1, y1, u0, v0, u1, v1, dif, z, rhw);
 	
 	uint16 wIndices[2*3] = {1,0,2, 2,0,3};
+	FlushBatchedTriangles();
 	g_pD3DDev->SetFVF(RICE_FVF_TLITVERTEX);
 	g_pD3DDev->DrawIndexedPrimitiveUP( D3DPT_TRIANGLELIST, 0, 4, 2, wIndices, D3DFMT_INDEX16, g_texRectTVtx, sizeof(TLITVERTEX));
 }
@@ -233,6 +273,7 @@ void D3DRender::DrawSimpleRect(LONG nX0, LONG nY0, LONG nX1, LONG nY1, uint32 dw
 
 	static uint16 wIndices[2*3] = {1,0,2, 2,0,3};
 
+	FlushBatchedTriangles();
 	g_pD3DDev->SetFVF(RICE_FVF_FILLRECTVERTEX);
 	g_pD3DDev->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST, 0, 4, 2, wIndices, D3DFMT_INDEX16, frv, sizeof(FILLRECTVERTEX));
 }
@@ -242,14 +283,14 @@ void D3DRender::SetTextureUFlag(int dwFlag, uint32 tile)
 	TileUFlags[tile] = dwFlag;
 	if( gRDP.otherMode.cycle_type  >= CYCLE_TYPE_COPY )
 	{
-		g_pD3DDev->SetSamplerState(0, D3DSAMP_ADDRESSU, dwFlag );
+		gD3DDevWrapper.SetSamplerState(0, D3DSAMP_ADDRESSU, dwFlag );
 	}
 	else
 	{
 		for (uint32_t i = 0; i < nStages; i++)
 		{
 			if (nTextureStages[i] == tile-gRSP.curTile)
-				g_pD3DDev->SetSamplerState(i, D3DSAMP_ADDRESSU, dwFlag);
+				gD3DDevWrapper.SetSamplerState(i, D3DSAMP_ADDRESSU, dwFlag);
 		}
 	}
 }
@@ -259,14 +300,14 @@ void D3DRender::SetTextureVFlag(int dwFlag, uint32 tile)
 	TileVFlags[tile] = dwFlag;
 	if( gRDP.otherMode.cycle_type  >= CYCLE_TYPE_COPY )
 	{
-		g_pD3DDev->SetSamplerState(0, D3DSAMP_ADDRESSV, dwFlag );
+		gD3DDevWrapper.SetSamplerState(0, D3DSAMP_ADDRESSV, dwFlag );
 	}
 	else
 	{
 		for (uint32_t i = 0; i < nStages; i++)
 		{
 			if (nTextureStages[i] == tile - gRSP.curTile)
-				g_pD3DDev->SetSamplerState(i, D3DSAMP_ADDRESSV, dwFlag);
+				gD3DDevWrapper.SetSamplerState(i, D3DSAMP_ADDRESSV, dwFlag);
 		}
 	}
 }
@@ -504,18 +545,21 @@ void D3DRender::SetFogColor(uint32 r, uint32 g, uint32 b, uint32 a)
 void D3DRender::ClearBuffer(bool cbuffer, bool zbuffer)
 {
 	float depth = ((gRDP.originalFillColor&0xFFFF)>>2)/(float)0x3FFF;
+	FlushBatchedTriangles();
 	if( cbuffer ) g_pD3DDev->Clear(0, NULL, D3DCLEAR_TARGET, 0xFF000000, depth, 0);
 	if( zbuffer ) g_pD3DDev->Clear(0, NULL, D3DCLEAR_ZBUFFER, 0xFF000000, depth, 0);
 }
 
 void D3DRender::ClearZBuffer(float depth)
 {
+	FlushBatchedTriangles();
 	g_pD3DDev->Clear(0, NULL, D3DCLEAR_ZBUFFER, 0xFF000000, depth, 0);
 }
 
 void D3DRender::ClearBuffer(bool cbuffer, bool zbuffer, D3DRECT &rect)
 {
 	float depth = ((gRDP.originalFillColor&0xFFFF)>>2)/(float)0x3FFF;
+	FlushBatchedTriangles();
 	if( cbuffer ) g_pD3DDev->Clear(1, &rect, D3DCLEAR_TARGET, 0xFF000000, depth, 0);
 	if( zbuffer ) g_pD3DDev->Clear(1, &rect, D3DCLEAR_ZBUFFER, 0xFF000000, depth, 0);
 }
@@ -609,6 +653,7 @@ void D3DRender::BeginRendering(void)
 void D3DRender::CaptureScreen(char *filename)
 {
 	LPDIRECT3DSURFACE9 surface;
+	FlushBatchedTriangles();
 	g_pD3DDev->GetRenderTarget(0,&surface);
 	D3DXSaveSurfaceToFile(filename,D3DXIFF_BMP,surface,NULL,NULL);
 	surface->Release();
@@ -620,11 +665,11 @@ void D3DRender::D3DSetMinFilter(uint32 dwStage, uint32 filter)
 	if( filter == D3DTEXF_LINEAR && options.DirectXAnisotropyValue > 0 )
 	{
 		// Use Anisotropy filter instead of LINEAR filter
-		g_pD3DDev->SetSamplerState( dwStage, D3DSAMP_MINFILTER, D3DTEXF_ANISOTROPIC  );
-		g_pD3DDev->SetSamplerState( dwStage, D3DSAMP_MAXANISOTROPY, options.DirectXAnisotropyValue );
+		gD3DDevWrapper.SetSamplerState( dwStage, D3DSAMP_MINFILTER, D3DTEXF_ANISOTROPIC  );
+		gD3DDevWrapper.SetSamplerState( dwStage, D3DSAMP_MAXANISOTROPY, options.DirectXAnisotropyValue );
 	}
 	else
-		g_pD3DDev->SetSamplerState( dwStage, D3DSAMP_MINFILTER, filter );
+		gD3DDevWrapper.SetSamplerState( dwStage, D3DSAMP_MINFILTER, filter );
 }
 
 void D3DRender::D3DSetMagFilter(uint32 dwStage, uint32 filter)
@@ -632,11 +677,11 @@ void D3DRender::D3DSetMagFilter(uint32 dwStage, uint32 filter)
 	if( filter == D3DTEXF_LINEAR && options.DirectXAnisotropyValue > 0 )
 	{
 		// Use Anisotropy filter instead of LINEAR filter
-		g_pD3DDev->SetSamplerState( dwStage, D3DSAMP_MAGFILTER, D3DTEXF_ANISOTROPIC  );
-		g_pD3DDev->SetSamplerState( dwStage, D3DSAMP_MAXANISOTROPY, options.DirectXAnisotropyValue);
+		gD3DDevWrapper.SetSamplerState( dwStage, D3DSAMP_MAGFILTER, D3DTEXF_ANISOTROPIC  );
+		gD3DDevWrapper.SetSamplerState( dwStage, D3DSAMP_MAXANISOTROPY, options.DirectXAnisotropyValue);
 	}
 	else
-		g_pD3DDev->SetSamplerState( dwStage, D3DSAMP_MAGFILTER, filter );
+		gD3DDevWrapper.SetSamplerState( dwStage, D3DSAMP_MAGFILTER, filter );
 }
 
 void D3DRender::D3DSetMipFilter(uint32 dwStage, uint32 filter)
@@ -644,9 +689,9 @@ void D3DRender::D3DSetMipFilter(uint32 dwStage, uint32 filter)
 	if( filter == D3DTEXF_LINEAR && options.DirectXAnisotropyValue > 0 )
 	{
 		// Use Anisotropy filter instead of LINEAR filter
-		g_pD3DDev->SetSamplerState( dwStage, D3DSAMP_MIPFILTER, D3DTEXF_ANISOTROPIC  );
-		g_pD3DDev->SetSamplerState( dwStage, D3DSAMP_MAXANISOTROPY, options.DirectXAnisotropyValue );
+		gD3DDevWrapper.SetSamplerState( dwStage, D3DSAMP_MIPFILTER, D3DTEXF_ANISOTROPIC  );
+		gD3DDevWrapper.SetSamplerState( dwStage, D3DSAMP_MAXANISOTROPY, options.DirectXAnisotropyValue );
 	}
 	else
-		g_pD3DDev->SetSamplerState( dwStage, D3DSAMP_MIPFILTER, filter );
+		gD3DDevWrapper.SetSamplerState( dwStage, D3DSAMP_MIPFILTER, filter );
 }
\ No newline at end of file
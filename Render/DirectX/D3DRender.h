@@ -30,6 +30,9 @@ class ofstream;
 extern LPDIRECT3DDEVICE9 g_pD3DDev;
 extern CD3DDevWrapper    gD3DDevWrapper;
 
+// Draws the triangles batched by RenderFlushTris, before anything which changes the device or reads what it has drawn
+void FlushBatchedTriangles(void);
+
 class D3DRender : public CRender
 {
 
@@ -49,6 +52,7 @@ public:
 			CRender::gRenderReferenceCount--;
 			if( CRender::gRenderReferenceCount == 0 )
 			{
+				FlushBatchedTriangles();
 				g_pD3DDev->EndScene(); 
 			}
 		}
@@ -110,6 +114,7 @@ protected:
 
 	// Basic render drawing functions
 	bool RenderFlushTris();
+	void FlushBatchedTris() { FlushBatchedTriangles(); }
 	bool RenderTexRect();
 	bool RenderFillRect(uint32 dwColor, float depth);
 	bool RenderLine3D();
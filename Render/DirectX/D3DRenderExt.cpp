@@ -33,6 +33,7 @@ static uint32 dwSavedMagFilter = 0;
 void D3DRender::DrawSpriteR_Render()	// With Rotation
 {
 	uint16 wIndices[2*3] = {1,0,2, 2,0,3};
+	FlushBatchedTriangles();
 	g_pD3DDev->SetFVF(RICE_FVF_TLITVERTEX);
 	g_pD3DDev->DrawIndexedPrimitiveUP( D3DPT_TRIANGLELIST, 0, 4, 2, wIndices, D3DFMT_INDEX16, g_texRectTVtx, sizeof(TLITVERTEX));
 }
@@ -57,6 +58,7 @@ void D3DRender::DrawObjBGCopy(uObjBg &info)
 	{
 #ifndef SUPPORT_LOCKABLE_ZBUFFER
 #ifndef SUPPORT_ZBUFFER_IMG
+		FlushBatchedTriangles();
 		g_pD3DDev->Clear(0, NULL, D3DCLEAR_ZBUFFER, 0, 1.0, 0);	//Check me
 		LOG_UCODE("    Clearing ZBuffer by using ZeldaBG");
 #else
@@ -112,6 +114,7 @@ void D3DRender::DrawObjBGCopy(uObjBg &info)
 		{
 			if( IsResultGood(g_pD3DDev->CreateDepthStencilSurface(windowSetting.uDisplayWidth, windowSetting.uDisplayHeight, D3DFMT_D16_LOCKABLE, D3DMULTISAMPLE_NONE, &g_pLockableBackBuffer)) && g_pLockableBackBuffer )
 			{
+				FlushBatchedTriangles();
 				g_pD3DDev->SetRenderTarget(NULL, g_pLockableBackBuffer);
 				TRACE0("Created and use lockable depth buffer");
 			}
@@ -188,6 +191,8 @@ void D3DRender::FinishSpriteDraw(LPD3DXSPRITE d3dSprite)
 
 LPD3DXSPRITE D3DRender::InitSpriteDraw(void)
 {
+	FlushBatchedTriangles();
+	gRDP.dirtyStates |= RDP_DIRTY_RENDER;
 	gD3DDevWrapper.SetTextureStageState( 1, D3DTSS_COLOROP, D3DTOP_DISABLE );
 	gD3DDevWrapper.SetTextureStageState( 1, D3DTSS_ALPHAOP, D3DTOP_DISABLE );
 
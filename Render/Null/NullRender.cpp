@@ -0,0 +1,246 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "../../stdafx.h"
+
+NullRenderCounters gNullRenderCounters;
+
+CNullRender::CNullRender()
+{
+	m_Mux = 0;
+	memset(&gNullRenderCounters, 0, sizeof(gNullRenderCounters));
+
+	m_pColorCombiner = new CNullColorCombiner(this);
+	m_pColorCombiner->Initialize();
+}
+
+CNullRender::~CNullRender()
+{
+	ClearDeviceObjects();
+}
+
+bool CNullRender::ClearDeviceObjects()
+{
+	return true;
+}
+
+bool CNullRender::InitDeviceObjects()
+{
+	m_Mux = 0;
+	m_pColorCombiner->Initialize();
+	status.curScissor = UNKNOWN_SCISSOR;
+	return true;
+}
+
+bool CNullRender::RenderFlushTris()
+{
+	// the clipper is part of the CPU side being measured
+	ClipVertexes();
+	NULL_RENDER_COUNT(numFlushes, 1);
+	NULL_RENDER_COUNT(numTriangles, g_clippedVtxCount/3);
+	return true;
+}
+
+bool CNullRender::RenderTexRect()
+{
+	NULL_RENDER_COUNT(numTexRects, 1);
+	return true;
+}
+
+bool CNullRender::RenderFillRect(uint32 dwColor, float depth)
+{
+	NULL_RENDER_COUNT(numFillRects, 1);
+	return true;
+}
+
+bool CNullRender::RenderLine3D()
+{
+	NULL_RENDER_COUNT(numLines, 1);
+	return true;
+}
+
+void CNullRender::DrawSimple2DTexture(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, D3DCOLOR dif, float z, float rhw)
+{
+	StartDrawSimple2DTexture(x0, y0, x1, y1, u0, v0, u1, v1, dif, z, rhw);
+	NULL_RENDER_COUNT(numSimple2DTextures, 1);
+}
+
+void CNullRender::SetZBias(int bias)
+{
+	if (m_dwZBias != bias)
+	{
+		m_dwZBias = bias;
+		NULL_RENDER_COUNT(numStateChanges, 1);
+	}
+}
+
+void CNullRender::SetTextureUFlag(int dwFlag, uint32 tile)
+{
+	TileUFlags[tile] = dwFlag;
+	NULL_RENDER_COUNT(numStateChanges, 1);
+}
+
+void CNullRender::SetTextureVFlag(int dwFlag, uint32 tile)
+{
+	TileVFlags[tile] = dwFlag;
+	NULL_RENDER_COUNT(numStateChanges, 1);
+}
+
+void CNullRender::ZBufferEnable(BOOL bZBuffer)
+{
+	SetZCompare(bZBuffer);
+	SetZUpdate(bZBuffer);
+}
+
+void CNullRender::SetZCompare(BOOL bZCompare)
+{
+	gRDP.tnl.Zbuffer = bZCompare;
+	m_bZCompare = bZCompare;
+	NULL_RENDER_COUNT(numStateChanges, 1);
+}
+
+void CNullRender::SetZUpdate(BOOL bZUpdate)
+{
+	m_bZUpdate = bZUpdate;
+	NULL_RENDER_COUNT(numStateChanges, 1);
+}
+
+void CNullRender::SetShadeMode(RenderShadeMode mode)
+{
+	if (gRSP.shadeMode != mode)
+	{
+		gRSP.shadeMode = mode;
+		NULL_RENDER_COUNT(numStateChanges, 1);
+	}
+}
+
+void CNullRender::SetAlphaRef(uint32 dwAlpha)
+{
+	if (m_dwAlpha != dwAlpha)
+	{
+		m_dwAlpha = dwAlpha;
+		NULL_RENDER_COUNT(numStateChanges, 1);
+	}
+}
+
+void CNullRender::ForceAlphaRef(uint32 dwAlpha)
+{
+	NULL_RENDER_COUNT(numStateChanges, 1);
+}
+
+bool CNullRender::SetCurrentTexture(int tile, CTexture *handler, uint32 dwTileWidth, uint32 dwTileHeight, TxtrCacheEntry *pTextureEntry)
+{
+	RenderTexture &texture = g_textures[tile];
+	texture.pTextureEntry = pTextureEntry;
+
+	if( handler != NULL && texture.m_pCTexture != handler )
+	{
+		texture.m_pCTexture = handler;
+		texture.m_dwTileWidth = dwTileWidth;
+		texture.m_dwTileHeight = dwTileHeight;
+
+		if( handler->m_bIsEnhancedTexture )
+		{
+			texture.m_fTexWidth = (float)pTextureEntry->pTexture->m_dwCreatedTextureWidth;
+			texture.m_fTexHeight = (float)pTextureEntry->pTexture->m_dwCreatedTextureHeight;
+		}
+		else
+		{
+			texture.m_fTexWidth = (float)handler->m_dwCreatedTextureWidth;
+			texture.m_fTexHeight = (float)handler->m_dwCreatedTextureHeight;
+		}
+
+		NULL_RENDER_COUNT(numTextureChanges, 1);
+	}
+
+	return true;
+}
+
+bool CNullRender::SetCurrentTexture(int tile, TxtrCacheEntry *pEntry)
+{
+	if (pEntry != NULL && pEntry->pTexture != NULL)
+	{
+		if(pEntry->pEnhancedTexture != NULL)
+			SetCurrentTexture( tile, pEntry->pEnhancedTexture,pEntry->ti.WidthToCreate, pEntry->ti.HeightToCreate, pEntry);
+		else
+			SetCurrentTexture( tile, pEntry->pTexture,pEntry->ti.WidthToCreate, pEntry->ti.HeightToCreate, pEntry);
+		return true;
+	}
+	else
+	{
+		SetCurrentTexture( tile, NULL, 64, 64, NULL );
+		return false;
+	}
+}
+
+void CNullRender::SetFillMode(FillMode mode)
+{
+	NULL_RENDER_COUNT(numStateChanges, 1);
+}
+
+void CNullRender::SetAlphaTestEnable(BOOL bAlphaTestEnable)
+{
+	NULL_RENDER_COUNT(numStateChanges, 1);
+}
+
+void CNullRender::SetFogMinMax(float fMin, float fMax)
+{
+	NULL_RENDER_COUNT(numStateChanges, 1);
+}
+
+void CNullRender::TurnFogOnOff(bool flag)
+{
+	NULL_RENDER_COUNT(numStateChanges, 1);
+}
+
+void CNullRender::SetFogEnable(bool bEnable)
+{
+	NULL_RENDER_COUNT(numStateChanges, 1);
+}
+
+void CNullRender::SetFogColor(uint32 r, uint32 g, uint32 b, uint32 a)
+{
+	gRDP.fogColor = COLOR_RGBA(r, g, b, a);
+	NULL_RENDER_COUNT(numStateChanges, 1);
+}
+
+void CNullRender::ClearBuffer(bool cbuffer, bool zbuffer)
+{
+	NULL_RENDER_COUNT(numClears, 1);
+}
+
+void CNullRender::ClearZBuffer(float depth)
+{
+	NULL_RENDER_COUNT(numClears, 1);
+}
+
+void CNullRender::UpdateScissor()
+{
+	UpdateScissorWithClipRatio();
+}
+
+void CNullRender::ApplyRDPScissor(bool force)
+{
+	status.curScissor = RDP_SCISSOR;
+}
+
+void CNullRender::ApplyScissorWithClipRatio(bool force)
+{
+	status.curScissor = RSP_SCISSOR;
+}
@@ -0,0 +1,93 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef __RICE_NULLRENDER_H__
+#define __RICE_NULLRENDER_H__
+
+// What reaches the null render, counted when the CountRenderCalls option is set
+struct NullRenderCounters
+{
+	uint32	numFrames;
+	uint32	numClears;
+	uint32	numFlushes;				// RenderFlushTris calls
+	uint32	numTriangles;			// triangles left after clipping
+	uint32	numTexRects;
+	uint32	numFillRects;
+	uint32	numLines;
+	uint32	numSimple2DTextures;
+	uint32	numTextureChanges;
+	uint32	numCombinerChanges;
+	uint32	numStateChanges;		// depth, alpha, fog, shade, fill mode and texture address states
+};
+
+extern NullRenderCounters gNullRenderCounters;
+
+#define NULL_RENDER_COUNT(counter, n)	{ if( options.bCountRenderCalls ) gNullRenderCounters.counter += (n); }
+
+/********************************************************************************************************************
+ * Render used by the HeadlessRender option, it runs the parser, the vertex pipeline, the clipper and the texture
+ * loading as usual and accepts the draws without a Direct3D device, so the CPU side can be profiled on its own.
+ ********************************************************************************************************************/
+class CNullRender : public CRender
+{
+public:
+	CNullRender();
+	~CNullRender();
+
+	bool InitDeviceObjects();
+	bool ClearDeviceObjects();
+
+	void SetTextureUFlag(int dwFlag, uint32 tile);
+	void SetTextureVFlag(int dwFlag, uint32 tile);
+
+	void SetShadeMode(RenderShadeMode mode);
+	void ZBufferEnable(BOOL bZBuffer);
+	void ClearZBuffer(float depth);
+	void ClearBuffer(bool cbuffer, bool zbuffer);
+
+	void SetZCompare(BOOL bZCompare);
+	void SetZUpdate(BOOL bZUpdate);
+	void SetZBias(int bias);
+	void SetAlphaRef(uint32 dwAlpha);
+	void ForceAlphaRef(uint32 dwAlpha);
+	void SetFillMode(FillMode mode);
+	void SetAlphaTestEnable(BOOL bAlphaTestEnable);
+
+	bool SetCurrentTexture(int tile, CTexture *handler,uint32 dwTileWidth, uint32 dwTileHeight, TxtrCacheEntry *pTextureEntry);
+	bool SetCurrentTexture(int tile, TxtrCacheEntry *pTextureEntry);
+
+	void DrawSimple2DTexture(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, D3DCOLOR dif, float z, float rhw);
+
+	void SetFogMinMax(float fMin, float fMax);
+	void SetFogEnable(bool bEnable);
+	void TurnFogOnOff(bool flag);
+	void SetFogColor(uint32 r, uint32 g, uint32 b, uint32 a);
+	void UpdateScissor();
+	void ApplyRDPScissor(bool force=false);
+	void ApplyScissorWithClipRatio(bool force=false);
+
+protected:
+	// Basic render drawing functions
+	bool RenderFlushTris();
+	bool RenderTexRect();
+	bool RenderFillRect(uint32 dwColor, float depth);
+	bool RenderLine3D();
+};
+
+#endif // __RICE_NULLRENDER_H__
@@ -17,9 +17,12 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 */
 
-#include "..\stdafx.h"
+#include "../stdafx.h"
+#ifdef _WIN32
 #include "BMGDLL.h"
+#endif
 #include "../Utility/util.h"
+#include "../Parser/DLCulling.h"
 
 CRender * CRender::g_pRender=NULL;
 int CRender::gRenderReferenceCount=0;
@@ -52,7 +55,9 @@ CRender::CRender() :
 	m_dwAlpha(0xFF),
 	
 	m_dwMinFilter(D3DTEXF_POINT),
-	m_dwMagFilter(D3DTEXF_POINT)
+	m_dwMagFilter(D3DTEXF_POINT),
+
+	m_pColorCombiner(NULL)
 {
 	int i;
 	InitRenderBase();
@@ -70,11 +75,7 @@ CRender::CRender() :
 		TileUFlags[i] = TileVFlags[i] = D3DTADDRESS_CLAMP;
 	}
 
-	//Create the pixel shader, where going to assume the user has support for this
-	m_pColorCombiner = new CDirectXPixelShaderCombiner(this);
-	//Inititalize the pixel shader combiner
-	m_pColorCombiner->Initialize();
-
+	// The combiner is created by the derived render
 }
 
 CRender::~CRender()
@@ -119,6 +120,7 @@ void CRender::SetProjection(const u32 address, bool bReplace)
 		MatrixMultiplyAligned(&gRSP.mProjectionMat, &gRSP.mTempMat, &gRSP.mProjectionMat);
 	}
 
+	gDListCuller.Uncullable();
 	gRSP.mWorldProjectValid = false;
 }
 
@@ -155,6 +157,7 @@ void CRender::SetWorldView(const u32 address, bool bPush, bool bReplace)
 		}
 	}
 
+	gDListCuller.Uncullable();
 	gRSP.mWorldProjectValid = false;
 }
 
@@ -163,6 +166,7 @@ void CRender::PopWorldView(u32 num)
 {
 	if (gRSP.mModelViewTop > (num - 1))
 	{
+		gDListCuller.Uncullable();
 		gRSP.mModelViewTop -= num;
 
 		gRSP.mWorldProjectValid = false;
@@ -176,12 +180,16 @@ void CRender::SetMux(uint32 dwMux0, uint32 dwMux1)
 	{
 		m_Mux = tempmux;
 		m_pColorCombiner->UpdateCombiner(dwMux0, dwMux1);
+		gRDP.dirtyStates |= RDP_DIRTY_COMBINER;
 	}
 }
 
 
 void CRender::SetCombinerAndBlender()
 {
+	// The draws other than the triangles change more states after this, the triangles set them up again
+	gRDP.dirtyStates |= RDP_DIRTY_RENDER;
+
 	InitOtherModes();
 	
 	CBlender::InitBlenderMode();
@@ -191,8 +199,26 @@ void CRender::SetCombinerAndBlender()
 	ApplyTextureFilter();
 }
 
+void CRender::SetTriangleStates(uint32 dirty)
+{
+	if( dirty & (RDP_DIRTY_OTHERMODE|RDP_DIRTY_RENDER) )
+	{
+		SetCombinerAndBlender();
+	}
+	else
+	{
+		// The othermode, and so the blender, is still as it was set up for the previous triangles
+		m_pColorCombiner->InitCombinerMode();
+		ApplyTextureFilter();
+	}
+
+	gRDP.dirtyStates = 0;
+}
+
 void CRender::RenderReset()
 {
+	gRDP.dirtyStates = RDP_DIRTY_ALL;
+
 	UpdateClipRectangle();
 	SetZBias(0);
 	gRSP.numVertices = 0;
@@ -821,6 +847,7 @@ void CRender::CleanUp(void)
 
 void CRender::SetTextureEnable(bool bEnable)
 {
+	gRDP.dirtyStates |= RDP_DIRTY_TEXTURE;
 	gRSP.bTextureEnabled = bEnable;
 }
 
@@ -830,6 +857,7 @@ void CRender::SetTextureScale(int dwTile,  float fScaleX, float fScaleY)
 	{
 		if( gRSP.curTile != dwTile )
 			gRDP.textureIsChanged = true;
+		gRDP.dirtyStates |= RDP_DIRTY_TEXTURE;
 
 		gRSP.curTile = dwTile;
 
@@ -1336,7 +1364,7 @@ void CRender::SaveTextureToFile(CTexture &texture, char *filename, int width, in
 
 bool SaveRGBABufferToPNGFile(char *filename, unsigned char *buf, int width, int height)
 {
-
+#ifdef _WIN32
 	if (_stricmp(right(filename, 4), ".png") != 0)	strcat(filename, ".png");
 
 	struct BMGImageStruct img;
@@ -1352,4 +1380,8 @@ bool SaveRGBABufferToPNGFile(char *filename, unsigned char *buf, int width, int
 		return true;
 	else
 		return false;
+#else
+	// BMGLib is only built for Windows
+	return false;
+#endif
 }
\ No newline at end of file
@@ -56,7 +56,7 @@ public:
 	
 	inline bool IsTexel0Enable() {return m_pColorCombiner->m_bTex0Enabled;}
 	inline bool IsTexel1Enable() {return m_pColorCombiner->m_bTex1Enabled;}
-	inline bool CRender::IsTextureEnabled() { return (m_pColorCombiner->m_bTex0Enabled||m_pColorCombiner->m_bTex1Enabled); }
+	inline bool IsTextureEnabled() { return (m_pColorCombiner->m_bTex0Enabled||m_pColorCombiner->m_bTex1Enabled); }
 
 	inline RenderTexture& GetCurrentTexture() { return g_textures[gRSP.curTile]; }
 	inline RenderTexture& GetTexture(uint32 dwTile) { return g_textures[dwTile]; }
@@ -112,6 +112,8 @@ public:
 
 	virtual void RenderReset();
 	virtual void SetCombinerAndBlender();
+	// Sets up the states of the next triangles again for the RDP_DIRTY_* bits of what changed since the last ones
+	void SetTriangleStates(uint32 dirty);
 	virtual void SetMux(uint32 dwMux0, uint32 dwMux1);
 	void SetCullMode(bool bCullFront, bool bCullBack)
 	{ gRDP.tnl.TriCull = bCullFront; gRDP.tnl.CullBack = bCullBack; }
@@ -150,6 +152,8 @@ public:
 
 	bool DrawTriangles();
 	virtual bool RenderFlushTris()=0;
+	// Draws the triangles a renderer keeps back from RenderFlushTris, before a texture they may sample is changed
+	virtual void FlushBatchedTris() {}
 
 	bool TexRect(LONG nX0, LONG nY0, LONG nX1, LONG nY1, float fS0, float fT0, float fScaleS, float fScaleT, bool colorFlag=false, uint32 difcolor=0xFFFFFFFF);
 	bool TexRectFlip(LONG nX0, LONG nY0, LONG nX1, LONG nY1, float fS0, float fT0, float fS1, float fT1);
@@ -17,8 +17,21 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 */
 
-#include "..\stdafx.h"
+#include "../stdafx.h"
 #include "float.h"
+#include "../Parser/DLCulling.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define VTX_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+// The lanes of the SSE2 registers are stored to these arrays with aligned stores
+#ifdef _MSC_VER
+#define VTX_ALIGN16	__declspec(align(16))
+#else
+#define VTX_ALIGN16	__attribute__((aligned(16)))
+#endif
 
 #define ENABLE_CLIP_TRI
 #define X_CLIP_MAX	0x1
@@ -28,16 +41,20 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define Z_CLIP_MAX	0x10
 #define Z_CLIP_MIN	0x20
 
-inline void RSP_Vtx_Clipping(int i)
+// The X clip planes are moved out to the sides of the window when the screen is stretched
+inline float GetClipScaleFactor()
+{
+	if(windowSetting.uScreenScaleMode == 1)
+		return (3.0f * windowSetting.uDisplayWidth) / (4.0f * windowSetting.uDisplayHeight);
+	return 1.0f;
+}
+
+inline void RSP_Vtx_Clipping(int i, float scaleFactor)
 {
 	g_vecProjected[i].ClipFlags = 0;
 	if( g_vecProjected[i].ProjectedPos.w > 0 )
 	{
 		{
-			float scaleFactor = 1.0f;
-			if(windowSetting.uScreenScaleMode == 1)
-				scaleFactor = (3.0f * windowSetting.uDisplayWidth) / (4.0f * windowSetting.uDisplayHeight);
-			
 			if(g_vecProjected[i].ProjectedPos.x > scaleFactor)   g_vecProjected[i].ClipFlags |= X_CLIP_MAX;
 			if(g_vecProjected[i].ProjectedPos.x < -scaleFactor)  g_vecProjected[i].ClipFlags |= X_CLIP_MIN;
 			if(g_vecProjected[i].ProjectedPos.y > 1)			 g_vecProjected[i].ClipFlags |= Y_CLIP_MAX;
@@ -93,6 +110,7 @@ void InitRenderBase()
 	gRDP.scissor.right=gRDP.scissor.bottom=640;
 	
 	gRSP.curTile=gRSPnumLights= 0;
+	gRSP.bLightIsUpdated = true;
 	gRDP.fogColor = gRDP.primitiveColor = gRDP.envColor = gRDP.primitiveDepth = gRDP.primLODMin = gRDP.primLODFrac = gRDP.LODFrac = 0;
 	gRDP.fPrimitiveDepth = 0;
 	gRSP.numVertices = 0;
@@ -127,9 +145,12 @@ void InitRenderBase()
 	gRDP.originalFillColor	=0;
 
 	gRDP.textureIsChanged = false;
+	gRDP.dirtyStates = RDP_DIRTY_ALL;
 
 	memset(&gRDP.otherMode,0,sizeof(RDP_OtherMode));
 	memset(&gRDP.tiles,0,sizeof(Tile)*8);
+	memset(gRDP.mTiles, 0, sizeof(gRDP.mTiles));
+	memset(gRDP.mTileSize, 0, sizeof(gRDP.mTileSize));
 }
 
 //*****************************************************************************
@@ -340,9 +361,10 @@ void InitVertex(uint32 dwV, uint32 vtxIndex, bool bTexture)
 		{
 			ComputeLOD();
 		}
-		else
+		else if( gRDP.LODFrac != 0 )
 		{
 			gRDP.LODFrac = 0;
+			gRDP.dirtyStates |= RDP_DIRTY_COMBINER;
 		}
 	}
 
@@ -421,6 +443,420 @@ inline void ReplaceAlphaWithFogFactor(int i)
 	}
 }
 
+// Transforms the positions of the vertices dwV0 to dwV0+dwNum-1 into g_vecProjected, divides them by w and sets
+// their clip flags, as RSP_Vtx_Clipping does. With the primary depth hack the depth is the primitive depth.
+static void TransformVertices(const FiddledVtx *pVtxBase, uint32 dwV0, uint32 dwNum, const Matrix4x4 &mat, bool bDepthHack)
+{
+	float scaleFactor = GetClipScaleFactor();
+
+#ifdef VTX_USE_SSE2
+	// 4 vertices at a time, each lane of a register is a vertex. The sums are in the order of Matrix4x4::Transform
+	// so the results are the same as those of the scalar code.
+	const __m128 m11 = _mm_set1_ps(mat.m11), m12 = _mm_set1_ps(mat.m12), m13 = _mm_set1_ps(mat.m13), m14 = _mm_set1_ps(mat.m14);
+	const __m128 m21 = _mm_set1_ps(mat.m21), m22 = _mm_set1_ps(mat.m22), m23 = _mm_set1_ps(mat.m23), m24 = _mm_set1_ps(mat.m24);
+	const __m128 m31 = _mm_set1_ps(mat.m31), m32 = _mm_set1_ps(mat.m32), m33 = _mm_set1_ps(mat.m33), m34 = _mm_set1_ps(mat.m34);
+	const __m128 m41 = _mm_set1_ps(mat.m41), m42 = _mm_set1_ps(mat.m42), m43 = _mm_set1_ps(mat.m43), m44 = _mm_set1_ps(mat.m44);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 minusOne = _mm_set1_ps(-1.0f);
+	const __m128 scale = _mm_set1_ps(scaleFactor);
+	const __m128 minusScale = _mm_set1_ps(-scaleFactor);
+	const __m128 depth = _mm_set1_ps(gRDP.fPrimitiveDepth);
+
+	for (uint32 n = 0; n < dwNum; n += 4)
+	{
+		uint32 count = min(dwNum - n, 4u);
+		const FiddledVtx *pVtx = pVtxBase + n;
+
+		// The last vertices are copied, not to read past the end of the command's vertices
+		FiddledVtx tail[4];
+		if (count < 4)
+		{
+			memset(tail, 0, sizeof(tail));
+			memcpy(tail, pVtx, count*sizeof(FiddledVtx));
+			pVtx = tail;
+		}
+
+		// y, x, flag and z are the 4 first shorts of each vertex
+		__m128i v0 = _mm_loadl_epi64((const __m128i *)&pVtx[0]);
+		__m128i v1 = _mm_loadl_epi64((const __m128i *)&pVtx[1]);
+		__m128i v2 = _mm_loadl_epi64((const __m128i *)&pVtx[2]);
+		__m128i v3 = _mm_loadl_epi64((const __m128i *)&pVtx[3]);
+		__m128i v01 = _mm_unpacklo_epi32(v0, v1);
+		__m128i v23 = _mm_unpacklo_epi32(v2, v3);
+		__m128i yx = _mm_unpacklo_epi64(v01, v23);
+		__m128i fz = _mm_unpackhi_epi64(v01, v23);
+
+		__m128 x = _mm_cvtepi32_ps(_mm_srai_epi32(yx, 16));
+		__m128 y = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(yx, 16), 16));
+		__m128 z = _mm_cvtepi32_ps(_mm_srai_epi32(fz, 16));
+
+		__m128 tx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m11), _mm_mul_ps(y, m21)), _mm_mul_ps(z, m31)), m41);
+		__m128 ty = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m12), _mm_mul_ps(y, m22)), _mm_mul_ps(z, m32)), m42);
+		__m128 tz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m13), _mm_mul_ps(y, m23)), _mm_mul_ps(z, m33)), m43);
+		__m128 tw = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m14), _mm_mul_ps(y, m24)), _mm_mul_ps(z, m34)), m44);
+
+		__m128 pw = _mm_div_ps(one, tw);
+		__m128 px = _mm_mul_ps(tx, pw);
+		__m128 py = _mm_mul_ps(ty, pw);
+		__m128 pz;
+		if (bDepthHack)
+		{
+			pz = depth;
+			tz = _mm_mul_ps(depth, tw);
+		}
+		else
+		{
+			pz = _mm_mul_ps(tz, pw);
+		}
+
+		__m128i flags = _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(px, scale)), _mm_set1_epi32(X_CLIP_MAX));
+		flags = _mm_or_si128(flags, _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(px, minusScale)), _mm_set1_epi32(X_CLIP_MIN)));
+		flags = _mm_or_si128(flags, _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(py, one)), _mm_set1_epi32(Y_CLIP_MAX)));
+		flags = _mm_or_si128(flags, _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(py, minusOne)), _mm_set1_epi32(Y_CLIP_MIN)));
+		flags = _mm_or_si128(flags, _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(pz, one)), _mm_set1_epi32(Z_CLIP_MAX)));
+		flags = _mm_or_si128(flags, _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(pz, minusOne)), _mm_set1_epi32(Z_CLIP_MIN)));
+		flags = _mm_and_si128(flags, _mm_castps_si128(_mm_cmpgt_ps(pw, _mm_setzero_ps())));
+
+		// Back to a vector per vertex
+		_MM_TRANSPOSE4_PS(tx, ty, tz, tw);
+		_MM_TRANSPOSE4_PS(px, py, pz, pw);
+		__m128 transformed[4] = { tx, ty, tz, tw };
+		__m128 projected[4] = { px, py, pz, pw };
+		VTX_ALIGN16 uint32 clipFlags[4];
+		_mm_store_si128((__m128i *)clipFlags, flags);
+
+		for (uint32 k = 0; k < count; k++)
+		{
+			DaedalusVtx4 &v = g_vecProjected[dwV0 + n + k];
+			_mm_store_ps(&v.TransformedPos.x, transformed[k]);
+			_mm_store_ps(&v.ProjectedPos.x, projected[k]);
+			v.ClipFlags = clipFlags[k];
+		}
+	}
+#else
+	for (uint32 i = dwV0; i < dwV0 + dwNum; i++)
+	{
+		const FiddledVtx & vert = pVtxBase[i - dwV0];
+
+		v4 w(float(vert.x), float(vert.y), float(vert.z), 1.0f);
+
+		g_vecProjected[i].TransformedPos = mat.Transform(w);
+
+		g_vecProjected[i].ProjectedPos.w = 1.0f / g_vecProjected[i].TransformedPos.w;
+		g_vecProjected[i].ProjectedPos.x = g_vecProjected[i].TransformedPos.x * g_vecProjected[i].ProjectedPos.w;
+		g_vecProjected[i].ProjectedPos.y = g_vecProjected[i].TransformedPos.y * g_vecProjected[i].ProjectedPos.w;
+
+		if (bDepthHack)
+		{
+			g_vecProjected[i].ProjectedPos.z = gRDP.fPrimitiveDepth;
+			g_vecProjected[i].TransformedPos.z = gRDP.fPrimitiveDepth*g_vecProjected[i].TransformedPos.w;
+		}
+		else
+		{
+			g_vecProjected[i].ProjectedPos.z = g_vecProjected[i].TransformedPos.z * g_vecProjected[i].ProjectedPos.w;
+		}
+
+		RSP_Vtx_Clipping(i, scaleFactor);
+	}
+#endif
+}
+
+// The directional lights moved into the model space of the world matrix, so the vertex normals are lit without
+// being transformed. Only valid if the matrix is a rotation with a uniform scale, which keeps the angles between
+// the normals and the lights.
+struct ModelSpaceLights
+{
+	bool	bValid;
+	float	matrix[9];				// 3x3 of the world matrix the lights were moved with
+	float	scale;					// of the matrix
+	float	dirX[16];
+	float	dirY[16];
+	float	dirZ[16];
+};
+
+static ModelSpaceLights gModelLights;
+
+#define MODEL_LIGHTS_TOLERANCE		0.001f		// relative error allowed on the lengths and the angles of the matrix rows
+
+// Moves the lights into the model space of mat_world, when the lights or the matrix have changed. Returns false if
+// the matrix distorts the normals, then they are transformed and lit one by one.
+bool PrepareModelSpaceLights(const Matrix4x4 &mat_world)
+{
+	const float matrix[9] = { mat_world.m11, mat_world.m12, mat_world.m13, mat_world.m21, mat_world.m22, mat_world.m23, mat_world.m31, mat_world.m32, mat_world.m33 };
+	if (!gRSP.bLightIsUpdated && memcmp(matrix, gModelLights.matrix, sizeof(matrix)) == 0)
+		return gModelLights.bValid;
+
+	gRSP.bLightIsUpdated = false;
+	memcpy(gModelLights.matrix, matrix, sizeof(matrix));
+
+	// A normal n is transformed to n*M, so the rows of M must be orthogonal and of the same length
+	v3 row0(mat_world.m11, mat_world.m12, mat_world.m13);
+	v3 row1(mat_world.m21, mat_world.m22, mat_world.m23);
+	v3 row2(mat_world.m31, mat_world.m32, mat_world.m33);
+	float l0 = row0.LengthSq();
+	float l1 = row1.LengthSq();
+	float l2 = row2.LengthSq();
+	float scale2 = (l0 + l1 + l2) / 3;
+	float tolerance = scale2 * MODEL_LIGHTS_TOLERANCE;
+
+	gModelLights.bValid = scale2 > 1e-12f &&
+		fabsf(l0 - scale2) <= tolerance && fabsf(l1 - scale2) <= tolerance && fabsf(l2 - scale2) <= tolerance &&
+		fabsf(row0.Dot(row1)) <= tolerance && fabsf(row0.Dot(row2)) <= tolerance && fabsf(row1.Dot(row2)) <= tolerance;
+
+	if (gModelLights.bValid)
+	{
+		// n*M . L = n . M*L, and the length of n*M is the scale times the length of n
+		gModelLights.scale = sqrtf(scale2);
+		float invScale = 1.0f / gModelLights.scale;
+		for (uint32 l = 0; l < gRSPnumLights; l++)
+		{
+			const v3 &dir = gRSPlights[l].Direction;
+			gModelLights.dirX[l] = row0.Dot(dir) * invScale;
+			gModelLights.dirY[l] = row1.Dot(dir) * invScale;
+			gModelLights.dirZ[l] = row2.Dot(dir) * invScale;
+		}
+	}
+
+	return gModelLights.bValid;
+}
+
+#ifdef VTX_USE_SSE2
+// Lights the vertices as LightVert does with their normals transformed by the world matrix, from the normals in
+// model space, 4 vertices at a time. The alpha of the colors is left to the caller.
+void LightVerticesModelSpaceSSE2(const FiddledVtx *pVtxBase, uint32 dwV0, uint32 dwNum)
+{
+	const v3 & ambient = gRSPlights[gRSPnumLights].Colour;
+
+	// Normalise leaves the zero normals as they are, the transform scales the others by gModelLights.scale
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 maxColor = _mm_set1_ps(255.0f);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(gModelLights.scale);
+
+	for (uint32 n = 0; n < dwNum; n += 4)
+	{
+		uint32 count = min(dwNum - n, 4u);
+
+		VTX_ALIGN16 float normX[4] = { 0, 0, 0, 0 };
+		VTX_ALIGN16 float normY[4] = { 0, 0, 0, 0 };
+		VTX_ALIGN16 float normZ[4] = { 0, 0, 0, 0 };
+		for (uint32 k = 0; k < count; k++)
+		{
+			const FiddledVtx & vert = pVtxBase[n + k];
+			normX[k] = (float)vert.norm_x;
+			normY[k] = (float)vert.norm_y;
+			normZ[k] = (float)vert.norm_z;
+		}
+
+		__m128 nx = _mm_load_ps(normX);
+		__m128 ny = _mm_load_ps(normY);
+		__m128 nz = _mm_load_ps(normZ);
+		__m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz));
+		__m128 normalise = _mm_cmpgt_ps(lengthSq, zero);
+		__m128 factor = _mm_div_ps(one, _mm_sqrt_ps(lengthSq));
+		factor = _mm_or_ps(_mm_and_ps(normalise, factor), _mm_andnot_ps(normalise, scale));
+
+		__m128 r = _mm_set1_ps(ambient.x);
+		__m128 g = _mm_set1_ps(ambient.y);
+		__m128 b = _mm_set1_ps(ambient.z);
+
+		for (uint32 l = 0; l < gRSPnumLights; l++)
+		{
+			__m128 cosT = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_set1_ps(gModelLights.dirX[l])), _mm_mul_ps(ny, _mm_set1_ps(gModelLights.dirY[l]))),
+				_mm_mul_ps(nz, _mm_set1_ps(gModelLights.dirZ[l])));
+			cosT = _mm_max_ps(_mm_mul_ps(cosT, factor), zero);
+
+			r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(gRSPlights[l].Colour.x), cosT));
+			g = _mm_add_ps(g, _mm_mul_ps(_mm_set1_ps(gRSPlights[l].Colour.y), cosT));
+			b = _mm_add_ps(b, _mm_mul_ps(_mm_set1_ps(gRSPlights[l].Colour.z), cosT));
+		}
+
+		__m128i color = _mm_slli_epi32(_mm_cvttps_epi32(_mm_min_ps(r, maxColor)), 16);
+		color = _mm_or_si128(color, _mm_slli_epi32(_mm_cvttps_epi32(_mm_min_ps(g, maxColor)), 8));
+		color = _mm_or_si128(color, _mm_cvttps_epi32(_mm_min_ps(b, maxColor)));
+		color = _mm_or_si128(color, _mm_set1_epi32(0xFF000000));
+
+		VTX_ALIGN16 uint32 colors[4];
+		_mm_store_si128((__m128i *)colors, color);
+		for (uint32 k = 0; k < count; k++)
+			g_dwVtxDifColor[dwV0 + n + k] = colors[k];
+	}
+}
+#endif
+
+// The same one vertex at a time, for the builds without SSE2
+void LightVerticesModelSpaceScalar(const FiddledVtx *pVtxBase, uint32 dwV0, uint32 dwNum)
+{
+	const v3 & ambient = gRSPlights[gRSPnumLights].Colour;
+
+	for (uint32 i = dwV0; i < dwV0 + dwNum; i++)
+	{
+		const FiddledVtx & vert = pVtxBase[i - dwV0];
+		v3 norm((float)vert.norm_x, (float)vert.norm_y, (float)vert.norm_z);
+		float lengthSq = norm.LengthSq();
+		float factor = lengthSq > 0.0f ? 1.0f / sqrtf(lengthSq) : gModelLights.scale;
+
+		v3 result(ambient.x, ambient.y, ambient.z);
+		for (uint32 l = 0; l < gRSPnumLights; l++)
+		{
+			float fCosT = (norm.x * gModelLights.dirX[l] + norm.y * gModelLights.dirY[l] + norm.z * gModelLights.dirZ[l]) * factor;
+			if (fCosT > 0.0f)
+			{
+				result.x += gRSPlights[l].Colour.x * fCosT;
+				result.y += gRSPlights[l].Colour.y * fCosT;
+				result.z += gRSPlights[l].Colour.z * fCosT;
+			}
+		}
+
+		if (result.x > 255) result.x = 255;
+		if (result.y > 255) result.y = 255;
+		if (result.z > 255) result.z = 255;
+		g_dwVtxDifColor[i] = ((0xff000000) | (((uint32)result.x) << 16) | (((uint32)result.y) << 8) | ((uint32)result.z));
+	}
+}
+
+#ifdef _DEBUG
+// Compares the color lit in model space with the one of the normal transformed by the world matrix
+static void CheckModelSpaceLight(uint32 i, const v3 &model_normal, const Matrix4x4 &mat_world)
+{
+	v3 vecTransformedNormal = mat_world.TransformNormal(model_normal);
+	vecTransformedNormal.Normalise();
+	uint32 expected = LightVert(vecTransformedNormal);
+
+	for (int shift = 0; shift < 24; shift += 8)
+	{
+		int diff = (int)((g_dwVtxDifColor[i] >> shift) & 0xFF) - (int)((expected >> shift) & 0xFF);
+		if (diff > MODEL_LIGHTS_CHECK_ERROR || diff < -MODEL_LIGHTS_CHECK_ERROR)
+		{
+			WARNING(TRACE3("Vertex %d lit in model space to %08X instead of %08X", i, g_dwVtxDifColor[i], expected));
+			break;
+		}
+	}
+}
+#endif
+
+#ifdef VTX_USE_SSE2
+// Generates the texture coordinates of the vertices from their normals transformed by mat_world_project, 4 vertices
+// at a time. The normals are normalised as v3::Normalise does.
+void TexGenVerticesSSE2(const FiddledVtx *pVtxBase, uint32 dwV0, uint32 dwNum, const Matrix4x4 &mat_world_project, bool bLinear)
+{
+	const __m128 m11 = _mm_set1_ps(mat_world_project.m11), m12 = _mm_set1_ps(mat_world_project.m12), m13 = _mm_set1_ps(mat_world_project.m13);
+	const __m128 m21 = _mm_set1_ps(mat_world_project.m21), m22 = _mm_set1_ps(mat_world_project.m22), m23 = _mm_set1_ps(mat_world_project.m23);
+	const __m128 m31 = _mm_set1_ps(mat_world_project.m31), m32 = _mm_set1_ps(mat_world_project.m32), m33 = _mm_set1_ps(mat_world_project.m33);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	const __m128 pi = _mm_set1_ps(3.14159265f);
+	const __m128 a0 = _mm_set1_ps(TEXGEN_ACOS_A0), a1 = _mm_set1_ps(TEXGEN_ACOS_A1), a2 = _mm_set1_ps(TEXGEN_ACOS_A2), a3 = _mm_set1_ps(TEXGEN_ACOS_A3);
+	const __m128 scale = _mm_set1_ps(TEXGEN_ACOS_SCALE);
+
+	for (uint32 n = 0; n < dwNum; n += 4)
+	{
+		uint32 count = min(dwNum - n, 4u);
+
+		VTX_ALIGN16 float normX[4] = { 0, 0, 0, 0 };
+		VTX_ALIGN16 float normY[4] = { 0, 0, 0, 0 };
+		VTX_ALIGN16 float normZ[4] = { 0, 0, 0, 0 };
+		for (uint32 k = 0; k < count; k++)
+		{
+			const FiddledVtx & vert = pVtxBase[n + k];
+			normX[k] = (float)vert.norm_x;
+			normY[k] = (float)vert.norm_y;
+			normZ[k] = (float)vert.norm_z;
+		}
+
+		// Only x and y of the transformed normal are used, its z is still needed for the length
+		__m128 nx = _mm_load_ps(normX);
+		__m128 ny = _mm_load_ps(normY);
+		__m128 nz = _mm_load_ps(normZ);
+		__m128 tx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, m11), _mm_mul_ps(ny, m21)), _mm_mul_ps(nz, m31));
+		__m128 ty = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, m12), _mm_mul_ps(ny, m22)), _mm_mul_ps(nz, m32));
+		__m128 tz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, m13), _mm_mul_ps(ny, m23)), _mm_mul_ps(nz, m33));
+
+		__m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty)), _mm_mul_ps(tz, tz));
+		__m128 normalise = _mm_cmpgt_ps(lengthSq, zero);
+		__m128 factor = _mm_div_ps(one, _mm_sqrt_ps(lengthSq));
+		factor = _mm_or_ps(_mm_and_ps(normalise, factor), _mm_andnot_ps(normalise, one));
+		tx = _mm_mul_ps(tx, factor);
+		ty = _mm_mul_ps(ty, factor);
+
+		__m128 u, v;
+		if (bLinear)
+		{
+			u = _mm_mul_ps(half, _mm_add_ps(one, tx));
+			v = _mm_mul_ps(half, _mm_sub_ps(one, ty));
+		}
+		else
+		{
+			__m128 coords[2] = { tx, ty };
+			for (int c = 0; c < 2; c++)
+			{
+				__m128 a = _mm_min_ps(_mm_andnot_ps(signMask, coords[c]), one);
+				__m128 poly = _mm_add_ps(a0, _mm_mul_ps(a, _mm_add_ps(a1, _mm_mul_ps(a, _mm_add_ps(a2, _mm_mul_ps(a, a3))))));
+				__m128 r = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(one, a)), poly);
+				__m128 negative = _mm_cmplt_ps(coords[c], zero);
+				r = _mm_or_ps(_mm_and_ps(negative, _mm_sub_ps(pi, r)), _mm_andnot_ps(negative, r));
+				coords[c] = _mm_mul_ps(r, scale);
+			}
+			u = coords[0];
+			v = coords[1];
+		}
+
+		VTX_ALIGN16 float texU[4];
+		VTX_ALIGN16 float texV[4];
+		_mm_store_ps(texU, u);
+		_mm_store_ps(texV, v);
+		for (uint32 k = 0; k < count; k++)
+		{
+			g_vecProjected[dwV0 + n + k].Texture.x = texU[k];
+			g_vecProjected[dwV0 + n + k].Texture.y = texV[k];
+		}
+	}
+}
+#endif
+
+// The same one vertex at a time, for the builds without SSE2
+void TexGenVerticesScalar(const FiddledVtx *pVtxBase, uint32 dwV0, uint32 dwNum, const Matrix4x4 &mat_world_project, bool bLinear)
+{
+	for (uint32 i = dwV0; i < dwV0 + dwNum; i++)
+	{
+		const FiddledVtx & vert = pVtxBase[i - dwV0];
+		v3 model_normal((float)vert.norm_x, (float)vert.norm_y, (float)vert.norm_z);
+		v3 norm = mat_world_project.TransformNormal(model_normal);
+		norm.Normalise();
+
+		if (bLinear)
+		{
+			g_vecProjected[i].Texture.x = 0.5f * (1.0f + norm.x);
+			g_vecProjected[i].Texture.y = 0.5f * (1.0f - norm.y);
+		}
+		else
+		{
+			g_vecProjected[i].Texture.x = TexGenAcos(norm.x);
+			g_vecProjected[i].Texture.y = TexGenAcos(norm.y);
+		}
+	}
+}
+
+#ifdef _DEBUG
+// Compares the generated texture coordinates with those of acosf
+static void CheckTexGen(uint32 i, const v3 &model_normal, const Matrix4x4 &mat_world_project)
+{
+	v3 norm = mat_world_project.TransformNormal(model_normal);
+	norm.Normalise();
+	if (gRDP.tnl.TexGenLin || fabsf(norm.x) > 1.0f || fabsf(norm.y) > 1.0f)
+		return;
+
+	float u = acosf(norm.x) / 3.14f;
+	float v = acosf(norm.y) / 3.14f;
+	if (fabsf(g_vecProjected[i].Texture.x - u) > 2*TEXGEN_ACOS_ERROR || fabsf(g_vecProjected[i].Texture.y - v) > 2*TEXGEN_ACOS_ERROR)
+	{
+		WARNING(TRACE5("Texgen of vertex %d: %f, %f instead of %f, %f", i, g_vecProjected[i].Texture.x, g_vecProjected[i].Texture.y, u, v));
+	}
+}
+#endif
+
 void ProcessVertexData(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 {
 	// This function is called upon SPvertex
@@ -442,27 +878,32 @@ void ProcessVertexData(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 	const Matrix4x4 & mat_world_project = gRSP.mWorldProject;
 	const Matrix4x4 & mat_world = gRSP.mModelViewStack[gRSP.mModelViewTop];
 
-	for (uint32 i = dwV0; i < dwV0 + dwNum; i++)
-	{
-		const FiddledVtx & vert = pVtxBase[i - dwV0];
-
-		v4 w(float(vert.x), float(vert.y), float(vert.z), 1.0f);
+	bool bDepthHack = (g_curRomInfo.bPrimaryDepthHack || options.enableHackForGames == HACK_FOR_NASCAR) && gRDP.otherMode.depth_source;
+	TransformVertices(pVtxBase, dwV0, dwNum, mat_world_project, bDepthHack);
 
-		g_vecProjected[i].TransformedPos = mat_world_project.Transform(w);
+	bool bModelSpaceLights = gRDP.tnl.Light && !gRDP.tnl.PointLight && PrepareModelSpaceLights(mat_world);
+	if (bModelSpaceLights)
+	{
+#ifdef VTX_USE_SSE2
+		LightVerticesModelSpaceSSE2(pVtxBase, dwV0, dwNum);
+#else
+		LightVerticesModelSpaceScalar(pVtxBase, dwV0, dwNum);
+#endif
+	}
 
-		g_vecProjected[i].ProjectedPos.w = 1.0f / g_vecProjected[i].TransformedPos.w;
-		g_vecProjected[i].ProjectedPos.x = g_vecProjected[i].TransformedPos.x * g_vecProjected[i].ProjectedPos.w;
-		g_vecProjected[i].ProjectedPos.y = g_vecProjected[i].TransformedPos.y * g_vecProjected[i].ProjectedPos.w;
+	// Lets use mat_world_project instead of mat_world for nicer effect (see SSV space ship) //Corn
+	if (gRDP.tnl.Light && gRDP.tnl.TexGen)
+	{
+#ifdef VTX_USE_SSE2
+		TexGenVerticesSSE2(pVtxBase, dwV0, dwNum, mat_world_project, gRDP.tnl.TexGenLin != 0);
+#else
+		TexGenVerticesScalar(pVtxBase, dwV0, dwNum, mat_world_project, gRDP.tnl.TexGenLin != 0);
+#endif
+	}
 
-		if ((g_curRomInfo.bPrimaryDepthHack || options.enableHackForGames == HACK_FOR_NASCAR) && gRDP.otherMode.depth_source)
-		{
-			g_vecProjected[i].ProjectedPos.z = gRDP.fPrimitiveDepth;
-			g_vecProjected[i].TransformedPos.z = gRDP.fPrimitiveDepth*g_vecProjected[i].TransformedPos.w;
-		}
-		else
-		{
-			g_vecProjected[i].ProjectedPos.z = g_vecProjected[i].TransformedPos.z * g_vecProjected[i].ProjectedPos.w;
-		}
+	for (uint32 i = dwV0; i < dwV0 + dwNum; i++)
+	{
+		const FiddledVtx & vert = pVtxBase[i - dwV0];
 
 		if (gRDP.tnl.Fog)
 		{
@@ -471,45 +912,37 @@ void ProcessVertexData(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 				g_fFogCoord[i] = gRSPfFogMin;
 		}
 
-		RSP_Vtx_Clipping(i);
-
 		if (gRDP.tnl.Light)
 		{
 			
 			v3 model_normal((float)vert.norm_x, (float)vert.norm_y, (float)vert.norm_z);
-			v3 vecTransformedNormal;
-			vecTransformedNormal = mat_world.TransformNormal(model_normal);
-			vecTransformedNormal.Normalise();
 
 			if (gRDP.tnl.PointLight)
 			{
+				v4 w(float(vert.x), float(vert.y), float(vert.z), 1.0f);
 				g_dwVtxDifColor[i] = LightPointVert(w);
 			}
-			else
+			else if (!bModelSpaceLights)
 			{
+				v3 vecTransformedNormal = mat_world.TransformNormal(model_normal);
+				vecTransformedNormal.Normalise();
 				g_dwVtxDifColor[i] = LightVert(vecTransformedNormal);
 			}
+#ifdef _DEBUG
+			else
+			{
+				CheckModelSpaceLight(i, model_normal, mat_world);
+			}
+#endif
 
 			*(((uint8*)&(g_dwVtxDifColor[i])) + 3) = vert.rgba_a;	// still use alpha from the vertex
 
 			if (gRDP.tnl.TexGen)
 			{
-                // Lets use mat_world_project instead of mat_world for nicer effect (see SSV space ship) //Corn
-                vecTransformedNormal = mat_world_project.TransformNormal(model_normal);
-                vecTransformedNormal.Normalise();
-
-				const v3 & norm = vecTransformedNormal;
-
-				if (gRDP.tnl.TexGenLin)
-				{
-                    g_vecProjected[i].Texture.x = 0.5f * (1.0f + norm.x);
-                    g_vecProjected[i].Texture.y = 0.5f * (1.0f - norm.y);
-				}
-				else
-				{
-                    g_vecProjected[i].Texture.x = acosf(norm.x) / 3.14f;
-                    g_vecProjected[i].Texture.y = acosf(norm.y) / 3.14f;
-				}
+				// Generated by TexGenVerticesSSE2 or TexGenVerticesScalar
+#ifdef _DEBUG
+				CheckTexGen(i, model_normal, mat_world_project);
+#endif
 			}
 			else
 			{
@@ -566,15 +999,23 @@ bool AddTri(u32 v0, u32 v1, u32 v2, bool bTri4)
 	if(bTri4 && v0 == v1)
 		return false; // Cull empty tris
 
+	if (gDListCuller.SkipTriangle(v0, v1, v2))
+		return false;
+
 	if (IsTriangleVisible(v0, v1, v2))
 	{
-		if (CRender::g_pRender->IsTextureEnabled())
+		// Nothing is set up again for the triangles which follow each other with the same states
+		uint32 dirty = gRDP.dirtyStates | (gRDP.textureIsChanged ? RDP_DIRTY_TEXTURE : 0);
+		if (dirty != 0)
 		{
-			PrepareTextures();
-			InitVertexTextureConstants();
-		}
+			if ((dirty & (RDP_DIRTY_TEXTURE|RDP_DIRTY_COMBINER|RDP_DIRTY_RENDER)) && CRender::g_pRender->IsTextureEnabled())
+			{
+				PrepareTextures();
+				InitVertexTextureConstants();
+			}
 
-		CRender::g_pRender->SetCombinerAndBlender();
+			CRender::g_pRender->SetTriangleStates(dirty);
+		}
 
 		PrepareTriangle(v0, v1, v2);
 		return true;
@@ -646,12 +1087,50 @@ bool IsTriangleVisible(uint32 dwV0, uint32 dwV1, uint32 dwV2)
 	return true;
 }
 
+// Returns true if the box, in model space, is beyond one of the planes which RSP_Vtx_Clipping clips the vertices
+// against, under the current world and projection matrices. Then all its triangles would be culled in
+// IsTriangleVisible.
+bool IsBoxOffScreen(const float *pMin, const float *pMax)
+{
+	UpdateWorldProject();
+	const Matrix4x4 & mat_world_project = gRSP.mWorldProject;
+
+	float scaleFactor = GetClipScaleFactor();
+
+	// The depth of the vertices is replaced by the primitive depth with these hacks
+	uint32 flags = X_CLIP_MAX|X_CLIP_MIN|Y_CLIP_MAX|Y_CLIP_MIN;
+	if (!g_curRomInfo.bPrimaryDepthHack && options.enableHackForGames != HACK_FOR_NASCAR)
+		flags |= Z_CLIP_MAX|Z_CLIP_MIN;
+
+	for (int i = 0; i < 8 && flags != 0; i++)
+	{
+		v4 w((i&1) ? pMax[0] : pMin[0], (i&2) ? pMax[1] : pMin[1], (i&4) ? pMax[2] : pMin[2], 1.0f);
+		v4 pos = mat_world_project.Transform(w);
+
+		// The vertices behind the eye are not clipped
+		if (pos.w <= 0)
+			return false;
+
+		uint32 corner = 0;
+		if (pos.x > scaleFactor*pos.w)	corner |= X_CLIP_MAX;
+		if (pos.x < -scaleFactor*pos.w)	corner |= X_CLIP_MIN;
+		if (pos.y > pos.w)				corner |= Y_CLIP_MAX;
+		if (pos.y < -pos.w)				corner |= Y_CLIP_MIN;
+		if (pos.z > pos.w)				corner |= Z_CLIP_MAX;
+		if (pos.z < -pos.w)				corner |= Z_CLIP_MIN;
+		flags &= corner;
+	}
+
+	return flags != 0;
+}
+
 
 void SetPrimitiveColor(uint32 dwCol, uint32 LODMin, uint32 LODFrac)
 {
 	gRDP.primitiveColor = dwCol;
 	gRDP.primLODMin = LODMin;
 	gRDP.primLODFrac = LODFrac;
+	gRDP.dirtyStates |= RDP_DIRTY_COMBINER;
 	if( gRDP.primLODFrac < gRDP.primLODMin )
 	{
 		gRDP.primLODFrac = gRDP.primLODMin;
@@ -791,6 +1270,8 @@ void ProcessVertexDataDKR(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 	LOG_UCODE("    ProcessVertexDataDKR, CMatrix = %d, Add base=%s", gDKRCMatrixIndex, gDKRBillBoard?"true":"false");
 	VTX_DUMP(TRACE2("DKR Setting Vertexes\nCMatrix = %d, Add base=%s", gDKRCMatrixIndex, gDKRBillBoard?"true":"false"));
 
+	float scaleFactor = GetClipScaleFactor();
+
 	uint32 end = dwV0 + dwNum;
 	for (i = dwV0; i < end; i++)
 	{
@@ -835,7 +1316,7 @@ void ProcessVertexDataDKR(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 				g_fFogCoord[i] = gRSPfFogMin;
 		}
 
-		RSP_Vtx_Clipping(i);
+		RSP_Vtx_Clipping(i, scaleFactor);
 
 		short wA = *(short*)((pVtxBase + 6) ^ 2);
 		short wB = *(short*)((pVtxBase + 8) ^ 2);
@@ -865,6 +1346,8 @@ void ProcessVertexDataPD(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 	const Matrix4x4 & mat_world = gRSP.mModelViewStack[gRSP.mModelViewTop];
 	const Matrix4x4 & mat_project = gRSP.mProjectionMat;
 
+	float scaleFactor = GetClipScaleFactor();
+
 	for (uint32 i = dwV0; i < dwV0 + dwNum; i++)
 	{
 		N64VtxPD &vert = pVtxBase[i - dwV0];
@@ -881,7 +1364,7 @@ void ProcessVertexDataPD(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 		if( g_vecProjected[i].ProjectedPos.w < 0 || g_vecProjected[i].ProjectedPos.z < 0 || g_fFogCoord[i] < gRSPfFogMin )
 			g_fFogCoord[i] = gRSPfFogMin;
 
-		RSP_Vtx_Clipping(i);
+		RSP_Vtx_Clipping(i, scaleFactor);
 
 		uint8 *addr = g_pu8RamBase+dwPDCIAddr+ (vert.cidx&0xFF);
 		uint32 a = addr[0];
@@ -965,19 +1448,12 @@ void ProcessVertexDataConker(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 	//Model normal base vector
 	short *mn = (short*)(g_pu8RamBase + dwConkerVtxZAddr);
 
+	TransformVertices(pVtxBase, dwV0, dwNum, mat_world_project, false);
+
 	for (uint32 i = dwV0; i < dwV0 + dwNum; i++)
 	{
 		const FiddledVtx & vert = pVtxBase[i - dwV0];
 
-		v4 w(float(vert.x), float(vert.y), (float)vert.z, 1.0f);
-
-		g_vecProjected[i].TransformedPos = mat_world_project.Transform(w);
-
-		g_vecProjected[i].ProjectedPos.w = 1.0f / g_vecProjected[i].TransformedPos.w;
-		g_vecProjected[i].ProjectedPos.x = g_vecProjected[i].TransformedPos.x * g_vecProjected[i].ProjectedPos.w;
-		g_vecProjected[i].ProjectedPos.y = g_vecProjected[i].TransformedPos.y * g_vecProjected[i].ProjectedPos.w;
-		g_vecProjected[i].ProjectedPos.z = g_vecProjected[i].TransformedPos.z * g_vecProjected[i].ProjectedPos.w;
-
 		g_dwVtxDifColor[i] = COLOR_RGBA(vert.rgba_r, vert.rgba_g, vert.rgba_b, vert.rgba_a);
 
 		g_fFogCoord[i] = g_vecProjected[i].ProjectedPos.z;
@@ -985,9 +1461,6 @@ void ProcessVertexDataConker(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 		if (g_vecProjected[i].ProjectedPos.w < 0 || g_vecProjected[i].ProjectedPos.z < 0 || g_fFogCoord[i] < gRSPfFogMin)
 			g_fFogCoord[i] = gRSPfFogMin;
 
-		//Initialize clipping flags for vertexs
-		RSP_Vtx_Clipping(i);
-
 		if (gRDP.tnl.Light)
 		{
 			uint32 r = (uint32) gRSPlights[gRSPnumLights].Colour.x;
@@ -1082,8 +1555,8 @@ void ProcessVertexDataConker(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 				}
 				else
 				{
-                    g_vecProjected[i].Texture.x = acosf(norm.x) / 3.14f;
-                    g_vecProjected[i].Texture.y = acosf(norm.y) / 3.14f;
+                    g_vecProjected[i].Texture.x = TexGenAcos(norm.x);
+                    g_vecProjected[i].Texture.y = TexGenAcos(norm.y);
 				}
 			}
 			else
@@ -1128,6 +1601,7 @@ void SetLightDirection(uint32 dwLight, float x, float y, float z)
 	gRSPlights[dwLight].Direction.x = n.x;
 	gRSPlights[dwLight].Direction.y = n.y;
 	gRSPlights[dwLight].Direction.z = n.z;
+	gRSP.bLightIsUpdated = true;
 
 	DEBUGGER_PAUSE_AND_DUMP(NEXT_SET_LIGHT,TRACE4("Set Light %d dir: %.4f, %.4f, %.4f", dwLight, x, y, z));
 }
@@ -1157,6 +1631,7 @@ void SetLightEx(uint32 dwLight, float ca, float la, float qa)
 
 void ForceMainTextureIndex(int dwTile) 
 {
+	gRDP.dirtyStates |= RDP_DIRTY_TEXTURE;
 	if( dwTile == 1 && !(CRender::g_pRender->IsTexel0Enable()) && CRender::g_pRender->IsTexel1Enable() )
 	{
 		// Hack
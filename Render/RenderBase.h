@@ -73,7 +73,7 @@ extern float	gRSPfFogDivider;
 /************************************************************************/
 /*      Don't move                                                      */
 /************************************************************************/
-__declspec(align(16)) struct RSP_Options
+struct ALIGNED16 RSP_Options
 {
 	/************************************************************************/
 	/*      Don't move above                                                */
@@ -131,7 +131,7 @@ __declspec(align(16)) struct RSP_Options
 
 };
 
-__declspec(align(16)) struct RiceVideoVtx4
+struct ALIGNED16 RiceVideoVtx4
 {
 
 };
@@ -167,7 +167,14 @@ struct TimgLoadDetails
     bool				Swapped;
 };
 
-__declspec(align(16)) struct RDP_Options{
+// What changed since the states of the triangles were last set up, see AddTri
+#define RDP_DIRTY_OTHERMODE		0x01	// othermode, geometry mode and blend color
+#define RDP_DIRTY_COMBINER		0x02	// combiner mux, primitive and environment colors, LOD fraction
+#define RDP_DIRTY_TEXTURE		0x04	// Texture command and main tile, the tiles and loads set textureIsChanged
+#define RDP_DIRTY_RENDER		0x08	// states set for another draw than the triangles
+#define RDP_DIRTY_ALL			0x0F
+
+struct ALIGNED16 RDP_Options{
 	bool	bFogEnableInBlender;
 
 	uint32	fogColor;
@@ -202,6 +209,7 @@ __declspec(align(16)) struct RDP_Options{
 	ScissorType scissor;
 
 	bool	textureIsChanged;
+	uint32	dirtyStates;		// RDP_DIRTY_* bits
 };
 
 extern RDP_Options gRDP;
@@ -216,6 +224,7 @@ void InitVertexTextureConstants();
 bool AddTri(u32 v0, u32 v1, u32 v2, bool bTri4 = false);
 bool PrepareTriangle(uint32 dwV0, uint32 dwV1, uint32 dwV2);
 bool IsTriangleVisible(uint32 dwV0, uint32 dwV1, uint32 dwV2);
+bool IsBoxOffScreen(const float *pMin, const float *pMax);
 void ProcessVertexData(uint32 dwAddr, uint32 dwV0, uint32 dwNum);
 void SetPrimitiveColor(uint32 dwCol, uint32 LODMin, uint32 LODFrac);
 void SetPrimitiveDepth(uint32 z, uint32 dwDZ);
@@ -230,6 +239,42 @@ void SetLightEx(uint32 dwLight, float ca, float la, float qa);
 
 void ForceMainTextureIndex(int dwTile); 
 
+uint32 LightVert(v3 & norm);
+
+// The directional lights of the vertices dwV0 to dwV0+dwNum-1 from their normals in model space, once
+// PrepareModelSpaceLights has accepted the world matrix. The colors are within MODEL_LIGHTS_CHECK_ERROR of
+// those LightVert gives for the transformed normals. ProcessVertexData uses the SSE2 version when it is built.
+#define MODEL_LIGHTS_CHECK_ERROR	2			// largest difference of a color component with LightVert
+bool PrepareModelSpaceLights(const Matrix4x4 &mat_world);
+void LightVerticesModelSpaceSSE2(const FiddledVtx *pVtxBase, uint32 dwV0, uint32 dwNum);
+void LightVerticesModelSpaceScalar(const FiddledVtx *pVtxBase, uint32 dwV0, uint32 dwNum);
+
+// The texture coordinates of the spherical and the linear texgen for the vertices dwV0 to dwV0+dwNum-1, from their
+// normals transformed by mat_world_project. ProcessVertexData uses the SSE2 version when it is built.
+void TexGenVerticesSSE2(const FiddledVtx *pVtxBase, uint32 dwV0, uint32 dwNum, const Matrix4x4 &mat_world_project, bool bLinear);
+void TexGenVerticesScalar(const FiddledVtx *pVtxBase, uint32 dwV0, uint32 dwNum, const Matrix4x4 &mat_world_project, bool bLinear);
+
+// acos(x)/3.14 for the spherical texgen, without acosf. From Abramowitz and Stegun 4.4.45,
+// acos(x) = sqrt(1-x)*(a0 + a1*x + a2*x^2 + a3*x^3) for 0 <= x <= 1, within 6.8e-5 radians, and acos(-x) = pi - acos(x).
+// The texture coordinate is within 2.2e-5 of acosf(x)/3.14, under a 40th of a texel of a 1024 texel wide texture.
+#define TEXGEN_ACOS_A0		1.5707288f
+#define TEXGEN_ACOS_A1		-0.2121144f
+#define TEXGEN_ACOS_A2		0.0742610f
+#define TEXGEN_ACOS_A3		-0.0187293f
+#define TEXGEN_ACOS_SCALE	(1.0f / 3.14f)
+#define TEXGEN_ACOS_ERROR	2.2e-5f
+
+inline float TexGenAcos(float x)
+{
+	float a = fabsf(x);
+	if (a > 1.0f) a = 1.0f;		// acosf would return NaN for the normals a little longer than 1
+
+	float r = sqrtf(1.0f - a) * (TEXGEN_ACOS_A0 + a * (TEXGEN_ACOS_A1 + a * (TEXGEN_ACOS_A2 + a * TEXGEN_ACOS_A3)));
+	if (x < 0.0f)
+		r = 3.14159265f - r;
+	return r * TEXGEN_ACOS_SCALE;
+}
+
 void ClipVertexes();
 
 inline float ViewPortTranslatef_x(float x) { return ( (x+1) * windowSetting.vpWidthW/2) + windowSetting.vpLeftW; }
@@ -256,6 +301,7 @@ inline uint32 GetLODFrac() { return gRDP.LODFrac; }
 inline void SetEnvColor(uint32 dwCol) 
 { 
 	gRDP.envColor = dwCol; 
+	gRDP.dirtyStates |= RDP_DIRTY_COMBINER;
 	gRDP.fvEnvColor[0] = ((dwCol>>16)&0xFF)/255.0f;		//r
 	gRDP.fvEnvColor[1] = ((dwCol>>8)&0xFF)/255.0f;			//g
 	gRDP.fvEnvColor[2] = ((dwCol)&0xFF)/255.0f;			//b
@@ -268,6 +314,7 @@ inline float* GetEnvColorfv() { return gRDP.fvEnvColor; }
 inline void SetNumLights(uint32 dwNumLights) 
 { 
 	gRSPnumLights = dwNumLights; 
+	gRSP.bLightIsUpdated = true;
 	DEBUGGER_PAUSE_AND_DUMP(NEXT_SET_LIGHT,TRACE1("Set Num Of Light: %d", dwNumLights));
 }
 inline uint32 GetNumLights() { return gRSPnumLights; }
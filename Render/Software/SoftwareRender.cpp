@@ -0,0 +1,633 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "../../stdafx.h"
+
+CSoftwareRender *CSoftwareRender::g_pSoftwareRender = NULL;
+
+static inline float Saturate(float f)
+{
+	return f < 0 ? 0 : (f > 1 ? 1 : f);
+}
+
+static inline uint8 FloatToByte(float f)
+{
+	return (uint8)(Saturate(f)*255.0f+0.5f);
+}
+
+static inline void ColorToFloats(uint32 dwColor, float *rgba)
+{
+	rgba[0] = ((dwColor>>16)&0xFF)/255.0f;
+	rgba[1] = ((dwColor>>8)&0xFF)/255.0f;
+	rgba[2] = ((dwColor)&0xFF)/255.0f;
+	rgba[3] = ((dwColor>>24)&0xFF)/255.0f;
+}
+
+static inline uint32 FloatsToColor(const float *rgba)
+{
+	return COLOR_RGBA(FloatToByte(rgba[0]), FloatToByte(rgba[1]), FloatToByte(rgba[2]), FloatToByte(rgba[3]));
+}
+
+// Pixel centers are at integer coordinates, like Direct3D 9
+static inline float EdgeFunction(const TLITVERTEX &a, const TLITVERTEX &b, float x, float y)
+{
+	return (b.x-a.x)*(y-a.y) - (b.y-a.y)*(x-a.x);
+}
+
+// Pixels exactly on an edge belong to the triangle if it is a top or a left edge
+static inline bool IsTopLeftEdge(const TLITVERTEX &a, const TLITVERTEX &b)
+{
+	return b.y < a.y || (b.y == a.y && b.x > a.x);
+}
+
+static inline int AddressTexel(float coord, int size, int mode)
+{
+	if( size <= 0 )
+		return 0;
+
+	float t = coord*size;
+	if( t > 1e8f )			t = 1e8f;
+	else if( t < -1e8f )	t = -1e8f;
+
+	int i = (int)floorf(t);
+	switch( mode )
+	{
+	case D3DTADDRESS_CLAMP:
+		return i < 0 ? 0 : (i >= size ? size-1 : i);
+	case D3DTADDRESS_MIRROR:
+		i %= 2*size;
+		if( i < 0 )	i += 2*size;
+		return i < size ? i : 2*size-1-i;
+	default:
+		i %= size;
+		return i < 0 ? i+size : i;
+	}
+}
+
+static inline void SampleTexture(const SoftwareSampler &sampler, float u, float v, float *rgba)
+{
+	// a tile masked down to nothing has no texel to sample
+	if( sampler.pTexture == NULL || sampler.info.dwCreatedWidth == 0 || sampler.info.dwCreatedHeight == 0 )
+	{
+		rgba[0] = rgba[1] = rgba[2] = 0;
+		rgba[3] = 1;
+		return;
+	}
+
+	int x = AddressTexel(u, sampler.info.dwCreatedWidth, sampler.addressU);
+	int y = AddressTexel(v, sampler.info.dwCreatedHeight, sampler.addressV);
+	ColorToFloats(*(uint32*)((uint8*)sampler.info.lpSurface + y*sampler.info.lPitch + x*4), rgba);
+}
+
+// The inputs of the pixel shader combiner, see muxToPSMaps
+static inline float MuxInput(float inputs[][4], uint8 val, int channel)
+{
+	if( val&MUX_ALPHAREPLICATE )
+		channel = 3;
+
+	val &= MUX_MASK;
+	if( val >= MUX_COMBALPHA && val <= MUX_ENV_ALPHA )
+	{
+		val = val - MUX_COMBALPHA + MUX_COMBINED;
+		channel = 3;
+	}
+	else if( val > MUX_UNK )
+	{
+		val = MUX_0;
+	}
+
+	return inputs[val][channel];
+}
+
+// sub then mad_sat, as in GeneratePixelShaderFromMux
+static inline float CombineMuxChannel(float inputs[][4], const uint8 *abcd, int channel)
+{
+	float a = MuxInput(inputs, abcd[0], channel);
+	float b = MuxInput(inputs, abcd[1], channel);
+	float c = MuxInput(inputs, abcd[2], channel);
+	float d = MuxInput(inputs, abcd[3], channel);
+	return Saturate((a-b)*c+d);
+}
+
+static inline SoftwarePixelMode GetPixelMode(void)
+{
+	if( gRDP.otherMode.cycle_type == CYCLE_TYPE_COPY )
+		return SOFT_PIXEL_COPY;
+	else if( gRDP.otherMode.cycle_type == CYCLE_TYPE_FILL )
+		return SOFT_PIXEL_FILL;
+	else
+		return SOFT_PIXEL_COMBINE;
+}
+
+CSoftwareRender::CSoftwareRender()
+{
+	m_width = m_height = 0;
+	m_vpLeft = m_vpTop = m_vpRight = m_vpBottom = 0;
+	m_blendType = kBlendModeOpaque;
+	m_dwAlphaRef = 0x04;
+	m_bAlphaTestEnable = true;
+
+	m_pixelMode = SOFT_PIXEL_FILL;
+	m_drawBlendType = kBlendModeOpaque;
+	m_bDrawAlphaTest = false;
+	m_bDrawDepth = false;
+	memset(m_samplers, 0, sizeof(m_samplers));
+	memset(m_muxInputs, 0, sizeof(m_muxInputs));
+
+	g_pSoftwareRender = this;
+}
+
+CSoftwareRender::~CSoftwareRender()
+{
+	g_pSoftwareRender = NULL;
+}
+
+bool CSoftwareRender::ClearDeviceObjects()
+{
+	std::vector<uint32>().swap(m_colorBuffer);
+	std::vector<float>().swap(m_depthBuffer);
+	m_width = m_height = 0;
+	return CNullRender::ClearDeviceObjects();
+}
+
+bool CSoftwareRender::InitDeviceObjects()
+{
+	m_width = windowSetting.uDisplayWidth;
+	m_height = windowSetting.uDisplayHeight;
+	m_colorBuffer.assign(m_width*m_height, 0xFF000000);
+	m_depthBuffer.assign(m_width*m_height, 1.0f);
+	m_vpLeft = m_vpTop = 0;
+	m_vpRight = m_width;
+	m_vpBottom = m_height;
+
+	return CNullRender::InitDeviceObjects();
+}
+
+void CSoftwareRender::SetCombinerAndBlender()
+{
+	CRender::SetCombinerAndBlender();
+	m_blendType = CBlender::GetBlendType();
+}
+
+void CSoftwareRender::SetAlphaRef(uint32 dwAlpha)
+{
+	CNullRender::SetAlphaRef(dwAlpha);
+	m_dwAlphaRef = dwAlpha;
+}
+
+void CSoftwareRender::ForceAlphaRef(uint32 dwAlpha)
+{
+	CNullRender::ForceAlphaRef(dwAlpha);
+	m_dwAlphaRef = dwAlpha;
+}
+
+void CSoftwareRender::SetAlphaTestEnable(BOOL bAlphaTestEnable)
+{
+	CNullRender::SetAlphaTestEnable(bAlphaTestEnable);
+	m_bAlphaTestEnable = bAlphaTestEnable ? true : false;
+}
+
+void CSoftwareRender::ClearRect(int left, int top, int right, int bottom, bool cbuffer, uint32 color, bool zbuffer, float depth)
+{
+	// Direct3D clears within the viewport only
+	left = max(left, m_vpLeft);
+	top = max(top, m_vpTop);
+	right = min(right, m_vpRight);
+	bottom = min(bottom, m_vpBottom);
+
+	for( int y=top; y<bottom; y++ )
+	{
+		for( int x=left; x<right; x++ )
+		{
+			if( cbuffer )	m_colorBuffer[y*m_width+x] = color;
+			if( zbuffer )	m_depthBuffer[y*m_width+x] = depth;
+		}
+	}
+}
+
+void CSoftwareRender::ClearBuffer(bool cbuffer, bool zbuffer)
+{
+	CNullRender::ClearBuffer(cbuffer, zbuffer);
+
+	float depth = ((gRDP.originalFillColor&0xFFFF)>>2)/(float)0x3FFF;
+	ClearRect(0, 0, m_width, m_height, cbuffer, 0xFF000000, zbuffer, depth);
+}
+
+void CSoftwareRender::ClearBuffer(bool cbuffer, bool zbuffer, D3DRECT &rect)
+{
+	CNullRender::ClearBuffer(cbuffer, zbuffer);
+
+	float depth = ((gRDP.originalFillColor&0xFFFF)>>2)/(float)0x3FFF;
+	ClearRect(rect.x1, rect.y1, rect.x2, rect.y2, cbuffer, 0xFF000000, zbuffer, depth);
+}
+
+void CSoftwareRender::ClearZBuffer(float depth)
+{
+	CNullRender::ClearZBuffer(depth);
+	ClearRect(0, 0, m_width, m_height, false, 0, true, depth);
+}
+
+void CSoftwareRender::ClearSurface(ClearFlag dwFlags, uint32 color, float depth)
+{
+	ClearRect(0, 0, m_width, m_height, (dwFlags&CLEAR_COLOR_BUFFER) != 0, color, (dwFlags&CLEAR_DEPTH_BUFFER) != 0, depth);
+}
+
+void CSoftwareRender::SetViewportRect(int left, int top, int width, int height)
+{
+	// Same limits as the Direct3D viewport
+	if( width+left > m_width-1 )	width = m_width-1-left;
+	if( height+top > m_height-1 )	height = m_height-1-top;
+
+	m_vpLeft = max(left, 0);
+	m_vpTop = max(top, 0);
+	m_vpRight = max(min(left+width, m_width), m_vpLeft);
+	m_vpBottom = max(min(top+height, m_height), m_vpTop);
+}
+
+void CSoftwareRender::ApplyRDPScissor(bool force)
+{
+	if( !force && status.curScissor == RDP_SCISSOR )
+		return;
+
+	if( options.bEnableHacks && g_CI.dwWidth == 0x200 && gRDP.scissor.right == 0x200 && g_CI.dwWidth>(*g_GraphicsInfo.VI_WIDTH_REG & 0xFFF) )
+	{
+		// Hack for RE2
+		uint32 width = *g_GraphicsInfo.VI_WIDTH_REG & 0xFFF;
+		uint32 height = (gRDP.scissor.right*gRDP.scissor.bottom)/width;
+		SetViewportRect(0, 0, (uint32)(width*windowSetting.fMultX), (uint32)(height*windowSetting.fMultY));
+	}
+	else
+	{
+		SetViewportRect((uint32)(gRDP.scissor.left*windowSetting.fMultX),
+			(uint32)(gRDP.scissor.top*windowSetting.fMultY),
+			(uint32)((gRDP.scissor.right-gRDP.scissor.left+1)*windowSetting.fMultX),
+			(uint32)((gRDP.scissor.bottom-gRDP.scissor.top+1)*windowSetting.fMultY));
+	}
+
+	status.curScissor = RDP_SCISSOR;
+}
+
+void CSoftwareRender::ApplyScissorWithClipRatio(bool force)
+{
+	if( !force && status.curScissor == RSP_SCISSOR )	return;
+
+	WindowSettingStruct &w = windowSetting;
+	SetViewportRect(w.clipping.left, w.clipping.top, w.clipping.width, w.clipping.height);
+	status.curScissor = RSP_SCISSOR;
+}
+
+void CSoftwareRender::BeginDraw(SoftwarePixelMode mode)
+{
+	m_pixelMode = mode;
+	memset(m_samplers, 0, sizeof(m_samplers));
+
+	int tiles[2] = { -1, -1 };
+	switch( mode )
+	{
+	case SOFT_PIXEL_COMBINE:
+		if( m_pColorCombiner->m_pDecodedMux->m_bTexel0IsUsed )	tiles[0] = gRSP.curTile;
+		if( m_pColorCombiner->m_pDecodedMux->m_bTexel1IsUsed )	tiles[1] = (gRSP.curTile+1)&7;
+		m_drawBlendType = m_blendType;
+		m_bDrawAlphaTest = m_bAlphaTestEnable;
+		break;
+	case SOFT_PIXEL_COPY:
+		tiles[0] = gRSP.curTile;
+		m_drawBlendType = kBlendModeOpaque;
+		m_bDrawAlphaTest = true;
+		break;
+	case SOFT_PIXEL_SIMPLE_TEXTURE:
+		tiles[0] = 0;
+		m_drawBlendType = kBlendModeOpaque;
+		m_bDrawAlphaTest = true;
+		break;
+	default:
+		m_drawBlendType = m_blendType;
+		m_bDrawAlphaTest = m_bAlphaTestEnable;
+		break;
+	}
+
+	for( int i=0; i<2; i++ )
+	{
+		if( tiles[i] < 0 || g_textures[tiles[i]].m_pCTexture == NULL )
+			continue;
+
+		SoftwareSampler &sampler = m_samplers[i];
+		if( g_textures[tiles[i]].m_pCTexture->StartUpdate(&sampler.info) )
+		{
+			sampler.pTexture = g_textures[tiles[i]].m_pCTexture;
+			sampler.addressU = mode == SOFT_PIXEL_SIMPLE_TEXTURE ? D3DTADDRESS_CLAMP : TileUFlags[tiles[i]];
+			sampler.addressV = mode == SOFT_PIXEL_SIMPLE_TEXTURE ? D3DTADDRESS_CLAMP : TileVFlags[tiles[i]];
+		}
+	}
+
+	// ZENABLE is set by either of them in D3DRender
+	m_bDrawDepth = m_bZCompare || m_bZUpdate;
+
+	if( mode == SOFT_PIXEL_COMBINE )
+	{
+		float *prim = GetPrimitiveColorfv();
+		float *env = GetEnvColorfv();
+		float frac = gRDP.LODFrac / 255.0f;
+		float frac2 = gRDP.primLODFrac / 255.0f;
+		for( int i=0; i<4; i++ )
+		{
+			m_muxInputs[MUX_0][i] = 0;
+			m_muxInputs[MUX_1][i] = 1;
+			m_muxInputs[MUX_PRIM][i] = prim[i];
+			m_muxInputs[MUX_ENV][i] = env[i];
+			m_muxInputs[MUX_LODFRAC][i] = frac;
+			m_muxInputs[MUX_PRIMLODFRAC][i] = frac2;
+			m_muxInputs[MUX_K5][i] = 1;
+			m_muxInputs[MUX_UNK][i] = 0;
+		}
+	}
+}
+
+void CSoftwareRender::EndDraw()
+{
+	for( int i=0; i<2; i++ )
+	{
+		if( m_samplers[i].pTexture != NULL )
+		{
+			m_samplers[i].pTexture->EndUpdate(&m_samplers[i].info);
+			m_samplers[i].pTexture = NULL;
+		}
+	}
+}
+
+void CSoftwareRender::ShadePixel(int x, int y, float z, const float *color, const float *tex)
+{
+	int idx = y*m_width+x;
+	float out[4];
+
+	switch( m_pixelMode )
+	{
+	case SOFT_PIXEL_FILL:
+		out[0] = color[0]; out[1] = color[1]; out[2] = color[2]; out[3] = color[3];
+		break;
+	case SOFT_PIXEL_COPY:
+	case SOFT_PIXEL_SIMPLE_TEXTURE:
+		SampleTexture(m_samplers[0], tex[0], tex[1], out);
+		break;
+	default:
+		{
+			const uint8 *mux = m_pColorCombiner->m_pDecodedMux->m_bytes;
+			if( m_pColorCombiner->m_pDecodedMux->m_bTexel0IsUsed )	SampleTexture(m_samplers[0], tex[0], tex[1], m_muxInputs[MUX_TEXEL0]);
+			if( m_pColorCombiner->m_pDecodedMux->m_bTexel1IsUsed )	SampleTexture(m_samplers[1], tex[2], tex[3], m_muxInputs[MUX_TEXEL1]);
+			memcpy(m_muxInputs[MUX_SHADE], color, sizeof(float)*4);
+
+			// r1, the combined color, is not written yet in the first cycle
+			memset(m_muxInputs[MUX_COMBINED], 0, sizeof(float)*4);
+			float r1[4];
+			for( int i=0; i<3; i++ )	r1[i] = CombineMuxChannel(m_muxInputs, mux+0, i);
+			r1[3] = CombineMuxChannel(m_muxInputs, mux+4, 3);
+
+			memcpy(m_muxInputs[MUX_COMBINED], r1, sizeof(r1));
+			for( int i=0; i<3; i++ )	out[i] = CombineMuxChannel(m_muxInputs, mux+8, i);
+			out[3] = CombineMuxChannel(m_muxInputs, mux+12, 3);
+		}
+		break;
+	}
+
+	// D3DCMP_GREATEREQUAL
+	if( m_bDrawAlphaTest && FloatToByte(out[3]) < m_dwAlphaRef )
+		return;
+
+	// D3DCMP_LESSEQUAL
+	if( m_bDrawDepth )
+	{
+		if( z > m_depthBuffer[idx] )
+			return;
+		if( m_bZUpdate )
+			m_depthBuffer[idx] = z;
+	}
+
+	if( m_drawBlendType != kBlendModeOpaque )
+	{
+		float dst[4];
+		ColorToFloats(m_colorBuffer[idx], dst);
+
+		float srcFactor, dstFactor;
+		float sa = Saturate(out[3]);
+		switch( m_drawBlendType )
+		{
+		case kBlendModeAlphaTrans:			srcFactor = sa;		dstFactor = 1-sa;	break;
+		case kBlendModeFade:				srcFactor = 0;		dstFactor = 1-sa;	break;
+		case kBlendModeOne:					srcFactor = 1;		dstFactor = 1;		break;
+		case kBlendModeZeroOne:				srcFactor = 0;		dstFactor = 1;		break;
+		case kBlendModeAlphaTransInvSrc:	srcFactor = 1-sa;	dstFactor = sa;		break;
+		case kBlendModeOneSrc:				srcFactor = 1;		dstFactor = sa;		break;
+		default:							srcFactor = 1;		dstFactor = 0;		break;
+		}
+
+		for( int i=0; i<4; i++ )
+			out[i] = out[i]*srcFactor + dst[i]*dstFactor;
+	}
+
+	m_colorBuffer[idx] = FloatsToColor(out);
+}
+
+void CSoftwareRender::DrawTriangle(const TLITVERTEX &v0, const TLITVERTEX &v1, const TLITVERTEX &v2, float zBias)
+{
+	const TLITVERTEX *v[3] = { &v0, &v1, &v2 };
+	float area = EdgeFunction(v0, v1, v2.x, v2.y);
+	if( area == 0 )
+		return;
+
+	// No culling, like D3DCULL_NONE
+	if( area < 0 )
+	{
+		v[1] = &v2;
+		v[2] = &v1;
+		area = -area;
+	}
+
+	float minX = min(v0.x, min(v1.x, v2.x));
+	float maxX = max(v0.x, max(v1.x, v2.x));
+	float minY = min(v0.y, min(v1.y, v2.y));
+	float maxY = max(v0.y, max(v1.y, v2.y));
+
+	int left = max(m_vpLeft, (int)ceilf(max(minX, -65536.0f)));
+	int right = min(m_vpRight-1, (int)floorf(min(maxX, 65536.0f)));
+	int top = max(m_vpTop, (int)ceilf(max(minY, -65536.0f)));
+	int bottom = min(m_vpBottom-1, (int)floorf(min(maxY, 65536.0f)));
+	if( left > right || top > bottom )
+		return;
+
+	bool topLeft[3] = {
+		IsTopLeftEdge(*v[1], *v[2]),
+		IsTopLeftEdge(*v[2], *v[0]),
+		IsTopLeftEdge(*v[0], *v[1]) };
+
+	// Flat shading takes the color of the first vertex
+	bool flat = gRSP.shadeMode == SHADE_DISABLED || gRSP.shadeMode == SHADE_FLAT;
+	float colors[3][4];
+	for( int i=0; i<3; i++ )
+		ColorToFloats(flat ? v0.dcDiffuse : v[i]->dcDiffuse, colors[i]);
+
+	for( int y=top; y<=bottom; y++ )
+	{
+		for( int x=left; x<=right; x++ )
+		{
+			float w[3];
+			w[0] = EdgeFunction(*v[1], *v[2], (float)x, (float)y);
+			w[1] = EdgeFunction(*v[2], *v[0], (float)x, (float)y);
+			w[2] = EdgeFunction(*v[0], *v[1], (float)x, (float)y);
+
+			bool inside = true;
+			for( int i=0; i<3; i++ )
+			{
+				if( w[i] < 0 || (w[i] == 0 && !topLeft[i]) )
+					inside = false;
+			}
+			if( !inside )
+				continue;
+
+			float b[3] = { w[0]/area, w[1]/area, w[2]/area };
+			float z = b[0]*v[0]->z + b[1]*v[1]->z + b[2]*v[2]->z + zBias;
+
+			// The colors and texture coordinates are perspective correct
+			float rhw = b[0]*v[0]->rhw + b[1]*v[1]->rhw + b[2]*v[2]->rhw;
+			float p[3];
+			for( int i=0; i<3; i++ )
+				p[i] = rhw > 0 ? b[i]*v[i]->rhw/rhw : b[i];
+
+			float color[4];
+			float tex[4];
+			for( int i=0; i<4; i++ )
+				color[i] = p[0]*colors[0][i] + p[1]*colors[1][i] + p[2]*colors[2][i];
+			tex[0] = p[0]*v[0]->tcord[0].u + p[1]*v[1]->tcord[0].u + p[2]*v[2]->tcord[0].u;
+			tex[1] = p[0]*v[0]->tcord[0].v + p[1]*v[1]->tcord[0].v + p[2]*v[2]->tcord[0].v;
+			tex[2] = p[0]*v[0]->tcord[1].u + p[1]*v[1]->tcord[1].u + p[2]*v[2]->tcord[1].u;
+			tex[3] = p[0]*v[0]->tcord[1].v + p[1]*v[1]->tcord[1].v + p[2]*v[2]->tcord[1].v;
+
+			ShadePixel(x, y, z, color, tex);
+		}
+	}
+}
+
+bool CSoftwareRender::RenderFlushTris()
+{
+	CNullRender::RenderFlushTris();
+	if( m_colorBuffer.empty() )
+		return true;
+
+	// As ApplyZBias in D3DRender
+	float zBias = m_dwZBias > 0 ? -0.00075f : 0.0f;
+
+	BeginDraw(GetPixelMode());
+	for( int i=0; i+2<g_clippedVtxCount; i+=3 )
+	{
+		DrawTriangle(g_clippedVtxBuffer[i], g_clippedVtxBuffer[i+1], g_clippedVtxBuffer[i+2], zBias);
+	}
+	EndDraw();
+	return true;
+}
+
+bool CSoftwareRender::RenderTexRect()
+{
+	CNullRender::RenderTexRect();
+	if( m_colorBuffer.empty() )
+		return true;
+
+	BeginDraw(GetPixelMode());
+	DrawTriangle(g_texRectTVtx[1], g_texRectTVtx[0], g_texRectTVtx[2], 0);
+	DrawTriangle(g_texRectTVtx[2], g_texRectTVtx[0], g_texRectTVtx[3], 0);
+	EndDraw();
+	return true;
+}
+
+bool CSoftwareRender::RenderFillRect(uint32 dwColor, float depth)
+{
+	CNullRender::RenderFillRect(dwColor, depth);
+	if( m_colorBuffer.empty() )
+		return true;
+
+	TLITVERTEX vtx[4];
+	memset(vtx, 0, sizeof(vtx));
+	for( int i=0; i<4; i++ )
+	{
+		vtx[i].x = m_fillRectVtx[i==1||i==2 ? 1 : 0].x;
+		vtx[i].y = m_fillRectVtx[i>=2 ? 1 : 0].y;
+		vtx[i].z = depth;
+		vtx[i].rhw = 1;
+		vtx[i].dcDiffuse = dwColor;
+	}
+
+	BeginDraw(GetPixelMode());
+	DrawTriangle(vtx[1], vtx[0], vtx[2], 0);
+	DrawTriangle(vtx[2], vtx[0], vtx[3], 0);
+	EndDraw();
+	return true;
+}
+
+bool CSoftwareRender::RenderLine3D()
+{
+	CNullRender::RenderLine3D();
+	if( m_colorBuffer.empty() )
+		return true;
+
+	TLITVERTEX vtx[4];
+	memset(vtx, 0, sizeof(vtx));
+	for( int i=0; i<4; i++ )
+	{
+		vtx[i].x = m_line3DVector[i].x;
+		vtx[i].y = m_line3DVector[i].y;
+		vtx[i].z = m_line3DVtx[0].z;
+		vtx[i].rhw = m_line3DVtx[0].rhw;
+		vtx[i].dcDiffuse = m_line3DVtx[i/2].dcDiffuse;
+	}
+
+	BeginDraw(GetPixelMode());
+	DrawTriangle(vtx[1], vtx[0], vtx[2], 0);
+	DrawTriangle(vtx[2], vtx[1], vtx[3], 0);
+	EndDraw();
+	return true;
+}
+
+void CSoftwareRender::DrawSimple2DTexture(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, D3DCOLOR dif, float z, float rhw)
+{
+	CNullRender::DrawSimple2DTexture(x0, y0, x1, y1, u0, v0, u1, v1, dif, z, rhw);
+	if( m_colorBuffer.empty() )
+		return;
+
+	BeginDraw(SOFT_PIXEL_SIMPLE_TEXTURE);
+	DrawTriangle(g_texRectTVtx[1], g_texRectTVtx[0], g_texRectTVtx[2], 0);
+	DrawTriangle(g_texRectTVtx[2], g_texRectTVtx[0], g_texRectTVtx[3], 0);
+	EndDraw();
+}
+
+void CSoftwareRender::CaptureScreen(char *filename)
+{
+	if( m_colorBuffer.empty() )
+		return;
+
+	// SaveRGBABufferToPNGFile takes the rows bottom-up, the alpha of the back buffer is not saved
+	std::vector<uint32> buf(m_width*m_height);
+	for( int y=0; y<m_height; y++ )
+	{
+		const uint32 *pSrc = &m_colorBuffer[(m_height-1-y)*m_width];
+		uint32 *pDst = &buf[y*m_width];
+		for( int x=0; x<m_width; x++ )
+			pDst[x] = pSrc[x] | 0xFF000000;
+	}
+
+	SaveRGBABufferToPNGFile(filename, (unsigned char*)&buf[0], m_width, m_height);
+	TRACE1("Capture screen to %s", filename);
+}
@@ -0,0 +1,116 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef __RICE_SOFTWARERENDER_H__
+#define __RICE_SOFTWARERENDER_H__
+
+#include <vector>
+
+// A texture stage of the software render, locked for the duration of one draw
+struct SoftwareSampler
+{
+	CTexture	*pTexture;		// NULL if the stage has no texture, it samples as opaque black
+	DrawInfo	info;
+	int			addressU;		// D3DTADDRESS_WRAP, D3DTADDRESS_MIRROR or D3DTADDRESS_CLAMP
+	int			addressV;
+};
+
+enum SoftwarePixelMode
+{
+	SOFT_PIXEL_COMBINE,			// 1 and 2 cycle modes, the decoded mux like the pixel shader combiner
+	SOFT_PIXEL_COPY,			// texel 0
+	SOFT_PIXEL_FILL,			// diffuse color
+	SOFT_PIXEL_SIMPLE_TEXTURE,	// texel of tile 0, no blending, for DrawSimple2DTexture
+};
+
+/********************************************************************************************************************
+ * Reference render used by the HeadlessRender option together with the SoftwareRender option. The frames are drawn
+ * in system memory, one pixel at a time, so that the output of the clipper, the vertex pipeline and the texture
+ * converters can be saved and compared as images without a GPU.
+ *
+ * It follows the Direct3D render: integer pixel centers, the viewport as the clip rectangle, LESSEQUAL depth test,
+ * GREATEREQUAL alpha test, the two cycles of the pixel shader combiner and the blend modes of CBlender. Textures
+ * are point sampled, fog and the specular color are not drawn.
+ ********************************************************************************************************************/
+class CSoftwareRender : public CNullRender
+{
+public:
+	CSoftwareRender();
+	~CSoftwareRender();
+
+	bool InitDeviceObjects();
+	bool ClearDeviceObjects();
+
+	void SetCombinerAndBlender();
+	void SetAlphaRef(uint32 dwAlpha);
+	void ForceAlphaRef(uint32 dwAlpha);
+	void SetAlphaTestEnable(BOOL bAlphaTestEnable);
+
+	void ClearBuffer(bool cbuffer, bool zbuffer);
+	void ClearBuffer(bool cbuffer, bool zbuffer, D3DRECT &rect);
+	void ClearZBuffer(float depth);
+	// Clears the buffers within the viewport, like CGraphicsContext::Clear
+	void ClearSurface(ClearFlag dwFlags, uint32 color, float depth);
+
+	void DrawSimple2DTexture(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, D3DCOLOR dif, float z, float rhw);
+
+	void ApplyRDPScissor(bool force=false);
+	void ApplyScissorWithClipRatio(bool force=false);
+	void CaptureScreen(char *filename);
+
+	static CSoftwareRender *g_pSoftwareRender;
+
+protected:
+	bool RenderFlushTris();
+	bool RenderTexRect();
+	bool RenderFillRect(uint32 dwColor, float depth);
+	bool RenderLine3D();
+
+	void SetViewportRect(int left, int top, int width, int height);
+	void ClearRect(int left, int top, int right, int bottom, bool cbuffer, uint32 color, bool zbuffer, float depth);
+
+	void BeginDraw(SoftwarePixelMode mode);
+	void EndDraw();
+	void DrawTriangle(const TLITVERTEX &v0, const TLITVERTEX &v1, const TLITVERTEX &v2, float zBias);
+	void ShadePixel(int x, int y, float z, const float *color, const float *tex);
+
+	std::vector<uint32>	m_colorBuffer;		// A8R8G8B8, top-down
+	std::vector<float>	m_depthBuffer;
+	int					m_width;
+	int					m_height;
+
+	int		m_vpLeft;		// viewport, right and bottom are exclusive
+	int		m_vpTop;
+	int		m_vpRight;
+	int		m_vpBottom;
+
+	BlendType	m_blendType;
+	uint32		m_dwAlphaRef;
+	bool		m_bAlphaTestEnable;
+
+	// Per draw states
+	SoftwarePixelMode	m_pixelMode;
+	BlendType			m_drawBlendType;
+	bool				m_bDrawAlphaTest;
+	bool				m_bDrawDepth;
+	SoftwareSampler		m_samplers[2];
+	float				m_muxInputs[MUX_UNK+1][4];	// rgba of each mux input
+};
+
+#endif // __RICE_SOFTWARERENDER_H__
@@ -17,7 +17,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 */
 
-#include "..\stdafx.h"
+#include "../stdafx.h"
+#include "TextureFilters/TextureCompress.h"
 
 
 
@@ -28,6 +29,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 CTexture::CTexture(uint32 dwWidth, uint32 dwHeight, TextureUsage usage) :
 	m_pTexture(NULL),
+	m_pMemory(NULL),
 	m_dwWidth(dwWidth),
 	m_dwHeight(dwHeight),
 	m_dwCreatedTextureWidth(dwWidth),
@@ -35,6 +37,7 @@ CTexture::CTexture(uint32 dwWidth, uint32 dwHeight, TextureUsage usage) :
 	m_fXScale(1.0f),
 	m_fYScale(1.0f),
 	m_bIsEnhancedTexture(false),
+	m_bCompressed(false),
 	m_Usage(usage)
 {
 	LPDIRECT3DTEXTURE9 pTxt;
@@ -50,11 +53,13 @@ CTexture::CTexture(uint32 dwWidth, uint32 dwHeight, TextureUsage usage) :
 
 	pTxt = CreateTexture(dwWidth, dwHeight, usage);
 
+#ifdef _WIN32
 	// Copy from old surface to new surface
 	if (m_pTexture != NULL)
 	{
 		m_pTexture->Release();
 	}
+#endif
 
 	m_dwWidth = dwWidth;
 	m_dwHeight = dwHeight;
@@ -62,10 +67,31 @@ CTexture::CTexture(uint32 dwWidth, uint32 dwHeight, TextureUsage usage) :
 }
 
 
+CTexture::CTexture(uint32 dwWidth, uint32 dwHeight, const BCTexture &data) :
+	m_pTexture(NULL),
+	m_pMemory(NULL),
+	m_dwWidth(dwWidth),
+	m_dwHeight(dwHeight),
+	m_dwCreatedTextureWidth(data.width),
+	m_dwCreatedTextureHeight(data.height),
+	m_bIsEnhancedTexture(false),
+	m_bCompressed(true),
+	m_Usage(AS_NORMAL)
+{
+	m_fXScale = (float)m_dwCreatedTextureWidth/(float)m_dwWidth;
+	m_fYScale = (float)m_dwCreatedTextureHeight/(float)m_dwHeight;
+	m_pTexture = CreateCompressedTexture(data);
+}
+
 CTexture::~CTexture(void)
 {
-	m_pTexture->Release();
+#ifdef _WIN32
+	if (m_pTexture != NULL)
+		m_pTexture->Release();
+#endif
 	m_pTexture = NULL;
+	delete [] m_pMemory;
+	m_pMemory = NULL;
 	m_dwWidth = 0;
 	m_dwHeight = 0;
 }
@@ -77,9 +103,26 @@ CTexture::~CTexture(void)
 // call to EndUpdate();
 bool CTexture::StartUpdate(DrawInfo *di)
 {
-	if (m_pTexture == NULL)
+	if (m_pMemory != NULL)
+	{
+		di->dwHeight = (uint16)m_dwHeight;
+		di->dwWidth = (uint16)m_dwWidth;
+		di->dwCreatedHeight = m_dwCreatedTextureHeight;
+		di->dwCreatedWidth = m_dwCreatedTextureWidth;
+		di->lpSurface = m_pMemory;
+		di->lPitch    = m_dwCreatedTextureWidth*4;
+		return true;
+	}
+
+	// the blocks of a compressed surface are no pixels
+	if (m_pTexture == NULL || m_bCompressed)
 		return false;
 
+#ifdef _WIN32
+	// the batched triangles may still sample the old texels
+	if (CRender::g_pRender != NULL)
+		CRender::g_pRender->FlushBatchedTris();
+
 	D3DLOCKED_RECT d3d_lr;
 	HRESULT hr = m_pTexture->LockRect(0, &d3d_lr, NULL, D3DLOCK_NOSYSLOCK);
 	if (SUCCEEDED(hr))
@@ -92,10 +135,8 @@ bool CTexture::StartUpdate(DrawInfo *di)
 		di->lPitch    = d3d_lr.Pitch;
 		return true;
 	}
-	else
-	{
-		return false;
-	}
+#endif
+	return false;
 }
 
 ///////////////////////////////////////////////////
@@ -106,7 +147,9 @@ void CTexture::EndUpdate(DrawInfo *di)
 	if (m_pTexture == NULL)
 		return;
 
+#ifdef _WIN32
 	m_pTexture->UnlockRect( 0 );
+#endif
 }
 
 LPDIRECT3DTEXTURE9 CTexture::CreateTexture(uint32 dwWidth, uint32 dwHeight, TextureUsage usage)
@@ -141,6 +184,19 @@ LPDIRECT3DTEXTURE9 CTexture::CreateTexture(uint32 dwWidth, uint32 dwHeight, Text
 	m_dwWidth = dwWidth;
 	m_dwHeight = dwHeight;
 
+#ifdef _WIN32
+	if( g_pD3DDev == NULL )
+#endif
+	{
+		// the null render keeps the pixels in system memory
+		m_fYScale = (float)m_dwCreatedTextureHeight/(float)m_dwHeight;
+		m_fXScale = (float)m_dwCreatedTextureWidth/(float)m_dwWidth;
+		m_pMemory = new unsigned char[w*h*4];
+		memset(m_pMemory, 0, w*h*4);
+		return NULL;
+	}
+
+#ifdef _WIN32
 	if( m_Usage == AS_RENDER_TARGET)
 	{
 		D3DXCheckTextureRequirements(g_pD3DDev, &m_dwCreatedTextureWidth, &m_dwCreatedTextureHeight, &dwNumMaps,D3DUSAGE_AUTOGENMIPMAP | D3DUSAGE_RENDERTARGET, &pf, D3DPOOL_DEFAULT);
@@ -184,4 +240,81 @@ LPDIRECT3DTEXTURE9 CTexture::CreateTexture(uint32 dwWidth, uint32 dwHeight, Text
 		return NULL;
 	}
 	return lpSurf;		
-}
\ No newline at end of file
+#endif
+}
+
+LPDIRECT3DTEXTURE9 CTexture::CreateCompressedTexture(const BCTexture &data)
+{
+#ifndef _WIN32
+	return NULL;
+#else
+	LPDIRECT3DTEXTURE9 lpSurf = NULL;
+	D3DFORMAT pf = data.bBC3 ? D3DFMT_DXT5 : D3DFMT_DXT1;
+
+	if (g_pD3DDev == NULL)
+		return NULL;
+
+	HRESULT hr = g_pD3DDev->CreateTexture(data.width, data.height, (UINT)data.levels.size(), 0, pf, D3DPOOL_MANAGED, &lpSurf, NULL);
+	if (FAILED(hr) || lpSurf == NULL)
+	{
+		TRACE2("Unable to create compressed surface %d x %d", data.width, data.height);
+		return NULL;
+	}
+
+	uint32 width = data.width;
+	uint32 height = data.height;
+	for (UINT level = 0; level < data.levels.size(); level++)
+	{
+		uint32 rowSize = (width+3)/4 * (data.bBC3 ? BC3_BLOCK_SIZE : BC1_BLOCK_SIZE);
+		uint32 rows = (height+3)/4;
+
+		D3DLOCKED_RECT d3d_lr;
+		if (FAILED(lpSurf->LockRect(level, &d3d_lr, NULL, 0)))
+		{
+			lpSurf->Release();
+			return NULL;
+		}
+		for (uint32 y = 0; y < rows; y++)
+			memcpy((BYTE*)d3d_lr.pBits + y*d3d_lr.Pitch, &data.levels[level][y*rowSize], rowSize);
+		lpSurf->UnlockRect(level);
+
+		width = width > 1 ? width/2 : 1;
+		height = height > 1 ? height/2 : 1;
+	}
+
+	return lpSurf;
+#endif
+}
+
+//////////////////////////////////////////////////
+// Compresses the surface to DXT1 if it is opaque, to
+// DXT5 otherwise. The mip levels are built on the CPU,
+// the hardware does not generate them for DXT surfaces.
+bool CTexture::Compress(BCTexture *pData)
+{
+	// DXT surfaces are made of 4x4 blocks
+	if (m_pTexture == NULL || m_bCompressed || m_Usage != AS_NORMAL || m_dwCreatedTextureWidth < 4 || m_dwCreatedTextureHeight < 4)
+		return false;
+
+	DrawInfo di;
+	if (!StartUpdate(&di))
+		return false;
+
+	BCTexture data;
+	CompressTextureBC((uint32*)di.lpSurface, m_dwCreatedTextureWidth, m_dwCreatedTextureHeight, di.lPitch, options.bMipMaps != FALSE, data);
+	EndUpdate(&di);
+
+	LPDIRECT3DTEXTURE9 pTxt = CreateCompressedTexture(data);
+	if (pTxt == NULL)
+		return false;
+
+#ifdef _WIN32
+	m_pTexture->Release();
+#endif
+	m_pTexture = pTxt;
+	m_bCompressed = true;
+
+	if (pData != NULL)
+		*pData = data;
+	return true;
+}
@@ -25,6 +25,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 ///////////////  storage for all the surfaces
 ///////////////  created so far.
 class CTexture;
+struct BCTexture;
 
 struct DrawInfo{
 	unsigned int	dwWidth;			// Describes the width of the real texture area. Use lPitch to move between successive lines
@@ -55,20 +56,30 @@ public:
 	float		m_fYScale;		// = m_dwCorrectedHeight/m_dwWidth
 
 	bool		m_bIsEnhancedTexture;
+	bool		m_bCompressed;		// DXT1/DXT5 surface, it cannot be updated
 	
 	TextureUsage	m_Usage;
 
 	LPDIRECT3DTEXTURE9 GetTexture() { return m_pTexture; }
+	// The texture has its pixels, in a Direct3D texture or in system memory for the null render
+	bool IsCreated() { return m_pTexture != NULL || m_pMemory != NULL; }
 
 	// Provides access to "surface"
 	bool StartUpdate(DrawInfo *di);
 	void EndUpdate(DrawInfo *di);
 	
+	// Replaces the A8R8G8B8 surface by a block compressed copy, optionally returning the compressed data
+	bool Compress(BCTexture *pData = NULL);
+
 	CTexture(uint32 dwWidth, uint32 dwHeight, TextureUsage usage = AS_NORMAL);
+	// Creates a block compressed texture, GetTexture() returns NULL if it cannot be created
+	CTexture(uint32 dwWidth, uint32 dwHeight, const BCTexture &data);
 
 protected:
 	LPDIRECT3DTEXTURE9 CreateTexture(uint32 dwWidth, uint32 dwHeight, TextureUsage usage = AS_NORMAL);
+	LPDIRECT3DTEXTURE9 CreateCompressedTexture(const BCTexture &data);
 	LPDIRECT3DTEXTURE9	m_pTexture;
+	unsigned char		*m_pMemory;		// A8R8G8B8 pixels when there is no Direct3D device
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,318 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "..\..\stdafx.h"
+#include <string>
+#include "HiresTxtrCache.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+CMappedFile::CMappedFile() :
+	m_pData(NULL),
+	m_size(0)
+#ifdef _WIN32
+	,m_hFile(INVALID_HANDLE_VALUE),
+	m_hMapping(NULL)
+#endif
+{
+}
+
+CMappedFile::~CMappedFile()
+{
+	Close();
+}
+
+bool CMappedFile::Open(const char *filename, size_t maxSize)
+{
+	Close();
+
+#ifdef _WIN32
+	m_hFile = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if( m_hFile == INVALID_HANDLE_VALUE )
+		return false;
+
+	LARGE_INTEGER size;
+	if( !GetFileSizeEx(m_hFile, &size) || size.QuadPart == 0 )
+	{
+		Close();
+		return false;
+	}
+
+	if( maxSize > 0 && (uint64)maxSize < (uint64)size.QuadPart )
+		size.QuadPart = maxSize;
+	if( size.HighPart != 0 )
+	{
+		Close();
+		return false;
+	}
+
+	m_hMapping = CreateFileMapping(m_hFile, NULL, PAGE_READONLY, 0, size.LowPart, NULL);
+	if( m_hMapping == NULL )
+	{
+		Close();
+		return false;
+	}
+
+	m_pData = (const unsigned char *)MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, size.LowPart);
+	m_size = size.LowPart;
+#else
+	int fd = open(filename, O_RDONLY);
+	if( fd < 0 )
+		return false;
+
+	struct stat st;
+	if( fstat(fd, &st) == 0 && st.st_size > 0 )
+	{
+		size_t size = (size_t)st.st_size;
+		if( maxSize > 0 && maxSize < size )
+			size = maxSize;
+
+		void *p = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+		if( p != MAP_FAILED )
+		{
+			m_pData = (const unsigned char *)p;
+			m_size = size;
+		}
+	}
+	close(fd);
+#endif
+
+	if( m_pData == NULL )
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void CMappedFile::Close()
+{
+#ifdef _WIN32
+	if( m_pData )
+		UnmapViewOfFile(m_pData);
+	if( m_hMapping )
+		CloseHandle(m_hMapping);
+	if( m_hFile != INVALID_HANDLE_VALUE )
+		CloseHandle(m_hFile);
+	m_hMapping = NULL;
+	m_hFile = INVALID_HANDLE_VALUE;
+#else
+	if( m_pData )
+		munmap((void *)m_pData, m_size);
+#endif
+	m_pData = NULL;
+	m_size = 0;
+}
+
+void CHiresTxtrIndex::clear()
+{
+	FreeStrings(m_numMapped);
+	m_infos.clear();
+	m_keys.clear();
+
+	SAFE_DELETE(m_pMappedFile);
+	m_pSortedKeys = NULL;
+	m_numMapped = 0;
+}
+
+/********************************************************************************************************************
+ * Memory-maps a binary hires index file and attaches it to the index. The records are used in place, their strings
+ * point into the mapped file.
+ * parameter:
+ * filename: the index file
+ * fingerprint: the fingerprint of the pack folder tree, the file is only used if it has been written for it
+ * infos: the index, which is cleared and receives the records
+ * return:
+ * return value: false if the file is missing, damaged, of another version or out of date
+ ********************************************************************************************************************/
+bool LoadHiresIndexFile(const char *filename, uint64 fingerprint, CHiresTxtrIndex &infos)
+{
+	CMappedFile *pFile = new CMappedFile;
+	if( !pFile->Open(filename) || pFile->GetSize() < sizeof(HiresIndexHeader) )
+	{
+		delete pFile;
+		return false;
+	}
+
+	const unsigned char *pData = pFile->GetData();
+	size_t size = pFile->GetSize();
+	const HiresIndexHeader &header = *(const HiresIndexHeader *)pData;
+
+	if( header.magic != HIRES_INDEX_MAGIC || header.version != HIRES_INDEX_VERSION || header.fingerprint != fingerprint ||
+		header.keysOffset + (uint64)header.numRecords*sizeof(uint64) > size ||
+		header.recordsOffset + (uint64)header.numRecords*sizeof(HiresIndexRecord) > size ||
+		header.stringsOffset + (uint64)header.stringTableSize > size ||
+		header.stringTableSize == 0 || pData[header.stringsOffset+header.stringTableSize-1] != 0 ||
+		(header.keysOffset & 7) != 0 || (header.recordsOffset & 3) != 0 )
+	{
+		TRACE1("Hires index file is out of date or damaged: %s", filename);
+		delete pFile;
+		return false;
+	}
+
+	const uint64 *keys = (const uint64 *)(pData + header.keysOffset);
+	const HiresIndexRecord *records = (const HiresIndexRecord *)(pData + header.recordsOffset);
+	const char *strings = (const char *)(pData + header.stringsOffset);
+
+	std::vector<ExtTxtrInfo> infoList(header.numRecords);
+	for( uint32 i=0; i<header.numRecords; i++ )
+	{
+		const HiresIndexRecord &rec = records[i];
+		if( rec.foldername >= header.stringTableSize || rec.filename >= header.stringTableSize ||
+			(rec.filename_a != HIRES_INDEX_NO_STRING && rec.filename_a >= header.stringTableSize) ||
+			(i > 0 && keys[i] < keys[i-1]) )
+		{
+			TRACE1("Hires index file is damaged: %s", filename);
+			delete pFile;
+			return false;
+		}
+
+		ExtTxtrInfo &info = infoList[i];
+		info.width = rec.width;
+		info.height = rec.height;
+		info.crc32 = (int)(keys[i]>>32);
+		info.pal_crc32 = (int)(keys[i]&0xFFFFFFFF);
+		info.fmt = rec.fmt;
+		info.siz = rec.siz;
+		info.type = (TextureType)rec.type;
+		info.bSeparatedAlpha = rec.bSeparatedAlpha != 0;
+		info.scaleShift = 0;
+		info.packRecord = -1;
+		info.pHiresTextureRGB = NULL;
+		info.pHiresTextureAlpha = NULL;
+		info.pPreloadedTexture = NULL;
+		info.preloadedSize = 0;
+		info.foldername = (char *)strings + rec.foldername;
+		info.filename = (char *)strings + rec.filename;
+		info.filename_a = rec.filename_a == HIRES_INDEX_NO_STRING ? NULL : (char *)strings + rec.filename_a;
+	}
+
+	infos.attach(pFile, keys, infoList.size() ? &infoList[0] : NULL, (int)infoList.size());
+	return true;
+}
+
+static uint32 AddIndexString(std::string &table, std::unordered_map<std::string, uint32> &offsets, const char *str)
+{
+	if( str == NULL )
+		return HIRES_INDEX_NO_STRING;
+
+	std::unordered_map<std::string, uint32>::const_iterator it = offsets.find(str);
+	if( it != offsets.end() )
+		return it->second;
+
+	uint32 offset = (uint32)table.size();
+	table.append(str, strlen(str)+1);
+	offsets[str] = offset;
+	return offset;
+}
+
+struct HiresKeyOrder
+{
+	CHiresTxtrIndex *infos;
+	bool operator()(int a, int b) const
+	{
+		return HiresTxtrKey((*infos)[a].crc32, (*infos)[a].pal_crc32) < HiresTxtrKey((*infos)[b].crc32, (*infos)[b].pal_crc32);
+	}
+};
+
+/********************************************************************************************************************
+ * Writes the records of the index to a binary hires index file.
+ * parameter:
+ * filename: the index file
+ * fingerprint: the fingerprint of the pack folder tree the records have been found in
+ * infos: the index
+ * return:
+ * return value: false if the file could not be written
+ ********************************************************************************************************************/
+bool SaveHiresIndexFile(const char *filename, uint64 fingerprint, CHiresTxtrIndex &infos)
+{
+	int count = infos.size();
+
+	// variants of a key stay in the order they have been added, the first one is the fallback of find()
+	std::vector<int> order(count);
+	for( int i=0; i<count; i++ )
+		order[i] = i;
+	HiresKeyOrder keyOrder = { &infos };
+	std::stable_sort(order.begin(), order.end(), keyOrder);
+
+	std::vector<uint64> keys(count);
+	std::vector<HiresIndexRecord> records(count);
+	std::string strings;
+	std::unordered_map<std::string, uint32> stringOffsets;
+
+	for( int i=0; i<count; i++ )
+	{
+		ExtTxtrInfo &info = infos[order[i]];
+		HiresIndexRecord &rec = records[i];
+
+		keys[i] = HiresTxtrKey(info.crc32, info.pal_crc32);
+		rec.width = info.width;
+		rec.height = info.height;
+		rec.fmt = info.fmt;
+		rec.siz = info.siz;
+		rec.type = info.type;
+		rec.bSeparatedAlpha = info.bSeparatedAlpha ? 1 : 0;
+		rec.foldername = AddIndexString(strings, stringOffsets, info.foldername);
+		rec.filename = AddIndexString(strings, stringOffsets, info.filename);
+		rec.filename_a = AddIndexString(strings, stringOffsets, info.filename_a);
+		rec.reserved = 0;
+	}
+	strings.push_back(0);
+
+	HiresIndexHeader header;
+	header.magic = HIRES_INDEX_MAGIC;
+	header.version = HIRES_INDEX_VERSION;
+	header.numRecords = count;
+	header.stringTableSize = (uint32)strings.size();
+	header.fingerprint = fingerprint;
+	header.keysOffset = sizeof(HiresIndexHeader);
+	header.recordsOffset = header.keysOffset + count*sizeof(uint64);
+	header.stringsOffset = header.recordsOffset + count*sizeof(HiresIndexRecord);
+	header.reserved = 0;
+
+	FILE *f = fopen(filename, "wb");
+	if( f == NULL )
+	{
+		TRACE1("Cannot write hires index file: %s", filename);
+		return false;
+	}
+
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+	if( count > 0 )
+	{
+		ok = ok && fwrite(&keys[0], sizeof(uint64), count, f) == (size_t)count;
+		ok = ok && fwrite(&records[0], sizeof(HiresIndexRecord), count, f) == (size_t)count;
+	}
+	ok = ok && fwrite(strings.data(), 1, strings.size(), f) == strings.size();
+	fclose(f);
+
+	if( !ok )
+	{
+		TRACE1("Cannot write hires index file: %s", filename);
+		remove(filename);
+	}
+
+	return ok;
+}
@@ -0,0 +1,93 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef _HIRES_TXTR_CACHE_H_
+#define _HIRES_TXTR_CACHE_H_
+
+#include "HiresTxtrIndex.h"
+
+/*
+	Binary hires index file, written after a pack has been scanned and memory-mapped at the next start.
+
+	<HiresIndexHeader>
+	<uint64 keys[numRecords]>					sorted (crc32, pal_crc32) keys
+	<HiresIndexRecord records[numRecords]>		in the same order as the keys
+	<char strings[stringTableSize]>				zero terminated strings referenced by the records
+
+	The file is discarded if its fingerprint does not match the one of the pack folder tree.
+*/
+
+#define HIRES_INDEX_MAGIC		0x58444948	// "HIDX"
+#define HIRES_INDEX_VERSION		1
+#define HIRES_INDEX_NO_STRING	0xFFFFFFFF
+
+struct HiresIndexHeader
+{
+	uint32 magic;
+	uint32 version;
+	uint32 numRecords;
+	uint32 stringTableSize;
+	uint64 fingerprint;
+	uint32 keysOffset;
+	uint32 recordsOffset;
+	uint32 stringsOffset;
+	uint32 reserved;
+};
+
+struct HiresIndexRecord
+{
+	uint32 width;
+	uint32 height;
+	s32    fmt;
+	s32    siz;
+	uint32 type;
+	uint32 bSeparatedAlpha;
+	uint32 foldername;		// offsets in the string table
+	uint32 filename;
+	uint32 filename_a;
+	uint32 reserved;
+};
+
+// A read-only view of a file, or of its first maxSize bytes
+class CMappedFile
+{
+public:
+	CMappedFile();
+	~CMappedFile();
+
+	bool Open(const char *filename, size_t maxSize = 0);
+	void Close();
+
+	const unsigned char *GetData() { return m_pData; }
+	size_t GetSize() { return m_size; }
+
+private:
+	const unsigned char *m_pData;
+	size_t m_size;
+#ifdef _WIN32
+	HANDLE m_hFile;
+	HANDLE m_hMapping;
+#endif
+};
+
+// Maps the index file and attaches it to infos. Returns false if the file is missing, damaged or out of date.
+bool LoadHiresIndexFile(const char *filename, uint64 fingerprint, CHiresTxtrIndex &infos);
+bool SaveHiresIndexFile(const char *filename, uint64 fingerprint, CHiresTxtrIndex &infos);
+
+#endif
@@ -0,0 +1,213 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef _HIRES_TXTR_INDEX_H_
+#define _HIRES_TXTR_INDEX_H_
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+enum TextureType
+{
+	NO_TEXTURE,
+	RGB_PNG,
+	RGB_WITH_ALPHA_TOGETHER_PNG,
+};
+
+struct ExtTxtrInfo{
+	unsigned int width;
+	unsigned int height;
+	int crc32;
+	int pal_crc32;
+	int fmt;
+	int siz;
+	char *foldername;
+	char *filename;
+	char *filename_a;
+	TextureType type;
+	bool bSeparatedAlpha;
+	int scaleShift;
+	int packRecord;			// record of the texture in the pack file (see HiresTxtrPack.h), -1 for loose files
+	// cached texture
+	unsigned char	*pHiresTextureRGB;
+	unsigned char	*pHiresTextureAlpha;
+	// preloaded texture (see HiresTxtrPreload.h)
+	unsigned char	*pPreloadedTexture;
+	unsigned int	preloadedSize;
+};
+
+inline uint64 HiresTxtrKey(uint32 crc32, uint32 pal_crc32)
+{
+	return (((uint64)crc32)<<32) | (uint64)pal_crc32;
+}
+
+class CMappedFile;
+
+/********************************************************************************************************************
+ * Index of the hires textures found for the current rom.
+ * The records are stored in a flat array so that they can be walked by index (caching, saving the cache file), while
+ * a hash map from the (crc32, pal_crc32) key gives constant time lookups. Packs may provide several textures for the
+ * same key which only differ by their format and size, so every key maps to the list of these variants.
+ * When the index has been loaded from a binary index file (see HiresTxtrCache.h), the records point to the strings of
+ * the mapped file and the lookups are done by binary search in its sorted key array, no hash map is built.
+ ********************************************************************************************************************/
+class CHiresTxtrIndex
+{
+private:
+	std::vector<ExtTxtrInfo> m_infos;
+	std::unordered_map<uint64, std::vector<int> > m_keys;
+
+	// binary index file the first m_numMapped records come from
+	CMappedFile *m_pMappedFile;
+	const uint64 *m_pSortedKeys;
+	int m_numMapped;
+
+	void FreeStrings(int first)
+	{
+		for( size_t i=first; i<m_infos.size(); i++ )
+		{
+			free(m_infos[i].foldername);
+			free(m_infos[i].filename);
+			free(m_infos[i].filename_a);
+		}
+	}
+
+	// Switches from the sorted key array of the mapped file to the hash map, needed once records get added
+	void HashMappedKeys()
+	{
+		for( int i=0; i<m_numMapped; i++ )
+			m_keys[m_pSortedKeys[i]].push_back(i);
+		m_pSortedKeys = NULL;
+	}
+
+	int FindVariant(const int *variants, int count, int fmt, int siz)
+	{
+		if( count > 1 )
+		{
+			for( int i=0; i<count; i++ )
+			{
+				ExtTxtrInfo &info = m_infos[variants[i]];
+				if( info.fmt == fmt && info.siz == siz )
+					return variants[i];
+			}
+		}
+
+		return variants[0];
+	}
+
+public:
+	CHiresTxtrIndex() : m_pMappedFile(NULL), m_pSortedKeys(NULL), m_numMapped(0) {}
+	~CHiresTxtrIndex() { clear(); }
+
+	int size()
+	{
+		return (int)m_infos.size();
+	}
+
+	// Removes all records and frees their strings. The cached textures must have been freed by the caller.
+	void clear();
+
+	void reserve(int n)
+	{
+		m_infos.reserve(n);
+		m_keys.reserve(n);
+	}
+
+	ExtTxtrInfo& operator[](int index)
+	{
+		return m_infos[index];
+	}
+
+	// Exchanges the records of two indexes, used to publish an index built by another thread
+	void swap(CHiresTxtrIndex &other)
+	{
+		m_infos.swap(other.m_infos);
+		m_keys.swap(other.m_keys);
+		std::swap(m_pMappedFile, other.m_pMappedFile);
+		std::swap(m_pSortedKeys, other.m_pSortedKeys);
+		std::swap(m_numMapped, other.m_numMapped);
+	}
+
+	// Takes over a mapped binary index file. records[i] have their strings in the mapped file and keys[i] is the key
+	// of records[i], in ascending order.
+	void attach(CMappedFile *pFile, const uint64 *keys, const ExtTxtrInfo *records, int count)
+	{
+		clear();
+		m_pMappedFile = pFile;
+		m_pSortedKeys = keys;
+		m_numMapped = count;
+		m_infos.assign(records, records+count);
+	}
+
+	// Adds a record. Returns its index, or -1 if a record with the same key, format and size is already in the index,
+	// in which case the caller keeps ownership of the strings of the rejected record. The strings of the accepted
+	// records are freed by clear().
+	int add(const ExtTxtrInfo &info)
+	{
+		if( m_pSortedKeys )
+			HashMappedKeys();
+
+		std::vector<int> &variants = m_keys[HiresTxtrKey(info.crc32, info.pal_crc32)];
+		for( size_t i=0; i<variants.size(); i++ )
+		{
+			ExtTxtrInfo &old = m_infos[variants[i]];
+			if( old.fmt == info.fmt && old.siz == info.siz )
+				return -1;
+		}
+
+		variants.push_back((int)m_infos.size());
+		m_infos.push_back(info);
+		return variants.back();
+	}
+
+	// Returns the index of the record for the key whose format and size match fmt/siz. If none of the variants
+	// matches, the first record added for the key is used. Returns -1 if there is no record for the key at all.
+	int find(uint64 key, int fmt, int siz)
+	{
+		if( m_pSortedKeys )
+		{
+			const uint64 *first = std::lower_bound(m_pSortedKeys, m_pSortedKeys+m_numMapped, key);
+			const uint64 *last = first;
+			while( last < m_pSortedKeys+m_numMapped && *last == key )
+				last++;
+			if( first == last )
+				return -1;
+
+			// the variants of a key are consecutive records of the mapped file
+			int base = (int)(first-m_pSortedKeys);
+			int count = (int)(last-first);
+			for( int i=0; count>1 && i<count; i++ )
+			{
+				ExtTxtrInfo &info = m_infos[base+i];
+				if( info.fmt == fmt && info.siz == siz )
+					return base+i;
+			}
+			return base;
+		}
+
+		std::unordered_map<uint64, std::vector<int> >::const_iterator it = m_keys.find(key);
+		if( it == m_keys.end() )
+			return -1;
+
+		return FindVariant(&it->second[0], (int)it->second.size(), fmt, siz);
+	}
+};
+
+#endif
@@ -0,0 +1,589 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "..\..\stdafx.h"
+#include <string>
+#include <thread>
+#include <atomic>
+#include "HiresTxtrPack.h"
+#include "HiresTxtrScanner.h"
+#include "BMGDll.h"
+#include "..\..\lib\BMGLib\zlib114\zlib.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+extern void CacheHiresTexture( ExtTxtrInfo &ExtTexInfo );
+
+// Number of textures decoded in parallel while packing, before they are written in order
+#define PACK_BATCH_SIZE		64
+
+CHiresTxtrPack gHiresTxtrPack;
+
+CHiresTxtrPack::CHiresTxtrPack() :
+	m_pRecords(NULL),
+	m_numRecords(0)
+#ifdef _WIN32
+	,m_hFile(INVALID_HANDLE_VALUE)
+#else
+	,m_fd(-1)
+#endif
+{
+}
+
+CHiresTxtrPack::~CHiresTxtrPack()
+{
+	Close();
+}
+
+bool CHiresTxtrPack::ReadAt(uint64 offset, void *buf, uint32 size)
+{
+#ifdef _WIN32
+	// a positional read does not move a shared file pointer, several threads can read at once
+	OVERLAPPED ov;
+	memset(&ov, 0, sizeof(ov));
+	ov.Offset = (DWORD)offset;
+	ov.OffsetHigh = (DWORD)(offset>>32);
+	DWORD read = 0;
+	return ReadFile(m_hFile, buf, size, &read, &ov) && read == size;
+#else
+	return pread(m_fd, buf, size, (off_t)offset) == (ssize_t)size;
+#endif
+}
+
+/********************************************************************************************************************
+ * Opens a pack file and attaches its records to an index. Only the index part of the file is mapped.
+ * parameter:
+ * filename: the pack file
+ * infos: the index, which is cleared and receives the records
+ * return:
+ * return value: false if the file is missing or damaged
+ ********************************************************************************************************************/
+bool CHiresTxtrPack::Open(const char *filename, CHiresTxtrIndex &infos)
+{
+	Close();
+
+#ifdef _WIN32
+	m_hFile = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if( m_hFile == INVALID_HANDLE_VALUE )
+		return false;
+#else
+	m_fd = open(filename, O_RDONLY);
+	if( m_fd < 0 )
+		return false;
+#endif
+
+	HiresPackHeader header;
+	if( !ReadAt(0, &header, sizeof(header)) || header.magic != HIRES_PACK_MAGIC || header.version != HIRES_PACK_VERSION ||
+		!m_index.Open(filename, header.indexSize) || m_index.GetSize() != header.indexSize )
+	{
+		TRACE1("Hires pack file is damaged or of another version: %s", filename);
+		Close();
+		return false;
+	}
+
+	const unsigned char *pData = m_index.GetData();
+	size_t size = m_index.GetSize();
+
+	if( header.keysOffset + (uint64)header.numRecords*sizeof(uint64) > size ||
+		header.recordsOffset + (uint64)header.numRecords*sizeof(HiresPackRecord) > size ||
+		header.stringsOffset + (uint64)header.stringTableSize > size ||
+		header.stringTableSize == 0 || pData[header.stringsOffset+header.stringTableSize-1] != 0 ||
+		(header.keysOffset & 7) != 0 || (header.recordsOffset & 7) != 0 )
+	{
+		TRACE1("Hires pack file is damaged: %s", filename);
+		Close();
+		return false;
+	}
+
+	const uint64 *keys = (const uint64 *)(pData + header.keysOffset);
+	const HiresPackRecord *records = (const HiresPackRecord *)(pData + header.recordsOffset);
+	const char *strings = (const char *)(pData + header.stringsOffset);
+
+	std::vector<ExtTxtrInfo> infoList(header.numRecords);
+	for( uint32 i=0; i<header.numRecords; i++ )
+	{
+		const HiresPackRecord &rec = records[i];
+		if( rec.filename >= header.stringTableSize || (i > 0 && keys[i] < keys[i-1]) ||
+			(rec.type != RGB_PNG && rec.type != RGB_WITH_ALPHA_TOGETHER_PNG) )
+		{
+			TRACE1("Hires pack file is damaged: %s", filename);
+			Close();
+			return false;
+		}
+
+		ExtTxtrInfo &info = infoList[i];
+		info.width = rec.width;
+		info.height = rec.height;
+		info.crc32 = (int)(keys[i]>>32);
+		info.pal_crc32 = (int)(keys[i]&0xFFFFFFFF);
+		info.fmt = rec.fmt;
+		info.siz = rec.siz;
+		info.type = (TextureType)rec.type;
+		info.bSeparatedAlpha = false;
+		info.scaleShift = 0;
+		info.packRecord = i;
+		info.pHiresTextureRGB = NULL;
+		info.pHiresTextureAlpha = NULL;
+		info.pPreloadedTexture = NULL;
+		info.preloadedSize = 0;
+		// the packed textures have no folder, the empty string at the end of the table is used for it
+		info.foldername = (char *)strings + header.stringTableSize - 1;
+		info.filename = (char *)strings + rec.filename;
+		info.filename_a = NULL;
+	}
+
+	m_pRecords = records;
+	m_numRecords = header.numRecords;
+
+	// the mapping stays owned by the pack
+	infos.attach(NULL, keys, infoList.size() ? &infoList[0] : NULL, (int)infoList.size());
+	return true;
+}
+
+void CHiresTxtrPack::Close()
+{
+	m_index.Close();
+	m_pRecords = NULL;
+	m_numRecords = 0;
+
+#ifdef _WIN32
+	if( m_hFile != INVALID_HANDLE_VALUE )
+		CloseHandle(m_hFile);
+	m_hFile = INVALID_HANDLE_VALUE;
+#else
+	if( m_fd >= 0 )
+		close(m_fd);
+	m_fd = -1;
+#endif
+}
+
+/********************************************************************************************************************
+ * Reads the texture of a record taken from the pack.
+ * parameter:
+ * info: the record, its packRecord member tells which texture of the pack is read
+ * return:
+ * info: width, height and pHiresTextureRGB are filled in, pHiresTextureRGB is NULL if the texture cannot be read
+ * return value: false if the texture cannot be read
+ ********************************************************************************************************************/
+bool CHiresTxtrPack::LoadTexture(ExtTxtrInfo &info)
+{
+	info.pHiresTextureRGB = NULL;
+	info.pHiresTextureAlpha = NULL;
+
+	if( info.packRecord < 0 || (uint32)info.packRecord >= m_numRecords )
+		return false;
+
+	const HiresPackRecord &rec = m_pRecords[info.packRecord];
+	uint32 bpp = rec.type == RGB_PNG ? 3 : 4;
+	if( rec.rawSize == 0 || rec.rawSize != rec.width*rec.height*bpp )
+	{
+		TRACE1("Packed texture %s is missing", info.filename);
+		return false;
+	}
+
+	unsigned char *pBuf = new unsigned char[rec.rawSize];
+	bool ok;
+
+	if( rec.compression == HIRES_PACK_ZLIB )
+	{
+		unsigned char *pPacked = new unsigned char[rec.dataSize];
+		uLongf size = rec.rawSize;
+		ok = ReadAt(rec.dataOffset, pPacked, rec.dataSize) &&
+			uncompress(pBuf, &size, pPacked, rec.dataSize) == Z_OK && size == rec.rawSize;
+		delete [] pPacked;
+	}
+	else
+	{
+		ok = rec.dataSize == rec.rawSize && ReadAt(rec.dataOffset, pBuf, rec.rawSize);
+	}
+
+	if( !ok )
+	{
+		TRACE1("Cannot read packed texture %s", info.filename);
+		delete [] pBuf;
+		return false;
+	}
+
+	info.width = rec.width;
+	info.height = rec.height;
+	info.pHiresTextureRGB = pBuf;
+	return true;
+}
+
+// A texture of the folder being packed, decoded and compressed by a worker thread
+struct PackChunk
+{
+	std::vector<unsigned char> data;
+	uint32 width;
+	uint32 height;
+	uint32 rawSize;
+	uint32 compression;
+};
+
+static void EncodePackChunk(ExtTxtrInfo info, bool bCompress, PackChunk &chunk)
+{
+	chunk.data.clear();
+	chunk.width = chunk.height = chunk.rawSize = 0;
+	chunk.compression = HIRES_PACK_RAW;
+
+	CacheHiresTexture(info);
+	if( !info.pHiresTextureRGB )
+		return;
+
+	uint32 numPixels = info.width*info.height;
+	unsigned char *pPixels = info.pHiresTextureRGB;
+	uint32 rawSize = numPixels*(info.type == RGB_PNG ? 3 : 4);
+
+	if( info.bSeparatedAlpha )
+	{
+		// merge the alpha file into a 32 bit texture the same way LoadHiresTexture does
+		unsigned char *pRGBA = new unsigned char[numPixels*4];
+		for( uint32 i=0; i<numPixels; i++ )
+		{
+			pRGBA[i*4+0] = info.pHiresTextureRGB[i*3+0];
+			pRGBA[i*4+1] = info.pHiresTextureRGB[i*3+1];
+			pRGBA[i*4+2] = info.pHiresTextureRGB[i*3+2];
+			pRGBA[i*4+3] = info.pHiresTextureAlpha[i*3];
+		}
+		delete [] info.pHiresTextureRGB;
+		delete [] info.pHiresTextureAlpha;
+		pPixels = pRGBA;
+		rawSize = numPixels*4;
+	}
+
+	chunk.width = info.width;
+	chunk.height = info.height;
+	chunk.rawSize = rawSize;
+
+	if( bCompress )
+	{
+		uLongf size = compressBound(rawSize);
+		chunk.data.resize(size);
+		if( compress2(&chunk.data[0], &size, pPixels, rawSize, Z_DEFAULT_COMPRESSION) == Z_OK && size < rawSize )
+		{
+			chunk.data.resize(size);
+			chunk.compression = HIRES_PACK_ZLIB;
+		}
+	}
+
+	if( chunk.compression == HIRES_PACK_RAW )
+		chunk.data.assign(pPixels, pPixels+rawSize);
+
+	delete [] pPixels;
+}
+
+struct PackKeyOrder
+{
+	const std::vector<uint64> *keys;
+	bool operator()(int a, int b) const
+	{
+		return (*keys)[a] < (*keys)[b];
+	}
+};
+
+static uint32 Align8(uint32 offset)
+{
+	return (offset + 7) & ~7;
+}
+
+/********************************************************************************************************************
+ * Packs the hires textures of a folder into a pack file. The textures are decoded on worker threads by batches and
+ * written in key order.
+ * parameter:
+ * foldername: the folder of the hires textures of the rom, ending with a path separator
+ * gamename: the internal name of the rom the textures are for
+ * packfilename: the pack file to write
+ * bCompress: flag that indicates if the textures should be compressed
+ * return:
+ * return value: false if there is no texture to pack or if the pack file could not be written
+ ********************************************************************************************************************/
+bool BuildHiresTexturePack(const char *foldername, const char *gamename, const char *packfilename, bool bCompress)
+{
+	std::vector<ExtTxtrInfo> found;
+	ScanHiresTextureFolder(foldername, gamename, true, found);
+
+	CHiresTxtrIndex infos;
+	infos.reserve((int)found.size());
+	for( size_t i=0; i<found.size(); i++ )
+	{
+		if( infos.add(found[i]) < 0 )
+		{
+			free(found[i].foldername);
+			free(found[i].filename);
+			free(found[i].filename_a);
+		}
+	}
+
+	int count = infos.size();
+	if( count == 0 )
+		return false;
+
+	// variants of a key stay in the order they have been added, the first one is the fallback of find()
+	std::vector<uint64> keyOfInfo(count);
+	std::vector<int> order(count);
+	for( int i=0; i<count; i++ )
+	{
+		keyOfInfo[i] = HiresTxtrKey(infos[i].crc32, infos[i].pal_crc32);
+		order[i] = i;
+	}
+	PackKeyOrder keyOrder = { &keyOfInfo };
+	std::stable_sort(order.begin(), order.end(), keyOrder);
+
+	std::vector<uint64> keys(count);
+	std::vector<HiresPackRecord> records(count);
+	std::string strings;
+
+	for( int i=0; i<count; i++ )
+	{
+		ExtTxtrInfo &info = infos[order[i]];
+		HiresPackRecord &rec = records[i];
+		memset(&rec, 0, sizeof(rec));
+
+		keys[i] = keyOfInfo[order[i]];
+		rec.fmt = info.fmt;
+		rec.siz = info.siz;
+		rec.type = info.bSeparatedAlpha ? RGB_WITH_ALPHA_TOGETHER_PNG : info.type;
+
+		// a texture merged with its alpha file is named like a texture with the alpha channel together
+		std::string name = info.filename;
+		if( info.bSeparatedAlpha && name.size() > 8 && _stricmp(name.c_str() + name.size() - 8, "_rgb.png") == 0 )
+			name.replace(name.size() - 8, 8, "_all.png");
+
+		rec.filename = (uint32)strings.size();
+		strings.append(name.c_str(), name.size()+1);
+	}
+	strings.push_back(0);
+
+	HiresPackHeader header;
+	header.magic = HIRES_PACK_MAGIC;
+	header.version = HIRES_PACK_VERSION;
+	header.numRecords = count;
+	header.stringTableSize = (uint32)strings.size();
+	header.keysOffset = sizeof(HiresPackHeader);
+	header.recordsOffset = header.keysOffset + count*sizeof(uint64);
+	header.stringsOffset = header.recordsOffset + count*sizeof(HiresPackRecord);
+	header.indexSize = Align8(header.stringsOffset + header.stringTableSize);
+
+	FILE *f = fopen(packfilename, "wb");
+	if( f == NULL )
+	{
+		TRACE1("Cannot write hires pack file: %s", packfilename);
+		return false;
+	}
+
+	// the records are written again once the offsets of the chunks are known
+	static const char padding[8] = {0};
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+	ok = ok && fwrite(&keys[0], sizeof(uint64), count, f) == (size_t)count;
+	ok = ok && fwrite(&records[0], sizeof(HiresPackRecord), count, f) == (size_t)count;
+	ok = ok && fwrite(strings.data(), 1, strings.size(), f) == strings.size();
+	ok = ok && fwrite(padding, 1, header.indexSize - header.stringsOffset - header.stringTableSize, f) == header.indexSize - header.stringsOffset - header.stringTableSize;
+
+	int numThreads = max((int)std::thread::hardware_concurrency(), 1);
+	std::vector<PackChunk> chunks(PACK_BATCH_SIZE);
+	uint64 offset = header.indexSize;
+
+	for( int first=0; ok && first<count; first+=PACK_BATCH_SIZE )
+	{
+		int batchSize = min(count-first, PACK_BATCH_SIZE);
+		std::atomic<int> nextChunk(0);
+		auto worker = [&]()
+		{
+			for( int i=nextChunk++; i<batchSize; i=nextChunk++ )
+				EncodePackChunk(infos[order[first+i]], bCompress, chunks[i]);
+		};
+
+		std::vector<std::thread> threads;
+		for( int t=1; t<min(numThreads, batchSize); t++ )
+			threads.push_back(std::thread(worker));
+		worker();
+		for( size_t t=0; t<threads.size(); t++ )
+			threads[t].join();
+
+		for( int i=0; ok && i<batchSize; i++ )
+		{
+			PackChunk &chunk = chunks[i];
+			HiresPackRecord &rec = records[first+i];
+			if( chunk.rawSize == 0 )
+			{
+				TRACE1("Cannot pack %s", infos[order[first+i]].filename);
+				continue;
+			}
+
+			rec.width = chunk.width;
+			rec.height = chunk.height;
+			rec.rawSize = chunk.rawSize;
+			rec.compression = chunk.compression;
+			rec.dataOffset = offset;
+			rec.dataSize = (uint32)chunk.data.size();
+
+			ok = fwrite(&chunk.data[0], 1, chunk.data.size(), f) == chunk.data.size();
+			offset += chunk.data.size();
+		}
+	}
+
+	ok = ok && fseek(f, header.recordsOffset, SEEK_SET) == 0;
+	ok = ok && fwrite(&records[0], sizeof(HiresPackRecord), count, f) == (size_t)count;
+	ok = fclose(f) == 0 && ok;
+
+	if( !ok )
+	{
+		TRACE1("Cannot write hires pack file: %s", packfilename);
+		remove(packfilename);
+	}
+
+	return ok;
+}
+
+/********************************************************************************************************************
+ * Writes the textures of a pack file to a folder as PNG files, named like the files they have been packed from.
+ * Textures which had a separate alpha file are written with the alpha channel together.
+ * parameter:
+ * packfilename: the pack file
+ * foldername: the folder receiving the PNG files, ending with a path separator
+ * return:
+ * return value: false if the pack cannot be opened or a texture cannot be read or written
+ ********************************************************************************************************************/
+bool ExtractHiresTexturePack(const char *packfilename, const char *foldername)
+{
+	CHiresTxtrIndex infos;
+	CHiresTxtrPack pack;
+	if( !pack.Open(packfilename, infos) )
+		return false;
+
+	bool ok = true;
+	for( int i=0; i<infos.size(); i++ )
+	{
+		ExtTxtrInfo info = infos[i];
+		if( !pack.LoadTexture(info) )
+		{
+			ok = false;
+			continue;
+		}
+
+		std::string filename = std::string(foldername) + info.filename;
+
+		struct BMGImageStruct img;
+		InitBMGImage(&img);
+		img.bits = info.pHiresTextureRGB;
+		img.bits_per_pixel = info.type == RGB_PNG ? 24 : 32;
+		img.width = info.width;
+		img.height = info.height;
+		img.scan_width = info.width*img.bits_per_pixel/8;
+
+		if( WritePNG(filename.c_str(), img) != BMG_OK )
+		{
+			TRACE1("Cannot write %s", filename.c_str());
+			ok = false;
+		}
+
+		delete [] info.pHiresTextureRGB;
+	}
+
+	// the records point into the pack, they have to go first
+	infos.clear();
+	pack.Close();
+	return ok;
+}
+
+#ifdef _WIN32
+// Splits the command line of HiresPackTool, arguments containing spaces are quoted
+static std::vector<std::string> SplitCommandLine(const char *cmdLine)
+{
+	std::vector<std::string> args;
+	const char *p = cmdLine;
+	for(;;)
+	{
+		while( *p == ' ' || *p == '\t' )
+			p++;
+		if( *p == 0 )
+			break;
+
+		std::string arg;
+		if( *p == '"' )
+		{
+			for( p++; *p && *p != '"'; p++ )
+				arg += *p;
+			if( *p == '"' )
+				p++;
+		}
+		else
+		{
+			for( ; *p && *p != ' ' && *p != '\t'; p++ )
+				arg += *p;
+		}
+		args.push_back(arg);
+	}
+	return args;
+}
+
+/********************************************************************************************************************
+ * Converter between hires texture folders and pack files, run with rundll32:
+ *   rundll32 RiceVideo.dll,HiresPackTool pack "<plugin dir>\hires_texture\<GameName>" ["<pack file>"]
+ *   rundll32 RiceVideo.dll,HiresPackTool packraw "<plugin dir>\hires_texture\<GameName>" ["<pack file>"]
+ *   rundll32 RiceVideo.dll,HiresPackTool unpack "<pack file>" "<folder>"
+ * The pack file defaults to hires_texture\<GameName>.hpk, where the plugin looks for it. "packraw" does not compress
+ * the textures, which makes the pack larger but faster to load.
+ ********************************************************************************************************************/
+#if defined(_M_IX86)
+#pragma comment(linker, "/EXPORT:HiresPackTool=_HiresPackTool@16")
+#else
+#pragma comment(linker, "/EXPORT:HiresPackTool")
+#endif
+extern "C" void CALLBACK HiresPackTool(HWND hWnd, HINSTANCE hInstance, LPSTR lpszCmdLine, int nCmdShow)
+{
+	std::vector<std::string> args = SplitCommandLine(lpszCmdLine);
+	char message[_MAX_PATH+100];
+	bool ok = false;
+
+	if( args.size() >= 2 && (_stricmp(args[0].c_str(), "pack") == 0 || _stricmp(args[0].c_str(), "packraw") == 0) )
+	{
+		// the folder is named after the rom
+		std::string folder = args[1];
+		while( folder.size() > 0 && (folder[folder.size()-1] == '\\' || folder[folder.size()-1] == '/') )
+			folder.erase(folder.size()-1);
+		size_t sep = folder.find_last_of("\\/");
+		std::string gamename = sep == std::string::npos ? folder : folder.substr(sep+1);
+		std::string packfile = args.size() >= 3 ? args[2] : folder + ".hpk";
+
+		ok = BuildHiresTexturePack((folder + "\\").c_str(), gamename.c_str(), packfile.c_str(), _stricmp(args[0].c_str(), "pack") == 0);
+		sprintf(message, ok ? "Hires textures packed to %s" : "Cannot pack the hires textures to %s", packfile.c_str());
+	}
+	else if( args.size() >= 3 && _stricmp(args[0].c_str(), "unpack") == 0 )
+	{
+		std::string folder = args[2];
+		CreateDirectory(folder.c_str(), NULL);
+		if( folder[folder.size()-1] != '\\' && folder[folder.size()-1] != '/' )
+			folder += "\\";
+
+		ok = ExtractHiresTexturePack(args[1].c_str(), folder.c_str());
+		sprintf(message, ok ? "Hires textures extracted from %s" : "Cannot extract all hires textures from %s", args[1].c_str());
+	}
+	else
+	{
+		strcpy(message, "Usage: HiresPackTool pack|packraw <texture folder> [<pack file>]\n"
+						"       HiresPackTool unpack <pack file> <folder>");
+	}
+
+	MessageBox(hWnd, message, "Hires texture pack", ok ? MB_OK|MB_ICONINFORMATION : MB_OK|MB_ICONERROR);
+}
+#endif
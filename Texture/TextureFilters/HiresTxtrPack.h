@@ -0,0 +1,115 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef _HIRES_TXTR_PACK_H_
+#define _HIRES_TXTR_PACK_H_
+
+#include "HiresTxtrIndex.h"
+#include "HiresTxtrCache.h"
+
+/*
+	Single file hires texture pack, hires_texture\<GameName>.hpk. It replaces the folder of loose PNG files of a rom.
+
+	<HiresPackHeader>
+	<uint64 keys[numRecords]>					sorted (crc32, pal_crc32) keys
+	<HiresPackRecord records[numRecords]>		in the same order as the keys
+	<char strings[stringTableSize]>				zero terminated names of the files the textures have been packed from
+	<chunks>									one per record, at HiresPackRecord::dataOffset
+
+	Everything up to indexSize is memory-mapped, the chunks are read on demand. A chunk holds the pixels exactly as
+	CacheHiresTexture leaves them: bottom-up rows of 24 bit (RGB_PNG) or 32 bit (RGB_WITH_ALPHA_TOGETHER_PNG) pixels.
+	Separate alpha files are merged into 32 bit textures when packing. A chunk may be compressed with zlib.
+*/
+
+#define HIRES_PACK_MAGIC		0x4B415048	// "HPAK"
+#define HIRES_PACK_VERSION		1
+
+enum HiresPackCompression
+{
+	HIRES_PACK_RAW,
+	HIRES_PACK_ZLIB,
+};
+
+struct HiresPackHeader
+{
+	uint32 magic;
+	uint32 version;
+	uint32 numRecords;
+	uint32 stringTableSize;
+	uint32 keysOffset;
+	uint32 recordsOffset;
+	uint32 stringsOffset;
+	uint32 indexSize;		// size of the mapped part of the file, the chunks follow
+};
+
+struct HiresPackRecord
+{
+	uint32 width;
+	uint32 height;
+	s32    fmt;
+	s32    siz;
+	uint32 type;
+	uint32 filename;		// offset in the string table
+	uint32 compression;
+	uint32 rawSize;
+	uint64 dataOffset;
+	uint32 dataSize;
+	uint32 reserved;
+};
+
+/********************************************************************************************************************
+ * An opened pack file. The records of the pack are attached to a CHiresTxtrIndex, which references the pack records
+ * by ExtTxtrInfo::packRecord. The textures are read with positional reads, so LoadTexture() may be called from several
+ * threads at once.
+ ********************************************************************************************************************/
+class CHiresTxtrPack
+{
+public:
+	CHiresTxtrPack();
+	~CHiresTxtrPack();
+
+	// The index is cleared and receives the records of the pack. It must be cleared before the pack is closed.
+	bool Open(const char *filename, CHiresTxtrIndex &infos);
+	void Close();
+	bool IsOpen() { return m_pRecords != NULL; }
+
+	// Fills in width, height and pHiresTextureRGB of a record taken from the pack, like CacheHiresTexture does for files
+	bool LoadTexture(ExtTxtrInfo &info);
+
+private:
+	bool ReadAt(uint64 offset, void *buf, uint32 size);
+
+	CMappedFile m_index;
+	const HiresPackRecord *m_pRecords;
+	uint32 m_numRecords;
+#ifdef _WIN32
+	HANDLE m_hFile;
+#else
+	int m_fd;
+#endif
+};
+
+extern CHiresTxtrPack gHiresTxtrPack;
+
+// Packs the hires textures of a folder (hires_texture\<GameName>\) into a pack file
+bool BuildHiresTexturePack(const char *foldername, const char *gamename, const char *packfilename, bool bCompress);
+// Writes the textures of a pack file back to a folder as PNG files
+bool ExtractHiresTexturePack(const char *packfilename, const char *foldername);
+
+#endif
@@ -0,0 +1,203 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "..\..\stdafx.h"
+#include "HiresTxtrPreload.h"
+#include "..\..\lib\BMGLib\zlib114\zlib.h"
+
+extern void CacheHiresTexture( ExtTxtrInfo &ExtTexInfo );
+
+/********************************************************************************************************************
+ * Loads the texture of a record and converts it to the preloaded layout
+ * parameter:
+ * info: the record of the hires texture
+ * bCompress: flag that indicates if the pixels should be compressed
+ * return:
+ * info: pPreloadedTexture, preloadedSize, width and height are filled in
+ * return value: false if the texture could not be loaded
+ ********************************************************************************************************************/
+bool PreloadHiresTexture(ExtTxtrInfo &info, bool bCompress)
+{
+	FreePreloadedHiresTexture(info);
+
+	ExtTxtrInfo decoded = info;
+	CacheHiresTexture(decoded);
+	if( !decoded.pHiresTextureRGB || (decoded.bSeparatedAlpha && !decoded.pHiresTextureAlpha) )
+	{
+		delete [] decoded.pHiresTextureRGB;
+		delete [] decoded.pHiresTextureAlpha;
+		return false;
+	}
+
+	uint32 width = decoded.width;
+	uint32 height = decoded.height;
+	uint32 pixelSize = PreloadedPixelSize(decoded);
+	uint32 rawSize = width*height*pixelSize;
+	unsigned char *pRaw = new unsigned char[rawSize];
+
+	// the decoded rows are bottom-up
+	for( uint32 y=0; y<height; y++ )
+	{
+		unsigned char *pDst = pRaw + y*width*pixelSize;
+		uint32 srcRow = height-1-y;
+
+		if( pixelSize == 3 )
+		{
+			// opaque, the alpha channel is added when the texture is copied to a surface
+			memcpy(pDst, decoded.pHiresTextureRGB + srcRow*width*3, width*3);
+		}
+		else if( decoded.type == RGB_PNG )
+		{
+			const unsigned char *pRGB = decoded.pHiresTextureRGB + srcRow*width*3;
+			const unsigned char *pA = decoded.pHiresTextureAlpha + srcRow*width*3;
+			for( uint32 x=0; x<width; x++ )
+			{
+				*pDst++ = *pRGB++;
+				*pDst++ = *pRGB++;
+				*pDst++ = *pRGB++;
+				*pDst++ = pA[x*3];
+			}
+		}
+		else
+		{
+			memcpy(pDst, decoded.pHiresTextureRGB + srcRow*width*4, width*4);
+		}
+	}
+
+	delete [] decoded.pHiresTextureRGB;
+	delete [] decoded.pHiresTextureAlpha;
+
+	info.width = width;
+	info.height = height;
+	info.pPreloadedTexture = pRaw;
+	info.preloadedSize = rawSize;
+
+	if( bCompress )
+	{
+		// the fastest level, the textures are inflated each time they are used
+		uLongf size = compressBound(rawSize);
+		unsigned char *pPacked = new unsigned char[size];
+		if( compress2(pPacked, &size, pRaw, rawSize, Z_BEST_SPEED) == Z_OK && size < rawSize )
+		{
+			info.pPreloadedTexture = new unsigned char[size];
+			info.preloadedSize = size;
+			memcpy(info.pPreloadedTexture, pPacked, size);
+			delete [] pRaw;
+		}
+		delete [] pPacked;
+	}
+
+	return true;
+}
+
+void FreePreloadedHiresTexture(ExtTxtrInfo &info)
+{
+	delete [] info.pPreloadedTexture;
+	info.pPreloadedTexture = NULL;
+	info.preloadedSize = 0;
+}
+
+static inline void AlphaFromIntensity(unsigned char *pRow, uint32 width)
+{
+	for( uint32 x=0; x<width; x++ )
+		pRow[x*4+3] = pRow[x*4+2];
+}
+
+// Copies a row of the preloaded layout to a row of A8R8G8B8 pixels
+static void UnpackRow(unsigned char *pDst, const unsigned char *pSrc, uint32 width, uint32 pixelSize, bool bAlphaFromIntensity)
+{
+	if( pixelSize == 4 )
+	{
+		memcpy(pDst, pSrc, width*4);
+	}
+	else
+	{
+		for( uint32 x=0; x<width; x++ )
+		{
+			pDst[x*4]   = pSrc[x*3];
+			pDst[x*4+1] = pSrc[x*3+1];
+			pDst[x*4+2] = pSrc[x*3+2];
+			pDst[x*4+3] = 0xFF;
+		}
+	}
+
+	if( bAlphaFromIntensity )
+		AlphaFromIntensity(pDst, width);
+}
+
+bool UnpackPreloadedHiresTexture(const ExtTxtrInfo &info, DrawInfo &dst, uint32 width, uint32 height, bool bAlphaFromIntensity)
+{
+	if( !info.pPreloadedTexture )
+		return false;
+
+	uint32 pixelSize = PreloadedPixelSize(info);
+	uint32 srcPitch = info.width*pixelSize;
+	width = min(width, info.width);
+	height = min(height, info.height);
+
+	if( info.preloadedSize == srcPitch*info.height )
+	{
+		for( uint32 y=0; y<height; y++ )
+		{
+			unsigned char *pDst = (unsigned char *)dst.lpSurface + y*dst.lPitch;
+			UnpackRow(pDst, info.pPreloadedTexture + y*srcPitch, width, pixelSize, bAlphaFromIntensity);
+		}
+		return true;
+	}
+
+	// inflate the rows straight into the surface, only the rows needed are inflated
+	z_stream stream;
+	memset(&stream, 0, sizeof(stream));
+	if( inflateInit(&stream) != Z_OK )
+		return false;
+	stream.next_in = info.pPreloadedTexture;
+	stream.avail_in = info.preloadedSize;
+
+	// rows wider than the area copied, and the rows without alpha, go through a row buffer
+	std::vector<unsigned char> row(width < info.width || pixelSize != 4 ? srcPitch : 0);
+
+	bool ok = true;
+	for( uint32 y=0; ok && y<height; y++ )
+	{
+		unsigned char *pDst = (unsigned char *)dst.lpSurface + y*dst.lPitch;
+		stream.next_out = row.size() ? &row[0] : pDst;
+		stream.avail_out = srcPitch;
+
+		while( stream.avail_out > 0 )
+		{
+			int ret = inflate(&stream, Z_NO_FLUSH);
+			if( ret != Z_OK && ret != Z_STREAM_END )
+				break;
+			if( ret == Z_STREAM_END )
+				break;
+		}
+		ok = stream.avail_out == 0;
+
+		if( row.size() )
+			UnpackRow(pDst, &row[0], width, pixelSize, bAlphaFromIntensity);
+		else if( bAlphaFromIntensity )
+			AlphaFromIntensity(pDst, width);
+	}
+
+	inflateEnd(&stream);
+
+	if( !ok )
+		TRACE1("Preloaded texture %s is damaged", info.filename);
+	return ok;
+}
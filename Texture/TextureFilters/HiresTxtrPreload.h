@@ -0,0 +1,47 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef _HIRES_TXTR_PRELOAD_H_
+#define _HIRES_TXTR_PRELOAD_H_
+
+#include "HiresTxtrIndex.h"
+
+/*
+	Hires textures preloaded with the caching option are kept close to the layout of the surfaces they are copied
+	to: top-down rows of A8R8G8B8 pixels, with the separate alpha file merged in. RGB textures without an alpha file
+	are kept as R8G8B8, 3 bytes per pixel, and get an opaque alpha channel when they are copied. The pixels are
+	compressed with zlib if bCompress is set and that makes them smaller, which is told by ExtTxtrInfo::preloadedSize
+	being less than width*height times the size of a pixel.
+*/
+
+// 3 for the RGB textures without an alpha file, 4 for the others
+inline uint32 PreloadedPixelSize(const ExtTxtrInfo &info)
+{
+	return (info.type == RGB_PNG && !info.bSeparatedAlpha) ? 3 : 4;
+}
+
+// Loads the texture of a record and keeps it in pPreloadedTexture
+bool PreloadHiresTexture(ExtTxtrInfo &info, bool bCompress);
+void FreePreloadedHiresTexture(ExtTxtrInfo &info);
+
+// Copies the top left width x height pixels of a preloaded texture to a locked surface. With bAlphaFromIntensity the
+// alpha channel is taken from the red channel, as for RGB textures replacing intensity textures.
+bool UnpackPreloadedHiresTexture(const ExtTxtrInfo &info, DrawInfo &dst, uint32 width, uint32 height, bool bAlphaFromIntensity);
+
+#endif
@@ -0,0 +1,409 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "..\..\stdafx.h"
+#include <string>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include "HiresTxtrScanner.h"
+
+#ifdef _WIN32
+#define PATH_SEPARATOR	"\\"
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#define PATH_SEPARATOR	"/"
+#define _stricmp strcasecmp
+#define _strdup strdup
+#endif
+
+// Files are handed out to the worker threads in chunks of this size
+#define SCAN_CHUNK_SIZE		64
+
+struct HiresScanItem
+{
+	int folder;				// index of the folder the file has been found in
+	std::string name;		// file name, without the folder
+	std::string name_a;		// name of the separate alpha channel file, if any
+	ExtTxtrInfo info;		// info.type is NO_TEXTURE if the file is not a hires texture
+	const char *error;		// why the file has been rejected, reported once the workers are done
+};
+
+static const char *FileSuffix(const std::string &name, size_t len)
+{
+	return name.length() >= len ? name.c_str() + name.length() - len : "";
+}
+
+/********************************************************************************************************************
+ * Reads the information about a PNG file, which is all in the signature and the IHDR chunk that has to follow it.
+ * Only the first 26 bytes of the file are read.
+ * parameter:
+ * filename: the file to read
+ * pInfo: receives the width, height and bit depth of the image
+ * return:
+ * return value: true if the file is a valid PNG file
+ ********************************************************************************************************************/
+bool ReadPNGHeaderInfo(const char *filename, IMAGE_INFO *pInfo)
+{
+	static const unsigned char pngSignature[8] = {137, 'P', 'N', 'G', '\r', '\n', 26, '\n'};
+	unsigned char header[26];
+
+	FILE *f = fopen(filename, "rb");
+	if( f == NULL )
+		return false;
+
+	size_t len = fread(header, 1, sizeof(header), f);
+	fclose(f);
+
+	// signature, then the IHDR chunk: <length=13><"IHDR"><width><height><bit depth><color type>...
+	if( len != sizeof(header) || memcmp(header, pngSignature, 8) != 0 || memcmp(header+12, "IHDR", 4) != 0 )
+		return false;
+
+	uint32 width  = (header[16]<<24) | (header[17]<<16) | (header[18]<<8) | header[19];
+	uint32 height = (header[20]<<24) | (header[21]<<16) | (header[22]<<8) | header[23];
+	uint32 bitDepth = header[24];
+	uint32 channels;
+
+	switch( header[25] )
+	{
+	case 0:	channels = 1;	break;	// grayscale
+	case 2:	channels = 3;	break;	// RGB
+	case 3:	channels = 1;	break;	// palette
+	case 4:	channels = 2;	break;	// grayscale + alpha
+	case 6:	channels = 4;	break;	// RGBA
+	default:
+		return false;
+	}
+
+	pInfo->Width = width;
+	pInfo->Height = height;
+	pInfo->Depth = bitDepth*channels;
+	pInfo->MipLevels = 1;
+	pInfo->Format = pInfo->Depth == 32 ? D3DFMT_A8R8G8B8 : (pInfo->Depth == 8 ? D3DFMT_P8 : D3DFMT_UNKNOWN);
+	pInfo->ImageFileFormat = XIFF_PNG;
+	return true;
+}
+
+/********************************************************************************************************************
+ * Walks a folder and collects the files which could be hires textures of the game. This only lists the directories,
+ * no file is opened.
+ ********************************************************************************************************************/
+static void WalkHiresFolder(const std::string &folder, const char *gamename, bool bRecursive,
+							std::vector<std::string> &folders, std::vector<HiresScanItem> &items)
+{
+	int folderIdx = (int)folders.size();
+	folders.push_back(folder);
+
+	std::vector<std::string> subfolders;
+
+#ifdef _WIN32
+	WIN32_FIND_DATA findData;
+	HANDLE findHandle = FindFirstFile((folder + "*.*").c_str(), &findData);
+	if( findHandle == INVALID_HANDLE_VALUE )
+		return;
+
+	do
+	{
+		const char *name = findData.cFileName;
+		bool bDirectory = (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+	DIR *dir = opendir(folder.c_str());
+	if( dir == NULL )
+		return;
+
+	struct dirent *ent;
+	while( (ent = readdir(dir)) != NULL )
+	{
+		const char *name = ent->d_name;
+		struct stat st;
+		bool bDirectory = stat((folder + name).c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+#endif
+		// hidden files, "." and ".."
+		if( name[0] == '.' )
+			continue;
+
+		if( bDirectory )
+		{
+			if( bRecursive )
+				subfolders.push_back(folder + name + PATH_SEPARATOR);
+			continue;
+		}
+
+		if( strstr(name, gamename) == NULL )
+			continue;
+
+		HiresScanItem item;
+		item.folder = folderIdx;
+		item.name = name;
+		item.info.type = NO_TEXTURE;
+		item.error = NULL;
+		items.push_back(item);
+#ifdef _WIN32
+	} while( FindNextFile(findHandle, &findData) );
+	FindClose(findHandle);
+#else
+	}
+	closedir(dir);
+#endif
+
+	for( size_t i=0; i<subfolders.size(); i++ )
+		WalkHiresFolder(subfolders[i], gamename, bRecursive, folders, items);
+}
+
+/********************************************************************************************************************
+ * Checks if a file is a hires texture and fills in its record. Runs on the worker threads, so it must not touch
+ * anything but the item it is given.
+ ********************************************************************************************************************/
+static void ParseHiresFile(const std::string &folder, HiresScanItem &item)
+{
+	ExtTxtrInfo &info = item.info;
+	const std::string &name = item.name;
+
+	// detect the texture type by it's extention
+	TextureType type = NO_TEXTURE;
+	if( _stricmp(FileSuffix(name, 13), "_ciByRGBA.png"   ) == 0 ||
+		_stricmp(FileSuffix(name, 16), "_allciByRGBA.png") == 0 ||
+		_stricmp(FileSuffix(name,  8), "_all.png")         == 0 )
+	{
+		type = RGB_WITH_ALPHA_TOGETHER_PNG;
+	}
+	else if( _stricmp(FileSuffix(name, 8), "_rgb.png") == 0 )
+	{
+		type = RGB_PNG;
+	}
+	else
+	{
+		return;
+	}
+
+	std::string path = folder + name;
+	IMAGE_INFO imgInfo;
+	if( !ReadPNGHeaderInfo(path.c_str(), &imgInfo) )
+	{
+		item.error = "Cannot get image info for file: %s";
+		return;
+	}
+
+	// a RGB texture may come with its alpha channel in a separate file
+	bool bSeparatedAlpha = false;
+	if( type == RGB_PNG )
+	{
+		std::string path_a = folder + name.substr(0, name.length()-8) + "_a.png";
+
+		FILE *f = fopen(path_a.c_str(), "rb");
+		if( f != NULL )
+		{
+			fclose(f);
+
+			IMAGE_INFO imgInfo2;
+			if( !ReadPNGHeaderInfo(path_a.c_str(), &imgInfo2) )
+			{
+				item.error = "Cannot get image info for alpha channel of file: %s";
+				return;
+			}
+			if( imgInfo2.Width != imgInfo.Width || imgInfo2.Height != imgInfo.Height )
+			{
+				item.error = "RGB and alpha texture size mismatch: %s";
+				return;
+			}
+			bSeparatedAlpha = true;
+			item.name_a = name.substr(0, name.length()-8) + "_a.png";
+		}
+	}
+
+	/*
+		<internal Rom name>#<DRAM CRC>#<format>#<size>#<PAL CRC>_ciByRGBA.png
+		The palette CRC is optional.
+	*/
+	const char *ptr = strchr(name.c_str(), '#');
+	if( ptr == NULL )
+	{
+		item.error = "Cannot parse file name: %s";
+		return;
+	}
+	ptr++;
+
+	uint32 fmt, siz, palcrc32;
+	char crcstr[16], crcstr2[16];
+	memset(crcstr, 0, sizeof(crcstr));
+	memset(crcstr2, 0, sizeof(crcstr2));
+	if( sscanf(ptr, "%8c#%d#%d#%8c", crcstr, &fmt, &siz, crcstr2) == 4 )
+		palcrc32 = strtoul(crcstr2, NULL, 16);
+	else if( sscanf(ptr, "%8c#%d#%d", crcstr, &fmt, &siz) == 3 )
+		palcrc32 = 0xFFFFFFFF;
+	else
+	{
+		item.error = "Cannot parse file name: %s";
+		return;
+	}
+
+	info.width = imgInfo.Width;
+	info.height = imgInfo.Height;
+	info.crc32 = strtoul(crcstr, NULL, 16);
+	info.pal_crc32 = palcrc32;
+	info.fmt = fmt;
+	info.siz = siz;
+	info.type = type;
+	info.bSeparatedAlpha = bSeparatedAlpha;
+	info.scaleShift = 0;
+	info.packRecord = -1;
+	info.pHiresTextureRGB = NULL;
+	info.pHiresTextureAlpha = NULL;
+	info.pPreloadedTexture = NULL;
+	info.preloadedSize = 0;
+	// the strings are filled in by the main thread for the accepted files only
+	info.foldername = NULL;
+	info.filename = NULL;
+	info.filename_a = NULL;
+}
+
+void ScanHiresTextureFolder(const char *foldername, const char *gamename, bool bRecursive, std::vector<ExtTxtrInfo> &found)
+{
+	std::vector<std::string> folders;
+	std::vector<HiresScanItem> items;
+
+	WalkHiresFolder(foldername, gamename, bRecursive, folders, items);
+	if( items.size() == 0 )
+		return;
+
+	// share the files out between the workers, chunk by chunk so that a slow disk area does not stall a single thread
+	std::atomic<size_t> nextItem(0);
+	auto worker = [&]()
+	{
+		for(;;)
+		{
+			size_t start = nextItem.fetch_add(SCAN_CHUNK_SIZE);
+			if( start >= items.size() )
+				break;
+
+			size_t end = min(start+SCAN_CHUNK_SIZE, items.size());
+			for( size_t i=start; i<end; i++ )
+				ParseHiresFile(folders[items[i].folder], items[i]);
+		}
+	};
+
+	size_t numThreads = std::thread::hardware_concurrency();
+	numThreads = max(min(numThreads, (items.size()+SCAN_CHUNK_SIZE-1)/SCAN_CHUNK_SIZE), (size_t)1);
+
+	std::vector<std::thread> threads;
+	for( size_t i=1; i<numThreads; i++ )
+		threads.push_back(std::thread(worker));
+	worker();
+	for( size_t i=0; i<threads.size(); i++ )
+		threads[i].join();
+
+	found.reserve(found.size() + items.size());
+	for( size_t i=0; i<items.size(); i++ )
+	{
+		HiresScanItem &item = items[i];
+		if( item.error )
+		{
+			TRACE1(item.error, item.name.c_str());
+			continue;
+		}
+		if( item.info.type == NO_TEXTURE )
+			continue;
+
+		item.info.foldername = _strdup(folders[item.folder].c_str());
+		item.info.filename = _strdup(item.name.c_str());
+		if( item.info.bSeparatedAlpha )
+			item.info.filename_a = _strdup(item.name_a.c_str());
+		found.push_back(item.info);
+	}
+}
+
+static void HashBytes(uint64 &hash, const void *data, size_t len)
+{
+	// FNV-1a
+	const unsigned char *p = (const unsigned char *)data;
+	for( size_t i=0; i<len; i++ )
+	{
+		hash ^= p[i];
+		hash *= 0x100000001B3ULL;
+	}
+}
+
+static void FingerprintFolder(uint64 &hash, const std::string &folder, const std::string &relname, uint64 mtime, bool bRecursive)
+{
+	HashBytes(hash, relname.c_str(), relname.length()+1);
+	HashBytes(hash, &mtime, sizeof(mtime));
+
+	if( !bRecursive )
+		return;
+
+	std::vector<std::pair<std::string, uint64> > subfolders;
+
+#ifdef _WIN32
+	WIN32_FIND_DATA findData;
+	HANDLE findHandle = FindFirstFileEx((folder + "*").c_str(), FindExInfoBasic, &findData, FindExSearchLimitToDirectories, NULL, FIND_FIRST_EX_LARGE_FETCH);
+	if( findHandle == INVALID_HANDLE_VALUE )
+		return;
+
+	do
+	{
+		if( (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && findData.cFileName[0] != '.' )
+		{
+			uint64 subtime = ((uint64)findData.ftLastWriteTime.dwHighDateTime<<32) | findData.ftLastWriteTime.dwLowDateTime;
+			subfolders.push_back(std::make_pair(std::string(findData.cFileName), subtime));
+		}
+	} while( FindNextFile(findHandle, &findData) );
+	FindClose(findHandle);
+#else
+	DIR *dir = opendir(folder.c_str());
+	if( dir == NULL )
+		return;
+
+	struct dirent *ent;
+	while( (ent = readdir(dir)) != NULL )
+	{
+		struct stat st;
+		if( ent->d_name[0] != '.' && stat((folder + ent->d_name).c_str(), &st) == 0 && S_ISDIR(st.st_mode) )
+			subfolders.push_back(std::make_pair(std::string(ent->d_name), (uint64)st.st_mtime));
+	}
+	closedir(dir);
+#endif
+
+	// the listing order is up to the file system
+	std::sort(subfolders.begin(), subfolders.end());
+	for( size_t i=0; i<subfolders.size(); i++ )
+	{
+		FingerprintFolder(hash, folder + subfolders[i].first + PATH_SEPARATOR, relname + subfolders[i].first + PATH_SEPARATOR,
+			subfolders[i].second, bRecursive);
+	}
+}
+
+uint64 HiresTextureFolderFingerprint(const char *foldername, bool bRecursive)
+{
+	uint64 hash = 0xCBF29CE484222325ULL;
+	uint64 mtime = 0;
+
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA attr;
+	if( GetFileAttributesEx(foldername, GetFileExInfoStandard, &attr) )
+		mtime = ((uint64)attr.ftLastWriteTime.dwHighDateTime<<32) | attr.ftLastWriteTime.dwLowDateTime;
+#else
+	struct stat st;
+	if( stat(foldername, &st) == 0 )
+		mtime = st.st_mtime;
+#endif
+
+	FingerprintFolder(hash, foldername, "", mtime, bRecursive);
+	return hash;
+}
@@ -0,0 +1,38 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef _HIRES_TXTR_SCANNER_H_
+#define _HIRES_TXTR_SCANNER_H_
+
+#include "TextureFilters.h"
+#include "HiresTxtrIndex.h"
+
+// Reads the image size and depth of a PNG file from its signature and IHDR chunk
+bool ReadPNGHeaderInfo(const char *filename, IMAGE_INFO *pInfo);
+
+// Scans foldername (which must end with a path separator) for the hires textures of gamename. The directory tree is
+// walked first, then the files are shared out between worker threads which parse the file names and PNG headers.
+// The records are returned in the order the files have been found, their strings are allocated with _strdup.
+void ScanHiresTextureFolder(const char *foldername, const char *gamename, bool bRecursive, std::vector<ExtTxtrInfo> &found);
+
+// Hashes the names and modification times of foldername and of the folders below it. Adding, removing or renaming a
+// file changes the modification time of its folder, so the fingerprint tells if a scan of the tree is still valid.
+uint64 HiresTextureFolderFingerprint(const char *foldername, bool bRecursive);
+
+#endif
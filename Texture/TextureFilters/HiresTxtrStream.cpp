@@ -0,0 +1,162 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "..\..\stdafx.h"
+#include "HiresTxtrStream.h"
+
+extern void CacheHiresTexture( ExtTxtrInfo &ExtTexInfo );
+
+// At most this many decoding threads, one core is left to the emulation
+#define MAX_STREAM_THREADS	4
+
+CHiresTxtrStreamer gHiresTxtrStreamer;
+
+CHiresTxtrStreamer::CHiresTxtrStreamer() :
+	m_pIndex(NULL),
+	m_budget(0),
+	m_bytes(0),
+	m_bStop(false)
+{
+}
+
+CHiresTxtrStreamer::~CHiresTxtrStreamer()
+{
+	Stop();
+}
+
+void CHiresTxtrStreamer::Start(CHiresTxtrIndex *pIndex, size_t budget)
+{
+	Stop();
+
+	m_pIndex = pIndex;
+	m_budget = budget;
+	m_bStop = false;
+
+	int numThreads = (int)std::thread::hardware_concurrency() - 1;
+	numThreads = max(min(numThreads, MAX_STREAM_THREADS), 1);
+	for( int i=0; i<numThreads; i++ )
+		m_threads.push_back(std::thread(&CHiresTxtrStreamer::WorkerThread, this));
+}
+
+void CHiresTxtrStreamer::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStop = true;
+		m_queue.clear();
+	}
+	m_cond.notify_all();
+
+	for( size_t i=0; i<m_threads.size(); i++ )
+		m_threads[i].join();
+	m_threads.clear();
+
+	m_pending.clear();
+	m_cache.clear();
+	m_lru.clear();
+	m_bytes = 0;
+	m_pIndex = NULL;
+}
+
+/********************************************************************************************************************
+ * Gets the decoded texture of a record of the index.
+ * parameter:
+ * idx: the index of the record
+ * return:
+ * return value: the decoded texture, or NULL if it is not ready yet. In that case its decoding has been queued.
+ ********************************************************************************************************************/
+HiresDecodedTexturePtr CHiresTxtrStreamer::Request(int idx)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::unordered_map<int, CacheItem>::iterator it = m_cache.find(idx);
+	if( it != m_cache.end() )
+	{
+		m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+		return it->second.texture;
+	}
+
+	if( m_threads.size() > 0 && m_pending.insert(idx).second )
+	{
+		m_queue.push_back(idx);
+		m_cond.notify_one();
+	}
+
+	return HiresDecodedTexturePtr();
+}
+
+void CHiresTxtrStreamer::Evict()
+{
+	// the most recently added texture is kept even if it is larger than the whole budget
+	while( m_bytes > m_budget && m_lru.size() > 1 )
+	{
+		int idx = m_lru.back();
+		m_lru.pop_back();
+
+		std::unordered_map<int, CacheItem>::iterator it = m_cache.find(idx);
+		m_bytes -= it->second.texture->bytes;
+		m_cache.erase(it);
+	}
+}
+
+void CHiresTxtrStreamer::WorkerThread()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	for(;;)
+	{
+		while( !m_bStop && m_queue.empty() )
+			m_cond.wait(lock);
+		if( m_bStop )
+			break;
+
+		int idx = m_queue.front();
+		m_queue.pop_front();
+		ExtTxtrInfo info = (*m_pIndex)[idx];
+
+		// decode without holding the lock
+		lock.unlock();
+
+		CacheHiresTexture(info);
+
+		HiresDecodedTexturePtr texture(new HiresDecodedTexture);
+		texture->width = info.width;
+		texture->height = info.height;
+		texture->pHiresTextureRGB = info.pHiresTextureRGB;
+		texture->pHiresTextureAlpha = info.pHiresTextureAlpha;
+		if( info.pHiresTextureRGB )
+		{
+			int bpp = info.type == RGB_PNG ? 3 : 4;
+			texture->bytes = (size_t)info.width*info.height*(info.pHiresTextureAlpha ? 2*bpp : bpp);
+		}
+
+		lock.lock();
+
+		m_pending.erase(idx);
+		if( m_bStop )
+			break;
+
+		m_lru.push_front(idx);
+		CacheItem &item = m_cache[idx];
+		item.texture = texture;
+		item.lru = m_lru.begin();
+		m_bytes += texture->bytes;
+		Evict();
+	}
+}
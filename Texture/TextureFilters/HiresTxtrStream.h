@@ -0,0 +1,96 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef _HIRES_TXTR_STREAM_H_
+#define _HIRES_TXTR_STREAM_H_
+
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <list>
+#include <unordered_set>
+#include "HiresTxtrIndex.h"
+
+// The decoded pixels of a hires texture, as CacheHiresTexture leaves them in an ExtTxtrInfo
+struct HiresDecodedTexture
+{
+	unsigned int width;
+	unsigned int height;
+	unsigned char *pHiresTextureRGB;		// NULL if the texture could not be loaded
+	unsigned char *pHiresTextureAlpha;
+	size_t bytes;
+
+	HiresDecodedTexture() : width(0), height(0), pHiresTextureRGB(NULL), pHiresTextureAlpha(NULL), bytes(0) {}
+	~HiresDecodedTexture()
+	{
+		delete [] pHiresTextureRGB;
+		delete [] pHiresTextureAlpha;
+	}
+};
+
+typedef std::shared_ptr<HiresDecodedTexture> HiresDecodedTexturePtr;
+
+/********************************************************************************************************************
+ * Decodes hires textures on demand on worker threads and keeps them in a LRU cache limited to a byte budget.
+ * Request() never blocks on decoding: until the texture of a record is ready it returns NULL, and the caller keeps
+ * using the original texture. Textures handed out stay valid while the caller holds them, even if they get evicted.
+ ********************************************************************************************************************/
+class CHiresTxtrStreamer
+{
+public:
+	CHiresTxtrStreamer();
+	~CHiresTxtrStreamer();
+
+	// The index must not change while the streamer is running
+	void Start(CHiresTxtrIndex *pIndex, size_t budget);
+	void Stop();
+	bool IsRunning() { return m_threads.size() > 0; }
+
+	HiresDecodedTexturePtr Request(int idx);
+
+private:
+	struct CacheItem
+	{
+		HiresDecodedTexturePtr texture;
+		std::list<int>::iterator lru;
+	};
+
+	void WorkerThread();
+	void Evict();
+
+	CHiresTxtrIndex *m_pIndex;
+	size_t m_budget;
+	size_t m_bytes;
+	bool m_bStop;
+
+	std::mutex m_mutex;
+	std::condition_variable m_cond;
+	std::vector<std::thread> m_threads;
+
+	std::deque<int> m_queue;
+	std::unordered_set<int> m_pending;			// queued or being decoded
+	std::unordered_map<int, CacheItem> m_cache;
+	std::list<int> m_lru;						// most recently used first
+};
+
+extern CHiresTxtrStreamer gHiresTxtrStreamer;
+
+#endif
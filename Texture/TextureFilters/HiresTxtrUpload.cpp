@@ -0,0 +1,204 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "..\..\stdafx.h"
+#include <algorithm>
+#include "HiresTxtrUpload.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define UPLOAD_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+/*
+	The rows are converted one after the other while the rows of the surface made by expanding the texture downwards
+	are written as soon as the row they copy is complete, so each row is still in the cache when it is expanded.
+*/
+
+#ifdef UPLOAD_USE_SSE2
+// Spreads 4 pixels of 3 bytes (the low 12 bytes of v) to the low 3 bytes of the 4 lanes, the high bytes are 0
+static inline __m128i Expand24To32(__m128i v)
+{
+	__m128i r = _mm_and_si128(v, _mm_setr_epi32(0x00FFFFFF, 0, 0, 0));
+	r = _mm_or_si128(r, _mm_and_si128(_mm_slli_si128(v, 1), _mm_setr_epi32(0, 0x00FFFFFF, 0, 0)));
+	r = _mm_or_si128(r, _mm_and_si128(_mm_slli_si128(v, 2), _mm_setr_epi32(0, 0, 0x00FFFFFF, 0)));
+	r = _mm_or_si128(r, _mm_and_si128(_mm_slli_si128(v, 3), _mm_setr_epi32(0, 0, 0, 0x00FFFFFF)));
+	return r;
+}
+#endif
+
+static inline uint32 Pixel24(const unsigned char *p)
+{
+	return p[0] | (p[1]<<8) | (p[2]<<16);
+}
+
+static void ConvertRow(uint32 *pDst, const unsigned char *pSrc, const unsigned char *pAlpha, uint32 width, HiresRowFormat format)
+{
+	if( format == HIRES_ROW_BGRA )
+	{
+		memcpy(pDst, pSrc, width*4);
+		return;
+	}
+
+	uint32 x = 0;
+
+#ifdef UPLOAD_USE_SSE2
+	// 16 bytes are read for 12, so the last pixels are left to the scalar loop
+	const __m128i opaque = _mm_set1_epi32(0xFF000000);
+	for( ; x+6<=width; x+=4 )
+	{
+		__m128i rgb = Expand24To32(_mm_loadu_si128((const __m128i *)(pSrc + x*3)));
+		__m128i a;
+		if( format == HIRES_ROW_BGR_ALPHA )
+			a = _mm_slli_epi32(Expand24To32(_mm_loadu_si128((const __m128i *)(pAlpha + x*3))), 24);
+		else if( format == HIRES_ROW_BGR_INTENSITY )
+			a = _mm_and_si128(_mm_slli_epi32(rgb, 8), opaque);
+		else
+			a = opaque;
+		_mm_storeu_si128((__m128i *)(pDst + x), _mm_or_si128(rgb, a));
+	}
+#endif
+
+	for( ; x<width; x++ )
+	{
+		const unsigned char *p = pSrc + x*3;
+		uint32 a;
+		if( format == HIRES_ROW_BGR_ALPHA )
+			a = pAlpha[x*3];
+		else if( format == HIRES_ROW_BGR_INTENSITY )
+			a = p[2];
+		else
+			a = 0xFF;
+		pDst[x] = Pixel24(p) | (a<<24);
+	}
+}
+
+// Expands a row to the right, like CTextureManager::Clamp and CTextureManager::Mirror with S_FLAG
+static void ExpandRowS(uint32 *line, uint32 width, const HiresEdgeExpansion &edges)
+{
+	if( edges.clampWidth > width )
+	{
+		uint32 val = line[width-1];
+		uint32 x = width;
+#ifdef UPLOAD_USE_SSE2
+		__m128i v = _mm_set1_epi32(val);
+		for( ; x+4<=edges.clampWidth; x+=4 )
+			_mm_storeu_si128((__m128i *)(line + x), v);
+#endif
+		for( ; x<edges.clampWidth; x++ )
+			line[x] = val;
+	}
+	else if( edges.mirrorWidth > width )
+	{
+		uint32 maskval1 = (1<<edges.maskS)-1;
+		uint32 maskval2 = (1<<(edges.maskS+1))-1;
+		uint32 x = width;
+
+		if( maskval1+1 == width && edges.mirrorWidth <= 2*width )
+		{
+			// the mask is the width of the texture, the mirrored columns are the reversed row
+#ifdef UPLOAD_USE_SSE2
+			for( ; x+4<=edges.mirrorWidth; x+=4 )
+			{
+				__m128i v = _mm_loadu_si128((const __m128i *)(line + 2*width-4-x));
+				_mm_storeu_si128((__m128i *)(line + x), _mm_shuffle_epi32(v, _MM_SHUFFLE(0,1,2,3)));
+			}
+#endif
+			for( ; x<edges.mirrorWidth; x++ )
+				line[x] = line[2*width-1-x];
+		}
+		else
+		{
+			for( ; x<edges.mirrorWidth; x++ )
+				line[x] = (x&maskval2)<=maskval1 ? line[x&maskval1] : line[maskval2-(x&maskval2)];
+		}
+	}
+}
+
+// Lists the rows below the texture with the rows they are copies of, like CTextureManager::Clamp and
+// CTextureManager::Mirror with T_FLAG. Returns false if a row copies a row which is itself a copy.
+static bool GetExpandedRows(uint32 height, const HiresEdgeExpansion &edges, std::vector< std::pair<uint32,uint32> > &rows)
+{
+	rows.clear();
+	if( edges.clampHeight > height )
+	{
+		for( uint32 y=height; y<edges.clampHeight; y++ )
+			rows.push_back(std::make_pair(height-1, y));
+	}
+	else if( edges.mirrorHeight > height )
+	{
+		uint32 maskval1 = (1<<edges.maskT)-1;
+		uint32 maskval2 = (1<<(edges.maskT+1))-1;
+		for( uint32 y=height; y<edges.mirrorHeight; y++ )
+		{
+			uint32 srcy = (y&maskval2)<=maskval1 ? y&maskval1 : maskval2-(y&maskval2);
+			if( srcy >= height )
+				return false;
+			rows.push_back(std::make_pair(srcy, y));
+		}
+	}
+
+	// in the order the copied rows are completed
+	std::sort(rows.begin(), rows.end());
+	return true;
+}
+
+// Copies the rows in the order of the destination rows, for masks making copies of copies
+static void CopyExpandedRowsInOrder(DrawInfo &dst, uint32 height, const HiresEdgeExpansion &edges)
+{
+	uint32 maskval1 = (1<<edges.maskT)-1;
+	uint32 maskval2 = (1<<(edges.maskT+1))-1;
+	for( uint32 y=height; y<edges.mirrorHeight; y++ )
+	{
+		uint32 srcy = (y&maskval2)<=maskval1 ? y&maskval1 : maskval2-(y&maskval2);
+		memcpy((unsigned char*)dst.lpSurface + y*dst.lPitch, (unsigned char*)dst.lpSurface + srcy*dst.lPitch, edges.surfaceWidth*4);
+	}
+}
+
+static void UploadRows(DrawInfo &dst, const HiresUploadSource *pSrc, uint32 width, uint32 height, const HiresEdgeExpansion &edges)
+{
+	std::vector< std::pair<uint32,uint32> > rows;
+	bool bFused = GetExpandedRows(height, edges, rows);
+	size_t next = 0;
+
+	for( uint32 y=0; y<height; y++ )
+	{
+		uint32 *line = (uint32*)((unsigned char*)dst.lpSurface + y*dst.lPitch);
+
+		if( pSrc )
+			ConvertRow(line, pSrc->pPixels + (int)y*pSrc->pitch, pSrc->pAlpha ? pSrc->pAlpha + (int)y*pSrc->alphaPitch : NULL, width, pSrc->format);
+		ExpandRowS(line, width, edges);
+
+		for( ; next<rows.size() && rows[next].first == y; next++ )
+			memcpy((unsigned char*)dst.lpSurface + rows[next].second*dst.lPitch, line, edges.surfaceWidth*4);
+	}
+
+	if( !bFused )
+		CopyExpandedRowsInOrder(dst, height, edges);
+}
+
+void UploadHiresTexture(DrawInfo &dst, const HiresUploadSource &src, uint32 width, uint32 height, const HiresEdgeExpansion &edges)
+{
+	UploadRows(dst, &src, width, height, edges);
+}
+
+void ExpandHiresTextureEdges(DrawInfo &dst, uint32 width, uint32 height, const HiresEdgeExpansion &edges)
+{
+	UploadRows(dst, NULL, width, height, edges);
+}
@@ -0,0 +1,60 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef _HIRES_TXTR_UPLOAD_H_
+#define _HIRES_TXTR_UPLOAD_H_
+
+// Pixel layouts of decoded hires textures, the bytes of the pixels are in the order of A8R8G8B8 surfaces
+enum HiresRowFormat
+{
+	HIRES_ROW_BGRA,				// 32 bit pixels, copied as they are
+	HIRES_ROW_BGR,				// 24 bit pixels, made opaque
+	HIRES_ROW_BGR_ALPHA,		// 24 bit pixels, the alpha is the first byte of the pixels of a separate 24 bit image
+	HIRES_ROW_BGR_INTENSITY,	// 24 bit pixels, the alpha is the red channel (RGB textures replacing intensity ones)
+};
+
+struct HiresUploadSource
+{
+	HiresRowFormat format;
+	const unsigned char *pPixels;	// the row copied to the top row of the surface
+	int pitch;						// bytes from a row to the next one, negative for bottom-up images
+	const unsigned char *pAlpha;	// HIRES_ROW_BGR_ALPHA only
+	int alphaPitch;
+};
+
+// How the area copied is extended over the rest of the surface, the way CTextureManager::Mirror and
+// CTextureManager::Clamp do it for the original textures
+struct HiresEdgeExpansion
+{
+	uint32 mirrorWidth;		// the columns are mirrored up to this width, 0 for none
+	uint32 maskS;
+	uint32 mirrorHeight;	// the rows are mirrored up to this height, 0 for none
+	uint32 maskT;
+	uint32 clampWidth;		// the last column is repeated up to this width, 0 for none (it overrides mirroring)
+	uint32 clampHeight;		// the last row is repeated up to this height, 0 for none (it overrides mirroring)
+	uint32 surfaceWidth;	// pixels of the rows made by expanding the texture downwards
+};
+
+// Copies width x height pixels to a locked A8R8G8B8 surface and expands them over its edges in a single pass
+void UploadHiresTexture(DrawInfo &dst, const HiresUploadSource &src, uint32 width, uint32 height, const HiresEdgeExpansion &edges);
+
+// Expands the width x height pixels already in the surface over its edges
+void ExpandHiresTextureEdges(DrawInfo &dst, uint32 width, uint32 height, const HiresEdgeExpansion &edges);
+
+#endif
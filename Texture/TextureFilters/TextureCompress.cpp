@@ -0,0 +1,434 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "../../stdafx.h"
+#include <algorithm>
+#include "TextureCompress.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define BC_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+/*
+	Fast BC1/BC3 encoder. The end points of the colors of a block are taken from the diagonal of their bounding box
+	along which they are spread, inset by 1/16 of the box to reduce the error of the extreme colors, and every pixel
+	gets the palette color nearest to its projection on the line between the end points. The alpha of BC3 uses the
+	exact minimum and maximum of the block, so fully transparent and fully opaque pixels stay so.
+*/
+
+// The palette position of a pixel projected on the line from end point 1 (0) to end point 0 (3), to its BC1 index
+static const uint32 bc1IndexOfPosition[4] = { 1, 3, 2, 0 };
+
+static inline uint32 ColorTo565(int r, int g, int b)
+{
+	return ((r>>3)<<11) | ((g>>2)<<5) | (b>>3);
+}
+
+static inline void Expand565(uint32 c, int rgb[3])
+{
+	int r = (c>>11) & 0x1F;
+	int g = (c>>5) & 0x3F;
+	int b = c & 0x1F;
+	rgb[0] = (r<<3) | (r>>2);
+	rgb[1] = (g<<2) | (g>>4);
+	rgb[2] = (b<<3) | (b>>2);
+}
+
+// Minimum and maximum of each channel of the block, as A8R8G8B8 values
+static inline void GetBlockBounds(const uint32 *pBlock, uint32 &minColor, uint32 &maxColor)
+{
+#ifdef BC_USE_SSE2
+	__m128i r0 = _mm_loadu_si128((const __m128i *)pBlock);
+	__m128i r1 = _mm_loadu_si128((const __m128i *)(pBlock+4));
+	__m128i r2 = _mm_loadu_si128((const __m128i *)(pBlock+8));
+	__m128i r3 = _mm_loadu_si128((const __m128i *)(pBlock+12));
+
+	__m128i mn = _mm_min_epu8(_mm_min_epu8(r0, r1), _mm_min_epu8(r2, r3));
+	__m128i mx = _mm_max_epu8(_mm_max_epu8(r0, r1), _mm_max_epu8(r2, r3));
+	mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(1,0,3,2)));
+	mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(1,0,3,2)));
+	mn = _mm_min_epu8(mn, _mm_shuffle_epi32(mn, _MM_SHUFFLE(2,3,0,1)));
+	mx = _mm_max_epu8(mx, _mm_shuffle_epi32(mx, _MM_SHUFFLE(2,3,0,1)));
+
+	minColor = (uint32)_mm_cvtsi128_si32(mn);
+	maxColor = (uint32)_mm_cvtsi128_si32(mx);
+#else
+	uint32 mn[4] = {255, 255, 255, 255};
+	uint32 mx[4] = {0, 0, 0, 0};
+	for( int i=0; i<16; i++ )
+	{
+		for( int c=0; c<4; c++ )
+		{
+			uint32 v = (pBlock[i] >> (c*8)) & 0xFF;
+			mn[c] = min(mn[c], v);
+			mx[c] = max(mx[c], v);
+		}
+	}
+	minColor = mn[0] | (mn[1]<<8) | (mn[2]<<16) | (mn[3]<<24);
+	maxColor = mx[0] | (mx[1]<<8) | (mx[2]<<16) | (mx[3]<<24);
+#endif
+}
+
+// Palette positions (0 = e1 ... 3 = e0) of the pixels projected on the line between the expanded end points
+static inline void GetColorPositions(const uint32 *pBlock, const int e0[3], const int e1[3], uint32 positions[16])
+{
+	int axis[3] = { e0[0]-e1[0], e0[1]-e1[1], e0[2]-e1[2] };
+	int len2 = axis[0]*axis[0] + axis[1]*axis[1] + axis[2]*axis[2];
+	float scale = 3.0f / (float)len2;
+
+#ifdef BC_USE_SSE2
+	// the pixels are unpacked to B, G, R, A words, the alpha word of the axis is 0
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i base = _mm_set_epi16(0, (short)e1[0], (short)e1[1], (short)e1[2], 0, (short)e1[0], (short)e1[1], (short)e1[2]);
+	const __m128i dir = _mm_set_epi16(0, (short)axis[0], (short)axis[1], (short)axis[2], 0, (short)axis[0], (short)axis[1], (short)axis[2]);
+	const __m128 vscale = _mm_set1_ps(scale);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128i three = _mm_set1_epi32(3);
+
+	for( int row=0; row<4; row++ )
+	{
+		__m128i px = _mm_loadu_si128((const __m128i *)(pBlock+row*4));
+		__m128i lo = _mm_sub_epi16(_mm_unpacklo_epi8(px, zero), base);
+		__m128i hi = _mm_sub_epi16(_mm_unpackhi_epi8(px, zero), base);
+
+		// B*ab+G*ag and R*ar for every pixel, then summed into one dot product per pixel
+		__m128 dlo = _mm_castsi128_ps(_mm_madd_epi16(lo, dir));
+		__m128 dhi = _mm_castsi128_ps(_mm_madd_epi16(hi, dir));
+		__m128i dot = _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(dlo, dhi, _MM_SHUFFLE(2,0,2,0))),
+									_mm_castps_si128(_mm_shuffle_ps(dlo, dhi, _MM_SHUFFLE(3,1,3,1))));
+
+		__m128i pos = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(dot), vscale), half));
+		// the positions are small, so clamping the 16 bit halves clamps the 32 bit values
+		pos = _mm_min_epi16(_mm_max_epi16(pos, zero), three);
+		_mm_storeu_si128((__m128i *)(positions+row*4), pos);
+	}
+#else
+	for( int i=0; i<16; i++ )
+	{
+		int r = (pBlock[i]>>16) & 0xFF;
+		int g = (pBlock[i]>>8) & 0xFF;
+		int b = pBlock[i] & 0xFF;
+		int dot = (r-e1[0])*axis[0] + (g-e1[1])*axis[1] + (b-e1[2])*axis[2];
+		int pos = (int)((float)dot*scale + 0.5f);
+		positions[i] = pos < 0 ? 0 : (pos > 3 ? 3 : pos);
+	}
+#endif
+}
+
+static void EncodeColorBlock(const uint32 *pBlock, uint32 minColor, uint32 maxColor, unsigned char *pDst)
+{
+	int mn[3] = { (int)(minColor>>16)&0xFF, (int)(minColor>>8)&0xFF, (int)minColor&0xFF };
+	int mx[3] = { (int)(maxColor>>16)&0xFF, (int)(maxColor>>8)&0xFF, (int)maxColor&0xFF };
+
+	// the box diagonal from min to max fits colors which grow together, flip the red and green extents if they
+	// grow against blue
+	int center[3] = { (mn[0]+mx[0])/2, (mn[1]+mx[1])/2, (mn[2]+mx[2])/2 };
+	int covRB = 0, covGB = 0;
+	for( int i=0; i<16; i++ )
+	{
+		int b = (int)(pBlock[i] & 0xFF) - center[2];
+		covRB += ((int)((pBlock[i]>>16) & 0xFF) - center[0]) * b;
+		covGB += ((int)((pBlock[i]>>8) & 0xFF) - center[1]) * b;
+	}
+	if( covRB < 0 )
+		std::swap(mn[0], mx[0]);
+	if( covGB < 0 )
+		std::swap(mn[1], mx[1]);
+
+	// inset the end points
+	for( int c=0; c<3; c++ )
+	{
+		int inset = (mx[c] - mn[c]) / 16;
+		mx[c] -= inset;
+		mn[c] += inset;
+	}
+
+	uint32 c0 = ColorTo565(mx[0], mx[1], mx[2]);
+	uint32 c1 = ColorTo565(mn[0], mn[1], mn[2]);
+	uint32 indices = 0;
+
+	if( c0 != c1 )
+	{
+		// c0 > c1 selects the 4 color palette
+		if( c0 < c1 )
+			std::swap(c0, c1);
+
+		int e0[3], e1[3];
+		Expand565(c0, e0);
+		Expand565(c1, e1);
+
+		uint32 positions[16];
+		GetColorPositions(pBlock, e0, e1, positions);
+		for( int i=0; i<16; i++ )
+			indices |= bc1IndexOfPosition[positions[i]] << (i*2);
+	}
+
+	pDst[0] = (unsigned char)c0;
+	pDst[1] = (unsigned char)(c0>>8);
+	pDst[2] = (unsigned char)c1;
+	pDst[3] = (unsigned char)(c1>>8);
+	pDst[4] = (unsigned char)indices;
+	pDst[5] = (unsigned char)(indices>>8);
+	pDst[6] = (unsigned char)(indices>>16);
+	pDst[7] = (unsigned char)(indices>>24);
+}
+
+static void EncodeAlphaBlock(const uint32 *pBlock, int aMin, int aMax, unsigned char *pDst)
+{
+	// a0 > a1 selects the 8 alpha ramp
+	pDst[0] = (unsigned char)aMax;
+	pDst[1] = (unsigned char)aMin;
+
+	uint64 indices = 0;
+	int range = aMax - aMin;
+	if( range > 0 )
+	{
+		for( int i=0; i<16; i++ )
+		{
+			int a = pBlock[i]>>24;
+			int pos = ((a - aMin)*7 + range/2) / range;
+			uint64 idx = pos == 7 ? 0 : (pos == 0 ? 1 : 8-pos);
+			indices |= idx << (i*3);
+		}
+	}
+
+	for( int i=0; i<6; i++ )
+		pDst[2+i] = (unsigned char)(indices >> (i*8));
+}
+
+void EncodeBC1Block(const uint32 *pBlock, unsigned char *pDst)
+{
+	uint32 minColor, maxColor;
+	GetBlockBounds(pBlock, minColor, maxColor);
+	EncodeColorBlock(pBlock, minColor, maxColor, pDst);
+}
+
+void EncodeBC3Block(const uint32 *pBlock, unsigned char *pDst)
+{
+	uint32 minColor, maxColor;
+	GetBlockBounds(pBlock, minColor, maxColor);
+	EncodeAlphaBlock(pBlock, minColor>>24, maxColor>>24, pDst);
+	EncodeColorBlock(pBlock, minColor, maxColor, pDst+8);
+}
+
+bool ImageHasAlpha(const uint32 *pSrc, uint32 width, uint32 height, int pitch)
+{
+	for( uint32 y=0; y<height; y++ )
+	{
+		const uint32 *pRow = (const uint32 *)((const unsigned char *)pSrc + y*pitch);
+		for( uint32 x=0; x<width; x++ )
+		{
+			if( pRow[x] < 0xFF000000 )
+				return true;
+		}
+	}
+	return false;
+}
+
+// Halves an image with a box filter
+static void DownsampleImage(const uint32 *pSrc, uint32 width, uint32 height, int pitch, std::vector<uint32> &dst)
+{
+	uint32 w = max(width/2, 1u);
+	uint32 h = max(height/2, 1u);
+	dst.resize(w*h);
+
+	for( uint32 y=0; y<h; y++ )
+	{
+		const uint32 *pRow0 = (const uint32 *)((const unsigned char *)pSrc + min(y*2, height-1)*pitch);
+		const uint32 *pRow1 = (const uint32 *)((const unsigned char *)pSrc + min(y*2+1, height-1)*pitch);
+		for( uint32 x=0; x<w; x++ )
+		{
+			uint32 x0 = min(x*2, width-1);
+			uint32 x1 = min(x*2+1, width-1);
+			uint32 p[4] = { pRow0[x0], pRow0[x1], pRow1[x0], pRow1[x1] };
+
+			uint32 result = 0;
+			for( int c=0; c<32; c+=8 )
+			{
+				uint32 sum = ((p[0]>>c)&0xFF) + ((p[1]>>c)&0xFF) + ((p[2]>>c)&0xFF) + ((p[3]>>c)&0xFF);
+				result |= ((sum+2)/4) << c;
+			}
+			dst[y*w+x] = result;
+		}
+	}
+}
+
+void CompressTextureBC(const uint32 *pSrc, uint32 width, uint32 height, int pitch, bool bMipMaps, BCTexture &tex)
+{
+	tex.bBC3 = ImageHasAlpha(pSrc, width, height, pitch);
+	tex.width = width;
+	tex.height = height;
+	tex.levels.clear();
+
+	int blockSize = tex.bBC3 ? BC3_BLOCK_SIZE : BC1_BLOCK_SIZE;
+	std::vector<uint32> mip;
+	std::vector<uint32> nextMip;
+
+	for(;;)
+	{
+		uint32 blocksX = (width+3)/4;
+		uint32 blocksY = (height+3)/4;
+		tex.levels.push_back(std::vector<unsigned char>(blocksX*blocksY*blockSize));
+		unsigned char *pDst = &tex.levels.back()[0];
+
+		for( uint32 by=0; by<blocksY; by++ )
+		{
+			for( uint32 bx=0; bx<blocksX; bx++ )
+			{
+				// the levels smaller than a block repeat their edge pixels
+				uint32 block[16];
+				for( uint32 y=0; y<4; y++ )
+				{
+					const uint32 *pRow = (const uint32 *)((const unsigned char *)pSrc + min(by*4+y, height-1)*pitch);
+					for( uint32 x=0; x<4; x++ )
+						block[y*4+x] = pRow[min(bx*4+x, width-1)];
+				}
+
+				if( tex.bBC3 )
+					EncodeBC3Block(block, pDst);
+				else
+					EncodeBC1Block(block, pDst);
+				pDst += blockSize;
+			}
+		}
+
+		if( !bMipMaps || (width == 1 && height == 1) )
+			break;
+
+		DownsampleImage(pSrc, width, height, pitch, nextMip);
+		mip.swap(nextMip);
+		width = max(width/2, 1u);
+		height = max(height/2, 1u);
+		pSrc = &mip[0];
+		pitch = width*4;
+	}
+}
+
+#define DDS_MAGIC				0x20534444	// "DDS "
+#define DDS_FOURCC_DXT1			0x31545844	// "DXT1"
+#define DDS_FOURCC_DXT5			0x35545844	// "DXT5"
+#define DDSD_CAPS				0x00000001
+#define DDSD_HEIGHT				0x00000002
+#define DDSD_WIDTH				0x00000004
+#define DDSD_PIXELFORMAT		0x00001000
+#define DDSD_MIPMAPCOUNT		0x00020000
+#define DDSD_LINEARSIZE			0x00080000
+#define DDPF_FOURCC				0x00000004
+#define DDSCAPS_COMPLEX			0x00000008
+#define DDSCAPS_TEXTURE			0x00001000
+#define DDSCAPS_MIPMAP			0x00400000
+
+struct DDSFileHeader
+{
+	uint32 magic;
+	uint32 size;
+	uint32 flags;
+	uint32 height;
+	uint32 width;
+	uint32 linearSize;
+	uint32 depth;
+	uint32 mipMapCount;
+	uint32 reserved1[11];
+	uint32 pfSize;
+	uint32 pfFlags;
+	uint32 pfFourCC;
+	uint32 pfBitCount;
+	uint32 pfMasks[4];
+	uint32 caps;
+	uint32 caps2;
+	uint32 caps3;
+	uint32 caps4;
+	uint32 reserved2;
+};
+
+bool SaveBCTextureDDS(const char *filename, const BCTexture &tex)
+{
+	DDSFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = DDS_MAGIC;
+	header.size = sizeof(header) - sizeof(header.magic);
+	header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_LINEARSIZE | DDSD_MIPMAPCOUNT;
+	header.height = tex.height;
+	header.width = tex.width;
+	header.linearSize = (uint32)tex.levels[0].size();
+	header.mipMapCount = (uint32)tex.levels.size();
+	header.pfSize = 32;
+	header.pfFlags = DDPF_FOURCC;
+	header.pfFourCC = tex.bBC3 ? DDS_FOURCC_DXT5 : DDS_FOURCC_DXT1;
+	header.caps = DDSCAPS_TEXTURE | (tex.levels.size() > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+	FILE *f = fopen(filename, "wb");
+	if( f == NULL )
+	{
+		TRACE1("Cannot write %s", filename);
+		return false;
+	}
+
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+	for( size_t i=0; ok && i<tex.levels.size(); i++ )
+		ok = fwrite(&tex.levels[i][0], 1, tex.levels[i].size(), f) == tex.levels[i].size();
+	ok = fclose(f) == 0 && ok;
+
+	if( !ok )
+	{
+		TRACE1("Cannot write %s", filename);
+		remove(filename);
+	}
+	return ok;
+}
+
+bool LoadBCTextureDDS(const char *filename, BCTexture &tex)
+{
+	FILE *f = fopen(filename, "rb");
+	if( f == NULL )
+		return false;
+
+	DDSFileHeader header;
+	bool ok = fread(&header, sizeof(header), 1, f) == 1 && header.magic == DDS_MAGIC &&
+		header.size == sizeof(header) - sizeof(header.magic) && (header.pfFlags & DDPF_FOURCC) &&
+		(header.pfFourCC == DDS_FOURCC_DXT1 || header.pfFourCC == DDS_FOURCC_DXT5) &&
+		header.width > 0 && header.height > 0 && header.width <= 8192 && header.height <= 8192 && header.mipMapCount <= 14;
+
+	if( ok )
+	{
+		tex.bBC3 = header.pfFourCC == DDS_FOURCC_DXT5;
+		tex.width = header.width;
+		tex.height = header.height;
+		tex.levels.resize(max(header.mipMapCount, 1u));
+
+		uint32 width = tex.width;
+		uint32 height = tex.height;
+		for( size_t i=0; ok && i<tex.levels.size(); i++ )
+		{
+			tex.levels[i].resize(((width+3)/4) * ((height+3)/4) * (tex.bBC3 ? BC3_BLOCK_SIZE : BC1_BLOCK_SIZE));
+			ok = fread(&tex.levels[i][0], 1, tex.levels[i].size(), f) == tex.levels[i].size();
+			width = max(width/2, 1u);
+			height = max(height/2, 1u);
+		}
+	}
+	fclose(f);
+
+	if( !ok )
+	{
+		TRACE1("Damaged compressed texture file: %s", filename);
+		tex.levels.clear();
+	}
+	return ok;
+}
@@ -0,0 +1,52 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef _TEXTURE_COMPRESS_H_
+#define _TEXTURE_COMPRESS_H_
+
+#include <vector>
+
+#define BC1_BLOCK_SIZE	8
+#define BC3_BLOCK_SIZE	16
+
+// A block compressed texture with its mip levels, as stored in D3DFMT_DXT1 / D3DFMT_DXT5 surfaces
+struct BCTexture
+{
+	bool bBC3;							// DXT5 if the texture has alpha, DXT1 otherwise
+	uint32 width;						// size of the first level
+	uint32 height;
+	std::vector< std::vector<unsigned char> > levels;	// rows of 4x4 blocks, the first level first
+};
+
+// Encodes a 4x4 block of A8R8G8B8 pixels. BC1 ignores the alpha channel.
+void EncodeBC1Block(const uint32 *pBlock, unsigned char *pDst);
+void EncodeBC3Block(const uint32 *pBlock, unsigned char *pDst);
+
+// Tells if any pixel of an A8R8G8B8 image is not opaque
+bool ImageHasAlpha(const uint32 *pSrc, uint32 width, uint32 height, int pitch);
+
+// Compresses an A8R8G8B8 image (pitch in bytes), to BC1 if it is opaque and to BC3 otherwise. The mip levels are
+// built with a box filter if bMipMaps is set.
+void CompressTextureBC(const uint32 *pSrc, uint32 width, uint32 height, int pitch, bool bMipMaps, BCTexture &tex);
+
+// DDS files of block compressed textures, used to cache compressed hires textures on disk
+bool SaveBCTextureDDS(const char *filename, const BCTexture &tex);
+bool LoadBCTextureDDS(const char *filename, BCTexture &tex);
+
+#endif
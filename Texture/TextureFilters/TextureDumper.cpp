@@ -0,0 +1,155 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "..\..\stdafx.h"
+#include "TextureDumper.h"
+#include "BMGDll.h"
+
+// Pixels waiting for the writer, a burst of new textures is queued up to this size before Dump() has to wait
+#define MAX_DUMP_QUEUE_BYTES	(64*1024*1024)
+
+CTextureDumper gTextureDumper;
+
+CTextureDumper::CTextureDumper() :
+	m_queuedBytes(0),
+	m_bStop(false)
+{
+}
+
+CTextureDumper::~CTextureDumper()
+{
+	// RomClosed and CloseDLL stop the writer, nothing is waited for here as the loader lock is held when the
+	// dll is unloaded
+	if( m_thread.joinable() )
+		m_thread.detach();
+}
+
+void CTextureDumper::AddDumpedFiles(const char *subfolder)
+{
+	std::string pattern = m_gamefolder + subfolder + "*.png";
+
+	WIN32_FIND_DATA findData;
+	HANDLE hFind = FindFirstFile(pattern.c_str(), &findData);
+	if( hFind == INVALID_HANDLE_VALUE )
+		return;
+
+	do
+	{
+		m_dumped.insert(std::string(subfolder) + findData.cFileName);
+	} while( FindNextFile(hFind, &findData) );
+	FindClose(hFind);
+}
+
+void CTextureDumper::Start(const char *gamefolder)
+{
+	Stop();
+
+	m_gamefolder = gamefolder;
+	AddDumpedFiles("png_all\\");
+	AddDumpedFiles("ci_by_png\\");
+
+	m_bStop = false;
+	m_thread = std::thread(&CTextureDumper::WriterThread, this);
+}
+
+void CTextureDumper::Stop()
+{
+	if( !IsRunning() )
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStop = true;
+	}
+	m_cond.notify_all();
+
+	// the writer empties the queue before it exits
+	m_thread.join();
+	m_dumped.clear();
+}
+
+void CTextureDumper::Dump(const char *name, CTexture &texture, int width, int height)
+{
+	if( !IsRunning() || width <= 0 || height <= 0 || !m_dumped.insert(name).second )
+		return;
+
+	DumpItem item;
+	item.filename = m_gamefolder + name;
+	item.width = width;
+	item.height = height;
+	item.pixels.resize(width*height*4);
+
+	DrawInfo srcInfo;
+	if( !texture.StartUpdate(&srcInfo) )
+	{
+		TRACE0("Cannot lock texture");
+		m_dumped.erase(name);
+		return;
+	}
+
+	// PNG files are written from bottom-up rows, like CRender::SaveTextureToFile does
+	for( int i=0; i<height; i++ )
+		memcpy(&item.pixels[(height-1-i)*width*4], (BYTE*)srcInfo.lpSurface + srcInfo.lPitch*i, width*4);
+	texture.EndUpdate(&srcInfo);
+
+	size_t bytes = item.pixels.size();
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while( m_queuedBytes > 0 && m_queuedBytes + bytes > MAX_DUMP_QUEUE_BYTES )
+			m_spaceCond.wait(lock);
+
+		m_queuedBytes += bytes;
+		m_queue.push_back(std::move(item));
+	}
+	m_cond.notify_one();
+}
+
+void CTextureDumper::WriterThread()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	for(;;)
+	{
+		while( !m_bStop && m_queue.empty() )
+			m_cond.wait(lock);
+		if( m_queue.empty() )
+			break;
+
+		DumpItem item = std::move(m_queue.front());
+		m_queue.pop_front();
+
+		// encode without holding the lock
+		lock.unlock();
+
+		struct BMGImageStruct img;
+		InitBMGImage(&img);
+		img.bits = &item.pixels[0];
+		img.bits_per_pixel = 32;
+		img.width = item.width;
+		img.height = item.height;
+		img.scan_width = item.width * 4;
+		if( WritePNG(item.filename.c_str(), img) != BMG_OK )
+			TRACE1("Cannot write %s", item.filename.c_str());
+
+		lock.lock();
+
+		m_queuedBytes -= item.pixels.size();
+		m_spaceCond.notify_one();
+	}
+}
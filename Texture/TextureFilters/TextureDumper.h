@@ -0,0 +1,79 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#ifndef _TEXTURE_DUMPER_H_
+#define _TEXTURE_DUMPER_H_
+
+#include <string>
+#include <deque>
+#include <unordered_set>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+/********************************************************************************************************************
+ * Writes dumped textures to PNG files on a background thread. Dump() only copies the pixels of the texture into a
+ * queue, the encoding and writing is done by the writer thread. The names of the files already dumped are kept in
+ * memory (the dump folder is listed once when the dumper starts), so no file system check is done per texture.
+ * The queue is limited to MAX_DUMP_QUEUE_BYTES of pixels, Dump() waits for the writer if it is full.
+ ********************************************************************************************************************/
+class CTextureDumper
+{
+public:
+	CTextureDumper();
+	// Does not stop the writer, Stop has to be called before the dll is unloaded
+	~CTextureDumper();
+
+	// gamefolder is texture_dump\<GameName>\ with the png_all and ci_by_png sub-folders
+	void Start(const char *gamefolder);
+	// Writes the queued textures and stops the writer thread
+	void Stop();
+	bool IsRunning() { return m_thread.joinable(); }
+
+	// Queues the first width x height pixels of a texture for being written to gamefolder\name, unless the file has
+	// already been dumped
+	void Dump(const char *name, CTexture &texture, int width, int height);
+
+private:
+	struct DumpItem
+	{
+		std::string filename;
+		std::vector<unsigned char> pixels;		// bottom-up A8R8G8B8 rows
+		int width;
+		int height;
+	};
+
+	void WriterThread();
+	void AddDumpedFiles(const char *subfolder);
+
+	std::string m_gamefolder;
+	std::unordered_set<std::string> m_dumped;	// only used by the emulation thread
+
+	std::mutex m_mutex;
+	std::condition_variable m_cond;				// signals new items to the writer
+	std::condition_variable m_spaceCond;		// signals free space in the queue to Dump()
+	std::thread m_thread;
+	std::deque<DumpItem> m_queue;
+	size_t m_queuedBytes;
+	bool m_bStop;
+};
+
+extern CTextureDumper gTextureDumper;
+
+#endif
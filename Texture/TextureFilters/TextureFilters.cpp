@@ -20,8 +20,18 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <thread>
+#include <atomic>
 #include "TextureFilters.h"
-#include "..\..\SimpleIni.h"
+#include "HiresTxtrIndex.h"
+#include "HiresTxtrScanner.h"
+#include "HiresTxtrCache.h"
+#include "HiresTxtrStream.h"
+#include "HiresTxtrPack.h"
+#include "HiresTxtrPreload.h"
+#include "HiresTxtrUpload.h"
+#include "TextureCompress.h"
+#include "TextureDumper.h"
 #include "BMGDll.h"
 #include "../../Utility/util.h"
 
@@ -92,6 +102,9 @@ void EnhanceTexture(TxtrCacheEntry *pEntry)
 			}
 			//Tell it that we have finished updating the surface
 			pSurfaceHandler->EndUpdate(&destInfo);	
+
+			if( options.bCompressEnhancedTextures )
+				pSurfaceHandler->Compress();
 		}
 
 		pSurfaceHandler->m_bIsEnhancedTexture = true;
@@ -110,378 +123,63 @@ void EnhanceTexture(TxtrCacheEntry *pEntry)
 /****
  All code bellow, CLEAN ME
 ****/
-enum TextureType
-{
-	NO_TEXTURE,
-	RGB_PNG,
-	RGB_WITH_ALPHA_TOGETHER_PNG,
-};
-
-struct ExtTxtrInfo{
-	unsigned int width;
-	unsigned int height;
-	int crc32;
-	int pal_crc32;
-	char *foldername;
-	char *filename;
-	char *filename_a;
-	TextureType type;
-	bool bSeparatedAlpha;
-	int scaleShift;
-	// cached texture
-	unsigned char	*pHiresTextureRGB;
-	unsigned char	*pHiresTextureAlpha;
-};
 void CacheHiresTexture( ExtTxtrInfo &ExtTexInfo );
 
-CSortedList<uint64,ExtTxtrInfo> gHiresTxtrInfos;
+CHiresTxtrIndex gHiresTxtrInfos;
 
-extern void GetPluginDir( char * Directory );
+// The index is built by a background thread into gLoadingHiresTxtrInfos, which is swapped with gHiresTxtrInfos by
+// PublishHiresTextures once it is complete. Until then no hires texture is found and the original ones are used.
+static CHiresTxtrIndex gLoadingHiresTxtrInfos;
+static std::thread gHiresIndexThread;
+static std::atomic<bool> gHiresIndexReady(false);
+static std::atomic<bool> gHiresIndexCancel(false);
 
-int GetImageInfoFromFile(char* pSrcFile, IMAGE_INFO *pSrcInfo)
-{
-    unsigned char sig[8];
-    FILE *f;
-
-	//Open up the file so we can read from it
-    f = fopen(pSrcFile, "rb");
-
-	//If the file returns empty then spit out an error
-    if (f == NULL)
-    {
-		TRACE1("GetImageInfoFromFile() error: couldn't open file '%s'", pSrcFile);
-		return 1;
-    }
-	//Read the first 8 bytes from the image
-    if (fread(sig, 1, 8, f) != 8)
-    {
-		//If we couldn't read the first 8 bytes then send spit out an error
-		TRACE1("GetImageInfoFromFile() error: couldn't read first 8 bytes of file '%s'", pSrcFile);
-		fclose(f);// We failed to read the first 8 bytes, so ensure that we have flosed the file read stream
-		return 1;
-    }
-	//Close the file stream
-    fclose(f);
-
-	//Now lets do some header anaylsis
-	if(sig[0] == 137 && sig[1] == 'P' && sig[2] == 'N' && sig[3] == 'G' && sig[4] == '\r' && sig[5] == '\n' &&
-               sig[6] == 26 && sig[7] == '\n') // PNG
-    {
-		//Define out BMGImageStruct where we will store our info
-        struct BMGImageStruct img;
-		//Set our new struct to the proper size
-        memset(&img, 0, sizeof(BMGImageStruct));
-		//Read the information we need from the PNG into our BMGImageStruct
-        BMG_Error code = ReadPNGInfo(pSrcFile, &img);
-
-        if( code == BMG_OK )
-        {
-			//Store the image width in our own image info
-            pSrcInfo->Width = img.width;
-			//Store the iamge height in our own image info
-            pSrcInfo->Height = img.height;
-			//Store the bits per pixel as our depth
-            pSrcInfo->Depth = img.bits_per_pixel;
-			//Store the amount of mip levels as 1, since png's do not contain mip map data
-            pSrcInfo->MipLevels = 1;
-			//Set our image format based on the amount of bits per pixel there is
-            if(img.bits_per_pixel == 32)
-                pSrcInfo->Format = D3DFMT_A8R8G8B8;
-            else if(img.bits_per_pixel == 8)
-                pSrcInfo->Format = D3DFMT_P8;
-            // Resource and File Format ignored
-            FreeBMGImage(&img);
-            return 0;
-        }
-		//If we get here it means we failed to read the PNG file
-        TRACE2("Couldn't read PNG file '%s'; error = %i", pSrcFile, code);
-        return 1;
-    }
-	//If we get here it means the image where checking is not a known format
-	TRACE1("GetImageInfoFromFile : unknown file format (%s)", pSrcFile);
-    return 1;
-}
+// folder of the compressed hires textures of the current rom, empty if there is no hires texture
+static char gCompressedCacheFolder[_MAX_PATH];
+
+extern void GetPluginDir( char * Directory );
 
 /********************************************************************************************************************
- * Truncates the current list with information about hires textures and scans the hires folder for hires textures and 
- * creates a list with records of properties of the hires textures.
+ * Scans the hires folder for hires textures and adds records of properties of the hires textures to the index.
+ * The folder is scanned by ScanHiresTextureFolder, which reads the PNG headers on worker threads.
  * parameter:
  * foldername: the folder that should be scaned for valid hires textures.
- * infos: a pointer that will point to the list containing the records with the infos about the found hires textures.
+ * gamename: the name of the rom the hires textures are for
+ * infos: the index receiving the records with the infos about the found hires textures.
  *        In case of enabled caching, these records will also contain the actual textures.
  * bRecursive: flag that indicates if also subfolders should be scanned for hires textures
  * bCacheTextures: flag that indicates if the identified hires textures should also be cached
- * bMainFolder: indicates if the folder is the main folder that will be scanned. That way, texture counting does not
- *              start at 1 each time a subfolder is accessed. (microdev: I know that is not important but it really 
- *              bugged me ;-))
  * return:
- * infos: the list with the records of the identified hires textures. Be aware that these records also contains the 
+ * infos: the index with the records of the identified hires textures. Be aware that these records also contains the 
  *        actual textures if caching is enabled.
  ********************************************************************************************************************/
-void FindAllTexturesFromFolder(char *foldername, CSortedList<uint64,ExtTxtrInfo> &infos, bool bRecursive, bool bCacheTextures = false, bool bMainFolder = true)
+void FindAllTexturesFromFolder(const char *foldername, const char *gamename, CHiresTxtrIndex &infos, bool bRecursive, bool bCacheTextures = false)
 {
 	// check if folder actually exists
 	if(!PathIsDirectory(foldername) )
 		return;
 
-	// the path of the texture
-	char			texturefilename[_MAX_PATH];
-	// the folder path which is scanned for textures
-	char			searchpath[_MAX_PATH];
-	// counter to count the identified hires textures
-	static int      count;
-	// handle to the first file found with a particular name (pattern search)
-	HANDLE			findfirst;
-	// the record containing the actual file data
-	WIN32_FIND_DATA libaa;
-	// 
-	IMAGE_INFO	imgInfo;
-	//
-	IMAGE_INFO	imgInfo2;
-	// simple ini
-	CSimpleIniA ini;
-
-	// prepare message
-	sprintf(generalText,"Processing folder: %s", foldername);
-	// create box for displaying it on screen
-	RECT rect2={0,200,windowSetting.uDisplayWidth,300};
-	//and.. well, you guess it - display it
-	OutputText(generalText,&rect2);
-
-	// set the search path to the current folder name
-	strcpy(searchpath, foldername);
-	// add the search pattern
-	strcat(searchpath, "*.*");
-
-	// and fetch the first file corresponding to this pattern
-	findfirst = FindFirstFile(searchpath, &libaa);
-	// ehmm... there is no first file
-	if( findfirst == INVALID_HANDLE_VALUE )
-	{
-		// thus forget it - empty folder
-		return;
-	}
-
-	// we are in the main folder ==> reset counter (I love it)
-	if (bMainFolder) 
-		count = 0;
-
-	// vars for: DRAM-crc, texture format, texture size (in bit), and the palette-crc
-	uint32 crc, fmt, siz, palcrc32;
-	//ASCII representation (hex) of DRAM-CRC and palette-CRC
-	char crcstr[16], crcstr2[16];
+	std::vector<ExtTxtrInfo> found;
+	ScanHiresTextureFolder(foldername, gamename, bRecursive, found);
 
-	do
+	infos.reserve(infos.size() + (int)found.size());
+	for( size_t i=0; i<found.size(); i++ )
 	{
-		// the array is empty, break the current operation
-		if( libaa.cFileName == NULL )
-			break;
-
-		// the current file is a hidden one
-		if( libaa.cFileName[0] == '.' )
-			// these files we don't need
-			continue;
-
-		// let's process the next file
-		count++;
-
-		// get the folder name
-		strcpy(texturefilename, foldername);
-		// and append the file name
-		strcat(texturefilename, libaa.cFileName);
-
-		// assemble the message
-		sprintf(generalText,"Texture %d is checked: %s", count, libaa.cFileName);
-		// display it in the status bar
-		SetWindowText(g_GraphicsInfo.hStatusBar,generalText);
-		// prepare a rectangle for on-screen display
-		RECT rect={0,300,windowSetting.uDisplayWidth,320};
-		// and also display it on-screen
-		OutputText(generalText,&rect, DT_LEFT);
-
-		//Check if the current file is a directory and if recursive scanning is enabled
-		if( PathIsDirectory(texturefilename) && bRecursive )
+		// add the new record to the index, duplicates (same CRCs, format and size) are rejected
+		int idx = infos.add(found[i]);
+		if( idx < 0 )
 		{
-			// add file-separator
-			strcat(texturefilename, "\\");
-			// scan detected subfolder for hires textures (recursive call)
-			FindAllTexturesFromFolder(texturefilename, infos, bRecursive, bCacheTextures, false);
-			continue;
-		}
-
-		// well, the current file is actually no file (probably a directory & recursive scanning is not enabled)
-		if( strstr(libaa.cFileName,g_curRomInfo.szGameName) == 0 )
-			// go on with the next one
+			free(found[i].foldername);
+			free(found[i].filename);
+			free(found[i].filename_a);
 			continue;
-
-		// now we've got a file. Let's check if it is a supported texture format
-		if( GetImageInfoFromFile(texturefilename, &imgInfo) != 0 )
-		{
-			// ehmm, wait a second... no!
-			TRACE1("Cannot get image info for file: %s", libaa.cFileName);
-			return;
-		}
-
-		// init texture type var
-		TextureType type = NO_TEXTURE;
-		// init alpha flag
-		bool bSeparatedAlpha = false;
-
-		// detect the texture type by it's extention
-		// microdev: this is not the smartest way. Should be done by header analysis if possible
-		if( _stricmp(right(libaa.cFileName, 13),  "_ciByRGBA.png"  ) == 0 || 
-			_stricmp(right(libaa.cFileName, 16), "_allciByRGBA.png") == 0 ||
-			_stricmp(right(libaa.cFileName,  8), "_all.png")         == 0)
-		{
-			type = RGB_WITH_ALPHA_TOGETHER_PNG;
 		}
-		// detect the texture type by it's extention
-		else if( _stricmp(right(libaa.cFileName,8), "_rgb.png") == 0)
-		{
-			// store type to the record
-			type = RGB_PNG;
 
-			char filename2[256];
-			// assemble the file name for the separate alpha channel file
-			strcpy(filename2,texturefilename);
-			strcpy(filename2 + strlen(filename2) -8,"_a.png");
-
-			// check if this file actually exists
-			if( PathFileExists(filename2) )
-			{
-				// check if the file with this name is actually a texture (well an alpha channel one)
-				if( GetImageInfoFromFile(filename2, &imgInfo2) != 0 )
-				{
-					// nope, it isn't => go on with next file
-					TRACE1("Cannot get image info for file: %s", filename2);
-					continue;
-				}
-				// yes it is a texture file. Check if the size of the alpha channel is the same as the one of the texture
-				if(imgInfo2.Width != imgInfo.Width || imgInfo2.Height != imgInfo.Height)
-				{
-					// nope, it isn't => go on with next file
-					TRACE1("RGB and alpha texture size mismatch: %s", filename2);
-					continue;
-				}
-
-				// Indicate that the file has a sperated alpha channel
-				bSeparatedAlpha = true; 
-			}
-		}
-		// if a known texture format has been detected...
-		if( type != NO_TEXTURE )
-		{
-		/*
-			Try to read image information here.
-
-			(CASTLEVANIA2)#(58E2333F)#(2)#(0)#(D7A5C6D9)_ciByRGBA.png
-			(------1-----)#(---2----)#(3)#(4)#(---5----)_ciByRGBA.png
-
-			1. Internal ROM name
-			2. The DRAM CRC
-			3. The image pixel size (8b=0, 16b=1, 24b=2, 32b=3)
-			4. The texture format (RGBA=0, YUV=1, CI=2, IA=3, I=4)
-			5. The palette CRC
-
-			<internal Rom name>#<DRAM CRC>#<24bit>#<RGBA>#<PAL CRC>_ciByRGBA.png
-		*/
-			// get the actual file name
-			strcpy(texturefilename, libaa.cFileName);
-			// place the pointer before the DRAM-CRC (first occurance of '#')
-			char *ptr = strchr(texturefilename,'#');
-			// terminate the string ('0' means end of string - or in this case begin of string)
-			*ptr++ = 0;
-
-			// extract the information from the file name - this file does not have a palette crc; information is:
-			// <DRAM(or texture)-CRC><texture type><texture format>
-			// o gosh, commenting source code is really boring - but necessary!! Thus do it! (and don't use drugs ;-))
-			if (sscanf(ptr, "%8c#%d#%d#%8c", crcstr, &fmt, &siz, crcstr2) == 4)
-				palcrc32 = strtoul(crcstr2, NULL, 16);
-			else if (sscanf(ptr, "%8c#%d#%d", crcstr, &fmt, &siz) == 3)
-				palcrc32 = 0xFFFFFFFF;
-			else
-				return;
-
-			// transform the ascii presentation of the hex value to an unsigned integer
-			crc = strtoul(crcstr,NULL,16);
-
-			// for the detection of an existing item
-			int foundIdx = -1;
-
-			// loop through the list of records of already fetched hires textures
-			for( int k=0; k<infos.size(); k++)
-			{
-				// check if texture already exists in the list
-				if( infos[k].crc32 == crc && infos[k].pal_crc32 == palcrc32 )
-				{
-					//Duplicates
-					foundIdx = k;
-				}
-			}
-
-			// if the texture is not yet in the list
-			if(	foundIdx < 0 )
-			{
-				// create a new entry
-				ExtTxtrInfo *newinfo = new ExtTxtrInfo;
-
-				// store the width
-				newinfo->width = imgInfo.Width;
-				// store the height
-				newinfo->height = imgInfo.Height;
-				//allocate space for the name of the folder it has been found in
-				newinfo->foldername = new char[strlen(foldername)+1];
-				// store the name of the folder it has been found in
-				strcpy(newinfo->foldername,foldername);
-				//store the name of the texture
-				newinfo->filename = _strdup(libaa.cFileName);
-				//assume by default theres no alpha texture
-				newinfo->filename_a = NULL;
-				// store DRAM (texture) CRC
-				newinfo->crc32 =	crc;
-				// store PAL (palette) CRC (the actual one or the dummy value ('FFFFFFFF'))
-				newinfo->pal_crc32 = palcrc32;
-				// store the texture type
-				newinfo->type = type;
-				// indicate if there is a separate alpha file that has to be loaded
-				newinfo->bSeparatedAlpha = bSeparatedAlpha;
-
-				// store the extention of the texture and also the extention of the alpha channel (if existing)
-				if(bSeparatedAlpha)
-				{
-					char filename2[_MAX_PATH];
-					strcpy(filename2, libaa.cFileName);
-					strcpy(filename2+strlen(filename2)-8,"_a.png");
-					newinfo->filename_a = _strdup(filename2);
-				}
-
-				// generate the key for the record describing the hires texture.
-				// This key is used to find it back in the list
-				// The key format is: <DRAM(texture)-CRC-8byte><PAL(palette)-CRC-6byte(2bytes have been truncated to have space for format and size)><format-1byte><size-1byte>
-				uint64 crc64 = newinfo->crc32;
-				crc64 <<= 32;
-				crc64 |= newinfo->pal_crc32&0xFFFFFFFF;
-
-				// if caching has been enabled, also cache the actual texture
-				if(bCacheTextures)
-				{
-					// generate status message
-					sprintf(generalText,"Texture %d is loading: %s", count, libaa.cFileName);
-					// display status message in the status bar fo the window
-					SetWindowText(g_GraphicsInfo.hStatusBar,generalText);
-					// prepare a rectancle for displaying onscreen message
-					RECT rect={0,300,windowSetting.uDisplayWidth,320};
-					// display onscreen message
-					OutputText(generalText,&rect, DT_LEFT);
-					// cache the actual texture to memory (and of course the alpha channel as well, if existing)
-					CacheHiresTexture(*newinfo);
-				}
-				// add the new record to the list 
-				infos.add(crc64,*newinfo);
-			}
-		}
-	// loop through all files of the current directory
-	} while(FindNextFile(findfirst, &libaa));
+		// if caching has been enabled, also cache the actual texture (and of course the alpha channel as well, if
+		// existing), unless the index is not wanted anymore
+		if( bCacheTextures && !gHiresIndexCancel )
+			PreloadHiresTexture(infos[idx], options.bCompressHiResCache);
+	}
 }
 
 /********************************************************************************************************************
@@ -548,73 +246,49 @@ void CreateDumpFolders(void)
 	}
 }
 
-/********************************************************************************************************************
- * Truncates the current list with information about hires textures and scans the hires folder for hires textures and 
- * creates a list with records of properties of the hires textures.
- * parameter: 
- * none
- * return:
- * none
- ********************************************************************************************************************/
-void FindAllHiResTextures()
+// Stops building the index in the background and throws away what it has found
+static void StopHiresIndexing(void)
 {
-	CSimpleIniA ini;
-	char	foldername[256];
-	// get the path of the plugin directory
-	GetPluginDir(foldername);
-
-	// add the relative path to the hires folder
-	strcat(foldername,"hires_texture\\");
-	// it does not exist? => create it
-	CheckAndCreateFolder(foldername);
-
-	// add the path to a sub-folder corresponding to the rom name 
-	// HOOK IN: PACK SELECT
-	strcat(foldername,g_curRomInfo.szGameName);
-	strcat(foldername,"\\");
+	if( !gHiresIndexThread.joinable() )
+		return;
 
-	// trunkate the current list with hires texture infos
-	gHiresTxtrInfos.clear();
+	gHiresIndexCancel = true;
+	gHiresIndexThread.join();
+	gHiresIndexCancel = false;
+	gHiresIndexReady = false;
 
-	// check if there is a subfolder for this rom
-	if( !PathFileExists(foldername) )
-	{
-		// no? bye, bye ;-)
-		return;
-	}
-	else
-	{
-		// find all hires textures and also cache them if configured to do so
-		FindAllTexturesFromFolder(foldername,gHiresTxtrInfos, true, options.bCacheHiResTextures != FALSE);
-	}
+	for( int i=0; i<gLoadingHiresTxtrInfos.size(); i++ )
+		FreePreloadedHiresTexture(gLoadingHiresTxtrInfos[i]);
+	gLoadingHiresTxtrInfos.clear();
 }
 
 void CloseHiresTextures(void)
 {
+	// the indexing thread opens the pack, the streaming threads read the index
+	StopHiresIndexing();
+	gHiresTxtrStreamer.Stop();
+	gTextureDumper.Stop();
+
 	if (gHiresTxtrInfos.size() > 0)
 	{
 		for (int i = 0; i < gHiresTxtrInfos.size(); i++)
 		{
-			//Clear out any information we have kept about the files
-			if (gHiresTxtrInfos[i].foldername)
-				delete[] gHiresTxtrInfos[i].foldername;
-			if (gHiresTxtrInfos[i].filename)
-				delete[]gHiresTxtrInfos[i].filename;
-			if (gHiresTxtrInfos[i].filename_a)
-				delete[]gHiresTxtrInfos[i].filename_a;
-
-			// don't forget to also free memory of cached textures
-			if (gHiresTxtrInfos[i].pHiresTextureRGB)
-				delete[] gHiresTxtrInfos[i].pHiresTextureRGB;
-			if (gHiresTxtrInfos[i].pHiresTextureAlpha)
-				delete[] gHiresTxtrInfos[i].pHiresTextureAlpha;
+			// free memory of cached textures, the information about the files is freed by the index
+			FreePreloadedHiresTexture(gHiresTxtrInfos[i]);
 		}
 		gHiresTxtrInfos.clear();
 	}
+
+	// the records of a pack point into it
+	gHiresTxtrPack.Close();
+	gCompressedCacheFolder[0] = 0;
 }
 
 void CloseExternalTextures(void)
 {
+	// write the textures still queued for dumping
+	gTextureDumper.Stop();
+
 	static char* currentRomName = new char[200];
 	// this condition has been added to avoid reloading the game each time a savestate has been loaded
 	// The trick is quite simple: it is checked if the internal rom name has changed
@@ -626,20 +300,149 @@ void CloseExternalTextures(void)
 	}
 }
 
+/********************************************************************************************************************
+ * Prepares the folder texture_cache\<GameName>\ keeping the compressed hires textures of the rom. The files are
+ * deleted if they have been made from another version of the hires textures.
+ * parameter:
+ * gamename: the name of the rom
+ * fingerprint: identifies the hires textures the compressed ones are made from
+ * return:
+ * none
+ ********************************************************************************************************************/
+static void InitCompressedCache(const char *gamename, uint64 fingerprint)
+{
+	char	foldername[_MAX_PATH];
+	char	filename[_MAX_PATH];
+
+	gCompressedCacheFolder[0] = 0;
+
+	GetPluginDir(foldername);
+	strcat(foldername,"texture_cache\\");
+	if( !CheckAndCreateFolder(foldername) )
+		return;
+	strcat(foldername,gamename);
+	strcat(foldername,"\\");
+	if( !CheckAndCreateFolder(foldername) )
+		return;
+
+	sprintf(filename, "%ssource.id", foldername);
+	uint64 cachedFingerprint = 0;
+	FILE *f = fopen(filename, "rb");
+	if( f )
+	{
+		if( fread(&cachedFingerprint, sizeof(cachedFingerprint), 1, f) != 1 )
+			cachedFingerprint = 0;
+		fclose(f);
+	}
+
+	if( cachedFingerprint != fingerprint )
+	{
+		// the hires textures have changed, throw the compressed ones away
+		WIN32_FIND_DATA findData;
+		sprintf(filename, "%s*.dds", foldername);
+		HANDLE hFind = FindFirstFile(filename, &findData);
+		if( hFind != INVALID_HANDLE_VALUE )
+		{
+			do
+			{
+				sprintf(filename, "%s%s", foldername, findData.cFileName);
+				DeleteFile(filename);
+			} while( FindNextFile(hFind, &findData) );
+			FindClose(hFind);
+		}
+
+		sprintf(filename, "%ssource.id", foldername);
+		f = fopen(filename, "wb");
+		if( f == NULL )
+			return;
+		fwrite(&fingerprint, sizeof(fingerprint), 1, f);
+		fclose(f);
+	}
+
+	strcpy(gCompressedCacheFolder, foldername);
+}
+
+// Hashes the size and modification time of a pack file
+static uint64 PackFileFingerprint(const char *filename)
+{
+	WIN32_FILE_ATTRIBUTE_DATA attr;
+	if( !GetFileAttributesEx(filename, GetFileExInfoStandard, &attr) )
+		return 0;
+
+	return ((((uint64)attr.ftLastWriteTime.dwHighDateTime<<32) | attr.ftLastWriteTime.dwLowDateTime) * 0x100000001B3ULL) ^
+		(((uint64)attr.nFileSizeHigh<<32) | attr.nFileSizeLow);
+}
+
 /********************************************************************************************************************
  * Scans the hires folder for hires textures and creates a list with records of properties of the hires textures.
- * in case of enabled hires caching also the actual hires textures will be added to the record. Before textures will
- * be loaded, existing list of texture information will be truncated.
+ * in case of enabled hires caching also the actual hires textures will be added to the record.
+ * The result of the scan is kept in a binary index file next to the folder of the rom, which is used as long as the
+ * folder tree has not been modified since. If there is a pack file for the rom, its textures are used instead of the
+ * folder. This runs on the indexing thread, the records are put in gLoadingHiresTxtrInfos.
+ * parameter:
+ * gamename: the name of the rom
+ * return:
+ * none
+ ********************************************************************************************************************/
+static void BuildHiresTextureIndex(std::string gamename)
+{
+	char	foldername[_MAX_PATH];
+	char	indexfilename[_MAX_PATH];
+	char	packfilename[_MAX_PATH];
+	// get the path of the plugin directory
+	GetPluginDir(foldername);
+	// add the relative path to the hires folder, it does not exist? => create it
+	strcat(foldername,"hires_texture\\");
+	CheckAndCreateFolder(foldername);
+
+	// a pack file of the rom replaces its folder
+	sprintf(packfilename, "%s%s.hpk", foldername, gamename.c_str());
+	if( gHiresTxtrPack.Open(packfilename, gLoadingHiresTxtrInfos) )
+	{
+		InitCompressedCache(gamename.c_str(), PackFileFingerprint(packfilename));
+	}
+	else
+	{
+		// the index file is kept out of the folder of the rom, writing it must not change the fingerprint of the folder
+		sprintf(indexfilename, "%s%s.hidx", foldername, gamename.c_str());
+
+		// add the path to a sub-folder corresponding to the rom name
+		// HOOK IN: PACK SELECT
+		strcat(foldername,gamename.c_str());
+		strcat(foldername,"\\");
+
+		// check if there is a subfolder for this rom
+		if( PathFileExists(foldername) )
+		{
+			uint64 fingerprint = HiresTextureFolderFingerprint(foldername, true);
+
+			//If we have already scanned this pack and it didn't change, use the index file in place
+			if( !LoadHiresIndexFile(indexfilename, fingerprint, gLoadingHiresTxtrInfos) )
+			{
+				// find all hires textures and also cache them if configured to do so
+				FindAllTexturesFromFolder(foldername, gamename.c_str(), gLoadingHiresTxtrInfos, true, options.bCacheHiResTextures != FALSE);
+				if( !gHiresIndexCancel )
+					SaveHiresIndexFile(indexfilename, fingerprint, gLoadingHiresTxtrInfos);
+			}
+
+			InitCompressedCache(gamename.c_str(), fingerprint);
+		}
+	}
+
+	gHiresIndexReady.store(true, std::memory_order_release);
+}
+
+/********************************************************************************************************************
+ * Starts building the index of the hires textures of the rom in the background, the rom is started meanwhile.
+ * PublishHiresTextures makes the hires textures used once the index is complete.
  * return:
  * none
  ********************************************************************************************************************/
 
 void InitHiresTextures()
 {
-	CSimpleIniA ini;
-
 	//If we are going to load highres texture, makes sure  our highres texture infos is actually empty
-	if (options.bLoadHiResTextures && gHiresTxtrInfos.size() <= 0)
+	if (options.bLoadHiResTextures && gHiresTxtrInfos.size() <= 0 && !gHiresIndexThread.joinable())
 	{
 		// create a box for displaying the message on screen
 		RECT rect={0,100,windowSetting.uDisplayWidth,200};
@@ -657,80 +460,51 @@ void InitHiresTextures()
 		OutputText("Finding all hires textures",&rect2);
 		SetWindowText(g_GraphicsInfo.hStatusBar,"Finding all hires textures");
 
-		// Generate our cache directory filename that where after
-		char	inifilename[1024];
-		// get the path of the plugin directory
-		GetPluginDir(inifilename);
-		// add the relative path to the hires folder
-		strcat(inifilename,"hires_texture\\");
-		//Grab our proper folder name
-		strcat(inifilename, g_curRomInfo.szGameName);
-		strcat(inifilename, "\\Cache.ini");
-
-		//If we have already loaded this pack in then dont bother trying to get all the infomration again
-		if (PathFileExists(inifilename))
-		{
-			ini.LoadFile(inifilename); //Load in our cache file
-			CSimpleIniA::TNamesDepend sections; //A place to store all the sections we find
-			ini.GetAllSections(sections); // Store all our sections
-			CSimpleIniA::TNamesDepend::const_iterator i; //Define our iterator so we can look through the sections we grabbed
+		gHiresIndexReady = false;
+		gHiresIndexCancel = false;
+		gHiresIndexThread = std::thread(BuildHiresTextureIndex, std::string(g_curRomInfo.szGameName));
+	}
+}
 
-			//Define a new place to store our incoming new info
-			ExtTxtrInfo *newinfo;
+/********************************************************************************************************************
+ * Swaps in the index of the hires textures once the indexing thread has completed it. The textures which have been
+ * looked up before are checked again. Called before each display list, it only reads a flag until the index is ready.
+ * return:
+ * none
+ ********************************************************************************************************************/
+void PublishHiresTextures(void)
+{
+	if( !gHiresIndexReady.load(std::memory_order_acquire) )
+		return;
 
-			//Since where just looping through
-			for (i = sections.begin(); i != sections.end(); ++i)
-			{
-		
-				//Where creating a new newinfo everytime we loop
-				newinfo = new ExtTxtrInfo;
-
-				//Grab the information we need straight out of the ini file, this is ten times faster than loading the information out of
-				//each and every darn png, specially with the community texture pack
-				newinfo->width		= ini.GetLongValue(i->pItem,     "width", 0);
-				newinfo->height		= ini.GetLongValue(i->pItem,    "height", 0);
-				newinfo->crc32		= ini.GetLongValue(i->pItem,     "crc32", 0);
-				newinfo->pal_crc32  = ini.GetLongValue(i->pItem, "pal_crc32", 0);
-				newinfo->type		= (TextureType)ini.GetLongValue(i->pItem,	  "type", 0);
-				newinfo->bSeparatedAlpha = ini.GetBoolValue(i->pItem, "seperated-alpha", 0);
-				newinfo->foldername = _strdup((char *)ini.GetValue(i->pItem, "foldername", ""));
-				newinfo->filename   = _strdup((char *)ini.GetValue(i->pItem,    "filename", ""));
-				newinfo->filename_a   =  _strdup((char *)ini.GetValue(i->pItem,  "filename_alpha", "NULL"));
-				if(newinfo->filename_a == "NULL")
-					newinfo->filename_a = NULL;
-				uint64 crc64 = newinfo->crc32;
-				crc64 <<= 32;
-				crc64 |= newinfo->pal_crc32&0xFFFFFFFF;
-				gHiresTxtrInfos.add(crc64,*newinfo);
-			}
-		}			
-		else
-		{
-			//Than find all hires textures
-			FindAllHiResTextures();
+	gHiresIndexThread.join();
+	gHiresIndexReady = false;
 
-			//And after we have foudn them all, loopthrough them and dump them to our cache file
-			for( int i=0; i<gHiresTxtrInfos.size(); i++)
-			{
-				ini.SetLongValue(gHiresTxtrInfos[i].filename, "width",			 gHiresTxtrInfos[i].width);
-				ini.SetLongValue(gHiresTxtrInfos[i].filename, "height",			 gHiresTxtrInfos[i].height);
-				ini.SetLongValue(gHiresTxtrInfos[i].filename, "crc32",			 gHiresTxtrInfos[i].crc32);
-				ini.SetLongValue(gHiresTxtrInfos[i].filename, "pal_crc32",		 gHiresTxtrInfos[i].pal_crc32);
-				ini.SetLongValue(gHiresTxtrInfos[i].filename, "type",			 gHiresTxtrInfos[i].type);
-				ini.SetBoolValue(gHiresTxtrInfos[i].filename, "seperated-alpha", gHiresTxtrInfos[i].bSeparatedAlpha);
-				ini.SetValue(gHiresTxtrInfos[i].filename,     "filename",		 gHiresTxtrInfos[i].filename);
-				ini.SetValue(gHiresTxtrInfos[i].filename,	  "filename_alpha",	 gHiresTxtrInfos[i].filename_a);
-				ini.SetValue(gHiresTxtrInfos[i].filename,	  "foldername",		 gHiresTxtrInfos[i].foldername);
-			}
-			//Save our cache file
-			ini.SaveFile(inifilename);
-		}
-	}
+	gHiresTxtrInfos.swap(gLoadingHiresTxtrInfos);
+	gLoadingHiresTxtrInfos.clear();
+
+	UpdateHiresStreaming();
+	gTextureManager.RecheckHiresForAllTextures();
+}
+
+/********************************************************************************************************************
+ * Starts the streaming of hires textures if it is enabled and the textures are not preloaded, stops it otherwise.
+ ********************************************************************************************************************/
+void UpdateHiresStreaming(void)
+{
+	bool bStream = options.bLoadHiResTextures && options.bStreamHiResTextures && !options.bCacheHiResTextures && gHiresTxtrInfos.size() > 0;
+
+	if( bStream && !gHiresTxtrStreamer.IsRunning() )
+		gHiresTxtrStreamer.Start(&gHiresTxtrInfos, (size_t)options.hiresStreamBudget<<20);
+	else if( !bStream && gHiresTxtrStreamer.IsRunning() )
+		gHiresTxtrStreamer.Stop();
 }
 
 // load all hires textures into cache
 void InitHiresCache(void)
 {
+	UpdateHiresStreaming();
+
 	//We can only create the cache if theres actually textures in its list
 	if (options.bCacheHiResTextures && gHiresTxtrInfos.size() > 0)
 	{
@@ -743,7 +517,8 @@ void InitHiresCache(void)
 			OutputText(generalText,&rect);
 
 			//Ok start caching!
-			CacheHiresTexture(gHiresTxtrInfos[i]);
+			if( !gHiresTxtrInfos[i].pPreloadedTexture )
+				PreloadHiresTexture(gHiresTxtrInfos[i], options.bCompressHiResCache);
 		}
 	}
 }
@@ -755,10 +530,11 @@ void ClearHiresCache(void)
 	{
 		for( int i=0; i<gHiresTxtrInfos.size(); i++)
 		{
-			SAFE_DELETE(gHiresTxtrInfos[i].pHiresTextureRGB);
-			SAFE_DELETE(gHiresTxtrInfos[i].pHiresTextureAlpha);
+			FreePreloadedHiresTexture(gHiresTxtrInfos[i]);
 		}
 	}
+
+	UpdateHiresStreaming();
 }
 
 /********************************************************************************************************************
@@ -839,7 +615,7 @@ int FindScaleFactor(ExtTxtrInfo &info, TxtrCacheEntry &entry)
  *         palette crc or a RGBA_PNG_FOR_ALL_CI texture has been found
  * return value: the index in "infos" where the corresponding hires texture has been found
  ********************************************************************************************************************/
-int CheckTextureInfos( CSortedList<uint64,ExtTxtrInfo> &infos, TxtrCacheEntry &entry)
+int CheckTextureInfos( CHiresTxtrIndex &infos, TxtrCacheEntry &entry)
 {
 	// determine if texture is a color-indexed (CI) texture
 	bool bCI = (gRDP.otherMode.text_tlut>=2 || entry.ti.Format == TXT_FMT_CI || entry.ti.Format == TXT_FMT_RGBA) && entry.ti.Size <= TXT_SIZE_8b;
@@ -854,22 +630,13 @@ int CheckTextureInfos( CSortedList<uint64,ExtTxtrInfo> &infos, TxtrCacheEntry &e
 	// crc64b = <DRAM-CRC-8bytes><palette-crc-6bytes (lowest 2 bytes are removed)><format-1byte><size-1byte>
 	crc64b |= (entry.dwPalCRC&0xFFFFFFFF);
 
-	// infos is the list containing the references to the detected external textures
-	// get the number of items contained in this list
-	int index=-1;
-
+	// infos is the index containing the references to the detected external textures. Several textures may share the
+	// same CRCs, in that case the one made for the format and size of the texture in the cache is picked
 	// If this is a color index texture, search for it
 	if( bCI )	
-		index = infos.find(crc64b);	// For CI or PNG with pal CRC
-	else
-		index = infos.find(crc64a); // For CI without pal CRC, and for RGBA_PNG_FOR_ALL_CI
-
-	// ok, we have a valid index, lets roll with it
-	if( index >= 0 )	
-		return index;
-	// no luck at all. there is no valid replacement
+		return infos.find(crc64b, entry.ti.Format, entry.ti.Size);	// For CI or PNG with pal CRC
 	else
-		return -1;
+		return infos.find(crc64a, entry.ti.Format, entry.ti.Size); // For CI without pal CRC, and for RGBA_PNG_FOR_ALL_CI
 }
 
 void DumpCachedTexture( TxtrCacheEntry &entry )
@@ -881,29 +648,31 @@ void DumpCachedTexture( TxtrCacheEntry &entry )
 		if( CheckTextureInfos(gHiresTxtrInfos, entry) >= 0 )
 			return;		// This texture already exists as a hires version, thus don't redump it.
 
-		char filename[256];
-		char gamefolder[256];
+		// the files are written by the dumper thread
+		if( !gTextureDumper.IsRunning() )
+		{
+			char gamefolder[256];
+			GetPluginDir(gamefolder);
+			strcat(gamefolder,"texture_dump\\");
+			strcat(gamefolder,g_curRomInfo.szGameName);
+			strcat(gamefolder,"\\");
+			gTextureDumper.Start(gamefolder);
+		}
 
-		GetPluginDir(gamefolder);
-		strcat(gamefolder,"texture_dump\\");
-		strcat(gamefolder,g_curRomInfo.szGameName);
-		strcat(gamefolder,"\\");
+		char filename[256];
 
 		//If the texture requires the extra pal CRC, then dump it as so
 		if( (gRDP.otherMode.text_tlut>=2 || entry.ti.Format == TXT_FMT_CI || entry.ti.Format == TXT_FMT_RGBA) && entry.ti.Size <= TXT_SIZE_8b )
 		{
-			sprintf(filename, "%sci_by_png\\%s#%08X#%d#%d#%08X_ciByRGBA.png", gamefolder, g_curRomInfo.szGameName, entry.dwCRC, entry.ti.Format, entry.ti.Size,entry.dwPalCRC);
-			//Only dump if the file doesnt already exist
-			if (!PathFileExists(filename))
-				CRender::g_pRender->SaveTextureToFile(*pSrcTexture, filename, entry.ti.WidthToLoad, entry.ti.HeightToLoad);
+			sprintf(filename, "ci_by_png\\%s#%08X#%d#%d#%08X_ciByRGBA.png", g_curRomInfo.szGameName, entry.dwCRC, entry.ti.Format, entry.ti.Size,entry.dwPalCRC);
 		}
 		else
 		{
-			sprintf(filename, "%spng_all\\%s#%08X#%d#%d_all.png", gamefolder, g_curRomInfo.szGameName, entry.dwCRC, entry.ti.Format, entry.ti.Size);
-			//Only dump if the file doesnt already exist
-			if (!PathFileExists(filename))
-				CRender::g_pRender->SaveTextureToFile(*pSrcTexture, filename, entry.ti.WidthToLoad, entry.ti.HeightToLoad);
+			sprintf(filename, "png_all\\%s#%08X#%d#%d_all.png", g_curRomInfo.szGameName, entry.dwCRC, entry.ti.Format, entry.ti.Size);
 		}
+
+		// the dumper skips the textures already dumped
+		gTextureDumper.Dump(filename, *pSrcTexture, entry.ti.WidthToLoad, entry.ti.HeightToLoad);
 	}
 }
 
@@ -1032,19 +801,55 @@ bool LoadRGBBufferFromPNGFile(char *filename, unsigned char **pbuf, int &width,
 //Solution: Implement automatic DXT5 compression of textures and dump them to a .dds file. DDS has the added benefit.
 //That it is GPU ready and doesnt require much processing power, speeding up the process.
 //DXT compression will also make storing textures into memory more feasible.
+//With CompressEnhancedTextures the surfaces are compressed to DXT1/DXT5 and kept in texture_cache\<GameName>\.
+
+/********************************************************************************************************************
+ * Gets the name of the file keeping the compressed hires texture of a texture. Besides the hires texture, the name
+ * holds everything of the original texture the layout of the surface depends on.
+ ********************************************************************************************************************/
+static void GetCompressedCacheFilename(ExtTxtrInfo &hires, TxtrCacheEntry &entry, char *filename)
+{
+	sprintf(filename, "%s%08X#%08X#%d#%d#%d#%dx%d#%dx%d#%d#%d%s.dds", gCompressedCacheFolder, hires.crc32, hires.pal_crc32,
+		hires.fmt, hires.siz, entry.ti.Format, entry.ti.WidthToLoad, entry.ti.HeightToLoad, entry.ti.WidthToCreate,
+		entry.ti.HeightToCreate, entry.ti.maskS, entry.ti.maskT, options.bMipMaps ? "_mip" : "");
+}
+
+/********************************************************************************************************************
+ * Loads the compressed hires texture of a texture from the cache folder
+ * parameter:
+ * entry: the original texture in the texture cache
+ * hires: the record of the hires texture
+ * filename: the cache file
+ * return:
+ * return value: true if the enhanced texture of entry has been created
+ ********************************************************************************************************************/
+static bool LoadCompressedHiresTexture(TxtrCacheEntry &entry, ExtTxtrInfo hires, const char *filename)
+{
+	BCTexture data;
+	if( !LoadBCTextureDDS(filename, data) )
+		return false;
+
+	int scale = 1 << FindScaleFactor(hires, entry);
+	CTexture *pTexture = new CTexture(entry.ti.WidthToCreate*scale, entry.ti.HeightToCreate*scale, data);
+	if( pTexture->GetTexture() == NULL )
+	{
+		delete pTexture;
+		return false;
+	}
+
+	SAFE_DELETE(entry.pEnhancedTexture);
+	entry.pEnhancedTexture = pTexture;
+	entry.pEnhancedTexture->m_bIsEnhancedTexture = true;
+	entry.dwEnhancementFlag = TEXTURE_EXTERNAL;
+	return true;
+}
+
 void LoadHiresTexture( TxtrCacheEntry &entry )
 {
 	// check if the external texture has already been checked
 	if( entry.bExternalTxtrChecked )
 		return;
 
-	// there is already an enhanced texture (e.g. a filtered one)
-	if( entry.pEnhancedTexture )
-	{
-		// delete it from memory before loading the external one
-		SAFE_DELETE(entry.pEnhancedTexture);
-	}
-
 	// search the index of the appropriate hires replacement texture
 	// in the list containing the infos of the external textures
 	int idx = CheckTextureInfos(gHiresTxtrInfos, entry);
@@ -1054,123 +859,169 @@ void LoadHiresTexture( TxtrCacheEntry &entry )
 		entry.bExternalTxtrChecked = true;
 		return;
 	}
-	 
-	// if caching has been disabled, the texture data
-	// has to be loaded from file system first
-	if(!options.bCacheHiResTextures)
-		CacheHiresTexture(gHiresTxtrInfos[idx]);
 
-	if( !gHiresTxtrInfos[idx].pHiresTextureRGB )
+	// a compressed copy made before replaces the decoding
+	char cachefilename[_MAX_PATH];
+	cachefilename[0] = 0;
+	if( options.bCompressEnhancedTextures && gCompressedCacheFolder[0] )
+	{
+		GetCompressedCacheFilename(gHiresTxtrInfos[idx], entry, cachefilename);
+		if( LoadCompressedHiresTexture(entry, gHiresTxtrInfos[idx], cachefilename) )
+			return;
+	}
+
+	// work on a copy of the record, so that the size of the area copied for this entry does not change the record
+	ExtTxtrInfo hires = gHiresTxtrInfos[idx];
+	// keeps a streamed texture alive until it has been copied
+	HiresDecodedTexturePtr decoded;
+	bool bPreloaded = false;
+
+	if( options.bCacheHiResTextures )
+	{
+		// the texture data is preloaded by InitHiresCache, load it now if it has not been
+		if( !gHiresTxtrInfos[idx].pPreloadedTexture )
+			PreloadHiresTexture(gHiresTxtrInfos[idx], options.bCompressHiResCache);
+		hires = gHiresTxtrInfos[idx];
+
+		if( !hires.pPreloadedTexture )
+		{
+			TRACE1("RGBBuffer creation failed for file '%s'.", hires.filename);
+			entry.bExternalTxtrChecked = true;
+			return;
+		}
+		bPreloaded = true;
+	}
+	else if( gHiresTxtrStreamer.IsRunning() )
+	{
+		// the texture is decoded by the streaming threads, the original texture is used until it is ready
+		decoded = gHiresTxtrStreamer.Request(idx);
+		if( !decoded )
+			return;
+
+		hires.width = decoded->width;
+		hires.height = decoded->height;
+		hires.pHiresTextureRGB = decoded->pHiresTextureRGB;
+		hires.pHiresTextureAlpha = decoded->pHiresTextureAlpha;
+	}
+	else
 	{
-		TRACE1("RGBBuffer creation failed for file '%s'.", gHiresTxtrInfos[idx].filename);
+		// the texture data has to be loaded from file system first
+		CacheHiresTexture(hires);
+	}
+
+	if( !bPreloaded && !hires.pHiresTextureRGB )
+	{
+		TRACE1("RGBBuffer creation failed for file '%s'.", hires.filename);
+		entry.bExternalTxtrChecked = true;
 		return;
 	}
 	// check if the alpha channel has been loaded if the texture has a separate alpha channel
-	else if( gHiresTxtrInfos[idx].bSeparatedAlpha && !gHiresTxtrInfos[idx].pHiresTextureAlpha )
+	else if( !bPreloaded && hires.bSeparatedAlpha && !hires.pHiresTextureAlpha )
 	{
-		TRACE1("Alpha buffer creation failed for file '%s'.", gHiresTxtrInfos[idx].filename_a);
+		TRACE1("Alpha buffer creation failed for file '%s'.", hires.filename_a);
+		entry.bExternalTxtrChecked = true;
+		if( !decoded )
+			SAFE_DELETE(hires.pHiresTextureRGB);
 		return;
 	}
 
-	int scale = 1 << FindScaleFactor(gHiresTxtrInfos[idx], entry);
+	// there is already an enhanced texture (e.g. a filtered one)
+	if( entry.pEnhancedTexture )
+	{
+		// delete it from memory before loading the external one
+		SAFE_DELETE(entry.pEnhancedTexture);
+	}
+
+	int scale = 1 << FindScaleFactor(hires, entry);
 
-	int input_height_shift = gHiresTxtrInfos[idx].height - entry.ti.HeightToLoad * scale;
-	int input_pitch_a = gHiresTxtrInfos[idx].width;
-	int input_pitch_rgb = gHiresTxtrInfos[idx].width;
-	gHiresTxtrInfos[idx].width = entry.ti.WidthToLoad * scale;
-	gHiresTxtrInfos[idx].height = entry.ti.HeightToLoad * scale;
+	int input_height_shift = hires.height - entry.ti.HeightToLoad * scale;
+	int input_pitch_a = hires.width;
+	int input_pitch_rgb = hires.width;
+	hires.width = entry.ti.WidthToLoad * scale;
+	hires.height = entry.ti.HeightToLoad * scale;
 
 	entry.pEnhancedTexture = new CTexture(entry.ti.WidthToCreate*scale, entry.ti.HeightToCreate*scale);
 	DrawInfo info;
 
 	if( entry.pEnhancedTexture && entry.pEnhancedTexture->StartUpdate(&info) )
 	{
-		if( gHiresTxtrInfos[idx].type == RGB_PNG )
+		// the surface is filled and expanded over its edges in one pass
+		HiresEdgeExpansion edges;
+		edges.mirrorWidth = entry.ti.WidthToCreate/entry.ti.WidthToLoad == 2 ? hires.width*2 : 0;
+		edges.maskS = entry.ti.maskS+hires.scaleShift;
+		edges.mirrorHeight = entry.ti.HeightToCreate/entry.ti.HeightToLoad == 2 ? hires.height*2 : 0;
+		edges.maskT = entry.ti.maskT+hires.scaleShift;
+		edges.clampWidth = entry.ti.WidthToCreate*scale < entry.pEnhancedTexture->m_dwCreatedTextureWidth ? entry.pEnhancedTexture->m_dwCreatedTextureWidth : 0;
+		edges.clampHeight = entry.ti.HeightToCreate*scale < entry.pEnhancedTexture->m_dwCreatedTextureHeight ? entry.pEnhancedTexture->m_dwCreatedTextureHeight : 0;
+		edges.surfaceWidth = entry.pEnhancedTexture->m_dwCreatedTextureWidth;
+
+		if( bPreloaded )
 		{
-			input_pitch_rgb *= 3;
-			input_pitch_a *= 3;
+			// the preloaded rows are in the order of the surface, RGB textures replacing intensity textures take
+			// their alpha from the intensity
+			bool bAlphaFromIntensity = hires.type == RGB_PNG && !hires.bSeparatedAlpha && entry.ti.Format == TXT_FMT_I;
+			UnpackPreloadedHiresTexture(gHiresTxtrInfos[idx], info, hires.width, hires.height, bAlphaFromIntensity);
+			ExpandHiresTextureEdges(info, hires.width, hires.height, edges);
+		}
+		else
+		{
+			// the decoded rows are bottom-up, the last row copied is the top row of the surface
+			HiresUploadSource src;
+			src.pAlpha = NULL;
+			src.alphaPitch = 0;
 
-			// Update the texture by using the buffer
-			for( uint32 i=0; i<gHiresTxtrInfos[idx].height; i++)
+			if( hires.type == RGB_PNG )
 			{
-				unsigned char *pRGB = gHiresTxtrInfos[idx].pHiresTextureRGB + (input_height_shift + i) * input_pitch_rgb;
-				unsigned char *pA = gHiresTxtrInfos[idx].pHiresTextureAlpha + (input_height_shift + i) * input_pitch_a;
-				unsigned char* pdst = (unsigned char*)info.lpSurface + (gHiresTxtrInfos[idx].height - i - 1)*info.lPitch;
+				input_pitch_rgb *= 3;
+				input_pitch_a *= 3;
+				src.pPixels = hires.pHiresTextureRGB + (input_height_shift + hires.height - 1) * input_pitch_rgb;
+				src.pitch = -input_pitch_rgb;
 
-				for( unsigned int j=0; j<gHiresTxtrInfos[idx].width; j++)
+				if( hires.bSeparatedAlpha )
 				{
-					*pdst++ = *pRGB++;		// R
-					*pdst++ = *pRGB++;		// G
-					*pdst++ = *pRGB++;		// B
-
-					if( gHiresTxtrInfos[idx].bSeparatedAlpha )
-					{
-						*pdst++ = *pA;
-						pA += 3;
-					}
-					else if( entry.ti.Format == TXT_FMT_I )
-					{
-						*pdst++ = *(pdst-1);
-					}
-					else
-					{
-						*pdst++ = 0xFF;
-					}
+					src.format = HIRES_ROW_BGR_ALPHA;
+					src.pAlpha = hires.pHiresTextureAlpha + (input_height_shift + hires.height - 1) * input_pitch_a;
+					src.alphaPitch = -input_pitch_a;
 				}
+				else if( entry.ti.Format == TXT_FMT_I )
+					src.format = HIRES_ROW_BGR_INTENSITY;
+				else
+					src.format = HIRES_ROW_BGR;
 			}
-		}
-		else
-		{
-			// Update the texture by using the buffer
-			input_pitch_rgb *= 4;
-			for( int i=gHiresTxtrInfos[idx].height-1; i>=0; i--)
+			else
 			{
-				uint32 *pRGB = (uint32*)(gHiresTxtrInfos[idx].pHiresTextureRGB + (input_height_shift + i) * input_pitch_rgb);
-				uint32 *pdst = (uint32*)((unsigned char*)info.lpSurface + (gHiresTxtrInfos[idx].height - i - 1)*info.lPitch);
-				for( unsigned int j=0; j<gHiresTxtrInfos[idx].width; j++)
-				{
-					*pdst++ = *pRGB++;		// RGBA
-				}
+				input_pitch_rgb *= 4;
+				src.format = HIRES_ROW_BGRA;
+				src.pPixels = hires.pHiresTextureRGB + (input_height_shift + hires.height - 1) * input_pitch_rgb;
+				src.pitch = -input_pitch_rgb;
 			}
-		}
-
-		if( entry.ti.WidthToCreate/entry.ti.WidthToLoad == 2 )
-		{
-			gTextureManager.Mirror((uint32*)info.lpSurface, gHiresTxtrInfos[idx].width, entry.ti.maskS+gHiresTxtrInfos[idx].scaleShift, gHiresTxtrInfos[idx].width*2, gHiresTxtrInfos[idx].width*2, gHiresTxtrInfos[idx].height, S_FLAG);
-		}
 
-		if( entry.ti.HeightToCreate/entry.ti.HeightToLoad == 2 )
-		{
-			gTextureManager.Mirror((uint32*)info.lpSurface, gHiresTxtrInfos[idx].height, entry.ti.maskT+gHiresTxtrInfos[idx].scaleShift, gHiresTxtrInfos[idx].height*2, entry.pEnhancedTexture->m_dwCreatedTextureWidth, gHiresTxtrInfos[idx].height, T_FLAG);
+			UploadHiresTexture(info, src, hires.width, hires.height, edges);
 		}
 
-		if( entry.ti.WidthToCreate*scale < entry.pEnhancedTexture->m_dwCreatedTextureWidth )
-		{
-			// Clamp
-			gTextureManager.Clamp((uint32*)info.lpSurface, gHiresTxtrInfos[idx].width, entry.pEnhancedTexture->m_dwCreatedTextureWidth, entry.pEnhancedTexture->m_dwCreatedTextureWidth, gHiresTxtrInfos[idx].height, S_FLAG);
-		}
-		if( entry.ti.HeightToCreate*scale < entry.pEnhancedTexture->m_dwCreatedTextureHeight )
-		{
-			// Clamp
-			gTextureManager.Clamp((uint32*)info.lpSurface, gHiresTxtrInfos[idx].height, entry.pEnhancedTexture->m_dwCreatedTextureHeight, entry.pEnhancedTexture->m_dwCreatedTextureWidth, gHiresTxtrInfos[idx].height, T_FLAG);
-		}
 		entry.pEnhancedTexture->EndUpdate(&info);
 
 
 		entry.pEnhancedTexture->m_bIsEnhancedTexture = true;
 		entry.dwEnhancementFlag = TEXTURE_EXTERNAL;
+
+		if( options.bCompressEnhancedTextures )
+		{
+			BCTexture data;
+			if( entry.pEnhancedTexture->Compress(cachefilename[0] ? &data : NULL) && cachefilename[0] )
+				SaveBCTextureDDS(cachefilename, data);
+		}
 	}
 	else
 	{
 		TRACE0("Cannot create a new texture");
 	}
 
-	// if caching has been disabled, remove
-	// cached texture from memory
-	if(!options.bCacheHiResTextures)
+	// if the texture has been loaded from file system for this entry only, remove it from memory
+	if( !bPreloaded && !decoded )
 	{
-		SAFE_DELETE(gHiresTxtrInfos[idx].pHiresTextureRGB);
-		SAFE_DELETE(gHiresTxtrInfos[idx].pHiresTextureAlpha);
+		SAFE_DELETE(hires.pHiresTextureRGB);
+		SAFE_DELETE(hires.pHiresTextureAlpha);
 	}
 
 }
@@ -1184,6 +1035,12 @@ void LoadHiresTexture( TxtrCacheEntry &entry )
  ********************************************************************************************************************/
 void CacheHiresTexture( ExtTxtrInfo &ExtTexInfo )
 {
+	// the texture comes from a pack file, it is stored decoded
+	if( ExtTexInfo.packRecord >= 0 )
+	{
+		gHiresTxtrPack.LoadTexture(ExtTexInfo);
+		return;
+	}
 
 	// the buffer for the rgb texture file name
 	char filename_rgb[256];
@@ -29,10 +29,12 @@ void hq2x(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int wi
 void hq2xS(uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height);
 
 void InitHiresTextures();
+void PublishHiresTextures(void);
 void CloseHiresTextures(void);
 
 void InitHiresCache(void);
 void ClearHiresCache(void);
+void UpdateHiresStreaming(void);
 
 void CreateDumpFolders();
 
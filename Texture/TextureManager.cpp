@@ -17,7 +17,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 */
 
-#include "..\stdafx.h"
+#include "../stdafx.h"
 
 CTextureManager gTextureManager;
 
@@ -165,13 +165,10 @@ void CTextureManager::RecheckHiresForAllTextures()
 	//Loop through our list but only at the amount we allow at a maximum
 	for (uint32 i = 0; i < m_numOfCachedTxtrList; i++)
 	{
-		//While we actually have an entry that exists
-		while (m_pCacheTxtrList[i])
+		// walk the entries without unlinking them, they stay in the cache
+		for (TxtrCacheEntry *pEntry = m_pCacheTxtrList[i]; pEntry != NULL; pEntry = pEntry->pNext)
 		{
-			TxtrCacheEntry *pTVictim = m_pCacheTxtrList[i];
-			m_pCacheTxtrList[i] = pTVictim->pNext;
-			pTVictim->bExternalTxtrChecked = false;
-
+			pEntry->bExternalTxtrChecked = false;
 		}
 	}
 }
@@ -327,7 +324,7 @@ TxtrCacheEntry * CTextureManager::CreateNewCacheEntry(uint32 dwAddr, uint32 dwWi
 		pEntry->pTexture = new CTexture(dwWidth, dwHeight);
 		
 		//Uhhh oh if any of this is NULL, we have a problem
-		if (pEntry->pTexture == NULL || pEntry->pTexture->GetTexture() == NULL)
+		if (pEntry->pTexture == NULL || !pEntry->pTexture->IsCreated())
 			TRACE2("Warning, unable to create %d x %d texture!", dwWidth, dwHeight);
 	}
 	
@@ -0,0 +1,1031 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+/*
+	Offline display list analyzer
+
+	Walks the display lists of the graphics task found in a memory dump, the way DLParser_Process runs them, without
+	transforming or drawing anything, and reports:
+
+	- the command histogram, with the names of the handlers of the plugin
+	- the vertices loaded, the triangle references to them and the vertices loaded but never used
+	- the state commands, how many change the state and how many are redundant
+	- the texture loads, and the images loaded more than once
+	- the commands identical to the command before them
+	- the cost of each display list called, in commands, vertices, triangles and texture loads
+
+	Usage: DListAnalyzer [options] rdram.bin task.bin
+
+	rdram.bin is the RDRAM of the emulator, 4 or 8 MB. task.bin is the DMEM, or the SP memory, with the OSTask at
+	0xFC0, or the 64 bytes of the OSTask alone. Both are in the byte order of the plugin memory, 32 bit words in the
+	order of the host, unless the type of the task says they are byte swapped, or -s is given.
+
+	The command layouts come from Parser/UcodeDefs.h, the handler tables from Parser/UcodeTables.h, and the microcode
+	is detected by Parser/MicrocodeDetect.h, all shared with the plugin. It builds with the Makefile next to this file,
+	or with "cl /EHsc DListAnalyzer.cpp".
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+typedef uint16_t	uint16;
+typedef uint32_t	uint32;
+typedef uint64_t	uint64;
+typedef uint8_t		uint8;
+
+typedef int8_t		s8;
+typedef int16_t		s16;
+typedef int32_t		s32;
+typedef uint32_t	u32;
+typedef uint8_t		u8;
+
+#ifndef _MSC_VER
+#define __int64		long long
+#endif
+
+#include "../../Parser/UcodeDefs.h"
+#include "../../Parser/MicrocodeDetect.h"
+
+#define DLA_MAX_STACK_SIZE		32			// MAX_DL_STACK_SIZE of the parser
+#define DLA_MAX_COMMANDS		1000000		// MAX_DL_COUNT of the parser
+#define DLA_MAX_VERTS			80
+#define DLA_TASK_OFFSET			0xFC0		// of the OSTask in DMEM
+#define DLA_GFX_TASK			1
+
+#define RSP_MOVE_WORD_SEGMENT	0x06
+#define RSP_DLIST_PUSH			0x00
+
+static const char *gGBINames[] =
+{
+	"GBI_0", "GBI_1", "GBI_2", "GBI_1_S2DEX", "GBI_2_S2DEX", "GBI_WR", "GBI_DKR", "GBI_LL", "GBI_SE", "GBI_GE", "GBI_CONKER", "GBI_PD"
+};
+
+// What the walk does with a command
+enum AnalyzerOp
+{
+	OP_OTHER,
+	OP_NOTHING,			// RSP_RDP_Nothing, ends the list
+	OP_MTX,
+	OP_POPMTX,
+	OP_MOVEMEM,
+	OP_MOVEWORD,
+	OP_VTX,
+	OP_MODIFYVTX,
+	OP_TRI1,
+	OP_TRI2,
+	OP_TRI4,
+	OP_LINE3D,
+	OP_CULLDL,
+	OP_BRANCHZ,
+	OP_DL,
+	OP_DLCOUNT,
+	OP_ENDDL,
+	OP_LOADUCODE,
+	OP_RDPHALF1,
+	OP_GEOMETRYMODE,
+	OP_OTHERMODE_L,
+	OP_OTHERMODE_H,
+	OP_RDP_OTHERMODE,
+	OP_TEXTURE,
+	OP_TEXRECT,
+	OP_FILLRECT,
+	OP_SYNC,
+	OP_SCISSOR,
+	OP_SETTIMG,
+	OP_LOADBLOCK,
+	OP_LOADTILE,
+	OP_LOADTLUT,
+	OP_SETTILE,
+	OP_SETTILESIZE,
+	OP_SETCOMBINE,
+	OP_PRIMCOLOR,
+	OP_ENVCOLOR,
+	OP_FOGCOLOR,
+	OP_BLENDCOLOR,
+	OP_FILLCOLOR,
+};
+
+struct OpcodeInfo
+{
+	const char	*name;
+	AnalyzerOp	op;
+	u32			layout;			// GBI_0, GBI_1 or GBI_2, the command layout the handler decodes
+};
+
+// The state commands, counted in the state report
+enum StateKind
+{
+	STATE_GEOMETRYMODE,
+	STATE_OTHERMODE,
+	STATE_TEXTURE,
+	STATE_SCISSOR,
+	STATE_SETTILE,
+	STATE_SETTILESIZE,
+	STATE_COMBINE,
+	STATE_PRIMCOLOR,
+	STATE_ENVCOLOR,
+	STATE_FOGCOLOR,
+	STATE_BLENDCOLOR,
+	STATE_FILLCOLOR,
+	NUM_STATE_KINDS
+};
+
+static const char *gStateNames[NUM_STATE_KINDS] =
+{
+	"GeometryMode", "SetOtherMode", "Texture", "SetScissor", "SetTile", "SetTileSize",
+	"SetCombine", "SetPrimColor", "SetEnvColor", "SetFogColor", "SetBlendColor", "SetFillColor"
+};
+
+struct StateCounters
+{
+	uint32	numCommands;
+	uint32	numRedundant;		// which leave the state as it was
+};
+
+struct DListCost
+{
+	uint32	numCalls;
+	uint64	numCommands;		// run in the list itself
+	uint64	numInclusive;		// run in the list and in the lists it calls
+	uint64	numVertices;
+	uint64	numTriangles;
+	uint64	numTextureLoads;
+};
+
+struct TextureImage
+{
+	uint32	numLoads;
+	uint32	numReloads;			// of the same image with the same load command
+};
+
+struct StackEntry
+{
+	uint32	pc;
+	uint32	address;			// of the list, for the costs
+};
+
+static OpcodeInfo	gOpcodes[256];
+static u32			gVertexStride = 10;
+
+static std::vector<uint32> gRDRAM;
+static uint32		gRamSize = 0;
+static bool			gTrace = false;
+static uint32		gTopLists = 20;
+
+//////////////////////////////////////////////////////////
+//                  Microcode tables                    //
+//////////////////////////////////////////////////////////
+
+// gNormalInstruction of Parser/ucode.h, with the names of the handlers
+static const char *gNormalInstructionName[MAX_UCODE_TABLE][256] =
+{
+#define UCODE(name)	#name
+#include "../../Parser/UcodeTables.h"
+#undef UCODE
+};
+
+// What the walk does with each handler, the handlers not here are only counted
+static const struct { const char *name; AnalyzerOp op; } gHandlerOps[] =
+{
+	{ "RSP_RDP_Nothing",			OP_NOTHING			},
+	{ "RSP_GBI1_Mtx",				OP_MTX				},
+	{ "RSP_GBI2_Mtx",				OP_MTX				},
+	{ "RSP_GBI1_PopMtx",			OP_POPMTX			},
+	{ "RSP_GBI2_PopMtx",			OP_POPMTX			},
+	{ "RSP_GBI1_MoveMem",			OP_MOVEMEM			},
+	{ "RSP_GBI2_MoveMem",			OP_MOVEMEM			},
+	{ "RSP_GBI1_MoveWord",			OP_MOVEWORD			},
+	{ "RSP_GBI2_MoveWord",			OP_MOVEWORD			},
+	{ "RSP_GBI0_Vtx",				OP_VTX				},
+	{ "RSP_GBI1_Vtx",				OP_VTX				},
+	{ "RSP_GBI2_Vtx",				OP_VTX				},
+	{ "RSP_GBI1_ModifyVtx",			OP_MODIFYVTX		},
+	{ "RSP_GBI1_Tri1",				OP_TRI1				},
+	{ "RSP_GBI2_Tri1",				OP_TRI1				},
+	{ "RSP_GBI1_Tri2",				OP_TRI2				},
+	{ "RSP_GBI2_Tri2",				OP_TRI2				},
+	{ "RSP_GBI0_Tri4",				OP_TRI4				},
+	{ "RSP_GBI1_Line3D",			OP_LINE3D			},
+	{ "RSP_GBI2_Line3D",			OP_LINE3D			},
+	{ "RSP_GBI1_CullDL",			OP_CULLDL			},
+	{ "RSP_GBI1_BranchZ",			OP_BRANCHZ			},
+	{ "RSP_GBI1_DL",				OP_DL				},
+	{ "RSP_GBI2_DL_Count",			OP_DLCOUNT			},
+	{ "RSP_GBI1_EndDL",				OP_ENDDL			},
+	{ "RSP_GBI1_LoadUCode",			OP_LOADUCODE		},
+	{ "RSP_GBI1_RDPHalf_1",			OP_RDPHALF1			},
+	{ "RSP_GBI1_GeometryMode",		OP_GEOMETRYMODE		},
+	{ "RSP_GBI2_GeometryMode",		OP_GEOMETRYMODE		},
+	{ "RSP_GBI1_SetOtherModeL",		OP_OTHERMODE_L		},
+	{ "RSP_GBI2_SetOtherModeL",		OP_OTHERMODE_L		},
+	{ "RSP_GBI1_SetOtherModeH",		OP_OTHERMODE_H		},
+	{ "RSP_GBI2_SetOtherModeH",		OP_OTHERMODE_H		},
+	{ "RSP_GBI1_Texture",			OP_TEXTURE			},
+	{ "RSP_GBI2_Texture",			OP_TEXTURE			},
+	{ "DLParser_RDPSetOtherMode",	OP_RDP_OTHERMODE	},
+	{ "DLParser_TexRect",			OP_TEXRECT			},
+	{ "DLParser_TexRectFlip",		OP_TEXRECT			},
+	{ "DLParser_FillRect",			OP_FILLRECT			},
+	{ "DLParser_RDPLoadSync",		OP_SYNC				},
+	{ "DLParser_RDPPipeSync",		OP_SYNC				},
+	{ "DLParser_RDPTileSync",		OP_SYNC				},
+	{ "DLParser_RDPFullSync",		OP_SYNC				},
+	{ "DLParser_SetScissor",		OP_SCISSOR			},
+	{ "DLParser_SetTImg",			OP_SETTIMG			},
+	{ "DLParser_LoadBlock",			OP_LOADBLOCK		},
+	{ "DLParser_LoadTile",			OP_LOADTILE			},
+	{ "DLParser_LoadTLut",			OP_LOADTLUT			},
+	{ "DLParser_SetTile",			OP_SETTILE			},
+	{ "DLParser_SetTileSize",		OP_SETTILESIZE		},
+	{ "DLParser_SetCombine",		OP_SETCOMBINE		},
+	{ "DLParser_SetPrimColor",		OP_PRIMCOLOR		},
+	{ "DLParser_SetEnvColor",		OP_ENVCOLOR			},
+	{ "DLParser_SetFogColor",		OP_FOGCOLOR			},
+	{ "DLParser_SetBlendColor",		OP_BLENDCOLOR		},
+	{ "DLParser_SetFillColor",		OP_FILLCOLOR		},
+};
+
+static void InitOpcodes(u32 ucode)
+{
+	for( int cmd=0; cmd<256; cmd++ )
+	{
+		const char *name = gNormalInstructionName[ucode][cmd];
+		gOpcodes[cmd].name = name;
+		gOpcodes[cmd].op = OP_OTHER;
+		for( size_t i=0; i<sizeof(gHandlerOps)/sizeof(gHandlerOps[0]); i++ )
+		{
+			if( strcmp(name, gHandlerOps[i].name) == 0 )
+			{
+				gOpcodes[cmd].op = gHandlerOps[i].op;
+				break;
+			}
+		}
+
+		// The handlers named after a GBI decode its layout, as the F3DEX 1 handlers left in the F3DEX 2 tables do
+		if( strncmp(name, "RSP_GBI0_", 9) == 0 )
+			gOpcodes[cmd].layout = GBI_0;
+		else if( strncmp(name, "RSP_GBI2_", 9) == 0 )
+			gOpcodes[cmd].layout = GBI_2;
+		else
+			gOpcodes[cmd].layout = GBI_1;
+	}
+}
+
+//////////////////////////////////////////////////////////
+//                 Microcode detection                  //
+//////////////////////////////////////////////////////////
+
+// The custom microcodes are walked with the table they are based on
+static void DetectMicrocode(u32 code_base, u32 code_size, u32 data_base, u32 data_size)
+{
+	char str[256];
+	MicrocodeData data = GBIMicrocode_Identify((const u8*)&gRDRAM[0], gRamSize-1, code_base, code_size, data_base, data_size, str, 256);
+
+	gVertexStride = data.stride;
+	if( IS_CUSTOM_UCODE(data.ucode) )
+		printf("Microcode: \"%s\", hash 0x%08x, custom %s walked as %s\n", str, data.hash, gGBINames[data.ucode], gGBINames[data.offset]);
+	else
+		printf("Microcode: \"%s\", hash 0x%08x, %s\n", str, data.hash, gGBINames[data.ucode]);
+	InitOpcodes(data.offset);
+}
+
+//////////////////////////////////////////////////////////
+//                     The walk                         //
+//////////////////////////////////////////////////////////
+
+class CDListAnalyzer
+{
+public:
+	CDListAnalyzer();
+
+	void Walk(uint32 address);
+	void Report();
+
+protected:
+	void Run(MicroCodeCommand command);
+	void CountState(StateKind kind, bool bChanged);
+	void LoadVertices(uint32 address, uint32 v0, uint32 n);
+	void AddTriangle(uint32 v0, uint32 v1, uint32 v2);
+	void Draw();
+	void LoadTexture(MicroCodeCommand command);
+	bool Call(uint32 address, bool bPush);
+	uint32 SegmentAddr(uint32 seg) { return segments[(seg>>24)&0x0F] + (seg&0x00FFFFFF); }
+	DListCost &Cost() { return costs[stack[sp].address]; }
+
+	// Walk state
+	StackEntry	stack[DLA_MAX_STACK_SIZE];
+	int			sp;
+	int			limit;				// commands left in the list of a DL_Count, or -1
+	uint32		segments[16];
+	uint32		rdpHalf1;
+	uint32		geometryMode;
+	uint32		otherModeL;
+	uint32		otherModeH;
+	uint32		lastCommand[256][2];	// the last command of each opcode, for the single valued states
+	uint32		tiles[8][2];
+	uint32		tileSizes[8][2];
+	uint32		textureImage[2];		// SetTImg
+	uint32		prevCommand[2];
+
+	// Vertex slots
+	bool		slotLoaded[DLA_MAX_VERTS];
+	bool		slotUsed[DLA_MAX_VERTS];
+
+	// Results
+	uint64		numCommands;
+	uint64		numCalls;
+	int			maxDepth;
+	uint64		opcodeCounts[256];
+	uint64		numVtxCommands;
+	uint64		numVertices;
+	uint64		numUnusedVertices;		// overwritten or left without being used by a triangle
+	uint64		numVertexRefs;			// of the triangles
+	uint64		numTriangles;
+	uint64		numLines;
+	uint64		numDraws;				// Tri, Line3D and rectangle commands
+	uint64		numBranchZ;
+	uint64		numCullDL;
+	uint64		numModifyVtx;
+	uint64		numMatrices;
+	uint64		numDuplicates;			// commands identical to the command before them
+	uint64		numTextureLoads;
+	uint64		numUnusedLoads;			// loads followed by another load before any draw
+	bool		bLoadSinceDraw;
+	StateCounters states[NUM_STATE_KINDS];
+	std::map<uint32, uint32> vertexLoads;		// loads of each vertex address
+	std::map<uint32, TextureImage> images;		// by RDRAM address
+	std::map<std::pair<uint64, uint64>, uint32> imageLoads;	// by SetTImg and load command
+	std::map<uint32, DListCost> costs;
+	std::string	error;
+};
+
+CDListAnalyzer::CDListAnalyzer()
+{
+	sp = 0;
+	limit = -1;
+	memset(segments, 0, sizeof(segments));
+	rdpHalf1 = 0;
+	geometryMode = 0;
+	otherModeL = 0;
+	otherModeH = 0;
+	memset(lastCommand, 0xFF, sizeof(lastCommand));
+	memset(tiles, 0xFF, sizeof(tiles));
+	memset(tileSizes, 0xFF, sizeof(tileSizes));
+	memset(textureImage, 0, sizeof(textureImage));
+	memset(prevCommand, 0xFF, sizeof(prevCommand));
+	memset(slotLoaded, 0, sizeof(slotLoaded));
+	memset(slotUsed, 0, sizeof(slotUsed));
+
+	numCommands = numCalls = 0;
+	maxDepth = 0;
+	memset(opcodeCounts, 0, sizeof(opcodeCounts));
+	numVtxCommands = numVertices = numUnusedVertices = numVertexRefs = numTriangles = numLines = numDraws = 0;
+	numBranchZ = numCullDL = numModifyVtx = numMatrices = numDuplicates = 0;
+	numTextureLoads = numUnusedLoads = 0;
+	bLoadSinceDraw = false;
+	memset(states, 0, sizeof(states));
+}
+
+void CDListAnalyzer::CountState(StateKind kind, bool bChanged)
+{
+	states[kind].numCommands++;
+	if( !bChanged )
+		states[kind].numRedundant++;
+}
+
+void CDListAnalyzer::LoadVertices(uint32 address, uint32 v0, uint32 n)
+{
+	numVtxCommands++;
+	if( address + n*16 > gRamSize )
+		return;
+
+	numVertices += n;
+	Cost().numVertices += n;
+	vertexLoads[address]++;
+
+	for( uint32 i=v0; i<v0+n && i<DLA_MAX_VERTS; i++ )
+	{
+		if( slotLoaded[i] && !slotUsed[i] )
+			numUnusedVertices++;
+		slotLoaded[i] = true;
+		slotUsed[i] = false;
+	}
+}
+
+void CDListAnalyzer::AddTriangle(uint32 v0, uint32 v1, uint32 v2)
+{
+	uint32 v[3] = { v0, v1, v2 };
+	for( int i=0; i<3; i++ )
+	{
+		if( v[i] < DLA_MAX_VERTS )
+			slotUsed[v[i]] = true;
+	}
+	numVertexRefs += 3;
+	numTriangles++;
+	Cost().numTriangles++;
+}
+
+void CDListAnalyzer::Draw()
+{
+	numDraws++;
+	bLoadSinceDraw = false;
+}
+
+void CDListAnalyzer::LoadTexture(MicroCodeCommand command)
+{
+	numTextureLoads++;
+	Cost().numTextureLoads++;
+	if( bLoadSinceDraw )
+		numUnusedLoads++;
+	bLoadSinceDraw = true;
+
+	uint32 address = SegmentAddr(textureImage[1]);
+	TextureImage &image = images[address];
+	image.numLoads++;
+
+	std::pair<uint64, uint64> key(((uint64)textureImage[0]<<32) | address, ((uint64)command.inst.cmd0<<32) | command.inst.cmd1);
+	if( imageLoads[key]++ > 0 )
+		image.numReloads++;
+}
+
+bool CDListAnalyzer::Call(uint32 address, bool bPush)
+{
+	if( address + 8 > gRamSize )
+	{
+		char msg[64];
+		sprintf(msg, "display list address 0x%08x out of range", address);
+		error = msg;
+		return false;
+	}
+
+	if( bPush )
+	{
+		if( sp+1 >= DLA_MAX_STACK_SIZE )
+		{
+			error = "display list stack overflow";
+			return false;
+		}
+		sp++;
+		maxDepth = std::max(maxDepth, sp);
+	}
+
+	stack[sp].pc = address;
+	stack[sp].address = address;
+	numCalls++;
+	costs[address].numCalls++;
+	return true;
+}
+
+void CDListAnalyzer::Run(MicroCodeCommand command)
+{
+	u32 cmd = command.inst.cmd;
+
+	switch( gOpcodes[cmd].op )
+	{
+	case OP_NOTHING:
+	case OP_ENDDL:
+		sp--;
+		break;
+
+	case OP_DL:
+		{
+			uint32 address = SegmentAddr(command.dlist.addr) & (gRamSize-1);
+			Call(address, command.dlist.param == RSP_DLIST_PUSH);
+		}
+		break;
+
+	case OP_DLCOUNT:
+		{
+			uint32 address = SegmentAddr(command.inst.cmd1);
+			if( address != 0 && Call(address, true) )
+				limit = command.inst.cmd0 & 0xFFFF;
+		}
+		break;
+
+	case OP_BRANCHZ:
+		// The depth of the vertex is not known, the branch is never taken
+		numBranchZ++;
+		break;
+
+	case OP_CULLDL:
+		// Nor is the visibility of the vertices
+		numCullDL++;
+		break;
+
+	case OP_RDPHALF1:
+		rdpHalf1 = command.inst.cmd1;
+		break;
+
+	case OP_LOADUCODE:
+		DetectMicrocode(command.inst.cmd1 & 0x1fffffff, 0x1000, rdpHalf1 & 0x1fffffff, (command.inst.cmd0 & 0xFFFF) + 1);
+		break;
+
+	case OP_MTX:
+	case OP_POPMTX:
+		numMatrices++;
+		break;
+
+	case OP_MOVEWORD:
+		if( gOpcodes[cmd].layout == GBI_2 )
+		{
+			if( command.mw2.type == RSP_MOVE_WORD_SEGMENT )
+				segments[(command.mw2.offset >> 2) & 0x0F] = command.mw2.value & 0x00FFFFFF;
+		}
+		else if( command.mw1.type == RSP_MOVE_WORD_SEGMENT )
+		{
+			segments[(command.mw1.offset >> 2) & 0x0F] = command.mw1.value & 0x00FFFFFF;
+		}
+		break;
+
+	case OP_VTX:
+		if( gOpcodes[cmd].layout == GBI_2 )
+		{
+			int vend = command.vtx2.vend >> 1;
+			int n = command.vtx2.n;
+			if( vend <= 64 && n <= vend )
+				LoadVertices(SegmentAddr(command.vtx2.addr), vend - n, n);
+		}
+		else if( gOpcodes[cmd].layout == GBI_0 )
+		{
+			uint32 v0 = command.vtx0.v0;
+			uint32 n = command.vtx0.n + 1;
+			if( v0 + n > 80 )
+				n = 32 - v0;
+			LoadVertices(SegmentAddr(command.vtx0.addr), v0, n);
+		}
+		else if( command.vtx1.v0 + command.vtx1.n <= 80 )
+		{
+			LoadVertices(SegmentAddr(command.vtx1.addr), command.vtx1.v0, command.vtx1.n);
+		}
+		break;
+
+	case OP_MODIFYVTX:
+		numModifyVtx++;
+		break;
+
+	case OP_TRI1:
+		if( gOpcodes[cmd].layout == GBI_2 )
+			AddTriangle(command.gbi2tri1.v0 >> 1, command.gbi2tri1.v1 >> 1, command.gbi2tri1.v2 >> 1);
+		else
+			AddTriangle(command.gbi1tri1.v0 / gVertexStride, command.gbi1tri1.v1 / gVertexStride, command.gbi1tri1.v2 / gVertexStride);
+		Draw();
+		break;
+
+	case OP_TRI2:
+		if( gOpcodes[cmd].layout == GBI_2 )
+		{
+			AddTriangle(command.gbi2tri2.v0, command.gbi2tri2.v1, command.gbi2tri2.v2);
+			AddTriangle(command.gbi2tri2.v3, command.gbi2tri2.v4, command.gbi2tri2.v5);
+		}
+		else
+		{
+			AddTriangle(command.gbi1tri2.v0 >> 1, command.gbi1tri2.v1 >> 1, command.gbi1tri2.v2 >> 1);
+			AddTriangle(command.gbi1tri2.v3 >> 1, command.gbi1tri2.v4 >> 1, command.gbi1tri2.v5 >> 1);
+		}
+		Draw();
+		break;
+
+	case OP_TRI4:
+		AddTriangle(command.tri4.v0, command.tri4.v1, command.tri4.v2);
+		if( command.tri4.v3 != command.tri4.v4 )	AddTriangle(command.tri4.v3, command.tri4.v4, command.tri4.v5);
+		if( command.tri4.v6 != command.tri4.v7 )	AddTriangle(command.tri4.v6, command.tri4.v7, command.tri4.v8);
+		if( command.tri4.v9 != command.tri4.v10 )	AddTriangle(command.tri4.v9, command.tri4.v10, command.tri4.v11);
+		Draw();
+		break;
+
+	case OP_LINE3D:
+		if( gOpcodes[cmd].layout == GBI_2 )
+		{
+			AddTriangle(command.gbi2line3d.v0 >> 1, command.gbi2line3d.v1 >> 1, command.gbi2line3d.v2 >> 1);
+			AddTriangle(command.gbi2line3d.v3 >> 1, command.gbi2line3d.v4 >> 1, command.gbi2line3d.v5 >> 1);
+		}
+		else if( command.gbi1line3d.v3 == 0 )
+		{
+			numLines++;
+		}
+		else
+		{
+			uint32 v0 = command.gbi1line3d.v0 / gVertexStride;
+			uint32 v1 = command.gbi1line3d.v1 / gVertexStride;
+			uint32 v2 = command.gbi1line3d.v2 / gVertexStride;
+			uint32 v3 = command.gbi1line3d.v3 / gVertexStride;
+			AddTriangle(v0, v1, v2);
+			AddTriangle(v2, v3, v0);
+		}
+		Draw();
+		break;
+
+	case OP_TEXRECT:
+		// The rectangle takes the two commands after it
+		stack[sp].pc += 16;
+		Draw();
+		break;
+
+	case OP_FILLRECT:
+		Draw();
+		break;
+
+	case OP_GEOMETRYMODE:
+		{
+			uint32 mode;
+			if( gOpcodes[cmd].layout == GBI_2 )
+				mode = (geometryMode & command.inst.cmd0) | command.inst.cmd1;
+			else if( cmd & 1 )
+				mode = geometryMode | command.inst.cmd1;
+			else
+				mode = geometryMode & ~command.inst.cmd1;
+			CountState(STATE_GEOMETRYMODE, mode != geometryMode);
+			geometryMode = mode;
+		}
+		break;
+
+	case OP_OTHERMODE_L:
+	case OP_OTHERMODE_H:
+		{
+			uint32 mask;
+			if( gOpcodes[cmd].layout == GBI_2 )
+				mask = (uint32)((s32)(0x80000000) >> command.othermode.len) >> command.othermode.sft;
+			else
+				mask = ((1 << command.othermode.len) - 1) << command.othermode.sft;
+
+			uint32 &current = gOpcodes[cmd].op == OP_OTHERMODE_L ? otherModeL : otherModeH;
+			uint32 mode = (current & ~mask) | command.othermode.data;
+			CountState(STATE_OTHERMODE, mode != current);
+			current = mode;
+		}
+		break;
+
+	case OP_RDP_OTHERMODE:
+		CountState(STATE_OTHERMODE, otherModeH != command.inst.cmd0 || otherModeL != command.inst.cmd1);
+		otherModeH = command.inst.cmd0;
+		otherModeL = command.inst.cmd1;
+		break;
+
+	case OP_SETTIMG:
+		textureImage[0] = command.inst.cmd0;
+		textureImage[1] = command.inst.cmd1;
+		break;
+
+	case OP_LOADBLOCK:
+	case OP_LOADTILE:
+	case OP_LOADTLUT:
+		LoadTexture(command);
+		// Like the parser, the size of the tile is set by the load
+		tileSizes[command.loadtile.tile][0] = tileSizes[command.loadtile.tile][1] = ~0u;
+		break;
+
+	case OP_SETTILE:
+		{
+			uint32 *pTile = tiles[command.settile.tile];
+			CountState(STATE_SETTILE, pTile[0] != command.inst.cmd0 || pTile[1] != command.inst.cmd1);
+			pTile[0] = command.inst.cmd0;
+			pTile[1] = command.inst.cmd1;
+		}
+		break;
+
+	case OP_SETTILESIZE:
+		{
+			uint32 *pSize = tileSizes[command.loadtile.tile];
+			CountState(STATE_SETTILESIZE, pSize[0] != command.inst.cmd0 || pSize[1] != command.inst.cmd1);
+			pSize[0] = command.inst.cmd0;
+			pSize[1] = command.inst.cmd1;
+		}
+		break;
+
+	case OP_TEXTURE:
+	case OP_SCISSOR:
+	case OP_SETCOMBINE:
+	case OP_PRIMCOLOR:
+	case OP_ENVCOLOR:
+	case OP_FOGCOLOR:
+	case OP_BLENDCOLOR:
+	case OP_FILLCOLOR:
+		{
+			StateKind kind;
+			switch( gOpcodes[cmd].op )
+			{
+			case OP_TEXTURE:	kind = STATE_TEXTURE;		break;
+			case OP_SCISSOR:	kind = STATE_SCISSOR;		break;
+			case OP_SETCOMBINE:	kind = STATE_COMBINE;		break;
+			case OP_PRIMCOLOR:	kind = STATE_PRIMCOLOR;		break;
+			case OP_ENVCOLOR:	kind = STATE_ENVCOLOR;		break;
+			case OP_FOGCOLOR:	kind = STATE_FOGCOLOR;		break;
+			case OP_BLENDCOLOR:	kind = STATE_BLENDCOLOR;	break;
+			default:			kind = STATE_FILLCOLOR;		break;
+			}
+
+			uint32 *pLast = lastCommand[cmd];
+			CountState(kind, pLast[0] != command.inst.cmd0 || pLast[1] != command.inst.cmd1);
+			pLast[0] = command.inst.cmd0;
+			pLast[1] = command.inst.cmd1;
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void CDListAnalyzer::Walk(uint32 address)
+{
+	sp = -1;
+	if( !Call(address, true) )
+		return;
+
+	while( sp >= 0 )
+	{
+		if( numCommands >= DLA_MAX_COMMANDS )
+		{
+			error = "too many commands, the display list does not end";
+			break;
+		}
+
+		uint32 pc = stack[sp].pc;
+		if( pc + 8 > gRamSize )
+		{
+			char msg[64];
+			sprintf(msg, "PC 0x%08x out of range", pc);
+			error = msg;
+			break;
+		}
+
+		MicroCodeCommand command;
+		command.inst.cmd0 = gRDRAM[pc>>2];
+		command.inst.cmd1 = gRDRAM[(pc>>2)+1];
+		stack[sp].pc = pc + 8;
+
+		u32 cmd = command.inst.cmd;
+		numCommands++;
+		opcodeCounts[cmd]++;
+
+		if( command.inst.cmd0 == prevCommand[0] && command.inst.cmd1 == prevCommand[1] )
+			numDuplicates++;
+		prevCommand[0] = command.inst.cmd0;
+		prevCommand[1] = command.inst.cmd1;
+
+		// Each list on the stack includes the cost of the command
+		Cost().numCommands++;
+		for( int i=0; i<=sp; i++ )
+		{
+			bool bCounted = false;
+			for( int j=0; j<i && !bCounted; j++ )
+				bCounted = stack[j].address == stack[i].address;
+			if( !bCounted )
+				costs[stack[i].address].numInclusive++;
+		}
+
+		if( gTrace )
+			printf("%*s%08X: %08X %08X %s\n", sp*2, "", pc, command.inst.cmd0, command.inst.cmd1, gOpcodes[cmd].name);
+
+		Run(command);
+
+		if( !error.empty() )
+			break;
+
+		if( limit >= 0 && --limit < 0 )
+			sp--;
+	}
+}
+
+static double Percent(uint64 n, uint64 total)
+{
+	return total ? 100.0*n/total : 0.0;
+}
+
+void CDListAnalyzer::Report()
+{
+	printf("\n%llu commands, %llu display lists called, deepest level %d\n", (unsigned long long)numCommands, (unsigned long long)numCalls, maxDepth+1);
+	if( !error.empty() )
+		printf("The walk stopped early: %s\n", error.c_str());
+
+	// Commands
+	std::vector<std::pair<uint64, u32> > histogram;
+	for( u32 i=0; i<256; i++ )
+	{
+		if( opcodeCounts[i] != 0 )
+			histogram.push_back(std::make_pair(opcodeCounts[i], i));
+	}
+	std::sort(histogram.rbegin(), histogram.rend());
+
+	printf("\nCommands\n");
+	printf("%-6s %-32s %10s %8s\n", "Opcode", "Handler", "Count", "%");
+	for( size_t i=0; i<histogram.size(); i++ )
+	{
+		u32 cmd = histogram[i].second;
+		printf("0x%02X   %-32s %10llu %7.2f%%\n", cmd, gOpcodes[cmd].name, (unsigned long long)histogram[i].first, Percent(histogram[i].first, numCommands));
+	}
+	printf("%llu commands identical to the command before them (%.2f%%)\n", (unsigned long long)numDuplicates, Percent(numDuplicates, numCommands));
+
+	// Vertices
+	uint64 numLeftUnused = 0;
+	for( int i=0; i<DLA_MAX_VERTS; i++ )
+	{
+		if( slotLoaded[i] && !slotUsed[i] )
+			numLeftUnused++;
+	}
+	uint64 numReloaded = 0;
+	for( std::map<uint32, uint32>::iterator it = vertexLoads.begin(); it != vertexLoads.end(); ++it )
+		numReloaded += it->second - 1;
+
+	printf("\nVertices\n");
+	printf("%llu Vtx commands, %llu vertices, %.1f per command\n", (unsigned long long)numVtxCommands, (unsigned long long)numVertices,
+		numVtxCommands ? (double)numVertices/numVtxCommands : 0.0);
+	printf("%llu triangles, %llu lines, %llu vertex references, %.2f references per vertex loaded\n", (unsigned long long)numTriangles,
+		(unsigned long long)numLines, (unsigned long long)numVertexRefs, numVertices ? (double)numVertexRefs/numVertices : 0.0);
+	printf("%llu vertices loaded and never used by a triangle (%.2f%%)\n", (unsigned long long)(numUnusedVertices + numLeftUnused),
+		Percent(numUnusedVertices + numLeftUnused, numVertices));
+	printf("%llu Vtx commands loading vertex data which was loaded before, from %u addresses\n", (unsigned long long)numReloaded, (uint32)vertexLoads.size());
+	printf("%llu matrix commands, %llu ModifyVtx, %llu CullDL and %llu BranchZ (not evaluated, never taken)\n", (unsigned long long)numMatrices,
+		(unsigned long long)numModifyVtx, (unsigned long long)numCullDL, (unsigned long long)numBranchZ);
+
+	// States
+	printf("\nState commands\n");
+	printf("%-16s %10s %10s %10s\n", "Command", "Count", "Changes", "Redundant");
+	for( int i=0; i<NUM_STATE_KINDS; i++ )
+	{
+		if( states[i].numCommands == 0 )
+			continue;
+		printf("%-16s %10u %10u %9.2f%%\n", gStateNames[i], states[i].numCommands, states[i].numCommands - states[i].numRedundant,
+			Percent(states[i].numRedundant, states[i].numCommands));
+	}
+
+	// Textures
+	uint32 numReloads = 0;
+	std::vector<std::pair<uint32, uint32> > loadedImages;
+	for( std::map<uint32, TextureImage>::iterator it = images.begin(); it != images.end(); ++it )
+	{
+		numReloads += it->second.numReloads;
+		loadedImages.push_back(std::make_pair(it->second.numLoads, it->first));
+	}
+	std::sort(loadedImages.rbegin(), loadedImages.rend());
+
+	printf("\nTexture loads\n");
+	printf("%llu loads of %u images, %u loading again an image with the same command (%.2f%%)\n", (unsigned long long)numTextureLoads,
+		(uint32)images.size(), numReloads, Percent(numReloads, numTextureLoads));
+	printf("%llu loads replaced by the next one before any draw\n", (unsigned long long)numUnusedLoads);
+	for( size_t i=0; i<loadedImages.size() && i<gTopLists; i++ )
+	{
+		const TextureImage &image = images[loadedImages[i].second];
+		printf("  0x%08X %6u loads %6u again\n", loadedImages[i].second, image.numLoads, image.numReloads);
+	}
+
+	// Lists
+	std::vector<std::pair<uint64, uint32> > lists;
+	for( std::map<uint32, DListCost>::iterator it = costs.begin(); it != costs.end(); ++it )
+		lists.push_back(std::make_pair(it->second.numInclusive, it->first));
+	std::sort(lists.rbegin(), lists.rend());
+
+	printf("\nDisplay lists, by the commands they run with the lists they call\n");
+	printf("%-10s %8s %10s %10s %10s %10s %10s\n", "Address", "Calls", "Commands", "Inclusive", "Vertices", "Triangles", "TexLoads");
+	for( size_t i=0; i<lists.size() && i<gTopLists; i++ )
+	{
+		const DListCost &cost = costs[lists[i].second];
+		printf("0x%08X %8u %10llu %10llu %10llu %10llu %10llu\n", lists[i].second, cost.numCalls, (unsigned long long)cost.numCommands,
+			(unsigned long long)cost.numInclusive, (unsigned long long)cost.numVertices, (unsigned long long)cost.numTriangles,
+			(unsigned long long)cost.numTextureLoads);
+	}
+}
+
+//////////////////////////////////////////////////////////
+//                        Main                          //
+//////////////////////////////////////////////////////////
+
+static bool ReadFile(const char *filename, std::vector<uint32> &words)
+{
+	FILE *f = fopen(filename, "rb");
+	if( f == NULL )
+	{
+		fprintf(stderr, "Cannot open %s\n", filename);
+		return false;
+	}
+
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	words.resize(size/4);
+	bool bRead = size >= 4 && fread(&words[0], 4, words.size(), f) == words.size();
+	fclose(f);
+
+	if( !bRead )
+		fprintf(stderr, "Cannot read %s\n", filename);
+	return bRead;
+}
+
+static inline uint32 ByteSwap(uint32 w)
+{
+	return (w>>24) | ((w>>8)&0xFF00) | ((w<<8)&0xFF0000) | (w<<24);
+}
+
+static void Usage()
+{
+	printf("Usage: DListAnalyzer [options] rdram.bin task.bin\n\n");
+	printf("  rdram.bin  RDRAM dump, 4 or 8 MB\n");
+	printf("  task.bin   DMEM dump with the OSTask at 0x%X, or the 64 bytes of the OSTask\n\n", DLA_TASK_OFFSET);
+	printf("  -s         the dumps are byte swapped, big endian words\n");
+	printf("  -t         print each command as it is walked\n");
+	printf("  -n count   number of display lists and images listed, %u by default\n", gTopLists);
+}
+
+int main(int argc, char **argv)
+{
+	bool bSwap = false;
+	const char *files[2] = { NULL, NULL };
+	int numFiles = 0;
+
+	for( int i=1; i<argc; i++ )
+	{
+		if( strcmp(argv[i], "-s") == 0 )
+			bSwap = true;
+		else if( strcmp(argv[i], "-t") == 0 )
+			gTrace = true;
+		else if( strcmp(argv[i], "-n") == 0 && i+1 < argc )
+			gTopLists = (uint32)atoi(argv[++i]);
+		else if( argv[i][0] != '-' && numFiles < 2 )
+			files[numFiles++] = argv[i];
+		else
+		{
+			Usage();
+			return 1;
+		}
+	}
+
+	if( numFiles != 2 )
+	{
+		Usage();
+		return 1;
+	}
+
+	std::vector<uint32> dmem;
+	if( !ReadFile(files[0], gRDRAM) || !ReadFile(files[1], dmem) )
+		return 1;
+
+	gRamSize = (uint32)gRDRAM.size()*4;
+	if( gRamSize != 0x400000 && gRamSize != 0x800000 )
+	{
+		fprintf(stderr, "%s is %u bytes, RDRAM is 4 or 8 MB\n", files[0], gRamSize);
+		return 1;
+	}
+
+	uint32 taskOffset = dmem.size()*4 >= DLA_TASK_OFFSET+64 ? DLA_TASK_OFFSET/4 : 0;
+	if( dmem.size() < taskOffset+16 )
+	{
+		fprintf(stderr, "%s is too small for an OSTask\n", files[1]);
+		return 1;
+	}
+
+	// A graphics task has type 1, seen as 0x01000000 in a byte swapped dump
+	if( dmem[taskOffset] == ByteSwap(DLA_GFX_TASK) )
+		bSwap = true;
+
+	if( bSwap )
+	{
+		for( size_t i=0; i<gRDRAM.size(); i++ )
+			gRDRAM[i] = ByteSwap(gRDRAM[i]);
+		for( size_t i=0; i<dmem.size(); i++ )
+			dmem[i] = ByteSwap(dmem[i]);
+	}
+
+	// OSTask_t of Parser/RSP_Parser.h
+	const uint32 *pTask = &dmem[taskOffset];
+	uint32 type = pTask[0];
+	uint32 ucode = pTask[4] & 0x1fffffff;
+	uint32 ucode_size = pTask[5];
+	uint32 ucode_data = pTask[6] & 0x1fffffff;
+	uint32 ucode_data_size = pTask[7];
+	uint32 data_ptr = pTask[12] & 0x1fffffff;
+
+	if( type != DLA_GFX_TASK )
+		printf("Warning: the task type is %u, not a graphics task\n", type);
+
+	printf("Task: ucode 0x%08x (0x%x bytes), ucode data 0x%08x (0x%x bytes), display list 0x%08x\n",
+		ucode, ucode_size, ucode_data, ucode_data_size, data_ptr);
+	DetectMicrocode(ucode, ucode_size, ucode_data, ucode_data_size);
+
+	CDListAnalyzer analyzer;
+	analyzer.Walk(data_ptr);
+	analyzer.Report();
+	return 0;
+}
@@ -0,0 +1,174 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "../../stdafx.h"
+#include "../../Parser/RenderThread.h"
+#include "HeadlessHost.h"
+
+// The state Video.cpp and Config.cpp define in the plugin
+PluginStatus status;
+char generalText[256];
+char *project_name = "RiceVideo";
+
+GFX_INFO g_GraphicsInfo;
+
+uint32 g_dwRamSize = 0x800000;
+uint32* g_pu32RamBase = NULL;
+signed char *g_ps8RamBase = NULL;
+unsigned char *g_pu8RamBase = NULL;
+
+WindowSettingStruct windowSetting;
+GlobalOptions options;
+RomOptions defaultRomOptions;
+RomOptions currentRomOptions;
+FrameBufferOptions frameBufferOptions;
+GameSetting g_curRomInfo;
+
+// The emulator registers, nothing reads them back
+static uint8 s_RomHeader[0x40];
+static uint8 s_DMEM[0x1000];
+static uint8 s_IMEM[0x1000];
+static uint32 s_MI_INTR_REG;
+static uint32 s_Registers[22];
+
+void GetPluginDir( char * Directory )
+{
+	strcpy(Directory, "./");
+}
+
+void __cdecl MsgInfo (char * Message, ...)
+{
+	va_list ap;
+	va_start( ap, Message );
+	vfprintf( stdout, Message, ap );
+	va_end( ap );
+	fprintf( stdout, "\n" );
+}
+
+void __cdecl ErrorMsg (char * Message, ...)
+{
+	va_list ap;
+	va_start( ap, Message );
+	vfprintf( stderr, Message, ap );
+	va_end( ap );
+	fprintf( stderr, "\n" );
+}
+
+void SetVIScales()
+{
+	if( g_curRomInfo.VIHeight>0 && g_curRomInfo.VIWidth>0 )
+	{
+		windowSetting.fViWidth = windowSetting.uViWidth = g_curRomInfo.VIWidth;
+		windowSetting.fViHeight = windowSetting.uViHeight = g_curRomInfo.VIHeight;
+	}
+	else
+	{
+		// there is no VI to read the size from
+		windowSetting.fViWidth = windowSetting.uViWidth = 320;
+		windowSetting.fViHeight = windowSetting.uViHeight = 240;
+	}
+	SetScreenMult(windowSetting.uDisplayWidth/windowSetting.fViWidth, windowSetting.uDisplayHeight/windowSetting.fViHeight);
+}
+
+void TriggerDPInterrupt(void)
+{
+	if( gRenderThread.IsRenderThread() )
+		return;
+
+	*(g_GraphicsInfo.MI_INTR_REG) |= 0x20;
+	if( g_GraphicsInfo.CheckInterrupts )
+		g_GraphicsInfo.CheckInterrupts();
+}
+
+// The hires textures and the texture enhancement are in TextureFilters.cpp, which needs BMGLib
+bool LoadHiresTexture( TxtrCacheEntry &entry )
+{
+	return false;
+}
+
+void EnhanceTexture(TxtrCacheEntry *pEntry)
+{
+}
+
+void DumpCachedTexture( TxtrCacheEntry &entry )
+{
+}
+
+bool HeadlessStartVideo(uint8 *rdram, uint32 rdramSize, bool bSoftwareRender)
+{
+	g_pu8RamBase = rdram;
+	g_ps8RamBase = (signed char *)rdram;
+	g_pu32RamBase = (uint32 *)rdram;
+	g_dwRamSize = rdramSize;
+
+	memset(&g_GraphicsInfo, 0, sizeof(g_GraphicsInfo));
+	g_GraphicsInfo.HEADER = s_RomHeader;
+	g_GraphicsInfo.RDRAM = rdram;
+	g_GraphicsInfo.DMEM = s_DMEM;
+	g_GraphicsInfo.IMEM = s_IMEM;
+	g_GraphicsInfo.MI_INTR_REG = &s_MI_INTR_REG;
+	uint32 **regs = &g_GraphicsInfo.DPC_START_REG;
+	for( int i=0; i<22; i++ )
+		regs[i] = &s_Registers[i];
+
+	memset(&options, 0, sizeof(options));
+	options.bHeadlessRender = TRUE;
+	options.bSoftwareRender = bSoftwareRender;
+	memset(&currentRomOptions, 0, sizeof(currentRomOptions));
+	memset(&frameBufferOptions, 0, sizeof(frameBufferOptions));
+	frameBufferOptions.bIgnore = true;
+	status.dwTvSystem = TV_SYSTEM_NTSC;
+
+	CGraphicsContext::g_pGraphicsContext = new CNullGraphicsContext();
+	g_pFrameBufferManager = new NullFrameBufferManager;
+	CGraphicsContext::InitWindowInfo();
+
+	// the defaults of the ini file
+	windowSetting.uWindowDisplayWidth = windowSetting.uFullScreenDisplayWidth = 640;
+	windowSetting.uWindowDisplayHeight = windowSetting.uFullScreenDisplayHeight = 480;
+	windowSetting.bDisplayFullscreen = FALSE;
+	if( !CGraphicsContext::Get()->Initialize(NULL, NULL, 640, 480, TRUE) )
+		return false;
+
+	if( bSoftwareRender )
+		CRender::g_pRender = new CSoftwareRender();
+	else
+		CRender::g_pRender = new CNullRender();
+	CRender::GetRender()->Initialize();
+
+	DLParser_Init();
+
+	status.bGameIsRunning = true;
+	return true;
+}
+
+void HeadlessStopVideo()
+{
+	status.bGameIsRunning = false;
+
+	gTextureManager.RecycleAllTextures();
+	gTextureManager.CleanUp();
+	RDP_Cleanup();
+
+	SAFE_DELETE(CRender::g_pRender);
+
+	CGraphicsContext::Get()->CleanUp();
+	SAFE_DELETE(CGraphicsContext::g_pGraphicsContext);
+	SAFE_DELETE(g_pFrameBufferManager);
+}
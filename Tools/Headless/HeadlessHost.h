@@ -0,0 +1,31 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+// Host side of the headless build. On Windows Video.cpp and Config.cpp own the
+// emulator interface and the options, here the caller hands over an RDRAM image
+// and the null or the software render is started the way StartVideo does it
+// when the HeadlessRender option is set.
+
+#ifndef _HEADLESSHOST_H_
+#define _HEADLESSHOST_H_
+
+bool HeadlessStartVideo(uint8 *rdram, uint32 rdramSize, bool bSoftwareRender);
+void HeadlessStopVideo();
+
+#endif // _HEADLESSHOST_H_
@@ -0,0 +1,169 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+// Time of DLParser_Process on two synthetic F3DEX2 frames with the null render, with the display list options off
+// and on. Not a test, "make bench" runs it.
+
+#include "../../stdafx.h"
+#include "../Headless/HeadlessHost.h"
+#include "../../Parser/DLCulling.h"
+#include <chrono>
+
+#define BENCH_RDRAM_SIZE	0x800000
+#define BENCH_UCODE_DATA	0x1000
+#define BENCH_UCODE_CODE	0x2000
+#define BENCH_ROOT_DLIST	0x100000
+#define BENCH_OBJ_DLISTS	0x110000
+#define BENCH_VERTICES		0x200000
+#define BENCH_NUM_OBJECTS	400
+#define BENCH_NUM_FRAMES	300
+#define BENCH_NUM_RUNS		10
+
+static uint8 *rdram;
+
+static void PutCommand(uint32 &pc, uint32 cmd0, uint32 cmd1)
+{
+	uint32 *ram = (uint32 *)rdram;
+	ram[pc>>2] = cmd0;
+	ram[(pc>>2)+1] = cmd1;
+	pc += 8;
+}
+
+// A frame of objects drawn by their own list: a few state commands, then two batches of 16 vertices loaded in the
+// same slots and 16 triangles each. The objects are all in the view, or every other one is moved out of it.
+static void BuildFrame(bool bHalfOffScreen)
+{
+	const char *version = "RSP Gfx ucode F3DEX       fifo 2.08  Yoshitaka Yasumoto 1999 Nintendo.";
+	for( size_t i=0; i<=strlen(version); i++ )
+		rdram[(BENCH_UCODE_DATA + i)^3] = version[i];
+
+	OSTask *pTask = (OSTask *)(g_GraphicsInfo.DMEM + 0x0FC0);
+	memset(pTask, 0, sizeof(OSTask));
+	pTask->t.ucode = BENCH_UCODE_CODE;
+	pTask->t.ucode_size = 0x1000;
+	pTask->t.ucode_data = BENCH_UCODE_DATA;
+	pTask->t.ucode_data_size = 0x800;
+	pTask->t.dram_stack_size = 0x400;
+	pTask->t.data_ptr = BENCH_ROOT_DLIST;
+
+	uint32 root = BENCH_ROOT_DLIST;
+	for( uint32 obj=0; obj<BENCH_NUM_OBJECTS; obj++ )
+	{
+		uint32 list = BENCH_OBJ_DLISTS + obj*0x100;
+		uint32 vertices = BENCH_VERTICES + obj*32*sizeof(FiddledVtx);
+		PutCommand(root, RSP_ZELDADL<<24, list);
+
+		FiddledVtx *pVtx = (FiddledVtx *)(rdram + vertices);
+		for( int i=0; i<32; i++ )
+		{
+			memset(&pVtx[i], 0, sizeof(FiddledVtx));
+			pVtx[i].x = (s16)((i&3) - 2 + ((bHalfOffScreen && (obj&1)) ? 1000 : 0));
+			pVtx[i].y = (s16)(((i>>2)&3) - 2);
+			pVtx[i].rgba_r = pVtx[i].rgba_g = pVtx[i].rgba_b = pVtx[i].rgba_a = 0xFF;
+		}
+
+		PutCommand(list, RDP_PIPESYNC<<24, 0);
+		PutCommand(list, RDP_SETPRIMCOLOR<<24, 0xFF000000 | obj);
+		PutCommand(list, RDP_SETENVCOLOR<<24, 0x00FF00FF);
+		for( int batch=0; batch<2; batch++ )
+		{
+			PutCommand(list, RSP_ZELDAVTX<<24 | 16<<12 | 16<<1, vertices + batch*16*sizeof(FiddledVtx));
+			for( int t=0; t<8; t++ )
+			{
+				int v = (t&1) ? 8 : 0;
+				PutCommand(list, RSP_ZELDATRI2<<24 | (v+4)<<17 | (v+5)<<9 | (v+6)<<1, (v+0)<<17 | (v+1)<<9 | (v+2)<<1);
+			}
+		}
+		PutCommand(list, RSP_ZELDAENDDL<<24, 0);
+	}
+	PutCommand(root, RSP_ZELDAENDDL<<24, 0);
+}
+
+struct BenchConfig
+{
+	const char	*name;
+	bool		bCacheDisplayLists;
+	bool		bCullDisplayLists;
+	double		best;		// us a frame
+};
+
+static double TimeFrames()
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for( int i=0; i<BENCH_NUM_FRAMES; i++ )
+		DLParser_Process();
+	std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / BENCH_NUM_FRAMES;
+}
+
+int main()
+{
+	rdram = new uint8[BENCH_RDRAM_SIZE];
+	memset(rdram, 0, BENCH_RDRAM_SIZE);
+	if( !HeadlessStartVideo(rdram, BENCH_RDRAM_SIZE, false) )
+	{
+		printf("DListBench: the headless render does not start\n");
+		return 1;
+	}
+	for( int frame=0; frame<2; frame++ )
+	{
+		BuildFrame(frame == 1);
+
+		BenchConfig configs[] = {
+			{ "fetch from RDRAM",		false,	false,	1e30 },
+			{ "CacheDisplayLists",		true,	false,	1e30 },
+			{ "CullDisplayLists",		false,	true,	1e30 },
+		};
+
+		// the first frame detects the microcode
+		options.bCullDisplayLists = FALSE;
+		DLParser_Process();
+		uint32 ucodeCount = status.gUcodeCount;
+		DLParser_Process();
+		uint32 numCommands = status.gUcodeCount - ucodeCount;
+
+		// the culler learns the bounds of the lists over its first frames
+		options.bCullDisplayLists = TRUE;
+		for( int i=0; i<=DLCULL_CHECK_CALLS+DLCULL_MIN_RUNS; i++ )
+			DLParser_Process();
+		uint32 numCulled = gDListCuller.GetNumCulled();
+		DLParser_Process();
+		numCulled = gDListCuller.GetNumCulled() - numCulled;
+
+		// The runs of the options are interleaved, so a slower period of the machine does not favour one of them
+		for( int run=0; run<BENCH_NUM_RUNS; run++ )
+		{
+			for( size_t i=0; i<ARRAYSIZE(configs); i++ )
+			{
+				options.bCacheDisplayLists = configs[i].bCacheDisplayLists;
+				options.bCullDisplayLists = configs[i].bCullDisplayLists;
+				configs[i].best = min(configs[i].best, TimeFrames());
+			}
+		}
+
+		printf("%d objects%s, %u commands a frame, %u lists culled, best of %d runs of %d frames\n", BENCH_NUM_OBJECTS,
+			frame == 1 ? " (every other one off screen)" : "", numCommands, numCulled, BENCH_NUM_RUNS, BENCH_NUM_FRAMES);
+		for( size_t i=0; i<ARRAYSIZE(configs); i++ )
+			printf("  %-24s %8.1f us a frame\n", configs[i].name, configs[i].best);
+	}
+
+	HeadlessStopVideo();
+	delete [] rdram;
+	return 0;
+}
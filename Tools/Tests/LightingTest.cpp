@@ -0,0 +1,192 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+// The lights of the vertices in model space, SSE2 and scalar, against LightVert of the transformed normals, and the
+// fallback of ProcessVertexData to LightVert when the world matrix is not a rotation
+
+#include "../../stdafx.h"
+
+static int failures = 0;
+
+// 9 vertices, two full batches of 4 and a partial one, with a zero normal, the axes and normals facing away
+static const s8 normals[][3] = { { 127, 0, 0 }, { 0, -128, 0 }, { 0, 0, 127 }, { 0, 0, 0 }, { 73, -73, 73 },
+	{ -90, 12, -90 }, { 5, 120, -30 }, { -127, -127, -127 }, { 40, 40, -100 } };
+static const uint32 numVerts = ARRAYSIZE(normals);
+
+static void InitVertices(FiddledVtx *verts)
+{
+	memset(verts, 0, numVerts * sizeof(FiddledVtx));
+	for (uint32 i = 0; i < numVerts; i++)
+	{
+		verts[i].x = (s16)(i * 10);
+		verts[i].y = (s16)(i * 5);
+		verts[i].z = -100;
+		verts[i].norm_x = normals[i][0];
+		verts[i].norm_y = normals[i][1];
+		verts[i].norm_z = normals[i][2];
+	}
+}
+
+static void InitLights()
+{
+	// 3 lights bright enough to saturate and the ambient
+	SetNumLights(3);
+	SetLightCol(0, 200, 100, 50);
+	SetLightDirection(0, 1.0f, 0.5f, 0.2f);
+	SetLightCol(1, 30, 160, 90);
+	SetLightDirection(1, -0.3f, 1.0f, -0.6f);
+	SetLightCol(2, 120, 120, 250);
+	SetLightDirection(2, 0.1f, -0.4f, 1.0f);
+	SetLightCol(3, 20, 25, 30);
+}
+
+static uint32 ExpectedColor(const FiddledVtx &vert, const Matrix4x4 &mat_world)
+{
+	v3 model_normal((float)vert.norm_x, (float)vert.norm_y, (float)vert.norm_z);
+	v3 norm = mat_world.TransformNormal(model_normal);
+	norm.Normalise();
+	return LightVert(norm);
+}
+
+static bool CloseColors(uint32 a, uint32 b, int tolerance)
+{
+	for (int shift = 0; shift < 24; shift += 8)
+	{
+		int diff = (int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF);
+		if (diff > tolerance || diff < -tolerance)
+			return false;
+	}
+	return true;
+}
+
+static void CheckModelSpace(const char *name, const Matrix4x4 &mat_world)
+{
+	FiddledVtx verts[numVerts];
+	InitVertices(verts);
+	InitLights();
+
+	if (!PrepareModelSpaceLights(mat_world))
+	{
+		printf("%s: the model space lights refuse the matrix\n", name);
+		failures++;
+		return;
+	}
+
+	const uint32 first = 5;
+	uint32 scalar[numVerts];
+	LightVerticesModelSpaceScalar(verts, first, numVerts);
+	memcpy(scalar, &g_dwVtxDifColor[first], sizeof(scalar));
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+	LightVerticesModelSpaceSSE2(verts, first, numVerts);
+	for (uint32 i = 0; i < numVerts; i++)
+	{
+		// Only the rounding of the sums differs
+		if (!CloseColors(g_dwVtxDifColor[first + i], scalar[i], 1))
+		{
+			printf("%s: vertex %d lit to %08X by SSE2, %08X by the scalar code\n", name, i, g_dwVtxDifColor[first + i], scalar[i]);
+			failures++;
+		}
+	}
+#endif
+
+	for (uint32 i = 0; i < numVerts; i++)
+	{
+		uint32 expected = ExpectedColor(verts[i], mat_world);
+		if (!CloseColors(scalar[i], expected, MODEL_LIGHTS_CHECK_ERROR))
+		{
+			printf("%s: vertex %d lit to %08X in model space, %08X by LightVert\n", name, i, scalar[i], expected);
+			failures++;
+		}
+	}
+}
+
+// ProcessVertexData with the world matrix on the stack, the colors are compared with LightVert
+static void CheckProcessVertexData(const char *name, const Matrix4x4 &mat_world, int tolerance)
+{
+	static FiddledVtx ram[numVerts];
+	InitVertices(ram);
+	InitLights();
+
+	g_pu8RamBase = (unsigned char *)ram;
+	gRSP.mModelViewTop = 0;
+	gRSP.mModelViewStack[0] = mat_world;
+	gRSP.mProjectionMat = gMatrixIdentity;
+	gRSP.mWorldProjectValid = false;
+	gRDP.tnl._u32 = 0;
+	gRDP.tnl.Light = 1;
+	gRDP.tnl.Shade = 1;
+
+	ProcessVertexData(0, 0, numVerts);
+
+	for (uint32 i = 0; i < numVerts; i++)
+	{
+		uint32 expected = ExpectedColor(ram[i], mat_world);
+		if (!CloseColors(g_dwVtxDifColor[i], expected, tolerance))
+		{
+			printf("%s: ProcessVertexData lit vertex %d to %08X, LightVert to %08X\n", name, i, g_dwVtxDifColor[i], expected);
+			failures++;
+		}
+	}
+}
+
+int main()
+{
+	// A rotation around z and x with a uniform scale of 3, and one with a translation
+	float c = cosf(0.6f), s = sinf(0.6f);
+	Matrix4x4 rotation(	3*c,	3*s,	0,		0,
+						-3*s*c,	3*c*c,	3*s,	0,
+						3*s*s,	-3*s*c,	3*c,	0,
+						0,		0,		0,		1);
+	Matrix4x4 moved(	0,		1,		0,		0,
+						-1,		0,		0,		0,
+						0,		0,		1,		0,
+						10,		-20,	-300,	1);
+
+	// A shear and a scale that is not uniform, the normals must be transformed one by one
+	Matrix4x4 shear(	1,		0.5f,	0,		0,
+						0,		1,		0,		0,
+						0.3f,	0,		0.2f,	0,
+						0,		0,		0,		1);
+	Matrix4x4 stretched(2,		0,		0,		0,
+						0,		1,		0,		0,
+						0,		0,		1,		0,
+						0,		0,		0,		1);
+
+	CheckModelSpace("Rotation", rotation);
+	CheckModelSpace("Moved", moved);
+
+	if (PrepareModelSpaceLights(shear) || PrepareModelSpaceLights(stretched))
+	{
+		printf("The model space lights accept a matrix that is not a rotation\n");
+		failures++;
+	}
+
+	CheckProcessVertexData("Rotation", rotation, MODEL_LIGHTS_CHECK_ERROR);
+	CheckProcessVertexData("Shear", shear, 0);
+	CheckProcessVertexData("Stretched", stretched, 0);
+
+	if (failures)
+	{
+		printf("LightingTest: %d failures\n", failures);
+		return 1;
+	}
+	printf("LightingTest: passed\n");
+	return 0;
+}
@@ -0,0 +1,210 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+// Triangles drawn by the software render under the alpha test, the depth test and the blend modes, against the
+// pixels worked out by hand
+
+#include "../../stdafx.h"
+#include "../Headless/HeadlessHost.h"
+
+static int failures = 0;
+
+// Opens the rasterizer of the software render to the test
+class ReferenceRender : public CSoftwareRender
+{
+public:
+	void SetBlendType(BlendType type)	{ m_blendType = type; }
+	void Clear(uint32 color, float depth)	{ ClearRect(0, 0, m_width, m_height, true, color, true, depth); }
+	uint32 Pixel(int x, int y)	{ return m_colorBuffer[y*m_width+x]; }
+	float Depth(int x, int y)	{ return m_depthBuffer[y*m_width+x]; }
+
+	// A triangle of the diffuse color, in screen coordinates
+	void Draw(float x0, float y0, float x1, float y1, float x2, float y2, float z, uint32 color)
+	{
+		TLITVERTEX v[3];
+		memset(v, 0, sizeof(v));
+		v[0].x = x0;	v[0].y = y0;
+		v[1].x = x1;	v[1].y = y1;
+		v[2].x = x2;	v[2].y = y2;
+		for( int i=0; i<3; i++ )
+		{
+			v[i].z = z;
+			v[i].rhw = 1;
+			v[i].dcDiffuse = color;
+		}
+
+		BeginDraw(SOFT_PIXEL_FILL);
+		DrawTriangle(v[0], v[1], v[2], 0);
+		EndDraw();
+	}
+};
+
+static void CheckPixel(ReferenceRender *render, const char *name, int x, int y, uint32 expected)
+{
+	uint32 pixel = render->Pixel(x, y);
+	if( pixel != expected )
+	{
+		printf("%s: pixel %d,%d is %08X instead of %08X\n", name, x, y, pixel, expected);
+		failures++;
+	}
+}
+
+// The lower left half of the square 10,10 to 30,30, its right edge from 30,10 to 10,30 is not drawn
+static void DrawHalfSquare(ReferenceRender *render, float z, uint32 color)
+{
+	render->Draw(10, 10, 30, 10, 10, 30, z, color);
+}
+
+static void CheckCoverage(ReferenceRender *render)
+{
+	render->Clear(0xFF000000, 1.0f);
+	render->SetZCompare(FALSE);
+	render->SetZUpdate(FALSE);
+	render->SetAlphaTestEnable(FALSE);
+	render->SetBlendType(kBlendModeOpaque);
+
+	DrawHalfSquare(render, 0.5f, 0xFFFF0000);
+	CheckPixel(render, "Coverage", 10, 10, 0xFFFF0000);		// top left corner
+	CheckPixel(render, "Coverage", 15, 15, 0xFFFF0000);
+	CheckPixel(render, "Coverage", 29, 10, 0xFFFF0000);		// on the top edge
+	CheckPixel(render, "Coverage", 20, 20, 0xFF000000);		// on the right edge
+	CheckPixel(render, "Coverage", 30, 10, 0xFF000000);
+	CheckPixel(render, "Coverage", 25, 25, 0xFF000000);
+	CheckPixel(render, "Coverage", 9, 15, 0xFF000000);
+}
+
+static void CheckDepth(ReferenceRender *render)
+{
+	render->Clear(0xFF000000, 1.0f);
+	render->SetAlphaTestEnable(FALSE);
+	render->SetBlendType(kBlendModeOpaque);
+	render->SetZCompare(TRUE);
+	render->SetZUpdate(TRUE);
+
+	DrawHalfSquare(render, 0.5f, 0xFFFF0000);
+	DrawHalfSquare(render, 0.7f, 0xFF00FF00);		// behind
+	CheckPixel(render, "Depth behind", 15, 15, 0xFFFF0000);
+	DrawHalfSquare(render, 0.5f, 0xFF0000FF);		// LESSEQUAL passes the same depth
+	CheckPixel(render, "Depth equal", 15, 15, 0xFF0000FF);
+	DrawHalfSquare(render, 0.3f, 0xFFFFFF00);
+	CheckPixel(render, "Depth in front", 15, 15, 0xFFFFFF00);
+	if( render->Depth(15, 15) != 0.3f )
+	{
+		printf("Depth: %f is written instead of 0.3\n", render->Depth(15, 15));
+		failures++;
+	}
+
+	// Compared without being written
+	render->SetZUpdate(FALSE);
+	DrawHalfSquare(render, 0.2f, 0xFF00FFFF);
+	DrawHalfSquare(render, 0.25f, 0xFFFFFFFF);
+	CheckPixel(render, "Depth not written", 15, 15, 0xFFFFFFFF);
+
+	// Neither compared nor written
+	render->SetZCompare(FALSE);
+	DrawHalfSquare(render, 0.9f, 0xFF808080);
+	CheckPixel(render, "Depth off", 15, 15, 0xFF808080);
+}
+
+static void CheckAlphaTest(ReferenceRender *render)
+{
+	render->Clear(0xFF000000, 1.0f);
+	render->SetZCompare(FALSE);
+	render->SetZUpdate(FALSE);
+	render->SetBlendType(kBlendModeOpaque);
+	render->SetAlphaTestEnable(TRUE);
+	render->SetAlphaRef(0x80);
+
+	DrawHalfSquare(render, 0.5f, 0x7FFF0000);		// GREATEREQUAL fails below the reference
+	CheckPixel(render, "Alpha test below", 15, 15, 0xFF000000);
+	DrawHalfSquare(render, 0.5f, 0x80FF0000);
+	CheckPixel(render, "Alpha test equal", 15, 15, 0x80FF0000);
+
+	render->SetAlphaTestEnable(FALSE);
+	DrawHalfSquare(render, 0.5f, 0x0000FF00);
+	CheckPixel(render, "Alpha test off", 15, 15, 0x0000FF00);
+}
+
+static void CheckBlend(ReferenceRender *render)
+{
+	render->SetZCompare(FALSE);
+	render->SetZUpdate(FALSE);
+	render->SetAlphaTestEnable(FALSE);
+
+	// src*srcAlpha + dst*(1-srcAlpha), 0x80 of alpha is 128/255: the red of 0x80, the blue of 0x7F and the alpha of
+	// 0.502*0.502 + 0.498 = 0.750
+	render->Clear(0xFF0000FF, 1.0f);
+	render->SetBlendType(kBlendModeAlphaTrans);
+	DrawHalfSquare(render, 0.5f, 0x80FF0000);
+	CheckPixel(render, "AlphaTrans", 15, 15, 0xBF80007F);
+	CheckPixel(render, "AlphaTrans", 25, 25, 0xFF0000FF);
+
+	// src + dst, saturated
+	render->Clear(0xFF101010, 1.0f);
+	render->SetBlendType(kBlendModeOne);
+	DrawHalfSquare(render, 0.5f, 0x40202020);
+	CheckPixel(render, "One", 15, 15, 0xFF303030);
+	DrawHalfSquare(render, 0.5f, 0x40F0F0F0);
+	CheckPixel(render, "One saturated", 15, 15, 0xFFFFFFFF);
+
+	// dst*(1-srcAlpha)
+	render->Clear(0xFFFFFFFF, 1.0f);
+	render->SetBlendType(kBlendModeFade);
+	DrawHalfSquare(render, 0.5f, 0xFF00FF00);
+	CheckPixel(render, "Fade", 15, 15, 0x00000000);
+
+	// dst only
+	render->Clear(0xFF123456, 1.0f);
+	render->SetBlendType(kBlendModeZeroOne);
+	DrawHalfSquare(render, 0.5f, 0xFFFFFFFF);
+	CheckPixel(render, "ZeroOne", 15, 15, 0xFF123456);
+
+	render->SetBlendType(kBlendModeOpaque);
+}
+
+int main()
+{
+	static uint8 rdram[0x400000];
+	if( !HeadlessStartVideo(rdram, sizeof(rdram), false) )
+	{
+		printf("SoftwareRenderTest: the headless render does not start\n");
+		return 1;
+	}
+
+	// As StartVideo creates the render
+	SAFE_DELETE(CRender::g_pRender);
+	ReferenceRender *render = new ReferenceRender();
+	CRender::g_pRender = render;
+	render->Initialize();
+
+	CheckCoverage(render);
+	CheckDepth(render);
+	CheckAlphaTest(render);
+	CheckBlend(render);
+
+	HeadlessStopVideo();
+
+	if( failures )
+	{
+		printf("SoftwareRenderTest: %d failures\n", failures);
+		return 1;
+	}
+	printf("SoftwareRenderTest: passed\n");
+	return 0;
+}
@@ -0,0 +1,129 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+// TexGenAcos against acosf over [-1,1], and the SSE2 texgen against the scalar one
+
+#include "../../stdafx.h"
+#include <float.h>
+
+static int failures = 0;
+
+static void CheckAcos(float x)
+{
+	float expected = acosf(x) / 3.14f;
+	float error = fabsf(TexGenAcos(x) - expected);
+	if (!(error <= TEXGEN_ACOS_ERROR))
+	{
+		printf("TexGenAcos(%g) = %.8f, acosf gives %.8f\n", x, TexGenAcos(x), expected);
+		failures++;
+	}
+}
+
+static void CheckAcosRange()
+{
+	const int steps = 200000;
+	for (int i = 0; i <= steps; i++)
+		CheckAcos(-1.0f + 2.0f * i / steps);
+
+	const float special[] = { -1.0f, 1.0f, 0.0f, -0.0f, FLT_MIN, -FLT_MIN, FLT_MIN / 4, -FLT_MIN / 4, 1e-45f, -1e-45f,
+		nextafterf(1.0f, 0.0f), nextafterf(-1.0f, 0.0f), 0.5f, -0.5f };
+	for (size_t i = 0; i < ARRAYSIZE(special); i++)
+		CheckAcos(special[i]);
+
+	// The normals a little longer than 1 are clamped instead of giving NaN
+	if (TexGenAcos(1.0001f) != TexGenAcos(1.0f) || TexGenAcos(-1.0001f) != TexGenAcos(-1.0f))
+	{
+		printf("TexGenAcos does not clamp outside [-1,1]\n");
+		failures++;
+	}
+}
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define TEXGEN_TEST_SSE2
+#endif
+
+#ifdef TEXGEN_TEST_SSE2
+static void CheckLanes(const Matrix4x4 &mat, bool bLinear)
+{
+	// 7 vertices, a full batch of 4 and a partial one, with a zero normal and the axes
+	static const s8 normals[][3] = { { 127, 0, 0 }, { 0, -128, 0 }, { 0, 0, 127 }, { 0, 0, 0 }, { 73, -73, 73 }, { -90, 12, -90 }, { 5, 120, -30 } };
+	const uint32 num = ARRAYSIZE(normals);
+	const uint32 first = 3;
+
+	FiddledVtx verts[num];
+	memset(verts, 0, sizeof(verts));
+	for (uint32 i = 0; i < num; i++)
+	{
+		verts[i].norm_x = normals[i][0];
+		verts[i].norm_y = normals[i][1];
+		verts[i].norm_z = normals[i][2];
+	}
+
+	float scalarU[num], scalarV[num];
+	TexGenVerticesScalar(verts, first, num, mat, bLinear);
+	for (uint32 i = 0; i < num; i++)
+	{
+		scalarU[i] = g_vecProjected[first + i].Texture.x;
+		scalarV[i] = g_vecProjected[first + i].Texture.y;
+	}
+
+	TexGenVerticesSSE2(verts, first, num, mat, bLinear);
+	for (uint32 i = 0; i < num; i++)
+	{
+		float du = fabsf(g_vecProjected[first + i].Texture.x - scalarU[i]);
+		float dv = fabsf(g_vecProjected[first + i].Texture.y - scalarV[i]);
+		if (!(du <= 1e-5f && dv <= 1e-5f))
+		{
+			printf("%s texgen of vertex %d: SSE2 %f, %f, scalar %f, %f\n", bLinear ? "Linear" : "Spherical", i,
+				g_vecProjected[first + i].Texture.x, g_vecProjected[first + i].Texture.y, scalarU[i], scalarV[i]);
+			failures++;
+		}
+	}
+}
+#endif
+
+int main()
+{
+	CheckAcosRange();
+
+#ifdef TEXGEN_TEST_SSE2
+	// A rotation around z and x with a scale, and a matrix that is not a rotation
+	float c = cosf(0.6f), s = sinf(0.6f);
+	Matrix4x4 rotation(	2*c,	2*s,	0,		0,
+						-2*s,	2*c*c,	2*c*s,	0,
+						0,		-2*s,	2*c,	0,
+						0,		0,		0,		1);
+	Matrix4x4 shear(	1,		0.5f,	0,		0,
+						0,		1,		0,		0,
+						0.3f,	0,		0.2f,	0,
+						0,		0,		0,		1);
+	CheckLanes(rotation, false);
+	CheckLanes(rotation, true);
+	CheckLanes(shear, false);
+	CheckLanes(shear, true);
+#endif
+
+	if (failures)
+	{
+		printf("TexGenTest: %d failures\n", failures);
+		return 1;
+	}
+	printf("TexGenTest: passed\n");
+	return 0;
+}
@@ -26,7 +26,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "ColourValue.h"
 
 // The ordering of these elements is required for the VectorTnL code.
-__declspec(align(16)) struct DaedalusVtx4
+struct ALIGNED16 DaedalusVtx4
 {
     v4	TransformedPos;
     v4	ProjectedPos;
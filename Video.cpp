@@ -18,6 +18,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 #include "stdafx.h"
 #include "_BldNum.h"
+#include "Parser/DLCapture.h"
+#include "Parser/DLProfiler.h"
+#include "Parser/RenderThread.h"
 
 PluginStatus status;
 char generalText[256];
@@ -128,6 +131,7 @@ FUNC_TYPE(void) NAME_DEFINE(ChangeWindow) ()
 
 	windowSetting.bDisplayFullscreen = !windowSetting.bDisplayFullscreen;
 	g_CritialSection.Lock();
+	gRenderThread.Sync();
 	windowSetting.bDisplayFullscreen = CGraphicsContext::Get()->ToggleFullscreen();
 
 	if (g_GraphicsInfo.hStatusBar != NULL)
@@ -203,8 +207,16 @@ bool StartVideo(void)
 	ChangeWinSize();
 		
 	try {
-		CGraphicsContext::g_pGraphicsContext = new CDXGraphicsContext();
-		g_pFrameBufferManager = new DXFrameBufferManager;
+		if( options.bHeadlessRender )
+		{
+			CGraphicsContext::g_pGraphicsContext = new CNullGraphicsContext();
+			g_pFrameBufferManager = new NullFrameBufferManager;
+		}
+		else
+		{
+			CGraphicsContext::g_pGraphicsContext = new CDXGraphicsContext();
+			g_pFrameBufferManager = new DXFrameBufferManager;
+		}
 		CGraphicsContext::InitWindowInfo();
 		
 		windowSetting.bDisplayFullscreen = FALSE;
@@ -216,12 +228,24 @@ bool StartVideo(void)
 			return false;
 		}
 
-		CRender::g_pRender = new D3DRender();
+		if( options.bHeadlessRender && options.bSoftwareRender )
+			CRender::g_pRender = new CSoftwareRender();
+		else if( options.bHeadlessRender )
+			CRender::g_pRender = new CNullRender();
+		else
+			CRender::g_pRender = new D3DRender();
 		CRender::GetRender()->Initialize();
 		
 		DLParser_Init();
 		
 		status.bGameIsRunning = true;
+
+		// record the display lists if the capture option is set
+		gDListCapture.StartForRom();
+		gDListProfiler.Reset();
+
+		if( options.bRenderThread )
+			gRenderThread.Start();
 	}
 	catch(...)
 	{
@@ -236,6 +260,9 @@ bool StartVideo(void)
 extern void CloseExternalTextures(void);
 void StopVideo()
 {
+	// the last display list is drawn before anything is released
+	gRenderThread.Stop();
+
 	if( CGraphicsContext::Get()->IsWindowed() == false )
 	{
 		status.ToToggleFullScreen = TRUE;
@@ -245,6 +272,9 @@ void StopVideo()
 
 	g_CritialSection.Lock();
 	status.bGameIsRunning = false;
+	gDListCapture.Stop();
+	if( options.bProfileDisplayLists )
+		gDListProfiler.Export();
 
 
 	try {
@@ -363,6 +393,10 @@ void SetVIScales()
 FUNC_TYPE(void) NAME_DEFINE(UpdateScreen) (void)
 {
 	g_CritialSection.Lock();
+	gRenderThread.Sync();
+	gDListCapture.RecordCall(DLCAPTURE_UPDATE_SCREEN);
+	if( options.bProfileDisplayLists )
+		gDListProfiler.EndFrame();
 
 	if( status.bHandleN64RenderTexture )
 		g_pFrameBufferManager->CloseRenderTexture(true);
@@ -410,6 +444,8 @@ FUNC_TYPE(void) NAME_DEFINE(UpdateScreen) (void)
 FUNC_TYPE(void) NAME_DEFINE(ViStatusChanged) (void)
 {
 	g_CritialSection.Lock();
+	gRenderThread.Sync();
+	gDListCapture.RecordCall(DLCAPTURE_VI_STATUS_CHANGED);
 	SetVIScales();
 	CRender::g_pRender->UpdateClipRectangle();
 	g_CritialSection.Unlock();
@@ -419,6 +455,8 @@ FUNC_TYPE(void) NAME_DEFINE(ViStatusChanged) (void)
 FUNC_TYPE(void) NAME_DEFINE(ViWidthChanged) (void)
 {
 	g_CritialSection.Lock();
+	gRenderThread.Sync();
+	gDListCapture.RecordCall(DLCAPTURE_VI_WIDTH_CHANGED);
 	SetVIScales();
 	CRender::g_pRender->UpdateClipRectangle();
 	g_CritialSection.Unlock();
@@ -480,6 +518,7 @@ void __cdecl ErrorMsg (char * Message, ...)
 
 //---------------------------------------------------------------------------------------
 
+extern void CloseHiresTextures(void);
 FUNC_TYPE(void) NAME_DEFINE(CloseDLL) (void)
 { 
 	if( status.bGameIsRunning )
@@ -487,6 +526,9 @@ FUNC_TYPE(void) NAME_DEFINE(CloseDLL) (void)
 		RomClosed();
 	}
 
+	// also stops the indexing of the hires textures
+	CloseHiresTextures();
+
 #ifdef _DEBUG
 	CloseDialogBox();
 #endif
@@ -494,6 +536,9 @@ FUNC_TYPE(void) NAME_DEFINE(CloseDLL) (void)
 
 FUNC_TYPE(void) NAME_DEFINE(ProcessRDPList)(void)
 {
+	gRenderThread.Sync();
+	gDListCapture.RecordCall(DLCAPTURE_PROCESS_RDP_LIST);
+
 	try
 	{
 		RDP_DLParser_Process();
@@ -504,22 +549,39 @@ FUNC_TYPE(void) NAME_DEFINE(ProcessRDPList)(void)
 	}
 }	
 
+extern void PublishHiresTextures(void);
 FUNC_TYPE(void) NAME_DEFINE(ProcessDList)(void)
 {
 	g_CritialSection.Lock();
+
+	// the previous display list is done before anything of the plugin is touched
+	gRenderThread.Sync();
+
+	// the hires textures are indexed in the background, use them once they are ready
+	PublishHiresTextures();
+
+	gDListCapture.RecordCall(DLCAPTURE_PROCESS_DLIST);
+
 	if( status.toShowCFB )
 	{
 		CRender::GetRender()->DrawFrameBuffer(true);
 		status.toShowCFB = false;
 	}
 
-	try
+	if( gRenderThread.CanProcessDList() )
 	{
-		DLParser_Process();
+		gRenderThread.ProcessDList();
 	}
-	catch (...)
+	else
 	{
-		TRACE0("Unknown Error in ProcessDList");
+		try
+		{
+			DLParser_Process();
+		}
+		catch (...)
+		{
+			TRACE0("Unknown Error in ProcessDList");
+		}
 	}
 
 	g_CritialSection.Unlock();
@@ -529,6 +591,10 @@ FUNC_TYPE(void) NAME_DEFINE(ProcessDList)(void)
 
 void TriggerDPInterrupt(void)
 {
+	// raised by gRenderThread.ProcessDList when the list was queued
+	if( gRenderThread.IsRenderThread() )
+		return;
+
 	*(g_GraphicsInfo.MI_INTR_REG) |= 0x20;
 	g_GraphicsInfo.CheckInterrupts();
 }
@@ -536,6 +602,7 @@ void TriggerDPInterrupt(void)
 // Plugin spec 1.3 functions
 FUNC_TYPE(void) NAME_DEFINE(ShowCFB) (void)
 {
+	gDListCapture.RecordCall(DLCAPTURE_SHOW_CFB);
 	status.toShowCFB = true;
 }
 
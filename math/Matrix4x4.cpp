@@ -2,7 +2,7 @@
 #include "./Matrix4x4.h"
 #include "./Vector3.h"
 #include "./Vector4.h"
-#include "./Math.h"
+#include <math.h>
 
 void MatrixMultiplyUnaligned(Matrix4x4 * m_out, const Matrix4x4 *mat_a, const Matrix4x4 *mat_b)
 {
@@ -3,7 +3,7 @@
 
 #include "Vector3.h"
 class v4;
-__declspec(align(16)) class Matrix4x4
+class ALIGNED16 Matrix4x4
 {
 	public:
 
@@ -1,6 +1,6 @@
 #ifndef MATH_VECTOR4_H_
 #define MATH_VECTOR4_H_
-__declspec(align(16)) class v4
+class ALIGNED16 v4
 {
 public:
 	v4() {}
@@ -0,0 +1,294 @@
+/*
+Copyright (C) 2003-2009 Rice1964
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+// The plugin is built against windows.h and the Direct3D 9 headers. When they
+// are not available (the headless build in Tools/Headless) this header
+// declares the small part of them that the parser, the vertex pipeline, the
+// combiner decoding, the texture manager and the null and software renders use.
+// None of the declarations here talk to a device, the d3d types only carry
+// the values the shared code stores.
+
+#ifndef _PLATFORM_H_
+#define _PLATFORM_H_
+
+#if defined(_MSC_VER)
+#define ALIGNED16			__declspec(align(16))
+#else
+#define ALIGNED16			__attribute__((aligned(16)))
+#endif
+
+#ifndef _WIN32
+
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// the std headers go before the min and max macros, as they do after windows.h
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#define EXPORT				__attribute__((visibility("default")))
+#define __cdecl
+#define _cdecl
+#define WINAPI
+#define CALLBACK
+#define __forceinline		inline __attribute__((always_inline))
+#define __noop(...)			((void)0)
+
+#define __int8				char
+#define __int16				short
+#define __int32				int
+#define __int64				long long
+
+#define MAX_PATH			260
+#define _MAX_PATH			260
+#define ARRAYSIZE(a)		(sizeof(a)/sizeof((a)[0]))
+#define _finite(x)			isfinite(x)
+
+#ifndef max
+#define max(a,b)			(((a) > (b)) ? (a) : (b))
+#endif
+#ifndef min
+#define min(a,b)			(((a) < (b)) ? (a) : (b))
+#endif
+
+typedef int					BOOL;
+typedef unsigned char		BYTE;
+typedef unsigned short		WORD;
+typedef uint32_t			DWORD;
+typedef int32_t				LONG;
+typedef uint32_t			ULONG;
+typedef uint32_t			UINT;
+typedef int32_t				HRESULT;
+typedef void				VOID;
+typedef char				CHAR;
+typedef char				TCHAR;
+typedef char *				LPSTR;
+typedef const char *		LPCSTR;
+typedef const char *		LPCTSTR;
+typedef void *				LPVOID;
+typedef void *				HANDLE;
+typedef void *				HWND;
+typedef void *				HMENU;
+typedef void *				HINSTANCE;
+typedef void *				HMODULE;
+
+#ifndef TRUE
+#define TRUE				1
+#define FALSE				0
+#endif
+
+#define S_OK				((HRESULT)0)
+#define E_FAIL				((HRESULT)0x80004005)
+#define SUCCEEDED(hr)		(((HRESULT)(hr)) >= 0)
+#define FAILED(hr)			(((HRESULT)(hr)) < 0)
+
+typedef struct tagRECT
+{
+	LONG left;
+	LONG top;
+	LONG right;
+	LONG bottom;
+} RECT;
+
+typedef union _LARGE_INTEGER
+{
+	long long QuadPart;
+} LARGE_INTEGER;
+
+typedef struct tagPOINT
+{
+	LONG x;
+	LONG y;
+} POINT;
+
+typedef struct _devicemodeA
+{
+	DWORD dmPelsWidth;
+	DWORD dmPelsHeight;
+} DEVMODEA, DEVMODE;
+
+#define DT_CENTER			0x00000001
+#define DT_VCENTER			0x00000004
+
+#define _stricmp			strcasecmp
+#define _strnicmp			strncasecmp
+#define stricmp				strcasecmp
+#define _snprintf			snprintf
+#define _vsnprintf			vsnprintf
+
+inline void Sleep(DWORD ms)				{ usleep(ms * 1000); }
+inline DWORD timeGetTime()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (DWORD)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+inline DWORD GetTickCount()				{ return timeGetTime(); }
+inline BOOL QueryPerformanceFrequency(LARGE_INTEGER *freq)
+{
+	freq->QuadPart = 1000000000LL;
+	return TRUE;
+}
+inline BOOL QueryPerformanceCounter(LARGE_INTEGER *count)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	count->QuadPart = (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+	return TRUE;
+}
+inline void OutputDebugString(LPCSTR)	{}
+
+inline BOOL CreateDirectory(LPCSTR path, void *)	{ return mkdir(path, 0755) == 0; }
+inline BOOL PathFileExists(LPCSTR path)				{ return access(path, F_OK) == 0; }
+
+// CCritSect is built on this
+typedef struct _CRITICAL_SECTION
+{
+	std::recursive_mutex	mutex;
+	LONG					LockCount;
+} CRITICAL_SECTION;
+inline void InitializeCriticalSection(CRITICAL_SECTION *cs)	{ cs->LockCount = 0; }
+inline void DeleteCriticalSection(CRITICAL_SECTION *)		{}
+inline void EnterCriticalSection(CRITICAL_SECTION *cs)		{ cs->mutex.lock(); cs->LockCount++; }
+inline void LeaveCriticalSection(CRITICAL_SECTION *cs)		{ cs->LockCount--; cs->mutex.unlock(); }
+
+// Direct3D types carried by the shared code
+typedef DWORD D3DCOLOR;
+#define D3DCOLOR_ARGB(a,r,g,b)	((D3DCOLOR)((((a)&0xff)<<24)|(((r)&0xff)<<16)|(((g)&0xff)<<8)|((b)&0xff)))
+#define D3DCOLOR_RGBA(r,g,b,a)	D3DCOLOR_ARGB(a,r,g,b)
+
+typedef struct _D3DLOCKED_RECT
+{
+	int		Pitch;
+	void *	pBits;
+} D3DLOCKED_RECT;
+
+typedef struct _D3DRECT
+{
+	LONG x1;
+	LONG y1;
+	LONG x2;
+	LONG y2;
+} D3DRECT;
+
+typedef struct _D3DVIEWPORT9
+{
+	DWORD	X;
+	DWORD	Y;
+	DWORD	Width;
+	DWORD	Height;
+	float	MinZ;
+	float	MaxZ;
+} D3DVIEWPORT9;
+
+typedef struct IDirect3DTexture9 *LPDIRECT3DTEXTURE9;
+typedef struct IDirect3DSurface9 *LPDIRECT3DSURFACE9;
+
+typedef enum _D3DFORMAT
+{
+	D3DFMT_UNKNOWN	= 0,
+	D3DFMT_A8R8G8B8	= 21,
+	D3DFMT_X8R8G8B8	= 22,
+	D3DFMT_DXT1		= 0x31545844,
+	D3DFMT_DXT5		= 0x35545844,
+} D3DFORMAT;
+
+typedef enum _D3DTEXTUREADDRESS
+{
+	D3DTADDRESS_WRAP	= 1,
+	D3DTADDRESS_MIRROR	= 2,
+	D3DTADDRESS_CLAMP	= 3,
+} D3DTEXTUREADDRESS;
+
+typedef enum _D3DTEXTUREFILTERTYPE
+{
+	D3DTEXF_NONE	= 0,
+	D3DTEXF_POINT	= 1,
+	D3DTEXF_LINEAR	= 2,
+} D3DTEXTUREFILTERTYPE;
+
+typedef enum _D3DBLEND
+{
+	D3DBLEND_ZERO			= 1,
+	D3DBLEND_ONE			= 2,
+	D3DBLEND_SRCCOLOR		= 3,
+	D3DBLEND_INVSRCCOLOR	= 4,
+	D3DBLEND_SRCALPHA		= 5,
+	D3DBLEND_INVSRCALPHA	= 6,
+	D3DBLEND_DESTALPHA		= 7,
+	D3DBLEND_INVDESTALPHA	= 8,
+	D3DBLEND_DESTCOLOR		= 9,
+	D3DBLEND_INVDESTCOLOR	= 10,
+} D3DBLEND;
+
+typedef enum _D3DCMPFUNC
+{
+	D3DCMP_NEVER		= 1,
+	D3DCMP_LESS			= 2,
+	D3DCMP_EQUAL		= 3,
+	D3DCMP_LESSEQUAL	= 4,
+	D3DCMP_GREATER		= 5,
+	D3DCMP_NOTEQUAL		= 6,
+	D3DCMP_GREATEREQUAL	= 7,
+	D3DCMP_ALWAYS		= 8,
+} D3DCMPFUNC;
+
+typedef enum _D3DCULL
+{
+	D3DCULL_NONE	= 1,
+	D3DCULL_CW		= 2,
+	D3DCULL_CCW		= 3,
+} D3DCULL;
+
+typedef enum _D3DRENDERSTATETYPE
+{
+	D3DRS_SRCBLEND			= 19,
+	D3DRS_DESTBLEND			= 20,
+	D3DRS_ALPHABLENDENABLE	= 27,
+} D3DRENDERSTATETYPE;
+
+#define D3DFVF_XYZ			0x002
+#define D3DFVF_XYZRHW		0x004
+#define D3DFVF_DIFFUSE		0x040
+#define D3DFVF_SPECULAR		0x080
+#define D3DFVF_TEX2			0x200
+
+#endif // _WIN32
+
+#endif // _PLATFORM_H_
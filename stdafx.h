@@ -10,6 +10,7 @@
 
 #pragma once
 
+#ifdef _WIN32
 #define EXPORT				__declspec(dllexport)
 #define VC_EXTRALEAN		// Exclude rarely-used stuff from Windows headers
 
@@ -24,18 +25,24 @@
 #include <commctrl.h>
 #include <ShellAPI.h>
 #include <winnt.h>			// For 32x32To64 multiplies
+#else
+#include <stdio.h>
+#endif
 #endif
 #include <math.h>			// For sqrt()
 #include <iostream>
 #include <fstream>
 #include <istream>
 
+#ifdef _WIN32
 #include <process.h>
 
 #include <d3d9.h>
 #include <d3dx9.h>
 #include <d3d9types.h>
 #include "./Utility/dxerr.h"
+#endif
+#include "platform.h"
 #include <vector>
 #include "./Utility/DaedalusVtx.h"
 #include "./math/Vector2.h"
@@ -70,19 +77,29 @@
 
 #include "./Combiner/blender.h"
 
-#include "./Combiner/combiner.h"
+#include "./Combiner/Combiner.h"
+#ifdef _WIN32
 #include "./Combiner/DirectXCombiner/DirectXCombiner.h"
+#endif
+#include "./Combiner/NullCombiner/NullCombiner.h"
 
 #include "./Device/RenderTexture.h"
 #include "./Device/FrameBuffer.h"
 
 #include "./Device/GraphicsContext.h"
+#ifdef _WIN32
 #include "./Device/DirectXDevice/DXGraphicsContext.h"
+#endif
+#include "./Device/NullDevice/NullGraphicsContext.h"
 
 #include "./Render/RenderBase.h"
 #include "./Render/ExtendedRender.h"
 #include "./Render/Render.h"
+#ifdef _WIN32
 #include "./Render/DirectX/D3DRender.h"
+#endif
+#include "./Render/Null/NullRender.h"
+#include "./Render/Software/SoftwareRender.h"
 
 #include "resource.h"
 